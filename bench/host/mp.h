@@ -0,0 +1,57 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2014  Michael VERGOZ                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Minimal host replacement for <mp.h> : only what common/task.c needs
+ * so the scheduler can be benchmarked as a regular Linux process.
+ */
+
+#ifndef _MP_H
+	#define _MP_H
+
+	#include <string.h>
+
+	#ifndef MP_TASK_MAX
+		#define MP_TASK_MAX 10
+	#endif
+
+	#define TRUE 1
+	#define FALSE 0
+
+	#define YES TRUE
+	#define NO FALSE
+
+	typedef signed char mp_ret_t;
+	typedef signed char mp_bool_t;
+
+	typedef struct mp_kernel_s mp_kernel_t;
+
+	#include "../../include/common/list.h"
+	#include "../../include/common/task.h"
+
+	#define MP_TRACE_EVENT(type, id, arg)
+
+	#define MP_INTERRUPT_SAFE_BEGIN {
+	#define MP_INTERRUPT_SAFE_END }
+
+	unsigned long mp_clock_ticks();
+	void mp_clock_task_change(mp_task_t *task);
+
+#endif
@@ -0,0 +1,175 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Usable capacity and cost of the size class allocator against the
+ * former single chunk size pool, both on MP_MEM_SIZE bytes.
+ *
+ * Each workload allocates its sizes round robin until the first
+ * failure (capacity), then times alloc and free pairs in ns. A workload
+ * which does not fit at all reports a capacity of 0 and no cost.
+ * make bench-mem
+ */
+
+#include <mp.h>
+#include <time.h>
+
+#define BENCH_PAIRS 100000
+
+typedef struct _fixed_chunk_s _fixed_chunk_t;
+
+/* chunk of the former allocator */
+struct _fixed_chunk_s {
+	unsigned char data[MP_MEM_CHUNK];
+	unsigned long canary;
+	unsigned int id;
+	mp_list_item_t item;
+};
+
+typedef struct _workload_s {
+	char *name;
+	int sizes[8];
+	int number;
+} _workload_t;
+
+static _fixed_chunk_t __fixed[MP_MEM_SIZE/sizeof(_fixed_chunk_t)];
+static mp_list_t __fixedFree;
+static mp_kernel_t __kernel;
+
+static void *__ptrs[MP_MEM_SIZE];
+
+static void _fixed_erase(void) {
+	int a;
+
+	memset(__fixed, 0, sizeof(__fixed));
+	mp_list_init(&__fixedFree);
+	for(a=0; a<sizeof(__fixed)/sizeof(__fixed[0]); a++) {
+		__fixed[a].canary = MEM_CANARY;
+		__fixed[a].id = a;
+		mp_list_add_last(&__fixedFree, &__fixed[a].item, &__fixed[a]);
+	}
+}
+
+static void *_fixed_alloc(mp_kernel_t *kernel, int size) {
+	mp_list_item_t *item;
+	_fixed_chunk_t *chunk;
+
+	if(size >= MP_MEM_CHUNK)
+		return(NULL);
+
+	item = __fixedFree.first;
+	if(!item)
+		return(NULL);
+	chunk = item->user;
+	mp_list_remove(&__fixedFree, item);
+	memset(&chunk->data, 0, sizeof(chunk->data));
+	return(chunk);
+}
+
+static void _fixed_free(mp_kernel_t *kernel, void *ptr) {
+	_fixed_chunk_t *chunk = ptr;
+
+	if(chunk->canary != MEM_CANARY)
+		return;
+	memset(&chunk->item, 0, sizeof(chunk->item));
+	mp_list_add_first(&__fixedFree, &chunk->item, chunk);
+}
+
+static double _bench_now(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return(ts.tv_sec*1e9+ts.tv_nsec);
+}
+
+static void _bench_run(char *allocator, _workload_t *workload,
+		void (*erase)(void),
+		void *(*alloc)(mp_kernel_t *, int),
+		void (*release)(mp_kernel_t *, void *)) {
+	int capacity;
+	int a;
+	double start, allocNs, freeNs;
+
+	erase();
+
+	/* capacity */
+	for(capacity=0; capacity<MP_MEM_SIZE; capacity++) {
+		__ptrs[capacity] = alloc(&__kernel, workload->sizes[capacity%workload->number]);
+		if(__ptrs[capacity] == NULL)
+			break;
+	}
+	for(a=0; a<capacity; a++)
+		release(&__kernel, __ptrs[a]);
+
+	/* a size does not fit at all, nothing to time */
+	if(capacity == 0) {
+		printf("%s,%s,0,-,-\n", allocator, workload->name);
+		return;
+	}
+
+	/* cost, batches of the capacity keep the pool busy */
+	allocNs = freeNs = 0;
+	for(a=0; a<BENCH_PAIRS; a+=capacity) {
+		int b, batch = capacity < BENCH_PAIRS-a ? capacity : BENCH_PAIRS-a;
+
+		start = _bench_now();
+		for(b=0; b<batch; b++)
+			__ptrs[b] = alloc(&__kernel, workload->sizes[b%workload->number]);
+		allocNs += _bench_now()-start;
+
+		start = _bench_now();
+		for(b=0; b<batch; b++)
+			release(&__kernel, __ptrs[b]);
+		freeNs += _bench_now()-start;
+	}
+
+	printf("%s,%s,%d,%.1f,%.1f\n", allocator, workload->name, capacity,
+		allocNs/BENCH_PAIRS, freeNs/BENCH_PAIRS);
+}
+
+static void _classes_erase(void) {
+	mp_mem_erase(&__kernel);
+}
+
+int main(int argc, char **argv) {
+	_workload_t workloads[] = {
+		/* register buffers of the sensor drivers */
+		{ "registers", { 2, 2, 3, 2 }, 4 },
+
+		/* driver buffers and a sensor, regMaster operands come from pools */
+		{ "drivers", { 2, 3, sizeof(mp_sensor_t) }, 3 },
+
+		/* serial lines */
+		{ "circular", { sizeof(mp_circular_buffer_t) }, 1 },
+	};
+	int a;
+
+	/* out of memory is reported */
+	mp_printk_unset();
+
+	printf("allocator,workload,capacity,alloc_ns,free_ns\n");
+	for(a=0; a<sizeof(workloads)/sizeof(workloads[0]); a++) {
+		_bench_run("fixed", &workloads[a], _fixed_erase, _fixed_alloc, _fixed_free);
+		_bench_run("classes", &workloads[a], _classes_erase, mp_mem_alloc, mp_mem_free);
+	}
+
+	return(0);
+}
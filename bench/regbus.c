@@ -0,0 +1,215 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+/*
+ * Several regMaster clients on one shared I2C bus.
+ *
+ * Three simulated slaves are wired on USCI_B3, the board opens the
+ * gate once and registers a bus, then three clients (gyro, accel and
+ * baro) join it and keep BENCH_DEPTH sample reads of 6 bytes queued
+ * each on the bench/regsim.c bus.
+ * Rows report the share of the bus every client got and its mean
+ * and worst time from enqueue to the stop condition of the read,
+ * first with equal priorities (round robin) then with the gyro one
+ * level above the others.
+ *
+ * make bench-regbus
+ */
+
+#include <mp.h>
+#include "regsim.h"
+
+#define BENCH_OPS     6000
+#define BENCH_DEPTH   4
+#define BENCH_SAMPLE  6
+#define BENCH_CLIENTS 3
+
+typedef struct _bench_s _bench_t;
+typedef struct _bench_client_s _bench_client_t;
+
+struct _bench_client_s {
+	_bench_t *bench;
+	char *name;
+
+	mp_regMaster_t regMaster;
+	mp_regMaster_op_t ops[BENCH_DEPTH+1];
+	mp_posix_i2c_device_t device;
+
+	unsigned char samples[BENCH_DEPTH][BENCH_SAMPLE];
+
+	/* enqueue times, the device serves them in order */
+	double queued[BENCH_DEPTH+1];
+	int head;
+	int tail;
+
+	unsigned long completed;
+	unsigned long stops;
+	double total;
+	double worst;
+};
+
+struct _bench_s {
+	mp_kernel_t kernel;
+	mp_i2c_t i2c;
+	mp_regMaster_bus_t bus;
+
+	_bench_client_t clients[BENCH_CLIENTS];
+
+	mp_bool_t priority;
+
+	unsigned long completed;
+	double wallStart;
+};
+
+static _bench_t __bench;
+
+static char *__names[BENCH_CLIENTS] = { "gyro", "accel", "baro" };
+static unsigned char __addresses[BENCH_CLIENTS] = { 0x6b, 0x1d, 0x60 };
+
+static void _bench_onStop(mp_posix_i2c_device_t *device) {
+	_bench_client_t *client = device->user;
+	double wait;
+
+	mp_bench_regsim_onStop(device);
+
+	/* a read ends on a stop condition */
+	wait = mp_bench_regsim_clock()-client->queued[client->tail];
+	client->tail = (client->tail+1)%(BENCH_DEPTH+1);
+
+	client->stops++;
+	client->total += wait;
+	if(wait > client->worst)
+		client->worst = wait;
+}
+
+static void _bench_read(_bench_client_t *client, unsigned char *sample);
+
+static void _bench_report(_bench_t *bench) {
+	_bench_client_t *client;
+	double wall;
+	int a;
+
+	wall = mp_bench_regsim_clock()-bench->wallStart;
+	for(a=0; a<BENCH_CLIENTS; a++) {
+		client = &bench->clients[a];
+		printf("%s,%s,%u,%lu,%.1f,%.0f,%.0f,%.0f\n",
+			bench->priority == YES ? "priority" : "fair",
+			client->name, client->regMaster.priority,
+			client->completed, client->completed*100.0/bench->completed,
+			client->completed/wall, client->total/client->stops*1e6,
+			client->worst*1e6);
+	}
+	fflush(stdout);
+}
+
+static void _bench_onSample(mp_regMaster_op_t *operand, mp_bool_t terminate) {
+	_bench_client_t *client = operand->user;
+	_bench_t *bench = client->bench;
+
+	if(terminate == TRUE || bench->completed >= BENCH_OPS)
+		return;
+
+	client->completed++;
+	bench->completed++;
+	if(bench->completed == BENCH_OPS) {
+		_bench_report(bench);
+		mp_posix_quit();
+		return;
+	}
+
+	_bench_read(client, operand->wait);
+}
+
+static void _bench_read(_bench_client_t *client, unsigned char *sample) {
+	client->queued[client->head] = mp_bench_regsim_clock();
+	client->head = (client->head+1)%(BENCH_DEPTH+1);
+
+	if(mp_regMaster_readReg(&client->regMaster, 0x28 | 0x80,
+			sample, BENCH_SAMPLE, _bench_onSample, client) != TRUE)
+		fprintf(stderr, "bench: %s queue full\n", client->name);
+}
+
+static void _bench_onBoot(void *user) {
+	_bench_t *bench = user;
+	_bench_client_t *client;
+	mp_ret_t ret;
+	int a;
+	int b;
+
+	/* one gate, one bus */
+	ret = mp_bench_regsim_open(&bench->kernel, &bench->i2c);
+	if(ret == TRUE)
+		ret = mp_regMaster_bus_init_i2c(&bench->kernel, &bench->bus, &bench->i2c, "Bench bus");
+	if(ret == FALSE) {
+		fprintf(stderr, "bench: can not open the I2C bus\n");
+		mp_posix_quit();
+		return;
+	}
+
+	/* clients join the bus registered on their gate */
+	for(a=0; a<BENCH_CLIENTS; a++) {
+		client = &bench->clients[a];
+		client->bench = bench;
+		client->name = __names[a];
+
+		mp_bench_regsim_device(&client->device, __addresses[a], client);
+		client->device.onStop = _bench_onStop;
+
+		ret = mp_regMaster_init_bus(&bench->kernel, &client->regMaster,
+				mp_regMaster_bus_handle(MP_BENCH_REGSIM_GATE), client->ops, BENCH_DEPTH+1,
+				client, client->name);
+		if(ret == FALSE) {
+			fprintf(stderr, "bench: %s can not join the bus\n", client->name);
+			mp_posix_quit();
+			return;
+		}
+		mp_regMaster_setSlaveAddress(&client->regMaster, __addresses[a]);
+	}
+
+	if(bench->priority == YES)
+		mp_regMaster_setPriority(&bench->clients[0].regMaster, 1);
+
+	bench->wallStart = mp_bench_regsim_clock();
+	for(b=0; b<BENCH_DEPTH; b++) {
+		for(a=0; a<BENCH_CLIENTS; a++)
+			_bench_read(&bench->clients[a], bench->clients[a].samples[b]);
+	}
+}
+
+static void _bench_run(mp_bool_t priority) {
+	_bench_t *bench = &__bench;
+
+	memset(bench, 0, sizeof(*bench));
+	bench->priority = priority;
+
+	mp_bench_regsim_run(&bench->kernel, _bench_onBoot, bench);
+}
+
+int main(int argc, char **argv) {
+	printf("mode,client,priority,ops,share_pct,ops_per_sec,mean_us,worst_us\n");
+	fflush(stdout);
+
+	_bench_run(NO);
+	_bench_run(YES);
+
+	return(0);
+}
@@ -0,0 +1,203 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+/*
+ * regMaster error handling against injected I2C faults.
+ *
+ * One client reads 2 bytes from a slave of the bench/regsim.c bus
+ * BENCH_OPS times and a fault is injected after every BENCH_EVERY reads with
+ * mp_posix_i2c_fault() :
+ *  @li clean : no fault
+ *  @li nack : the address is not acknowledged twice, retries absorb it
+ *  @li nack-lost : three NACK in a row, more than MP_REGMASTER_RETRIES
+ *  @li arbitration : another master wins once, the USCI is reset
+ *  @li hold : the slave holds SDA, the watchdog times out and recovers
+ *
+ * Rows report what the callbacks got, the bus counters and the worst
+ * time from enqueue to callback. result is FAIL when the counts are
+ * not the expected ones, the exit status is then not zero.
+ *
+ * make bench-regfault
+ */
+
+#include <mp.h>
+#include "regsim.h"
+
+#define BENCH_OPS    200
+#define BENCH_EVERY  10
+#define BENCH_FAULTS (BENCH_OPS/BENCH_EVERY-1)
+
+typedef struct _bench_s _bench_t;
+typedef struct _bench_scenario_s _bench_scenario_t;
+
+struct _bench_scenario_s {
+	char *name;
+	mp_posix_i2c_fault_t fault;
+	unsigned int count;
+
+	/* expected callbacks with an error and bus counters */
+	unsigned long failed;
+	unsigned long nacks;
+	unsigned long arbitrations;
+	unsigned long timeouts;
+};
+
+struct _bench_s {
+	mp_kernel_t kernel;
+	mp_i2c_t i2c;
+
+	mp_regMaster_t regMaster;
+	mp_regMaster_op_t ops[2];
+	mp_posix_i2c_device_t device;
+
+	_bench_scenario_t *scenario;
+
+	unsigned char sample[2];
+	double queued;
+
+	unsigned long done;
+	unsigned long ok;
+	unsigned long failed;
+	unsigned long errors[MP_REGMASTER_ERR_TIMEOUT+1];
+	double worst;
+};
+
+static _bench_t __bench;
+
+static _bench_scenario_t __scenarios[] = {
+	{ "clean", MP_POSIX_I2C_FAULT_NONE, 0, 0, 0, 0, 0 },
+	{ "nack", MP_POSIX_I2C_FAULT_NACK, MP_REGMASTER_RETRIES, 0, BENCH_FAULTS*MP_REGMASTER_RETRIES, 0, 0 },
+	{ "nack-lost", MP_POSIX_I2C_FAULT_NACK, MP_REGMASTER_RETRIES+1, BENCH_FAULTS, BENCH_FAULTS*(MP_REGMASTER_RETRIES+1), 0, 0 },
+	{ "arbitration", MP_POSIX_I2C_FAULT_ARBITRATION, 1, 0, 0, BENCH_FAULTS, 0 },
+	{ "hold", MP_POSIX_I2C_FAULT_HOLD, 1, 0, 0, 0, BENCH_FAULTS },
+	{ NULL }
+};
+
+static mp_bool_t _bench_report(_bench_t *bench) {
+	_bench_scenario_t *sc = bench->scenario;
+	mp_regMaster_bus_t *bus = bench->regMaster.bus;
+	mp_bool_t pass;
+
+	pass = bench->done == BENCH_OPS &&
+		bench->failed == sc->failed &&
+		bench->errors[MP_REGMASTER_ERR_NACK] == sc->failed &&
+		bus->nacks == sc->nacks &&
+		bus->arbitrations == sc->arbitrations &&
+		bus->timeouts == sc->timeouts &&
+		bus->recoveries == sc->timeouts ? YES : NO;
+
+	printf("%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%.0f,%s\n",
+		sc->name, bench->done, bench->ok, bench->failed,
+		bus->nacks, bus->arbitrations, bus->timeouts,
+		bus->restarts, bus->recoveries,
+		bench->worst*1e6, pass == YES ? "PASS" : "FAIL");
+	fflush(stdout);
+
+	return(pass);
+}
+
+static void _bench_read(_bench_t *bench);
+
+static void _bench_onSample(mp_regMaster_op_t *operand, mp_bool_t terminate) {
+	_bench_t *bench = operand->user;
+	_bench_scenario_t *sc = bench->scenario;
+	double wait;
+
+	if(operand->error == MP_REGMASTER_ERR_STOP)
+		return;
+
+	wait = mp_bench_regsim_clock()-bench->queued;
+	if(wait > bench->worst)
+		bench->worst = wait;
+
+	bench->done++;
+	if(terminate == TRUE) {
+		bench->failed++;
+		bench->errors[operand->error]++;
+	}
+	else if(bench->sample[0] == 0x5a && bench->sample[1] == 0x5a)
+		bench->ok++;
+
+	if(bench->done == BENCH_OPS) {
+		exit(_bench_report(bench) == YES ? 0 : 1);
+		return;
+	}
+
+	/* the next read meets the fault */
+	if(sc->fault != MP_POSIX_I2C_FAULT_NONE && bench->done%BENCH_EVERY == 0)
+		mp_posix_i2c_fault(&bench->device, sc->fault, sc->count);
+
+	_bench_read(bench);
+}
+
+static void _bench_read(_bench_t *bench) {
+	bench->sample[0] = 0;
+	bench->sample[1] = 0;
+	bench->queued = mp_bench_regsim_clock();
+
+	if(mp_regMaster_readReg(&bench->regMaster, 0x28,
+			bench->sample, 2, _bench_onSample, bench) != TRUE)
+		fprintf(stderr, "bench: queue full\n");
+}
+
+static void _bench_onBoot(void *user) {
+	_bench_t *bench = user;
+	mp_ret_t ret;
+
+	mp_bench_regsim_device(&bench->device, 0x40, bench);
+
+	ret = mp_bench_regsim_open(&bench->kernel, &bench->i2c);
+	if(ret == TRUE)
+		ret = mp_regMaster_init_i2c(&bench->kernel, &bench->regMaster, &bench->i2c,
+			bench->ops, 2, bench, "Bench regMaster");
+	if(ret == FALSE) {
+		fprintf(stderr, "bench: can not open the I2C bus\n");
+		exit(1);
+	}
+	mp_regMaster_setSlaveAddress(&bench->regMaster, 0x40);
+
+	_bench_read(bench);
+}
+
+static mp_bool_t _bench_run(_bench_scenario_t *sc) {
+	_bench_t *bench = &__bench;
+
+	memset(bench, 0, sizeof(*bench));
+	bench->scenario = sc;
+
+	return(mp_bench_regsim_run(&bench->kernel, _bench_onBoot, bench));
+}
+
+int main(int argc, char **argv) {
+	_bench_scenario_t *sc;
+	int ret = 0;
+
+	printf("scenario,ops,ok,failed,nacks,arbitrations,timeouts,restarts,recoveries,worst_us,result\n");
+	fflush(stdout);
+
+	for(sc=__scenarios; sc->name; sc++) {
+		if(_bench_run(sc) == NO)
+			ret = 1;
+	}
+
+	return(ret);
+}
@@ -0,0 +1,246 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+/*
+ * regMaster priority lanes on one device.
+ *
+ * An ADC-like slave is read by one client which mixes register dumps
+ * of BENCH_DUMP bytes and sample reads of BENCH_SAMPLE bytes, as
+ * ADS124x does. Every round queues BENCH_DUMPS dumps then
+ * BENCH_SAMPLES samples (a DRDY arriving during a dump) with the
+ * interrupts masked, so the burst is queued before the wire of the
+ * bench/regsim.c bus starts. Three modes are run :
+ *  @li fifo : samples stay in the BG lane, the former single queue
+ *  @li strict : samples in the RT lane, weight 0
+ *  @li weighted : samples in the RT lane, weight 1
+ * "lane" rows come from the MP_REGMASTER_STATS accounting (enqueue to
+ * start), "class" rows are seen by the device (burst to register byte).
+ *
+ * make bench-reglanes
+ */
+
+#include <mp.h>
+#include "regsim.h"
+
+#define BENCH_ROUNDS  300
+#define BENCH_DUMPS   8
+#define BENCH_DUMP    16
+#define BENCH_SAMPLES 2
+#define BENCH_SAMPLE  3
+
+#define BENCH_QUEUED  (BENCH_DUMPS+BENCH_SAMPLES)
+
+#define BENCH_REG_SAMPLE 0x12
+#define BENCH_REG_DUMP   0x20
+
+typedef enum {
+	BENCH_FIFO,
+	BENCH_STRICT,
+	BENCH_WEIGHTED,
+} _bench_mode_t;
+
+typedef struct _bench_s _bench_t;
+typedef struct _bench_class_s _bench_class_t;
+
+struct _bench_class_s {
+	unsigned long ops;
+	double total;
+	double worst;
+};
+
+struct _bench_s {
+	mp_kernel_t kernel;
+	mp_i2c_t i2c;
+	mp_regMaster_bus_t bus;
+
+	mp_regMaster_t regMaster;
+	mp_regMaster_op_t ops[BENCH_QUEUED+1];
+	mp_posix_i2c_device_t device;
+
+	unsigned char dumps[BENCH_DUMPS][BENCH_DUMP];
+	unsigned char samples[BENCH_SAMPLES][BENCH_SAMPLE];
+
+	_bench_mode_t mode;
+
+	int rounds;
+	int outstanding;
+
+	/* burst time and per class delay seen by the device */
+	double burst;
+	mp_bool_t addressed;
+	_bench_class_t sample;
+	_bench_class_t dump;
+};
+
+static _bench_t __bench;
+
+static char *__modes[] = { "fifo", "strict", "weighted" };
+
+static void _bench_onStart(mp_posix_i2c_device_t *device, mp_bool_t read) {
+	_bench_t *bench = device->user;
+
+	mp_bench_regsim_onStart(device, read);
+
+	if(read == NO)
+		bench->addressed = YES;
+}
+
+static void _bench_onWrite(mp_posix_i2c_device_t *device, unsigned char data) {
+	_bench_t *bench = device->user;
+	_bench_class_t *class;
+	double wait;
+
+	mp_bench_regsim_onWrite(device, data);
+
+	/* the register byte tells the class */
+	if(bench->addressed == NO)
+		return;
+	bench->addressed = NO;
+
+	class = data == BENCH_REG_SAMPLE ? &bench->sample : &bench->dump;
+	wait = mp_bench_regsim_clock()-bench->burst;
+	class->ops++;
+	class->total += wait;
+	if(wait > class->worst)
+		class->worst = wait;
+}
+
+static void _bench_round(_bench_t *bench);
+
+static void _bench_class(_bench_t *bench, char *name, _bench_class_t *class) {
+	printf("%s,class,%s,%lu,%.0f,%.0f\n",
+		__modes[bench->mode], name, class->ops,
+		class->total/class->ops*1e6, class->worst*1e6);
+}
+
+static void _bench_report(_bench_t *bench) {
+	mp_regMaster_stats_t stats;
+	unsigned char lane;
+
+	for(lane=0; lane<MP_REGMASTER_LANES; lane++) {
+		mp_regMaster_stats_get(&bench->bus, lane, &stats);
+		if(stats.ops == 0)
+			continue;
+
+		printf("%s,lane,%s,%lu,%lu,%lu\n",
+			__modes[bench->mode],
+			lane == MP_REGMASTER_LANE_RT ? "RT" : "BG",
+			stats.ops,
+			mp_clock_hires_us(stats.waitTotal/stats.ops),
+			mp_clock_hires_us(stats.waitMax));
+	}
+
+	_bench_class(bench, "sample", &bench->sample);
+	_bench_class(bench, "dump", &bench->dump);
+	fflush(stdout);
+}
+
+static void _bench_onEnd(mp_regMaster_op_t *operand, mp_bool_t terminate) {
+	_bench_t *bench = operand->user;
+
+	if(terminate == TRUE)
+		return;
+
+	if(--bench->outstanding > 0)
+		return;
+
+	if(++bench->rounds == BENCH_ROUNDS) {
+		_bench_report(bench);
+		mp_posix_quit();
+		return;
+	}
+
+	_bench_round(bench);
+}
+
+static void _bench_round(_bench_t *bench) {
+	mp_regMaster_t *cirr = &bench->regMaster;
+	unsigned char lane;
+	int a;
+
+	bench->outstanding = BENCH_QUEUED;
+	bench->burst = mp_bench_regsim_clock();
+
+	/* the burst is queued before the wire starts */
+	mp_interrupt_disable();
+
+	for(a=0; a<BENCH_DUMPS; a++)
+		mp_regMaster_readReg(cirr, BENCH_REG_DUMP+a, bench->dumps[a], BENCH_DUMP, _bench_onEnd, bench);
+
+	lane = bench->mode == BENCH_FIFO ? MP_REGMASTER_LANE_BG : MP_REGMASTER_LANE_RT;
+	for(a=0; a<BENCH_SAMPLES; a++)
+		mp_regMaster_readRegExt(cirr, BENCH_REG_SAMPLE, bench->samples[a], BENCH_SAMPLE,
+			_bench_onEnd, bench, FALSE, lane);
+
+	mp_interrupt_enable();
+}
+
+static void _bench_onBoot(void *user) {
+	_bench_t *bench = user;
+	mp_ret_t ret;
+
+	ret = mp_bench_regsim_open(&bench->kernel, &bench->i2c);
+	if(ret == TRUE)
+		ret = mp_regMaster_bus_init_i2c(&bench->kernel, &bench->bus, &bench->i2c, "Bench bus");
+	if(ret == FALSE) {
+		fprintf(stderr, "bench: can not open the I2C bus\n");
+		mp_posix_quit();
+		return;
+	}
+
+	mp_bench_regsim_device(&bench->device, 0x48, bench);
+	bench->device.onStart = _bench_onStart;
+	bench->device.onWrite = _bench_onWrite;
+
+	ret = mp_regMaster_init_bus(&bench->kernel, &bench->regMaster, &bench->bus,
+			bench->ops, BENCH_QUEUED+1, bench, "ADC");
+	if(ret == FALSE) {
+		fprintf(stderr, "bench: can not join the bus\n");
+		mp_posix_quit();
+		return;
+	}
+	mp_regMaster_setSlaveAddress(&bench->regMaster, 0x48);
+
+	mp_regMaster_setWeight(&bench->bus, bench->mode == BENCH_WEIGHTED ? 1 : 0);
+
+	_bench_round(bench);
+}
+
+static void _bench_run(_bench_mode_t mode) {
+	_bench_t *bench = &__bench;
+
+	memset(bench, 0, sizeof(*bench));
+	bench->mode = mode;
+
+	mp_bench_regsim_run(&bench->kernel, _bench_onBoot, bench);
+}
+
+int main(int argc, char **argv) {
+	printf("mode,source,name,ops,mean_us,worst_us\n");
+	fflush(stdout);
+
+	_bench_run(BENCH_FIFO);
+	_bench_run(BENCH_STRICT);
+	_bench_run(BENCH_WEIGHTED);
+
+	return(0);
+}
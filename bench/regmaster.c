@@ -0,0 +1,163 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * regMaster throughput on a simulated I2C bus, operations started by
+ * the ASR task against operations chained from the interrupt.
+ *
+ * A simulated slave is wired on the bench/regsim.c bus. The board keeps a few sample reads of
+ * 6 bytes queued, as back-to-back DRDY reads do, and reports the
+ * operations per second and the part of the wall time the bus was
+ * idle. The loaded rows add a task burning BENCH_LOAD_US every tick,
+ * as the fusion code does, which delays the ASR.
+ *
+ * make bench-regmaster
+ */
+
+#include <mp.h>
+#include "regsim.h"
+
+#define BENCH_OPS     5000
+#define BENCH_DEPTH   4
+#define BENCH_SAMPLE  6
+#define BENCH_ADDRESS 0x6b
+
+/* CPU time of the load task per tick */
+#define BENCH_LOAD_US 300
+
+typedef struct _bench_s {
+	mp_kernel_t kernel;
+	mp_i2c_t i2c;
+	mp_regMaster_t regMaster;
+	/* the callback queues the next read before its operand is released */
+	mp_regMaster_op_t ops[BENCH_DEPTH+1];
+	mp_posix_i2c_device_t device;
+
+	unsigned char samples[BENCH_DEPTH][BENCH_SAMPLE];
+
+	mp_bool_t chain;
+	mp_bool_t load;
+
+	unsigned long issued;
+	unsigned long completed;
+
+	double wallStart;
+} _bench_t;
+
+static _bench_t __bench;
+
+static void _bench_read(_bench_t *bench, unsigned char *sample);
+
+static MP_TASK(_bench_load) {
+	double end = mp_bench_regsim_clock()+BENCH_LOAD_US/1e6;
+
+	if(task->signal == MP_TASK_SIG_STOP) {
+		mp_task_signal(task, MP_TASK_SIG_DEAD);
+		return;
+	}
+
+	while(mp_bench_regsim_clock() < end);
+}
+
+static void _bench_onSample(mp_regMaster_op_t *operand, mp_bool_t terminate) {
+	_bench_t *bench = operand->user;
+	double wall;
+
+	if(terminate == TRUE)
+		return;
+
+	bench->completed++;
+	if(bench->completed == BENCH_OPS) {
+		wall = mp_bench_regsim_clock()-bench->wallStart;
+		printf("%s,%s,%d,%.3f,%.0f,%.1f,%lu\n",
+			bench->chain == YES ? "chained" : "asr",
+			bench->load == YES ? "loaded" : "idle",
+			BENCH_OPS, wall, BENCH_OPS/wall,
+			100.0-mp_bench_regsim_wired()/1e9*100.0/wall,
+			mp_posix_interrupt_served(bench->i2c.gate->_ISRVector));
+		fflush(stdout);
+		mp_posix_quit();
+		return;
+	}
+
+	_bench_read(bench, operand->wait);
+}
+
+static void _bench_read(_bench_t *bench, unsigned char *sample) {
+	if(bench->issued >= BENCH_OPS)
+		return;
+	bench->issued++;
+
+	/* auto increment of the gyro output registers */
+	if(mp_regMaster_readReg(&bench->regMaster, 0x28 | 0x80,
+			sample, BENCH_SAMPLE, _bench_onSample, bench) != TRUE)
+		fprintf(stderr, "bench: regMaster queue full\n");
+}
+
+static void _bench_onBoot(void *user) {
+	_bench_t *bench = user;
+	mp_ret_t ret;
+	int a;
+
+	mp_bench_regsim_device(&bench->device, BENCH_ADDRESS, bench);
+
+	ret = mp_bench_regsim_open(&bench->kernel, &bench->i2c);
+	if(ret == TRUE) {
+		mp_i2c_setSlaveAddress(&bench->i2c, BENCH_ADDRESS);
+		ret = mp_regMaster_init_i2c(&bench->kernel, &bench->regMaster, &bench->i2c,
+			bench->ops, BENCH_DEPTH+1, bench, "Bench regMaster");
+	}
+	if(ret == FALSE) {
+		fprintf(stderr, "bench: can not open the I2C bus\n");
+		mp_posix_quit();
+		return;
+	}
+	bench->regMaster.bus->chain = bench->chain;
+
+	if(bench->load == YES)
+		mp_task_create(&bench->kernel.tasks, "Bench load", _bench_load, bench, 1);
+
+	bench->wallStart = mp_bench_regsim_clock();
+	for(a=0; a<BENCH_DEPTH; a++)
+		_bench_read(bench, bench->samples[a]);
+}
+
+static void _bench_run(mp_bool_t chain, mp_bool_t load) {
+	_bench_t *bench = &__bench;
+
+	memset(bench, 0, sizeof(*bench));
+	bench->chain = chain;
+	bench->load = load;
+
+	mp_bench_regsim_run(&bench->kernel, _bench_onBoot, bench);
+}
+
+int main(int argc, char **argv) {
+	printf("mode,cpu,ops,seconds,ops_per_sec,bus_idle_pct,isr\n");
+	fflush(stdout);
+
+	_bench_run(NO, NO);
+	_bench_run(YES, NO);
+	_bench_run(NO, YES);
+	_bench_run(YES, YES);
+
+	return(0);
+}
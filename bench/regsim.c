@@ -0,0 +1,185 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Simulated I2C bus shared by the regMaster benchmarks.
+ *
+ * Slaves are wired on the POSIX I2C stand-in of MP_BENCH_REGSIM_GATE
+ * and burn the time the bits take on a 400 kHz bus (9 bits per byte,
+ * one bit for start and stop conditions). A benchmark overrides the
+ * device callbacks it needs and calls the default ones for the wire
+ * time. Every run is forked so that each one starts from a fresh
+ * kernel, its exit status tells the result.
+ */
+
+#include <mp.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "regsim.h"
+
+/* nanoseconds the bits have been on the wire */
+static double __wired;
+
+static mp_kernel_onBoot_t __onBoot;
+static void *__onBootUser;
+static mp_bool_t __started;
+
+static void _mp_bench_regsim_onBoot(void *user);
+
+/**
+ * @brief Monotonic wall clock in seconds
+ */
+double mp_bench_regsim_clock(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return(ts.tv_sec+ts.tv_nsec/1e9);
+}
+
+/**
+ * @brief The bus is busy while the bits are on the wire
+ *
+ * @param[in] bits Bits to send
+ */
+void mp_bench_regsim_wire(unsigned int bits) {
+	double end = mp_bench_regsim_clock()+bits*MP_BENCH_REGSIM_BIT_NS/1e9;
+
+	__wired += bits*MP_BENCH_REGSIM_BIT_NS;
+	while(mp_bench_regsim_clock() < end);
+}
+
+/**
+ * @brief Nanoseconds spent on the wire by the run
+ */
+double mp_bench_regsim_wired(void) {
+	return(__wired);
+}
+
+void mp_bench_regsim_onStart(mp_posix_i2c_device_t *device, mp_bool_t read) {
+	/* start and address byte */
+	mp_bench_regsim_wire(1+9);
+}
+
+void mp_bench_regsim_onWrite(mp_posix_i2c_device_t *device, unsigned char data) {
+	mp_bench_regsim_wire(9);
+}
+
+unsigned char mp_bench_regsim_onRead(mp_posix_i2c_device_t *device) {
+	mp_bench_regsim_wire(9);
+	return(0x5a);
+}
+
+void mp_bench_regsim_onStop(mp_posix_i2c_device_t *device) {
+	mp_bench_regsim_wire(1);
+}
+
+/**
+ * @brief Wire a slave with the default callbacks
+ *
+ * Callbacks can be replaced after, every byte read is 0x5a.
+ *
+ * @param[in] device Device context
+ * @param[in] address Slave address
+ * @param[in] user User pointer of the callbacks
+ */
+void mp_bench_regsim_device(mp_posix_i2c_device_t *device, unsigned char address, void *user) {
+	device->address = address;
+	device->onStart = mp_bench_regsim_onStart;
+	device->onWrite = mp_bench_regsim_onWrite;
+	device->onRead = mp_bench_regsim_onRead;
+	device->onStop = mp_bench_regsim_onStop;
+	device->user = user;
+	mp_posix_i2c_attach(MP_BENCH_REGSIM_GATE, device);
+}
+
+/**
+ * @brief Open the gate as a 400 kHz master
+ *
+ * @param[in] kernel Kernel handler
+ * @param[in] i2c I2C interface
+ * @return TRUE or FALSE
+ */
+mp_ret_t mp_bench_regsim_open(mp_kernel_t *kernel, mp_i2c_t *i2c) {
+	mp_options_t options[] = {
+		{ "gate", MP_BENCH_REGSIM_GATE },
+		{ "sda", "p10.1" },
+		{ "clk", "p10.2" },
+		{ NULL, NULL }
+	};
+	mp_options_t setup[] = {
+		{ "frequency", "400000" },
+		{ "role", "master" },
+		{ NULL, NULL }
+	};
+
+	if(mp_i2c_open(kernel, i2c, options, "Bench I2C") == FALSE)
+		return(FALSE);
+
+	if(mp_i2c_setup(i2c, setup) == FALSE) {
+		mp_i2c_close(i2c);
+		return(FALSE);
+	}
+
+	return(TRUE);
+}
+
+/**
+ * @brief Run a kernel into a child process
+ *
+ * onBoot is called once, the run ends with mp_posix_quit() (success)
+ * or exit().
+ *
+ * @param[in] kernel Kernel handler
+ * @param[in] onBoot Sets up the run
+ * @param[in] user onBoot user pointer
+ * @return YES if the child exited with a zero status
+ */
+mp_bool_t mp_bench_regsim_run(mp_kernel_t *kernel, mp_kernel_onBoot_t onBoot, void *user) {
+	int status;
+	pid_t pid;
+
+	pid = fork();
+	if(pid < 0)
+		return(NO);
+	if(pid > 0) {
+		waitpid(pid, &status, 0);
+		return(WIFEXITED(status) && WEXITSTATUS(status) == 0 ? YES : NO);
+	}
+
+	__onBoot = onBoot;
+	__onBootUser = user;
+
+	mp_kernel_init(kernel, _mp_bench_regsim_onBoot, NULL);
+	mp_printk_unset();
+
+	/* leaves the process */
+	mp_kernel_loop(kernel);
+	exit(1);
+}
+
+static void _mp_bench_regsim_onBoot(void *user) {
+	if(__started == YES)
+		return;
+	__started = YES;
+
+	__onBoot(__onBootUser);
+}
@@ -0,0 +1,51 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _HAVE_MP_BENCH_REGSIM_H
+	#define _HAVE_MP_BENCH_REGSIM_H
+
+	/**
+	 * @defgroup mpBenchRegsim
+	 * @{
+	 */
+
+	/** gate the simulated slaves are wired on */
+	#define MP_BENCH_REGSIM_GATE "USCI_B3"
+
+	/** one bit at 400 kHz */
+	#define MP_BENCH_REGSIM_BIT_NS 2500
+
+	/** @} */
+
+	double mp_bench_regsim_clock(void);
+	void mp_bench_regsim_wire(unsigned int bits);
+	double mp_bench_regsim_wired(void);
+
+	void mp_bench_regsim_onStart(mp_posix_i2c_device_t *device, mp_bool_t read);
+	void mp_bench_regsim_onWrite(mp_posix_i2c_device_t *device, unsigned char data);
+	unsigned char mp_bench_regsim_onRead(mp_posix_i2c_device_t *device);
+	void mp_bench_regsim_onStop(mp_posix_i2c_device_t *device);
+	void mp_bench_regsim_device(mp_posix_i2c_device_t *device, unsigned char address, void *user);
+
+	mp_ret_t mp_bench_regsim_open(mp_kernel_t *kernel, mp_i2c_t *i2c);
+	mp_bool_t mp_bench_regsim_run(mp_kernel_t *kernel, mp_kernel_onBoot_t onBoot, void *user);
+
+#endif
@@ -0,0 +1,814 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Micro-benchmarks of the common/ primitives.
+ *
+ * Every benchmark takes BENCH_SAMPLES samples of BENCH_BATCH operations
+ * and reports the min, median and p99 cost of one operation. On the host
+ * the unit is the nanosecond (make bench-suite), on the MSP430 it is the
+ * MCLK cycle counted by TIMER_B0: add this file to the firmware build
+ * and call mp_bench_suite() from a board state with printk routed to a
+ * serial line.
+ */
+
+#include <mp.h>
+#include "suite.h"
+
+#ifdef __MSP430__
+	#define BENCH_SAMPLES 32
+	#define BENCH_UNIT "cycles"
+#else
+	#include <time.h>
+	#include <unistd.h>
+
+	#define BENCH_SAMPLES 1000
+	#define BENCH_UNIT "ns"
+#endif
+
+/* operations per sample */
+#define BENCH_BATCH 16
+
+/* serial line sized payload */
+#define BENCH_LINE 32
+
+static void _bench_clock_init(mp_kernel_t *kernel);
+static void _bench_clock_fini(void);
+static unsigned long _bench_now(void);
+static double _bench_hz(void);
+
+static void _bench_begin(void);
+static void _bench_end(int sample);
+static void _bench_report(char *name, int payload);
+
+static void _bench_mem(mp_kernel_t *kernel);
+static void _bench_arena(mp_kernel_t *kernel);
+static void _bench_circular(mp_kernel_t *kernel);
+static void _bench_ring(mp_kernel_t *kernel);
+static void _bench_frame(mp_kernel_t *kernel);
+static void _bench_log(mp_kernel_t *kernel);
+static void _bench_list(mp_kernel_t *kernel);
+static void _bench_task(mp_kernel_t *kernel);
+static void _bench_hci(mp_kernel_t *kernel);
+static void _bench_kalman(mp_kernel_t *kernel);
+static void _bench_quaternion(mp_kernel_t *kernel);
+
+static MP_TASK(_bench_task_wakeup);
+
+static unsigned long __samples[BENCH_SAMPLES];
+static unsigned long __start;
+static unsigned long __overhead;
+static mp_bench_format_t __format;
+
+/* sink preventing the compiler to drop computations */
+static volatile float __sink;
+
+/**
+@defgroup mpBenchSuite Micro-benchmark suite
+
+@brief Cost of the common primitives
+
+@author @htmlonly &copy; @endhtmlonly 2016
+Michael Vergoz <mv@verman.fr>
+
+@date 17 Oct 2016
+
+CSV output has the columns name, payload, unit, batch, samples, min,
+median, p99 and ops_per_sec. JSON output is one object per line with
+the same keys. Rows of two releases can be compared by name and payload.
+
+@{
+*/
+
+/**
+ * @brief Run all the benchmarks
+ *
+ * Results are printed with mp_printk()
+ *
+ * @param[in] kernel Kernel context
+ * @param[in] format Output format
+ */
+void mp_bench_suite(mp_kernel_t *kernel, mp_bench_format_t format) {
+	int s;
+
+	__format = format;
+
+	_bench_clock_init(kernel);
+
+	/* cost of the measure itself */
+	__overhead = 0;
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		_bench_begin();
+		_bench_end(s);
+	}
+	__overhead = __samples[0];
+	for(s=1; s<BENCH_SAMPLES; s++) {
+		if(__samples[s] < __overhead)
+			__overhead = __samples[s];
+	}
+
+	if(format == MP_BENCH_CSV)
+		mp_printk("name,payload,unit,batch,samples,min,median,p99,ops_per_sec");
+
+	_bench_mem(kernel);
+	_bench_arena(kernel);
+	_bench_circular(kernel);
+	_bench_ring(kernel);
+	_bench_frame(kernel);
+	_bench_log(kernel);
+	_bench_list(kernel);
+	_bench_task(kernel);
+	_bench_hci(kernel);
+	_bench_kalman(kernel);
+	_bench_quaternion(kernel);
+
+	_bench_clock_fini();
+}
+
+/**@}*/
+
+#ifdef __MSP430__
+static mp_timer_t __timer;
+static volatile unsigned int __wraps;
+
+static void _bench_clock_wrap(mp_timer_t *timer) {
+	__wraps++;
+}
+
+static void _bench_clock_init(mp_kernel_t *kernel) {
+	char frequency[12];
+
+	/* fastest rate sourced from the DCO, the period is then widened */
+	sprintf(frequency, "%lu", mp_clock_get_speed()/0xffff+1);
+
+	mp_options_t options[] = {
+		{ "gate", "TIMER_B0" },
+		{ "frequency", frequency },
+		{ NULL, NULL }
+	};
+	__wraps = 0;
+	if(mp_timer_create(kernel, &__timer, options, "Bench") == FALSE) {
+		mp_printk("Bench: TIMER_B0 is not available");
+		return;
+	}
+	*__timer.regCCR0 = 0xffff;
+	mp_timer_set_interrupt(&__timer, _bench_clock_wrap);
+	mp_timer_enable_interrupt(&__timer);
+}
+
+static void _bench_clock_fini(void) {
+	mp_timer_destroy(&__timer);
+}
+
+static unsigned long _bench_now(void) {
+	unsigned int wraps;
+	unsigned int counter;
+
+	do {
+		wraps = __wraps;
+		counter = *__timer.regR;
+	} while(wraps != __wraps);
+
+	return(((unsigned long)wraps << 16)+counter);
+}
+
+static double _bench_hz(void) {
+	return(mp_clock_get_speed());
+}
+#else
+static void _bench_clock_init(mp_kernel_t *kernel) { }
+
+static void _bench_clock_fini(void) { }
+
+static unsigned long _bench_now(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return(ts.tv_sec*1000000000UL+ts.tv_nsec);
+}
+
+static double _bench_hz(void) {
+	return(1e9);
+}
+#endif
+
+static void _bench_begin(void) {
+	__start = _bench_now();
+}
+
+static void _bench_end(int sample) {
+	unsigned long elapsed = _bench_now()-__start;
+
+	__samples[sample] = elapsed > __overhead ? elapsed-__overhead : 0;
+}
+
+static int _bench_cmp(const void *a, const void *b) {
+	unsigned long x = *(const unsigned long *)a;
+	unsigned long y = *(const unsigned long *)b;
+
+	return(x < y ? -1 : x > y);
+}
+
+static void _bench_report(char *name, int payload) {
+	double min, median, p99, ops;
+
+	qsort(__samples, BENCH_SAMPLES, sizeof(__samples[0]), _bench_cmp);
+
+	min = (double)__samples[0]/BENCH_BATCH;
+	median = (double)__samples[BENCH_SAMPLES/2]/BENCH_BATCH;
+	p99 = (double)__samples[(BENCH_SAMPLES*99)/100]/BENCH_BATCH;
+	ops = median > 0 ? _bench_hz()/median : 0;
+
+	if(__format == MP_BENCH_JSON)
+		mp_printk("{\"name\":\"%s\",\"payload\":%d,\"unit\":\"%s\",\"batch\":%d,\"samples\":%d,"
+			"\"min\":%.1f,\"median\":%.1f,\"p99\":%.1f,\"ops_per_sec\":%.0f}",
+			name, payload, BENCH_UNIT, BENCH_BATCH, BENCH_SAMPLES, min, median, p99, ops);
+	else
+		mp_printk("%s,%d,%s,%d,%d,%.1f,%.1f,%.1f,%.0f",
+			name, payload, BENCH_UNIT, BENCH_BATCH, BENCH_SAMPLES, min, median, p99, ops);
+}
+
+static void _bench_mem(mp_kernel_t *kernel) {
+	/* register buffers, small contexts and circular buffers */
+	static const int sizes[] = { 2, 16, MP_MEM_CHUNK-1 };
+	void *ptrs[BENCH_BATCH];
+	int a, s, i;
+
+	for(i=0; i<sizeof(sizes)/sizeof(sizes[0]); i++) {
+		for(s=0; s<BENCH_SAMPLES; s++) {
+			_bench_begin();
+			for(a=0; a<BENCH_BATCH; a++)
+				ptrs[a] = mp_mem_alloc(kernel, sizes[i]);
+			_bench_end(s);
+
+			for(a=0; a<BENCH_BATCH; a++)
+				mp_mem_free(kernel, ptrs[a]);
+		}
+		_bench_report("mem_alloc", sizes[i]);
+
+		for(s=0; s<BENCH_SAMPLES; s++) {
+			for(a=0; a<BENCH_BATCH; a++)
+				ptrs[a] = mp_mem_alloc(kernel, sizes[i]);
+
+			_bench_begin();
+			for(a=0; a<BENCH_BATCH; a++)
+				mp_mem_free(kernel, ptrs[a]);
+			_bench_end(s);
+		}
+		_bench_report("mem_free", sizes[i]);
+	}
+}
+
+static void _bench_arena(mp_kernel_t *kernel) {
+	/* same sizes as mem_alloc */
+	static const int sizes[] = { 2, 16, MP_MEM_CHUNK-1 };
+	static unsigned char buffer[BENCH_BATCH*(MP_MEM_CHUNK+sizeof(void *))];
+	mp_arena_t arena;
+	void *ptrs[BENCH_BATCH];
+	int a, s, i;
+
+	mp_arena_init(&arena, buffer, sizeof(buffer));
+
+	for(i=0; i<sizeof(sizes)/sizeof(sizes[0]); i++) {
+		for(s=0; s<BENCH_SAMPLES; s++) {
+			_bench_begin();
+			for(a=0; a<BENCH_BATCH; a++)
+				ptrs[a] = mp_arena_alloc(&arena, sizes[i]);
+			_bench_end(s);
+
+			mp_arena_reset(&arena);
+		}
+		_bench_report("arena_alloc", sizes[i]);
+	}
+	__sink = (float)(unsigned long)ptrs[0];
+}
+
+static void _bench_circular_drain(mp_circular_t *cir) {
+	mp_circular_buffer_t *buffer;
+
+	while((buffer = mp_circular_read(cir)) != NULL)
+		mp_mem_free(cir->kernel, buffer);
+}
+
+static void _bench_circular(mp_kernel_t *kernel) {
+	mp_circular_buffer_t *buffers[BENCH_BATCH];
+	unsigned char line[BENCH_LINE];
+	mp_circular_t cir;
+	mp_bool_t done;
+	int size;
+	int a, s;
+
+	for(a=0; a<BENCH_LINE; a++)
+		line[a] = 'a'+a%26;
+
+	mp_circular_init(kernel, &cir, NULL, NULL);
+
+	/* write of a line, as mp_serial_write() */
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++)
+			mp_circular_write(&cir, line, BENCH_LINE);
+		_bench_end(s);
+
+		_bench_circular_drain(&cir);
+	}
+	_bench_report("circular_write", BENCH_LINE);
+
+	/* read of a line */
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		for(a=0; a<BENCH_BATCH; a++)
+			mp_circular_write(&cir, line, BENCH_LINE);
+
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++)
+			buffers[a] = mp_circular_read(&cir);
+		_bench_end(s);
+
+		for(a=0; a<BENCH_BATCH; a++)
+			mp_mem_free(kernel, buffers[a]);
+	}
+	_bench_report("circular_read", BENCH_LINE);
+
+	/* same read in place */
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		for(a=0; a<BENCH_BATCH; a++)
+			mp_circular_write(&cir, line, BENCH_LINE);
+
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++) {
+			mp_circular_peek(&cir, &size);
+			mp_circular_consume(&cir, size);
+		}
+		_bench_end(s);
+
+		_bench_circular_drain(&cir);
+	}
+	_bench_report("circular_peek_consume", BENCH_LINE);
+
+	/* one received byte into an existing buffer */
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		mp_circular_write(&cir, line, 1);
+
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++)
+			mp_circular_rxInterrupt(&cir, line[a]);
+		_bench_end(s);
+
+		_bench_circular_drain(&cir);
+	}
+	_bench_report("circular_rxInterrupt", 1);
+
+	/* one sent byte */
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		mp_circular_write(&cir, line, BENCH_BATCH);
+
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++)
+			line[a] = mp_circular_txInterrupt(&cir, &done);
+		_bench_end(s);
+
+		_bench_circular_drain(&cir);
+	}
+	_bench_report("circular_txInterrupt", 1);
+
+	mp_circular_fini(&cir);
+}
+
+static void _bench_ring(mp_kernel_t *kernel) {
+	static unsigned char storage[BENCH_BATCH*BENCH_LINE];
+	unsigned char line[BENCH_LINE];
+	mp_ring_span_t span[2];
+	mp_ring_t ring;
+	int a, s;
+
+	for(a=0; a<BENCH_LINE; a++)
+		line[a] = 'a'+a%26;
+
+	mp_ring_init(&ring, storage, sizeof(storage));
+
+	/* same operations as the circular rows */
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++)
+			mp_ring_write(&ring, line, BENCH_LINE);
+		_bench_end(s);
+
+		ring.tail = ring.head;
+	}
+	_bench_report("ring_write", BENCH_LINE);
+
+	/* header and payload built in place, as mp_hci_send_data() */
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++) {
+			mp_ring_reserve(&ring, span, BENCH_LINE);
+			mp_ring_span_write(span, 0, line, 4);
+			mp_ring_span_write(span, 4, line+4, BENCH_LINE-4);
+			mp_ring_commit(&ring, BENCH_LINE);
+		}
+		_bench_end(s);
+
+		ring.tail = ring.head;
+	}
+	_bench_report("ring_reserve_commit", BENCH_LINE);
+
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		mp_ring_write(&ring, storage, BENCH_BATCH*BENCH_LINE);
+
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++)
+			mp_ring_read(&ring, line, BENCH_LINE);
+		_bench_end(s);
+	}
+	_bench_report("ring_read", BENCH_LINE);
+
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		mp_ring_write(&ring, storage, BENCH_BATCH*BENCH_LINE);
+
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++) {
+			mp_ring_peek(&ring, span);
+			__sink = span[0].data[0];
+			mp_ring_consume(&ring, BENCH_LINE);
+		}
+		_bench_end(s);
+	}
+	_bench_report("ring_peek_consume", BENCH_LINE);
+
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++)
+			mp_ring_put(&ring, line[a]);
+		_bench_end(s);
+
+		ring.tail = ring.head;
+	}
+	_bench_report("ring_put", 1);
+
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		mp_ring_write(&ring, line, BENCH_BATCH);
+
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++)
+			mp_ring_get(&ring, &line[a]);
+		_bench_end(s);
+	}
+	_bench_report("ring_get", 1);
+}
+
+static void _bench_list(mp_kernel_t *kernel) {
+	mp_list_item_t items[BENCH_BATCH];
+	mp_list_t list;
+	mp_list_t other;
+	int a, s;
+
+	/* items are expected unlinked */
+	memset(items, 0, sizeof(items));
+	mp_list_init(&list);
+	mp_list_init(&other);
+
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++)
+			mp_list_add_last(&list, &items[a], &items[a]);
+		_bench_end(s);
+
+		for(a=0; a<BENCH_BATCH; a++)
+			mp_list_remove(&list, &items[a]);
+	}
+	_bench_report("list_add_last", BENCH_BATCH);
+
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++)
+			mp_list_add_first(&list, &items[a], &items[a]);
+		_bench_end(s);
+
+		for(a=0; a<BENCH_BATCH; a++)
+			mp_list_remove(&list, &items[a]);
+	}
+	_bench_report("list_add_first", BENCH_BATCH);
+
+	/* remove from the middle then the ends */
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		for(a=0; a<BENCH_BATCH; a++)
+			mp_list_add_last(&list, &items[a], &items[a]);
+
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++)
+			mp_list_remove(&list, &items[(a+BENCH_BATCH/2)%BENCH_BATCH]);
+		_bench_end(s);
+	}
+	_bench_report("list_remove", BENCH_BATCH);
+
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		for(a=0; a<BENCH_BATCH; a++)
+			mp_list_add_last(&list, &items[a], &items[a]);
+
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++)
+			mp_list_switch_last(&other, &list, &items[a]);
+		_bench_end(s);
+
+		for(a=0; a<BENCH_BATCH; a++)
+			mp_list_remove(&other, &items[a]);
+	}
+	_bench_report("list_switch_last", BENCH_BATCH);
+}
+
+static MP_TASK(_bench_task_wakeup) {
+	if(task->signal == MP_TASK_SIG_STOP) {
+		task->signal = MP_TASK_SIG_DEAD;
+		return;
+	}
+}
+
+static void _bench_task_run(mp_kernel_t *kernel, char *name, int number, unsigned long delay) {
+	static mp_task_handler_t hdl;
+	int a, s;
+
+	mp_task_init(kernel, &hdl);
+	for(a=0; a<number; a++)
+		mp_task_create(&hdl, "Bench", _bench_task_wakeup, NULL, delay);
+
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++)
+			mp_task_tick(&hdl);
+		_bench_end(s);
+	}
+	_bench_report(name, number);
+
+	mp_task_fini(&hdl);
+}
+
+static void _bench_task(mp_kernel_t *kernel) {
+	int number;
+
+	for(number=1; number<=MP_TASK_MAX; number*=2) {
+		/* nothing is due during the benchmark */
+		_bench_task_run(kernel, "task_tick_idle", number, 60000);
+
+		/* every task runs on each tick */
+		_bench_task_run(kernel, "task_tick_due", number, 0);
+	}
+}
+
+#ifdef SUPPORT_COMMON_FRAME
+static void _bench_frame_on(mp_frame_t *frame, unsigned char *data, unsigned int size) {
+	__sink += size;
+}
+#endif
+
+static void _bench_frame(mp_kernel_t *kernel) {
+#ifdef SUPPORT_COMMON_FRAME
+	static unsigned char payload[64];
+	static unsigned char encoded[MP_FRAME_SLIP_MAX(64)];
+	static unsigned char buffer[64];
+	static const struct {
+		char *decode;
+		char *encode;
+		mp_frame_codec_t codec;
+	} codecs[] = {
+		{ "frame_cobs_decode", "frame_cobs_encode", MP_FRAME_COBS },
+		{ "frame_slip_decode", "frame_slip_encode", MP_FRAME_SLIP },
+	};
+	mp_serial_t serial;
+	mp_frame_t frame;
+	unsigned int size = 0, found = 0;
+	int a, b, c, s;
+
+	/* binary payload, a zero and a SLIP special byte every 16 bytes */
+	for(a=0; a<sizeof(payload); a++)
+		payload[a] = (a%16) == 5 ? 0x00 : (a%16) == 11 ? 0xc0 : a+1;
+
+	memset(&serial, 0, sizeof(serial));
+	serial.useRing = YES;
+
+	for(c=0; c<sizeof(codecs)/sizeof(codecs[0]); c++) {
+		mp_frame_init(&frame, &serial, codecs[c].codec, buffer, sizeof(buffer), _bench_frame_on, NULL);
+
+		for(s=0; s<BENCH_SAMPLES; s++) {
+			_bench_begin();
+			for(a=0; a<BENCH_BATCH; a++)
+				size = mp_frame_encode(codecs[c].codec, payload, sizeof(payload), encoded, sizeof(encoded));
+			_bench_end(s);
+		}
+		_bench_report(codecs[c].encode, sizeof(payload));
+
+		for(s=0; s<BENCH_SAMPLES; s++) {
+			_bench_begin();
+			for(a=0; a<BENCH_BATCH; a++)
+				mp_frame_input(&frame, encoded, size);
+			_bench_end(s);
+		}
+		_bench_report(codecs[c].decode, sizeof(payload));
+
+		mp_frame_fini(&frame);
+	}
+
+	/* delimiter search, word at a time against byte per byte */
+	memset(encoded, 0x55, sizeof(encoded));
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++)
+			found += mp_frame_scan(encoded, sizeof(payload), 0x00);
+		_bench_end(s);
+	}
+	_bench_report("frame_scan", sizeof(payload));
+
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++) {
+			for(b=0; b<sizeof(payload) && encoded[b] != 0x00; b++);
+			found += b;
+		}
+		_bench_end(s);
+	}
+	_bench_report("frame_scan_bytes", sizeof(payload));
+
+	__sink += found;
+#endif
+}
+
+#ifdef MP_LOG
+static unsigned int _bench_log_encode(unsigned char *buffer, unsigned int size, const char *fmt, ...) {
+	va_list ap;
+
+	va_start(ap, fmt);
+	size = mp_log_encode(buffer, size, fmt, ap);
+	va_end(ap);
+	return(size);
+}
+
+static unsigned int _bench_log_format(char *buffer, unsigned int size, const char *fmt, ...) {
+	va_list ap;
+
+	va_start(ap, fmt);
+	size = vsnprintf(buffer, size, fmt, ap);
+	va_end(ap);
+	return(size);
+}
+#endif
+
+static void _bench_log(mp_kernel_t *kernel) {
+#ifdef MP_LOG
+	static const char fmt[] = "LSM9DS0 gyro x=%f y=%f z=%f dps";
+	static char buffer[64];
+	unsigned int size = 0;
+	float x = 12.5, y = -3.25, z = 0.125;
+	int a, s;
+
+	/* what the target does for mp_log() against mp_printk() */
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++)
+			size = _bench_log_encode((unsigned char *)buffer, MP_LOG_ARGS, fmt, x, y, z);
+		_bench_end(s);
+	}
+	_bench_report("log_encode", MP_LOG_HEADER+size);
+
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++)
+			size = _bench_log_format(buffer, sizeof(buffer), fmt, x, y, z);
+		_bench_end(s);
+	}
+	_bench_report("log_vsnprintf", size);
+#endif
+}
+
+static void _bench_hci(mp_kernel_t *kernel) {
+#ifdef SUPPORT_COMMON_HCI
+	static mp_hci_cmd_t command = {
+		MP_HCI_CMD_CREATE_OPCODE(0x0008, 0x08, 0), "1D"
+	};
+	static uint8_t buffer[MP_HCI_CMD_BUFFER_SIZE];
+	static uint8_t data[8] = { 0x02, 0x01, 0x06, 0x04, 0x09, 'm', 'p', 'h' };
+	uint16_t size = 0;
+	int a, s;
+
+	/* LE advertising data sized command */
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++)
+			size = mp_hci_create_cmd(buffer, &command, 8, data);
+		_bench_end(s);
+	}
+	_bench_report("hci_create_cmd", size);
+#endif
+}
+
+static void _bench_kalman(mp_kernel_t *kernel) {
+	mp_kalman_t kalman;
+	int a, s;
+
+	mp_kalman_init(kernel, &kalman, 0.022, 0.617);
+
+	for(s=0; s<BENCH_SAMPLES; s++) {
+		_bench_begin();
+		for(a=0; a<BENCH_BATCH; a++)
+			__sink = mp_kalman_update(&kalman, 21.5+(a&3)*0.1);
+		_bench_end(s);
+	}
+	_bench_report("kalman_update", 1);
+
+	mp_kalman_fini(&kalman);
+}
+
+static void _bench_quaternion(mp_kernel_t *kernel) {
+#ifdef SUPPORT_COMMON_QUATERNION
+	static const struct {
+		char *name;
+		mp_quaternion_fct_t function;
+	} filters[] = {
+		{ "quaternion_madgwick", mp_quaternion_madgwick },
+		{ "quaternion_mahony", mp_quaternion_mahony },
+	};
+	mp_quaternion_t quaternion;
+	int a, s, f;
+
+	for(f=0; f<sizeof(filters)/sizeof(filters[0]); f++) {
+		mp_quaternion_init(&quaternion, filters[f].function);
+
+		/* accelerometer, gyroscope and magnetometer at rest */
+		for(s=0; s<BENCH_SAMPLES; s++) {
+			_bench_begin();
+			for(a=0; a<BENCH_BATCH; a++)
+				mp_quaternion_update(&quaternion,
+					0.01, -0.02, 1.0,
+					0.001*a, -0.002, 0.003,
+					0.21, -0.05, 0.43);
+			_bench_end(s);
+		}
+		__sink = quaternion.q[0];
+		_bench_report(filters[f].name, 9);
+
+		mp_quaternion_fini(&quaternion);
+	}
+#endif
+}
+
+#ifdef __unix__
+static mp_kernel_t __kernel;
+
+static void _bench_printk(void *user, char *fmt, ...) {
+	va_list args;
+
+	va_start(args, fmt);
+	vprintf(fmt, args);
+	va_end(args);
+	putchar('\n');
+}
+
+static void _bench_onBoot(void *user) {
+	mp_kernel_t *kernel = user;
+
+	mp_printk_set(_bench_printk, NULL);
+	mp_bench_suite(kernel, __format);
+
+	/* leaves on the next schedule */
+	mp_printk_unset();
+	mp_posix_quit();
+}
+
+int main(int argc, char **argv) {
+	int opt;
+
+	__format = MP_BENCH_CSV;
+	while((opt = getopt(argc, argv, "f:")) != -1) {
+		if(opt == 'f' && strcmp(optarg, "json") == 0)
+			__format = MP_BENCH_JSON;
+		else if(opt == 'f' && strcmp(optarg, "csv") == 0)
+			__format = MP_BENCH_CSV;
+		else {
+			fprintf(stderr, "usage: %s [-f csv|json]\n", argv[0]);
+			return(EXIT_FAILURE);
+		}
+	}
+
+	mp_kernel_init(&__kernel, _bench_onBoot, &__kernel);
+	mp_kernel_loop(&__kernel);
+	mp_kernel_fini(&__kernel);
+
+	return(0);
+}
+#endif
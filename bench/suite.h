@@ -0,0 +1,42 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _HAVE_MP_BENCH_SUITE_H
+	#define _HAVE_MP_BENCH_SUITE_H
+
+	/**
+	 * @defgroup mpBenchSuite
+	 * @{
+	 */
+
+	typedef enum {
+		/** one header line then one line per benchmark */
+		MP_BENCH_CSV = 0,
+
+		/** one JSON object per line */
+		MP_BENCH_JSON = 1,
+	} mp_bench_format_t;
+
+	/** @} */
+
+	void mp_bench_suite(mp_kernel_t *kernel, mp_bench_format_t format);
+
+#endif
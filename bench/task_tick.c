@@ -0,0 +1,91 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2014  Michael VERGOZ                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Host benchmark of mp_task_tick() dispatch cost.
+ *
+ * Build with MP_TASK_MAX set to the number of tasks to create, e.g.
+ * make bench-task, and compare the idle (nothing due) and the periodic
+ * (a few tasks due per tick) cost per tick.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <mp.h>
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_TICKS 200000
+
+static unsigned long __ticks;
+static unsigned long __wakeups;
+
+unsigned long mp_clock_ticks() {
+	return(__ticks);
+}
+
+void mp_clock_task_change(mp_task_t *task) { }
+
+static MP_TASK(_bench_task) {
+	__wakeups++;
+}
+
+static double _bench_now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return(ts.tv_sec*1e9+ts.tv_nsec);
+}
+
+static double _bench_run(mp_task_handler_t *hdl, unsigned long base, unsigned long spread) {
+	double start;
+	int a;
+
+	mp_task_init(NULL, hdl);
+	__ticks = 0;
+	__wakeups = 0;
+
+	for(a=0; a<MP_TASK_MAX; a++)
+		mp_task_create(hdl, "bench", _bench_task, NULL, base+(a%spread));
+
+	start = _bench_now();
+	for(a=0; a<BENCH_TICKS; a++) {
+		__ticks++;
+		mp_task_tick(hdl);
+	}
+	return((_bench_now()-start)/BENCH_TICKS);
+}
+
+int main(int argc, char **argv) {
+	static mp_task_handler_t hdl;
+	double idle, periodic;
+	unsigned long wakeups;
+
+	/* nothing is ever due */
+	idle = _bench_run(&hdl, ~0UL/4, 1);
+
+	/* delays from 10 to 1009 ms */
+	periodic = _bench_run(&hdl, 10, 1000);
+	wakeups = __wakeups;
+
+	printf("tasks=%d idle=%.1f ns/tick periodic=%.1f ns/tick wakeups=%lu\n",
+		MP_TASK_MAX, idle, periodic, wakeups);
+
+	return(0);
+}
@@ -0,0 +1,271 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Serial throughput and CPU load, one interrupt per byte against the
+ * DMA channels, on the POSIX stand-ins.
+ *
+ * Each run forks a board process. A feeder process writes the pseudo
+ * terminal at the line rate (baud/10 bytes per second) while the board
+ * writes the same rate back through mp_serial_write() and reads with
+ * mp_serial_read(). The board reports the bytes moved, the ISR calls of
+ * the UART and DMA vectors and its CPU time over the wall time; the
+ * idle rows give the cost of the kernel loop alone.
+ *
+ * On the target the ISR count is what matters, the host CPU load only
+ * orders the paths.
+ * make bench-uart
+ */
+
+#define _GNU_SOURCE /* ptsname */
+
+#include <mp.h>
+#include <time.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/wait.h>
+
+#define BENCH_MS 2000
+
+typedef enum {
+	BENCH_IDLE = 0,
+	BENCH_INTERRUPT = 1,
+	BENCH_DMA = 2,
+} _bench_mode_t;
+
+typedef struct _bench_s {
+	mp_kernel_t kernel;
+	mp_uart_t uart;
+	mp_serial_t serial;
+
+	unsigned char rxBuffer[256];
+	unsigned char txBuffer[256];
+	unsigned char pattern[256];
+
+	_bench_mode_t mode;
+	unsigned long baudRate;
+	mp_bool_t started;
+
+	mp_ktimer_t pace;
+	mp_ktimer_t duration;
+
+	pid_t feeder;
+	double wallStart;
+	double cpuStart;
+	unsigned long isrStart;
+
+	unsigned long ticks;
+	unsigned long rxBytes;
+	unsigned long txBytes;
+} _bench_t;
+
+static _bench_t __bench;
+
+static char *__modes[] = { "idle", "interrupt", "dma" };
+
+static double _bench_clock(clockid_t id) {
+	struct timespec ts;
+
+	clock_gettime(id, &ts);
+	return(ts.tv_sec+ts.tv_nsec/1e9);
+}
+
+static unsigned long _bench_isr(void) {
+	return(mp_posix_interrupt_served(POSIX_USCI_A0_VECTOR)+mp_posix_interrupt_served(POSIX_DMA_VECTOR));
+}
+
+/* peer of the line, writes at the line rate and drains */
+static void _bench_feeder(char *path, unsigned long baudRate) {
+	unsigned char buffer[256];
+	struct termios tio;
+	double start, now;
+	unsigned long sent = 0, due;
+	int fd, size;
+
+	fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if(fd < 0)
+		_exit(1);
+	if(tcgetattr(fd, &tio) == 0) {
+		cfmakeraw(&tio);
+		tcsetattr(fd, TCSANOW, &tio);
+	}
+
+	memset(buffer, 0x55, sizeof(buffer));
+	start = _bench_clock(CLOCK_MONOTONIC);
+	while(1) {
+		now = _bench_clock(CLOCK_MONOTONIC);
+		due = (now-start)*baudRate/10;
+		while(sent < due) {
+			size = due-sent > sizeof(buffer) ? sizeof(buffer) : due-sent;
+			size = write(fd, buffer, size);
+			if(size <= 0)
+				break;
+			sent += size;
+		}
+		while(read(fd, buffer, sizeof(buffer)) > 0);
+		usleep(1000);
+	}
+}
+
+/* every tick: send what the line rate allows, read what came */
+static void _bench_pace(mp_ktimer_t *timer) {
+	_bench_t *bench = timer->user;
+	unsigned char buffer[64];
+	unsigned long due;
+	int size;
+
+	bench->ticks++;
+	due = bench->ticks*bench->baudRate/10000;
+	while(bench->txBytes < due) {
+		size = due-bench->txBytes > sizeof(bench->pattern) ? sizeof(bench->pattern) : due-bench->txBytes;
+		mp_serial_write(&bench->serial, bench->pattern, size);
+		bench->txBytes += size;
+	}
+
+	while((size = mp_serial_read(&bench->serial, buffer, sizeof(buffer))) > 0)
+		bench->rxBytes += size;
+}
+
+static void _bench_duration(mp_ktimer_t *timer) {
+	_bench_t *bench = timer->user;
+	double wall, cpu;
+	unsigned long isr, bytes;
+
+	wall = _bench_clock(CLOCK_MONOTONIC)-bench->wallStart;
+	cpu = _bench_clock(CLOCK_PROCESS_CPUTIME_ID)-bench->cpuStart;
+	isr = _bench_isr()-bench->isrStart;
+
+	if(bench->feeder > 0) {
+		kill(bench->feeder, SIGKILL);
+		waitpid(bench->feeder, NULL, 0);
+	}
+
+	/* last bytes of the feeder */
+	if(bench->mode != BENCH_IDLE)
+		_bench_pace(&bench->pace);
+
+	bytes = bench->rxBytes+bench->txBytes;
+	printf("%lu,%s,%.2f,%lu,%lu,%lu,%.1f,%.2f\n",
+		bench->baudRate, __modes[bench->mode], wall,
+		bench->rxBytes, bench->txBytes, isr,
+		bytes ? isr*1024.0/bytes : 0.0, cpu*100/wall);
+	fflush(stdout);
+
+	mp_posix_quit();
+}
+
+static void _bench_onBoot(void *user) {
+	_bench_t *bench = user;
+	char baudRate[16];
+	mp_ret_t ret;
+
+	if(bench->started == YES)
+		return;
+	bench->started = YES;
+
+	snprintf(baudRate, sizeof(baudRate), "%lu", bench->baudRate);
+	{
+		mp_options_t options[] = {
+			{ "gate", "USCI_A0" },
+			{ "baudRate", baudRate },
+			{ "dmaTx", "0" },
+			{ "dmaRx", "1" },
+			{ NULL, NULL }
+		};
+
+		/* the interrupt path runs without channels */
+		if(bench->mode != BENCH_DMA)
+			options[2].key = NULL;
+		ret = mp_uart_open(&bench->kernel, &bench->uart, options, "Bench UART");
+	}
+	if(ret == TRUE && bench->mode == BENCH_DMA)
+		ret = mp_serial_initUART_dma(
+			&bench->kernel, &bench->serial, &bench->uart,
+			bench->rxBuffer, sizeof(bench->rxBuffer),
+			bench->txBuffer, sizeof(bench->txBuffer),
+			"Bench serial"
+		);
+	else if(ret == TRUE)
+		ret = mp_serial_initUART_ring(
+			&bench->kernel, &bench->serial, &bench->uart,
+			bench->rxBuffer, sizeof(bench->rxBuffer),
+			bench->txBuffer, sizeof(bench->txBuffer),
+			"Bench serial"
+		);
+	if(ret == FALSE) {
+		fprintf(stderr, "bench: can not open the serial line\n");
+		mp_posix_quit();
+		return;
+	}
+
+	if(bench->mode != BENCH_IDLE) {
+		bench->feeder = fork();
+		if(bench->feeder == 0)
+			_bench_feeder(ptsname(bench->uart.fd), bench->baudRate);
+		mp_ktimer_start(&bench->kernel, &bench->pace, "Bench pace", 1, 1, _bench_pace, bench);
+	}
+	mp_ktimer_start(&bench->kernel, &bench->duration, "Bench duration", BENCH_MS, 0, _bench_duration, bench);
+
+	bench->wallStart = _bench_clock(CLOCK_MONOTONIC);
+	bench->cpuStart = _bench_clock(CLOCK_PROCESS_CPUTIME_ID);
+	bench->isrStart = _bench_isr();
+}
+
+static void _bench_run(unsigned long baudRate, _bench_mode_t mode) {
+	_bench_t *bench = &__bench;
+	pid_t pid;
+
+	pid = fork();
+	if(pid < 0)
+		return;
+	if(pid > 0) {
+		waitpid(pid, NULL, 0);
+		return;
+	}
+
+	memset(bench, 0, sizeof(*bench));
+	bench->baudRate = baudRate;
+	bench->mode = mode;
+	memset(bench->pattern, 0xaa, sizeof(bench->pattern));
+
+	mp_kernel_init(&bench->kernel, _bench_onBoot, bench);
+	mp_printk_unset();
+
+	/* leaves the process */
+	mp_kernel_loop(&bench->kernel);
+}
+
+int main(int argc, char **argv) {
+	unsigned long baudRates[] = { 115200, 460800 };
+	int a, mode;
+
+	printf("baud,mode,seconds,rx_bytes,tx_bytes,isr,isr_per_kb,cpu_pct\n");
+	fflush(stdout);
+
+	for(a=0; a<sizeof(baudRates)/sizeof(baudRates[0]); a++) {
+		for(mode=BENCH_IDLE; mode<=BENCH_DMA; mode++)
+			_bench_run(baudRates[a], mode);
+	}
+
+	return(0);
+}
@@ -0,0 +1,121 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <mp.h>
+
+/* allocations are aligned for pointers */
+#define _ARENA_ALIGN(size) \
+	(((size)+sizeof(void *)-1) & ~(sizeof(void *)-1))
+
+/**
+@defgroup mpCommonArena Arena allocator
+
+@ingroup mpCommon
+
+@brief Bump pointer allocations released all at once
+
+@version 1.0.0
+
+@author @htmlonly &copy; @endhtmlonly 2016
+Michael Vergoz <mv@verman.fr>
+
+@date 04 May 2016
+
+An arena serves allocations from a buffer given by the caller by
+moving a pointer forward. There is no per-allocation free: the whole
+arena is released with mp_arena_reset(). Allocation is O(1), has no
+header and can not fragment.
+
+An arena can be bound to a machine state with mp_state_arena(), it is
+then reset by mp_state_tick() right after the state unset callback.
+Everything the set callback allocates from it lives exactly as long as
+the state.
+
+@code
+static unsigned char _opBuffer[128];
+
+// [...]
+mp_arena_init(&olimex->opArena, _opBuffer, sizeof(_opBuffer));
+mp_state_arena(&olimex->kernel.states, OLIMEX_OP, &olimex->opArena);
+
+// into the OP set callback
+olimex->samples = mp_arena_alloc(&olimex->opArena, 32*sizeof(short));
+@endcode
+
+@{
+*/
+
+/**
+ * @brief Initialize an arena
+ *
+ * @param[in] arena Arena
+ * @param[in] buffer Backing buffer, must stay valid
+ * @param[in] size Size of the buffer
+ */
+void mp_arena_init(mp_arena_t *arena, void *buffer, unsigned int size) {
+	unsigned char *start = buffer;
+
+	memset(arena, 0, sizeof(*arena));
+
+	/* align the first allocation */
+	arena->start = (unsigned char *)_ARENA_ALIGN((unsigned long)start);
+	arena->end = start+size;
+	if(arena->start > arena->end)
+		arena->start = arena->end;
+	arena->pos = arena->start;
+}
+
+/**
+ * @brief Allocate from an arena
+ *
+ * Memory is zeroed. It is released by mp_arena_reset() only.
+ *
+ * @param[in] arena Arena
+ * @param[in] size Size to allocate
+ * @return Pointer or NULL when the arena is full
+ */
+void *mp_arena_alloc(mp_arena_t *arena, unsigned int size) {
+	unsigned char *ptr = arena->pos;
+
+	size = _ARENA_ALIGN(size);
+	if(size > (unsigned int)(arena->end-ptr)) {
+		arena->failed++;
+		return(NULL);
+	}
+
+	arena->pos = ptr+size;
+	if(mp_arena_used(arena) > arena->peak)
+		arena->peak = mp_arena_used(arena);
+
+	memset(ptr, 0, size);
+	return(ptr);
+}
+
+/**
+ * @brief Release every allocation of an arena
+ *
+ * @param[in] arena Arena
+ */
+void mp_arena_reset(mp_arena_t *arena) {
+	arena->pos = arena->start;
+}
+
+/**@}*/
@@ -146,6 +146,70 @@ mp_circular_buffer_t *mp_circular_read(mp_circular_t *cir) {
 	return(buffer);
 }
 
+/**
+ * @brief Get the first readable span
+ *
+ * Consumer side equivalent of mp_circular_read() without any
+ * allocation : bytes are read in place and released with
+ * mp_circular_consume(). Must not be mixed with
+ * mp_circular_txInterrupt() on the same circular.
+ *
+ * @param[in] cir Circular context
+ * @param[out] size Number of contiguous bytes
+ * @return Pointer to the bytes or NULL
+ */
+unsigned char *mp_circular_peek(mp_circular_t *cir, int *size) {
+	mp_circular_buffer_t *buffer;
+	unsigned char *data = NULL;
+
+	*size = 0;
+
+	cir->disable(cir);
+	buffer = cir->first;
+	if(buffer && buffer->pos < buffer->size) {
+		data = buffer->data+buffer->pos;
+		*size = buffer->size-buffer->pos;
+	}
+	cir->enable(cir);
+
+	return(data);
+}
+
+/**
+ * @brief Release bytes of the span returned by mp_circular_peek()
+ *
+ * An exhausted buffer is freed, the last one is kept and rewound.
+ *
+ * @param[in] cir Circular context
+ * @param[in] size Number of bytes consumed
+ */
+void mp_circular_consume(mp_circular_t *cir, int size) {
+	mp_circular_buffer_t *buffer;
+	mp_circular_buffer_t *release = NULL;
+
+	cir->disable(cir);
+	buffer = cir->first;
+	if(buffer) {
+		buffer->pos += size;
+		cir->totalSize -= size;
+
+		if(buffer->pos >= buffer->size) {
+			if(buffer->next) {
+				cir->first = buffer->next;
+				release = buffer;
+			}
+			else {
+				buffer->size = 0;
+				buffer->pos = 0;
+			}
+		}
+	}
+	cir->enable(cir);
+
+	if(release)
+		mp_mem_free(cir->kernel, release);
+}
+
 mp_ret_t mp_circular_write(mp_circular_t *cir, unsigned char *data, int size) {
 	mp_circular_buffer_t *buffer;
 	mp_circular_buffer_t *first;
@@ -212,13 +276,18 @@ void mp_circular_rxInterrupt(mp_circular_t *cir, unsigned char c) {
 	buffer = cir->last;
 
 	/* need allocation */
-	if(buffer->size >= MP_CIRCULAR_BUFFER_SIZE-1) {
-		/* allocate the buffer */
-		buffer = mp_mem_alloc(cir->kernel, sizeof(mp_circular_buffer_t));
+	if(buffer == NULL || buffer->size >= MP_CIRCULAR_BUFFER_SIZE-1) {
+		/* allocate the buffer, the byte is lost on overrun */
+		buffer = mp_mem_alloc_isr(cir->kernel, sizeof(mp_circular_buffer_t));
+		if(buffer == NULL)
+			return;
 		buffer->size = 0;
 		buffer->next = NULL;
 
-		cir->last->next = buffer;
+		if(cir->last)
+			cir->last->next = buffer;
+		else
+			cir->first = buffer;
 		cir->last = buffer;
 	}
 
@@ -0,0 +1,218 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <mp.h>
+
+static void _mp_co_onOperation(mp_regMaster_op_t *operand, mp_bool_t terminate);
+
+/**
+@defgroup mpCommonCoroutine Coroutines
+
+@ingroup mpCommon
+
+@brief Stackless coroutines for register sequences
+
+@version 1.0.0
+
+@author @htmlonly &copy; @endhtmlonly 2016
+Michael Vergoz <mv@verman.fr>
+
+@date 12 Apr 2016
+
+A coroutine is a task written as a linear sequence of register operations.
+Each await queues one regMaster operation using the register buffer
+embedded into the coroutine context and puts the task in sleep. The task
+is made pending again when the operation completes and continues just
+after the await. No allocation and no end callback are needed.
+
+Like protothreads the resume point is a switch() case, so local variables
+are lost across awaits (keep the state into the driver context) and two
+await macros can not share the same source line.
+
+An await which fails (co->terminate set, see co->error) leaves the
+coroutine like MP_CO_EXIT(), the next wakeup restarts the sequence from
+the beginning. An operation which can not be queued because the operand
+pool is empty is not a failure : the coroutine yields and queues it
+again on its next run.
+
+@code
+MP_TASK(_mp_drv_XXX_co) {
+	mp_drv_XXX_t *XXX = task->user;
+
+	MP_CO_BEGIN(&XXX->co);
+
+	MP_CO_AWAIT_READ(&XXX->co, &XXX->regMaster, XXX_WHO_AM_I, &XXX->whoIam, 1);
+	if(XXX->whoIam != 0x42) {
+		MP_CO_EXIT(&XXX->co);
+	}
+
+	MP_CO_AWAIT_REG(&XXX->co, &XXX->regMaster, XXX_CTRL_REG1, 0x01);
+	MP_CO_AWAIT_REG(&XXX->co, &XXX->regMaster, XXX_CTRL_REG2, 0x80);
+
+	MP_CO_END(&XXX->co);
+}
+
+// [...]
+
+mp_co_init(kernel, &XXX->co, "XXX sequence", _mp_drv_XXX_co, XXX);
+mp_co_wakeup(&XXX->co);
+@endcode
+
+@{
+*/
+
+/**
+ * @brief Create a coroutine
+ *
+ * The coroutine task is created sleeping, use mp_co_wakeup() to run it.
+ *
+ * @param[in] kernel Kernel handler
+ * @param[in] co Coroutine context
+ * @param[in] who Task name
+ * @param[in] body Task executing the coroutine
+ * @param[in] user User pointer given as task->user
+ * @return TRUE or FALSE
+ */
+mp_ret_t mp_co_init(mp_kernel_t *kernel, mp_co_t *co, char *who, mp_task_wakeup_t body, void *user) {
+	memset(co, 0, sizeof(*co));
+
+	co->task = mp_task_create(&kernel->tasks, who, body, user, 0);
+	if(!co->task)
+		return(FALSE);
+
+	mp_task_signal(co->task, MP_TASK_SIG_SLEEP);
+	return(TRUE);
+}
+
+/**
+ * @brief Destroy a coroutine
+ *
+ * @param[in] co Coroutine context
+ */
+void mp_co_fini(mp_co_t *co) {
+	if(co->task)
+		mp_task_destroy(co->task);
+}
+
+/**
+ * @brief Run the coroutine, can be called from an ISR
+ *
+ * @param[in] co Coroutine context
+ */
+void mp_co_wakeup(mp_co_t *co) {
+	if(co->task)
+		mp_task_signal(co->task, MP_TASK_SIG_PENDING);
+}
+
+/**
+ * @brief Check for an operation in flight
+ *
+ * Put the task back in sleep if the coroutine has been woken up before
+ * the end of the awaited operation.
+ *
+ * @param[in] co Coroutine context
+ * @return YES if the operation is not terminated
+ */
+mp_bool_t mp_co_waiting(mp_co_t *co) {
+	mp_bool_t ret = NO;
+
+	MP_INTERRUPT_SAFE_BEGIN
+	if(co->waiting == YES) {
+		mp_task_signal(co->task, MP_TASK_SIG_SLEEP);
+		ret = YES;
+	}
+	MP_INTERRUPT_SAFE_END
+
+	return(ret);
+}
+
+/**
+ * @brief Queue a register write for the coroutine
+ *
+ * Prefer MP_CO_AWAIT_REG()
+ *
+ * @param[in] co Coroutine context
+ * @param[in] cirr regMaster context
+ * @param[in] reg Register
+ * @param[in] value Value to write
+ * @return TRUE or FALSE if the operation has not been queued
+ */
+mp_ret_t mp_co_writeReg(mp_co_t *co, mp_regMaster_t *cirr, unsigned char reg, unsigned char value) {
+	mp_ret_t ret;
+
+	co->terminate = NO;
+	co->error = MP_REGMASTER_OK;
+
+	/* callbacks are delivered by the regMaster ASR, not before we return */
+	ret = mp_regMaster_writeReg(cirr, reg, value, _mp_co_onOperation, co);
+	if(ret != TRUE) {
+		co->error = MP_REGMASTER_ERR_QUEUE;
+		return(FALSE);
+	}
+
+	co->waiting = YES;
+	return(TRUE);
+}
+
+/**
+ * @brief Queue a register read for the coroutine
+ *
+ * Prefer MP_CO_AWAIT_READ() or MP_CO_AWAIT_SAMPLE()
+ *
+ * @param[in] co Coroutine context
+ * @param[in] cirr regMaster context
+ * @param[in] reg First register
+ * @param[out] wait Buffer to fill
+ * @param[in] waitSize Number of bytes to read
+ * @param[in] lane Queue lane
+ * @return TRUE or FALSE if the operation has not been queued
+ */
+mp_ret_t mp_co_readReg(mp_co_t *co, mp_regMaster_t *cirr, unsigned char reg, unsigned char *wait, int waitSize, unsigned char lane) {
+	mp_ret_t ret;
+
+	co->terminate = NO;
+	co->error = MP_REGMASTER_OK;
+
+	/* callbacks are delivered by the regMaster ASR, not before we return */
+	ret = mp_regMaster_readRegExt(cirr, reg, wait, waitSize, _mp_co_onOperation, co, FALSE, lane);
+	if(ret != TRUE) {
+		co->error = MP_REGMASTER_ERR_QUEUE;
+		return(FALSE);
+	}
+
+	co->waiting = YES;
+	return(TRUE);
+}
+
+/**@}*/
+
+static void _mp_co_onOperation(mp_regMaster_op_t *operand, mp_bool_t terminate) {
+	mp_co_t *co = operand->user;
+
+	MP_INTERRUPT_SAFE_BEGIN
+	co->waiting = NO;
+	co->terminate = terminate;
+	co->error = operand->error;
+	MP_INTERRUPT_SAFE_END
+
+	/* resume the coroutine */
+	mp_co_wakeup(co);
+}
@@ -0,0 +1,189 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <mp.h>
+
+static unsigned int _mp_event_match(unsigned int bits, unsigned int mask, mp_event_mode_t mode);
+
+/**
+@defgroup mpCommonEvent Event groups
+
+@ingroup mpCommon
+
+@brief Bit flags set from interrupts and awaited by a task
+
+@version 1.0.0
+
+@author @htmlonly &copy; @endhtmlonly 2016
+Michael Vergoz <mv@verman.fr>
+
+@date 21 Apr 2016
+
+An event group holds up to 16 bits which are raised by ISRs or tasks.
+One task may wait for any or all bits of a mask : it is made pending
+only when the expectation is met, raising other bits does not wake it.
+The waiting is one-shot, the task must call mp_event_wait() again after
+each wake up. Bits are received and cleared atomically with
+mp_event_take().
+
+@code
+#define _EV_GYRO  0x1
+#define _EV_ACCEL 0x2
+
+static void _mp_drv_XXX_onGyro(void *user) {
+	mp_drv_XXX_t *XXX = user;
+	mp_event_set_isr(&XXX->events, _EV_GYRO);
+}
+
+MP_TASK(_mp_drv_XXX_ASR) {
+	mp_drv_XXX_t *XXX = task->user;
+	unsigned int bits;
+
+	bits = mp_event_take(&XXX->events, _EV_GYRO | _EV_ACCEL, MP_EVENT_ANY);
+	if(bits & _EV_GYRO)
+		...;
+	if(bits & _EV_ACCEL)
+		...;
+
+	mp_event_wait(&XXX->events, task, _EV_GYRO | _EV_ACCEL, MP_EVENT_ANY);
+}
+@endcode
+
+@{
+*/
+
+/**
+ * @brief Initialize an event group
+ *
+ * @param[in] event Event group
+ */
+void mp_event_init(mp_event_t *event) {
+	memset(event, 0, sizeof(*event));
+}
+
+/**
+ * @brief Raise bits from task context
+ *
+ * @param[in] event Event group
+ * @param[in] bits Bits to raise
+ */
+void mp_event_set(mp_event_t *event, unsigned int bits) {
+	mp_task_t *task = NULL;
+
+	MP_INTERRUPT_SAFE_BEGIN
+	event->bits |= bits;
+	if(event->task && _mp_event_match(event->bits, event->mask, event->mode)) {
+		task = event->task;
+		event->task = NULL;
+	}
+	MP_INTERRUPT_SAFE_END
+
+	if(task)
+		mp_task_signal(task, MP_TASK_SIG_PENDING);
+}
+
+/**
+ * @brief Raise bits from ISR context
+ *
+ * The waiting task is woken up through the softirq ring.
+ *
+ * @param[in] event Event group
+ * @param[in] bits Bits to raise
+ */
+void mp_event_set_isr(mp_event_t *event, unsigned int bits) {
+	mp_task_t *task = event->task;
+
+	event->bits |= bits;
+	if(task && _mp_event_match(event->bits, event->mask, event->mode)) {
+		event->task = NULL;
+		mp_softirq_signal(task, MP_TASK_SIG_PENDING);
+	}
+}
+
+/**
+ * @brief Clear bits
+ *
+ * @param[in] event Event group
+ * @param[in] bits Bits to clear
+ */
+void mp_event_clear(mp_event_t *event, unsigned int bits) {
+	MP_INTERRUPT_SAFE_BEGIN
+	event->bits &= ~bits;
+	MP_INTERRUPT_SAFE_END
+}
+
+/**
+ * @brief Receive and clear bits
+ *
+ * @param[in] event Event group
+ * @param[in] mask Expected bits
+ * @param[in] mode MP_EVENT_ANY or MP_EVENT_ALL
+ * @return Received bits, 0 if the expectation is not met
+ */
+unsigned int mp_event_take(mp_event_t *event, unsigned int mask, mp_event_mode_t mode) {
+	unsigned int ret;
+
+	MP_INTERRUPT_SAFE_BEGIN
+	ret = _mp_event_match(event->bits, mask, mode);
+	event->bits &= ~ret;
+	MP_INTERRUPT_SAFE_END
+
+	return(ret);
+}
+
+/**
+ * @brief Put a task in sleep until the expected bits are raised
+ *
+ * The task is made pending at once if the expectation is already met.
+ * Only one task can wait an event group.
+ *
+ * @param[in] event Event group
+ * @param[in] task Task to wake up, usually the calling task
+ * @param[in] mask Expected bits
+ * @param[in] mode MP_EVENT_ANY or MP_EVENT_ALL
+ * @return YES if the expectation is already met
+ */
+mp_bool_t mp_event_wait(mp_event_t *event, mp_task_t *task, unsigned int mask, mp_event_mode_t mode) {
+	mp_bool_t ret = NO;
+
+	MP_INTERRUPT_SAFE_BEGIN
+	if(_mp_event_match(event->bits, mask, mode)) {
+		event->task = NULL;
+		ret = YES;
+	}
+	else {
+		event->mask = mask;
+		event->mode = mode;
+		event->task = task;
+	}
+	mp_task_signal(task, ret == YES ? MP_TASK_SIG_PENDING : MP_TASK_SIG_SLEEP);
+	MP_INTERRUPT_SAFE_END
+
+	return(ret);
+}
+
+/**@}*/
+
+static unsigned int _mp_event_match(unsigned int bits, unsigned int mask, mp_event_mode_t mode) {
+	if(mode == MP_EVENT_ALL)
+		return((bits & mask) == mask ? mask : 0);
+	return(bits & mask);
+}
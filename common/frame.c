@@ -0,0 +1,519 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <mp.h>
+
+#ifdef SUPPORT_COMMON_FRAME
+
+#define _SLIP_END     0xc0
+#define _SLIP_ESC     0xdb
+#define _SLIP_ESC_END 0xdc
+#define _SLIP_ESC_ESC 0xdd
+
+/* scan unit, 0x0101.. and 0x8080.. patterns */
+typedef unsigned long _word_t;
+#define _WORD_ONES  ((_word_t)-1/0xff)
+#define _WORD_HIGHS (_WORD_ONES*0x80)
+
+/* non zero when one byte of the word is zero */
+#define _WORD_HASZERO(_w) (((_w)-_WORD_ONES) & ~(_w) & _WORD_HIGHS)
+
+static unsigned int _mp_frame_scan2(unsigned char *data, unsigned int size, unsigned char c1, unsigned char c2);
+static void _mp_frame_cobs(mp_frame_t *frame, unsigned char *data, unsigned int size);
+static void _mp_frame_slip(mp_frame_t *frame, unsigned char *data, unsigned int size);
+static void _mp_frame_put(mp_frame_t *frame, unsigned char *data, unsigned int size);
+static void _mp_frame_end(mp_frame_t *frame);
+static void _mp_frame_reset(mp_frame_t *frame);
+static mp_bool_t _mp_frame_out(mp_ring_span_t *span, unsigned int *pos, unsigned char *data, unsigned int size);
+static void _mp_frame_onDma(mp_serial_t *serial, mp_serial_dma_event_t event);
+
+/**
+@defgroup mpCommonFrame Serial frames
+
+@ingroup mpCommon
+
+@brief COBS or SLIP framed packets over a serial line
+
+@version 1.0.0
+
+@author @htmlonly &copy; @endhtmlonly 2016
+Michael Vergoz <mv@verman.fr>
+
+@date 12 May 2016
+
+A frame context decodes the bytes of a ring or DMA serial backend as
+they come and calls onFrame() once per complete frame, the consumer
+never sees raw bytes. Delimiters and escapes are searched one machine
+word at a time and the bytes between them are copied with memcpy().
+
+Bytes are taken in place from the RX ring by mp_frame_poll(). On the
+DMA backend the context hooks the half and idle notifications of the
+serial line (unless onDma is already used), otherwise call
+mp_frame_poll() from a task or a software timer. Frames larger than the
+storage and malformed frames are dropped up to the next delimiter and
+counted.
+
+mp_frame_write() encodes a frame straight into the TX ring, a frame
+which does not fit is not sent at all.
+
+@code
+static unsigned char _frameBuffer[64];
+
+static void _onFrame(mp_frame_t *frame, unsigned char *data, unsigned int size) {
+	// data is valid until return
+}
+
+mp_frame_init(&XXX->frame, &XXX->serial, MP_FRAME_COBS,
+	_frameBuffer, sizeof(_frameBuffer), _onFrame, XXX);
+@endcode
+
+@{
+*/
+
+/**
+ * @brief Initialize a frame context
+ *
+ * @param[in] frame Frame context
+ * @param[in] serial Serial line opened with a ring or DMA backend
+ * @param[in] codec MP_FRAME_COBS or MP_FRAME_SLIP
+ * @param[in] buffer Decoded frame storage
+ * @param[in] size Size of the storage, largest frame accepted
+ * @param[in] onFrame Frame callback
+ * @param[in] user User pointer
+ * @return TRUE or FALSE
+ */
+mp_ret_t mp_frame_init(mp_frame_t *frame, mp_serial_t *serial, mp_frame_codec_t codec,
+		unsigned char *buffer, unsigned int size, mp_frame_on_t onFrame, void *user) {
+	memset(frame, 0, sizeof(*frame));
+
+	if(serial->useRing != YES) {
+		mp_printk("Frame: serial line without ring backend");
+		return(FALSE);
+	}
+
+	frame->serial = serial;
+	frame->codec = codec;
+	frame->buffer = buffer;
+	frame->size = size;
+	frame->onFrame = onFrame;
+	frame->user = user;
+
+	/* decode on DMA notifications */
+	if(serial->useDma == YES && serial->onDma == NULL) {
+		serial->onDma = _mp_frame_onDma;
+		serial->user = frame;
+	}
+
+	return(TRUE);
+}
+
+void mp_frame_fini(mp_frame_t *frame) {
+	if(frame->serial->onDma == _mp_frame_onDma) {
+		frame->serial->onDma = NULL;
+		frame->serial->user = NULL;
+	}
+}
+
+/**
+ * @brief Decode received bytes
+ *
+ * Called by mp_frame_poll(), available for bytes from another source.
+ *
+ * @param[in] frame Frame context
+ * @param[in] data Bytes
+ * @param[in] size Number of bytes
+ */
+void mp_frame_input(mp_frame_t *frame, unsigned char *data, unsigned int size) {
+	if(frame->codec == MP_FRAME_COBS)
+		_mp_frame_cobs(frame, data, size);
+	else
+		_mp_frame_slip(frame, data, size);
+}
+
+/**
+ * @brief Decode what the RX ring holds
+ *
+ * @param[in] frame Frame context
+ */
+void mp_frame_poll(mp_frame_t *frame) {
+	mp_ring_span_t span[2];
+	unsigned int size;
+
+	size = mp_serial_peek(frame->serial, span);
+	if(size == 0)
+		return;
+
+	mp_frame_input(frame, span[0].data, span[0].size);
+	mp_frame_input(frame, span[1].data, span[1].size);
+
+	mp_serial_consume(frame->serial, size);
+}
+
+/**
+ * @brief Send one frame
+ *
+ * @param[in] frame Frame context
+ * @param[in] data Payload
+ * @param[in] size Size of the payload
+ * @return TRUE or FALSE when the TX ring has no room for it
+ */
+mp_ret_t mp_frame_write(mp_frame_t *frame, unsigned char *data, unsigned int size) {
+	mp_ring_span_t span[2];
+	unsigned int max;
+
+	if(frame->codec == MP_FRAME_COBS)
+		max = MP_FRAME_COBS_MAX(size);
+	else
+		max = MP_FRAME_SLIP_MAX(size);
+
+	mp_serial_reserve(frame->serial, span, max);
+
+	size = mp_frame_encode_span(frame->codec, data, size, span);
+	if(size == 0) {
+		frame->drops++;
+		return(FALSE);
+	}
+
+	mp_serial_commit(frame->serial, size);
+	return(TRUE);
+}
+
+/**
+ * @brief Encode a frame into a buffer
+ *
+ * @param[in] codec MP_FRAME_COBS or MP_FRAME_SLIP
+ * @param[in] input Payload
+ * @param[in] size Size of the payload
+ * @param[out] output Encoded frame, delimiters included
+ * @param[in] outSize Size of output, see MP_FRAME_COBS_MAX()
+ * @return Encoded size or 0 when output is too small
+ */
+unsigned int mp_frame_encode(mp_frame_codec_t codec, unsigned char *input, unsigned int size,
+		unsigned char *output, unsigned int outSize) {
+	mp_ring_span_t span[2];
+
+	span[0].data = output;
+	span[0].size = outSize;
+	span[1].data = NULL;
+	span[1].size = 0;
+
+	return(mp_frame_encode_span(codec, input, size, span));
+}
+
+/**
+ * @brief Encode a frame into two spans
+ *
+ * @param[in] codec MP_FRAME_COBS or MP_FRAME_SLIP
+ * @param[in] input Payload
+ * @param[in] size Size of the payload
+ * @param[out] span Region from mp_ring_reserve()
+ * @return Encoded size or 0 when the region is too small
+ */
+unsigned int mp_frame_encode_span(mp_frame_codec_t codec, unsigned char *input, unsigned int size,
+		mp_ring_span_t *span) {
+	unsigned char code;
+	unsigned int pos = 0;
+	unsigned int run, a;
+
+	if(codec == MP_FRAME_COBS) {
+		while(1) {
+			/* a block holds up to 254 non zero bytes */
+			run = size < 254 ? size : 254;
+			a = mp_frame_scan(input, run, 0x00);
+
+			code = a+1;
+			if(!_mp_frame_out(span, &pos, &code, 1) || !_mp_frame_out(span, &pos, input, a))
+				return(0);
+			input += a;
+			size -= a;
+
+			/* the zero is implied by the code */
+			if(a < run) {
+				input++;
+				size--;
+
+				/* trailing zero, one empty block */
+				if(size == 0) {
+					code = 1;
+					if(!_mp_frame_out(span, &pos, &code, 1))
+						return(0);
+					break;
+				}
+				continue;
+			}
+
+			if(a < 254 || size == 0)
+				break;
+		}
+
+		code = 0x00;
+	}
+	else {
+		code = _SLIP_END;
+		if(!_mp_frame_out(span, &pos, &code, 1))
+			return(0);
+
+		while(size > 0) {
+			a = _mp_frame_scan2(input, size, _SLIP_END, _SLIP_ESC);
+			if(!_mp_frame_out(span, &pos, input, a))
+				return(0);
+			input += a;
+			size -= a;
+			if(size == 0)
+				break;
+
+			code = _SLIP_ESC;
+			if(!_mp_frame_out(span, &pos, &code, 1))
+				return(0);
+			code = *input == _SLIP_END ? _SLIP_ESC_END : _SLIP_ESC_ESC;
+			if(!_mp_frame_out(span, &pos, &code, 1))
+				return(0);
+			input++;
+			size--;
+		}
+
+		code = _SLIP_END;
+	}
+
+	/* delimiter */
+	if(!_mp_frame_out(span, &pos, &code, 1))
+		return(0);
+
+	return(pos);
+}
+
+/**
+ * @brief Find a byte, one machine word at a time
+ *
+ * @param[in] data Bytes
+ * @param[in] size Number of bytes
+ * @param[in] c Byte to find
+ * @return Index of the first c or size
+ */
+unsigned int mp_frame_scan(unsigned char *data, unsigned int size, unsigned char c) {
+	_word_t pattern = _WORD_ONES*c;
+	_word_t word;
+	unsigned int a = 0;
+
+	/* up to a word boundary */
+	while(a < size && ((unsigned long)(data+a) & (sizeof(_word_t)-1)) != 0) {
+		if(data[a] == c)
+			return(a);
+		a++;
+	}
+
+	for(; a+sizeof(_word_t) <= size; a+=sizeof(_word_t)) {
+		word = *(_word_t *)(data+a) ^ pattern;
+		if(_WORD_HASZERO(word))
+			break;
+	}
+
+	for(; a<size; a++) {
+		if(data[a] == c)
+			return(a);
+	}
+	return(size);
+}
+
+/**@}*/
+
+/* first c1 or c2 */
+static unsigned int _mp_frame_scan2(unsigned char *data, unsigned int size, unsigned char c1, unsigned char c2) {
+	_word_t pattern1 = _WORD_ONES*c1;
+	_word_t pattern2 = _WORD_ONES*c2;
+	_word_t word, w1, w2;
+	unsigned int a = 0;
+
+	while(a < size && ((unsigned long)(data+a) & (sizeof(_word_t)-1)) != 0) {
+		if(data[a] == c1 || data[a] == c2)
+			return(a);
+		a++;
+	}
+
+	for(; a+sizeof(_word_t) <= size; a+=sizeof(_word_t)) {
+		word = *(_word_t *)(data+a);
+		w1 = word ^ pattern1;
+		w2 = word ^ pattern2;
+		if(_WORD_HASZERO(w1) | _WORD_HASZERO(w2))
+			break;
+	}
+
+	for(; a<size; a++) {
+		if(data[a] == c1 || data[a] == c2)
+			return(a);
+	}
+	return(size);
+}
+
+static void _mp_frame_cobs(mp_frame_t *frame, unsigned char *data, unsigned int size) {
+	unsigned char zero = 0x00;
+	unsigned int a, run;
+
+	while(size > 0) {
+		if(frame->discard == YES) {
+			a = mp_frame_scan(data, size, 0x00);
+			if(a == size)
+				return;
+			_mp_frame_reset(frame);
+			data += a+1;
+			size -= a+1;
+			continue;
+		}
+
+		/* code byte */
+		if(frame->left == 0) {
+			if(*data == 0x00)
+				_mp_frame_end(frame);
+			else {
+				/* zero implied by the previous block */
+				if(frame->code != 0 && frame->code != 0xff)
+					_mp_frame_put(frame, &zero, 1);
+				frame->code = *data;
+				frame->left = *data-1;
+			}
+			data++;
+			size--;
+			continue;
+		}
+
+		/* block bytes, a delimiter there truncates the frame */
+		run = frame->left < size ? frame->left : size;
+		a = mp_frame_scan(data, run, 0x00);
+		_mp_frame_put(frame, data, a);
+		if(a < run) {
+			frame->errors++;
+			_mp_frame_reset(frame);
+			data += a+1;
+			size -= a+1;
+			continue;
+		}
+
+		frame->left -= run;
+		data += run;
+		size -= run;
+	}
+}
+
+static void _mp_frame_slip(mp_frame_t *frame, unsigned char *data, unsigned int size) {
+	unsigned char c;
+	unsigned int a;
+
+	while(size > 0) {
+		if(frame->discard == YES) {
+			a = mp_frame_scan(data, size, _SLIP_END);
+			if(a == size)
+				return;
+			_mp_frame_reset(frame);
+			data += a+1;
+			size -= a+1;
+			continue;
+		}
+
+		if(frame->escape == YES) {
+			frame->escape = NO;
+			c = *data;
+			if(c == _SLIP_ESC_END || c == _SLIP_ESC_ESC) {
+				c = c == _SLIP_ESC_END ? _SLIP_END : _SLIP_ESC;
+				_mp_frame_put(frame, &c, 1);
+				data++;
+				size--;
+			}
+			else {
+				/* the delimiter, if any, is taken by the discard */
+				frame->errors++;
+				frame->discard = YES;
+			}
+			continue;
+		}
+
+		a = _mp_frame_scan2(data, size, _SLIP_END, _SLIP_ESC);
+		_mp_frame_put(frame, data, a);
+		data += a;
+		size -= a;
+		if(size == 0)
+			break;
+
+		if(*data == _SLIP_END)
+			_mp_frame_end(frame);
+		else
+			frame->escape = YES;
+		data++;
+		size--;
+	}
+}
+
+static void _mp_frame_put(mp_frame_t *frame, unsigned char *data, unsigned int size) {
+	if(frame->discard == YES || size == 0)
+		return;
+
+	if(frame->length+size > frame->size) {
+		frame->overflows++;
+		frame->discard = YES;
+		return;
+	}
+
+	memcpy(frame->buffer+frame->length, data, size);
+	frame->length += size;
+}
+
+static void _mp_frame_end(mp_frame_t *frame) {
+	mp_bool_t complete;
+
+	/* COBS empty frames have one block, SLIP ones are line noise */
+	if(frame->codec == MP_FRAME_COBS)
+		complete = frame->code != 0 ? YES : NO;
+	else
+		complete = frame->length > 0 ? YES : NO;
+
+	if(complete == YES && frame->discard == NO) {
+		frame->frames++;
+		if(frame->onFrame)
+			frame->onFrame(frame, frame->buffer, frame->length);
+	}
+
+	_mp_frame_reset(frame);
+}
+
+static void _mp_frame_reset(mp_frame_t *frame) {
+	frame->length = 0;
+	frame->code = 0;
+	frame->left = 0;
+	frame->escape = NO;
+	frame->discard = NO;
+}
+
+static mp_bool_t _mp_frame_out(mp_ring_span_t *span, unsigned int *pos, unsigned char *data, unsigned int size) {
+	if(*pos+size > span[0].size+span[1].size)
+		return(NO);
+
+	if(size > 0)
+		mp_ring_span_write(span, *pos, data, size);
+	*pos += size;
+	return(YES);
+}
+
+/* half and idle come from the kernel loop, full from the DMA interrupt */
+static void _mp_frame_onDma(mp_serial_t *serial, mp_serial_dma_event_t event) {
+	if(event != MP_SERIAL_DMA_FULL)
+		mp_frame_poll(serial->user);
+}
+
+#endif
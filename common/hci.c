@@ -1,177 +1,298 @@
-/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
- * miniPhi - RTOS                                                          *
- * Copyright (C) 2014  Michael VERGOZ                                      *
- *                                                                         *
- * This program is free software; you can redistribute it and/or modify    *
- * it under the terms of the GNU General Public License as published by    *
- * the Free Software Foundation; either version 3 of the License, or       *
- * (at your option) any later version.                                     *
- *                                                                         *
- * This program is distributed in the hope that it will be useful,         *
- * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
- * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
- * GNU General Public License for more details.                            *
- *                                                                         *
- * You should have received a copy of the GNU General Public License       *
- * along with this program; if not, write to the Free Software Foundation, *
- * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
- *                                                                         *
- * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
-
-#include <mp.h>
-
-#ifdef SUPPORT_COMMON_HCI
-
-static void mp_hci_UART_rxInt(mp_uart_t *uart);
-static void mp_hci_UART_txInt(mp_uart_t *uart);
-
-static void mp_hci_UART_rxIntDisable(mp_circular_t *cir);
-static void mp_hci_UART_rxIntEnable(mp_circular_t *cir);
-static void mp_hci_UART_txIntDisable(mp_circular_t *cir);
-static void mp_hci_UART_txIntEnable(mp_circular_t *cir);
-
-mp_ret_t mp_hci_initUART(mp_kernel_t *kernel, mp_hci_t *hci, mp_uart_t *uart, char *who) {
-	mp_ret_t ret;
-
-	memset(hci, 0, sizeof(*hci));
-
-	hci->kernel = kernel;
-	hci->uart = uart;
-
-	/* Circular context for TX */
-	ret = mp_circular_init(
-		kernel, &hci->txCir,
-		mp_hci_UART_txIntEnable, mp_hci_UART_txIntDisable
-	);
-	if(!ret) {
-		mp_printk("HCI UART: Can not create TX circular");
-		return(FALSE);
-	}
-
-	/* Circular context for RX */
-	ret = mp_circular_init(
-		kernel, &hci->rxCir,
-		mp_hci_UART_rxIntEnable, mp_hci_UART_rxIntDisable
-	);
-	if(!ret) {
-		mp_printk("HCI UART: Can not create RX circular");
-		return(FALSE);
-	}
-
-	hci->txCir.user = hci;
-	hci->rxCir.user = hci;
-
-	/* setup interruption vectors */
-	hci->uart->user = hci;
-	hci->uart->onRead = mp_hci_UART_rxInt;
-	hci->uart->onWrite = mp_hci_UART_txInt;
-
-	mp_printk("Initialize HCI over UART: %s", who);
-
-	hci->state |= MP_HCI_STATE_OPENED;
-	return(TRUE);
-}
-
-mp_ret_t mp_hci_fini(mp_hci_t *hci) {
-	hci->state = 0;
-
-	hci->uart->onRead = NULL;
-	hci->uart->onWrite = NULL;
-	hci->uart->user = NULL;
-
-	mp_circular_fini(&hci->rxCir);
-	mp_circular_fini(&hci->txCir);
-
-	return(TRUE);
-}
-
-void mp_hci_connect(mp_hci_t *hci, uint8_t *addr) {
-	if((hci->state | MP_HCI_STATE_OPENED) == 0)
-		return;
-	memcpy(hci->addr, addr, sizeof(hci->addr));
-	hci->state |= MP_HCI_STATE_CONNECTED;
-}
-
-void mp_hci_send_raw(mp_hci_t *hci, uint8_t *input, int size) {
-	if((hci->state | MP_HCI_STATE_CONNECTED) == 0)
-		return;
-
-	mp_circular_write(&hci->txCir, input, size);
-}
-
-void mp_hci_send(mp_hci_t *hci, mp_hci_msg_type_t type, uint8_t *input, int size) {
-	if((hci->state | MP_HCI_STATE_CONNECTED) == 0)
-		return;
-
-	uint8_t type8 = type;
-	mp_circular_write(&hci->txCir, &type8, 1);
-	mp_circular_write(&hci->txCir, input, size);
-}
-
-void mp_hci_send_data(mp_hci_t *hci, uint16_t handle, uint8_t *input, int size) {
-	if((hci->state | MP_HCI_STATE_CONNECTED) == 0)
-		return;
-
-	uint8_t hdr[4];
-	hdr[0] = MP_HCI_MSG_DATA;
-	hdr[1] = (handle >> 4) & 0xFF;
-	hdr[2] = (handle & 0x0F) << 4;
-	hdr[3] = size;
-	mp_circular_write(&hci->txCir, hdr, 4);
-	mp_circular_write(&hci->txCir, input, size);
-}
-
-/* UART predefined interfacing */
-static void mp_hci_UART_rxInt(mp_uart_t *uart) {
-	unsigned char chr;
-
-	mp_hci_t *hci = uart->user;
-
-	/* read register */
-	chr = mp_uart_rx(uart);
-
-	/* run circular interrupt service */
-	mp_circular_rxInterrupt(&hci->rxCir, chr);
-}
-
-static void mp_hci_UART_txInt(mp_uart_t *uart) {
-	mp_hci_t *hci = uart->user;
-	unsigned char toSend;
-	mp_bool_t done;
-
-	/* run circular interrupt service */
-	toSend = mp_circular_txInterrupt(&hci->txCir, &done);
-	if(!done)
-		mp_uart_tx(uart, toSend);
-
-	/* done could be used to manage CTS */
-
-}
-
-
-static void mp_hci_UART_rxIntDisable(mp_circular_t *cir) {
-	mp_hci_t *hci = cir->user;
-	mp_uart_disable_rx_int(hci->uart);
-	return;
-}
-
-static void mp_hci_UART_rxIntEnable(mp_circular_t *cir) {
-	mp_hci_t *hci = cir->user;
-	mp_uart_enable_rx_int(hci->uart);
-	return;
-}
-
-
-static void mp_hci_UART_txIntDisable(mp_circular_t *cir) {
-	mp_hci_t *hci = cir->user;
-	mp_uart_disable_tx_int(hci->uart);
-	return;
-}
-
-static void mp_hci_UART_txIntEnable(mp_circular_t *cir) {
-	mp_hci_t *hci = cir->user;
-	mp_uart_enable_tx_int(hci->uart);
-
-}
-
-#endif
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2014  Michael VERGOZ                                      *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <mp.h>
+
+#ifdef SUPPORT_COMMON_HCI
+
+static void mp_hci_UART_rxInt(mp_uart_t *uart);
+static void mp_hci_UART_txInt(mp_uart_t *uart);
+
+static void mp_hci_UART_rxIntDisable(mp_circular_t *cir);
+static void mp_hci_UART_rxIntEnable(mp_circular_t *cir);
+static void mp_hci_UART_txIntDisable(mp_circular_t *cir);
+static void mp_hci_UART_txIntEnable(mp_circular_t *cir);
+static void mp_hci_write(mp_hci_t *hci, uint8_t *hdr, int hdrSize, uint8_t *input, int size);
+
+mp_ret_t mp_hci_initUART(mp_kernel_t *kernel, mp_hci_t *hci, mp_uart_t *uart, char *who) {
+	mp_ret_t ret;
+
+	memset(hci, 0, sizeof(*hci));
+
+	hci->kernel = kernel;
+	hci->uart = uart;
+
+	/* Circular context for TX */
+	ret = mp_circular_init(
+		kernel, &hci->txCir,
+		mp_hci_UART_txIntEnable, mp_hci_UART_txIntDisable
+	);
+	if(!ret) {
+		mp_printk("HCI UART: Can not create TX circular");
+		return(FALSE);
+	}
+
+	/* Circular context for RX */
+	ret = mp_circular_init(
+		kernel, &hci->rxCir,
+		mp_hci_UART_rxIntEnable, mp_hci_UART_rxIntDisable
+	);
+	if(!ret) {
+		mp_printk("HCI UART: Can not create RX circular");
+		return(FALSE);
+	}
+
+	hci->txCir.user = hci;
+	hci->rxCir.user = hci;
+
+	/* setup interruption vectors */
+	hci->uart->user = hci;
+	hci->uart->onRead = mp_hci_UART_rxInt;
+	hci->uart->onWrite = mp_hci_UART_txInt;
+
+	mp_printk("Initialize HCI over UART: %s", who);
+
+	hci->state |= MP_HCI_STATE_OPENED;
+	return(TRUE);
+}
+
+/**
+ * @brief HCI over UART using byte rings
+ *
+ * Same as mp_hci_initUART() but bytes are kept into two static
+ * rings (see @ref mpCommonRing), interrupt handlers never allocate.
+ * Received bytes are read with mp_hci_read().
+ *
+ * @param[in] kernel Kernel handler
+ * @param[in] hci HCI context
+ * @param[in] uart Opened UART
+ * @param[in] rxBuffer RX ring storage, power of two size
+ * @param[in] rxSize Size of rxBuffer
+ * @param[in] txBuffer TX ring storage, power of two size
+ * @param[in] txSize Size of txBuffer
+ * @param[in] who Name
+ * @return TRUE or FALSE
+ */
+mp_ret_t mp_hci_initUART_ring(
+		mp_kernel_t *kernel, mp_hci_t *hci, mp_uart_t *uart,
+		unsigned char *rxBuffer, unsigned int rxSize,
+		unsigned char *txBuffer, unsigned int txSize,
+		char *who
+	) {
+	memset(hci, 0, sizeof(*hci));
+
+	hci->kernel = kernel;
+	hci->uart = uart;
+	hci->useRing = YES;
+
+	if(!mp_ring_init(&hci->txRing, txBuffer, txSize)) {
+		mp_printk("HCI UART: Can not create TX ring");
+		return(FALSE);
+	}
+
+	if(!mp_ring_init(&hci->rxRing, rxBuffer, rxSize)) {
+		mp_printk("HCI UART: Can not create RX ring");
+		return(FALSE);
+	}
+
+	/* setup interruption vectors */
+	hci->uart->user = hci;
+	hci->uart->onRead = mp_hci_UART_rxInt;
+	hci->uart->onWrite = mp_hci_UART_txInt;
+
+	mp_uart_enable_rx_int(hci->uart);
+
+	mp_printk("Initialize HCI over UART ring: %s", who);
+
+	hci->state |= MP_HCI_STATE_OPENED;
+	return(TRUE);
+}
+
+mp_ret_t mp_hci_fini(mp_hci_t *hci) {
+	hci->state = 0;
+
+	hci->uart->onRead = NULL;
+	hci->uart->onWrite = NULL;
+	hci->uart->user = NULL;
+
+	if(hci->useRing == YES) {
+		mp_uart_disable_rx_int(hci->uart);
+		mp_uart_disable_tx_int(hci->uart);
+	}
+	else {
+		mp_circular_fini(&hci->rxCir);
+		mp_circular_fini(&hci->txCir);
+	}
+
+	return(TRUE);
+}
+
+/**
+ * @brief Read received bytes, ring backend only
+ *
+ * @param[in] hci HCI context
+ * @param[out] output Buffer to fill
+ * @param[in] size Size of the buffer
+ * @return Number of bytes read
+ */
+int mp_hci_read(mp_hci_t *hci, uint8_t *output, int size) {
+	if(hci->useRing != YES || mp_ring_count(&hci->rxRing) == 0)
+		return(0);
+
+	return(mp_ring_read(&hci->rxRing, output, size));
+}
+
+void mp_hci_connect(mp_hci_t *hci, uint8_t *addr) {
+	if((hci->state | MP_HCI_STATE_OPENED) == 0)
+		return;
+	memcpy(hci->addr, addr, sizeof(hci->addr));
+	hci->state |= MP_HCI_STATE_CONNECTED;
+}
+
+void mp_hci_send_raw(mp_hci_t *hci, uint8_t *input, int size) {
+	if((hci->state | MP_HCI_STATE_CONNECTED) == 0)
+		return;
+
+	mp_hci_write(hci, NULL, 0, input, size);
+}
+
+void mp_hci_send(mp_hci_t *hci, mp_hci_msg_type_t type, uint8_t *input, int size) {
+	if((hci->state | MP_HCI_STATE_CONNECTED) == 0)
+		return;
+
+	uint8_t type8 = type;
+	mp_hci_write(hci, &type8, 1, input, size);
+}
+
+void mp_hci_send_data(mp_hci_t *hci, uint16_t handle, uint8_t *input, int size) {
+	if((hci->state | MP_HCI_STATE_CONNECTED) == 0)
+		return;
+
+	uint8_t hdr[4];
+	hdr[0] = MP_HCI_MSG_DATA;
+	hdr[1] = (handle >> 4) & 0xFF;
+	hdr[2] = (handle & 0x0F) << 4;
+	hdr[3] = size;
+	mp_hci_write(hci, hdr, 4, input, size);
+}
+
+/* header and payload of one packet */
+static void mp_hci_write(mp_hci_t *hci, uint8_t *hdr, int hdrSize, uint8_t *input, int size) {
+	mp_ring_span_t span[2];
+
+	if(hci->useRing == YES) {
+		/* built in place, a packet which doesn't fit is dropped whole */
+		if(mp_ring_reserve(&hci->txRing, span, hdrSize+size) < hdrSize+size) {
+			hci->txRing.overruns += hdrSize+size;
+			return;
+		}
+		mp_ring_span_write(span, 0, hdr, hdrSize);
+		mp_ring_span_write(span, hdrSize, input, size);
+		mp_ring_commit(&hci->txRing, hdrSize+size);
+
+		mp_uart_enable_tx_int(hci->uart);
+		return;
+	}
+
+	if(hdrSize > 0)
+		mp_circular_write(&hci->txCir, hdr, hdrSize);
+	mp_circular_write(&hci->txCir, input, size);
+}
+
+/* UART predefined interfacing */
+static void mp_hci_UART_rxInt(mp_uart_t *uart) {
+	unsigned char chr;
+
+	mp_hci_t *hci = uart->user;
+
+	/* read register */
+	chr = mp_uart_rx(uart);
+
+	/* a full ring counts the overrun */
+	if(hci->useRing == YES) {
+		mp_ring_put(&hci->rxRing, chr);
+		return;
+	}
+
+	/* run circular interrupt service */
+	mp_circular_rxInterrupt(&hci->rxCir, chr);
+}
+
+static void mp_hci_UART_txInt(mp_uart_t *uart) {
+	mp_hci_t *hci = uart->user;
+	unsigned char toSend;
+	mp_bool_t done;
+
+	if(hci->useRing == YES) {
+		if(mp_ring_count(&hci->txRing) == 0) {
+			mp_uart_disable_tx_int(uart);
+			return;
+		}
+		mp_ring_get(&hci->txRing, &toSend);
+		mp_uart_tx(uart, toSend);
+		return;
+	}
+
+	/* run circular interrupt service */
+	toSend = mp_circular_txInterrupt(&hci->txCir, &done);
+	if(!done)
+		mp_uart_tx(uart, toSend);
+
+	/* done could be used to manage CTS */
+
+}
+
+
+static void mp_hci_UART_rxIntDisable(mp_circular_t *cir) {
+	mp_hci_t *hci = cir->user;
+
+	/* called by mp_circular_init() before the user is set */
+	if(!hci)
+		return;
+
+	mp_uart_disable_rx_int(hci->uart);
+	return;
+}
+
+static void mp_hci_UART_rxIntEnable(mp_circular_t *cir) {
+	mp_hci_t *hci = cir->user;
+	mp_uart_enable_rx_int(hci->uart);
+	return;
+}
+
+
+static void mp_hci_UART_txIntDisable(mp_circular_t *cir) {
+	mp_hci_t *hci = cir->user;
+
+	/* called by mp_circular_init() before the user is set */
+	if(!hci)
+		return;
+
+	mp_uart_disable_tx_int(hci->uart);
+	return;
+}
+
+static void mp_hci_UART_txIntEnable(mp_circular_t *cir) {
+	mp_hci_t *hci = cir->user;
+	mp_uart_enable_tx_int(hci->uart);
+
+}
+
+#endif
@@ -58,6 +58,9 @@ void mp_kernel_init(mp_kernel_t *kernel, mp_kernel_onBoot_t onBoot, void *user)
 	kernel->onBoot = onBoot;
 	kernel->onBootUser = user;
 
+	/* ISRs may post as soon as the machine is initialized */
+	mp_softirq_init(kernel);
+
 	/* initialize the machine */
 	mp_machine_init(kernel);
 
@@ -74,6 +77,9 @@ void mp_kernel_init(mp_kernel_t *kernel, mp_kernel_onBoot_t onBoot, void *user)
 	/* initialize tasks */
 	mp_task_init(kernel, &kernel->tasks);
 
+	/* initialize software timers */
+	mp_ktimer_init(kernel);
+
 	/* initialize logical machine state */
 	mp_state_init(kernel, &kernel->states);
 
@@ -118,6 +124,12 @@ void mp_kernel_state(mp_kernel_t *kernel, char number) {
 void mp_kernel_loop(mp_kernel_t *kernel) {
 	mp_task_tick_t taskRet;
 	while(1) {
+		/* execute works posted by ISRs */
+		mp_softirq_drain(kernel);
+
+		/* execute expired software timers */
+		mp_ktimer_tick(kernel);
+
 		/* let the clock schedules */
 		mp_clock_schedule(kernel);
 
@@ -0,0 +1,264 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <mp.h>
+
+static void _mp_ktimer_insert(mp_ktimer_handler_t *hdl, mp_ktimer_t *timer);
+static void _mp_ktimer_remove(mp_ktimer_handler_t *hdl, mp_ktimer_t *timer);
+
+/**
+@defgroup mpCommonKtimer Software timers
+
+@ingroup mpCommon
+
+@brief One-shot and periodic callbacks without task slot
+
+@version 1.0.0
+
+@author @htmlonly &copy; @endhtmlonly 2016
+Michael Vergoz <mv@verman.fr>
+
+@date 25 Apr 2016
+
+Kernel timers execute a callback after a delay in ticks, once or
+periodically. They do not use a task slot and do not allocate : the
+mp_ktimer_t is owned by the caller and linked into a hashed timer wheel
+of MP_KTIMER_SLOTS lists indexed by the expiration tick. The kernel loop
+services only the slots of the elapsed ticks so an expiration costs
+O(1) whatever the number of armed timers.
+
+Callbacks are executed from the kernel loop, they can start or stop
+any timer including their own. mp_ktimer_start() and mp_ktimer_stop()
+mask interrupts around the wheel so an ISR can arm or disarm a timer
+(e.g. a bus watchdog armed when a transfer starts). With the tickless
+clock a timer armed from an ISR is accounted at the next kernel loop
+pass, the ISR must make a task ready if it needs the loop sooner.
+
+@code
+static void _blink(mp_ktimer_t *timer) {
+	mp_drv_led_t *led = timer->user;
+	mp_drv_led_turn(led);
+}
+
+// [...]
+
+mp_ktimer_start(kernel, &XXX->blink, "Blink", 500, 500, _blink, &XXX->led);
+@endcode
+
+@{
+*/
+
+#define _MASK (MP_KTIMER_SLOTS-1)
+
+/**
+ * @brief Initialize the kernel timer wheel
+ *
+ * @param[in] kernel Kernel handler
+ */
+void mp_ktimer_init(mp_kernel_t *kernel) {
+	memset(&kernel->timers, 0, sizeof(kernel->timers));
+}
+
+/**
+ * @brief Arm a timer
+ *
+ * An armed timer is restarted with the new parameters.
+ *
+ * @param[in] kernel Kernel handler
+ * @param[in] timer Timer context
+ * @param[in] name Timer name
+ * @param[in] delay Ticks before the first expiration
+ * @param[in] period Ticks between next expirations, 0 for one-shot
+ * @param[in] callback Expiration callback
+ * @param[in] user User pointer
+ */
+void mp_ktimer_start(mp_kernel_t *kernel, mp_ktimer_t *timer, char *name,
+		unsigned long delay, unsigned long period, mp_ktimer_cb_t callback, void *user) {
+	mp_ktimer_handler_t *hdl = &kernel->timers;
+	unsigned long now;
+
+	/* the slot of the actual tick may be already serviced */
+	if(delay == 0)
+		delay = 1;
+
+	MP_INTERRUPT_SAFE_BEGIN
+	if(timer->list)
+		_mp_ktimer_remove(hdl, timer);
+	else
+		memset(timer, 0, sizeof(*timer));
+
+	/* wheel was idle, do not replay old slots */
+	now = mp_clock_ticks();
+	if(hdl->armed == 0)
+		hdl->current = now;
+
+	timer->name = name;
+	timer->expires = now+delay;
+	timer->period = period;
+	timer->callback = callback;
+	timer->user = user;
+
+	_mp_ktimer_insert(hdl, timer);
+	MP_INTERRUPT_SAFE_END
+}
+
+/**
+ * @brief Disarm a timer
+ *
+ * @param[in] kernel Kernel handler
+ * @param[in] timer Timer context
+ */
+void mp_ktimer_stop(mp_kernel_t *kernel, mp_ktimer_t *timer) {
+	MP_INTERRUPT_SAFE_BEGIN
+	if(timer->list)
+		_mp_ktimer_remove(&kernel->timers, timer);
+	MP_INTERRUPT_SAFE_END
+}
+
+/**
+ * @brief Check if a timer is armed
+ *
+ * @param[in] timer Timer context
+ * @return YES or NO
+ */
+mp_bool_t mp_ktimer_armed(mp_ktimer_t *timer) {
+	return(timer->list ? YES : NO);
+}
+
+/**
+ * @brief Execute expired timers
+ *
+ * Called by the kernel loop
+ *
+ * @param[in] kernel Kernel handler
+ */
+void mp_ktimer_tick(mp_kernel_t *kernel) {
+	mp_ktimer_handler_t *hdl = &kernel->timers;
+	unsigned long now = mp_clock_ticks();
+	mp_list_item_t *item;
+	mp_list_item_t *next;
+	mp_ktimer_t *timer;
+	mp_list_t expired;
+	mp_list_t *slot;
+
+	/* ISRs may arm or disarm timers, the wheel is walked masked */
+	mp_interrupt_disable();
+
+	if(hdl->armed == 0) {
+		hdl->current = now;
+		mp_interrupt_enable();
+		return;
+	}
+
+	/* one wheel revolution visits every slot */
+	if(now-hdl->current > MP_KTIMER_SLOTS)
+		hdl->current = now-MP_KTIMER_SLOTS;
+
+	mp_list_init(&expired);
+
+	while(hdl->current != now) {
+		hdl->current++;
+		slot = &hdl->slots[hdl->current & _MASK];
+
+		/* slots also hold timers of the next revolutions */
+		item = slot->first;
+		while(item) {
+			next = item->next;
+			timer = item->user;
+			if((long)(timer->expires-now) <= 0) {
+				mp_list_remove(slot, item);
+				mp_list_add_last(&expired, item, timer);
+				timer->list = &expired;
+			}
+			item = next;
+		}
+	}
+
+	/* callbacks may start or stop timers */
+	while(expired.first) {
+		timer = expired.first->user;
+		_mp_ktimer_remove(hdl, timer);
+
+		if(timer->period > 0) {
+			timer->expires += timer->period;
+
+			/* late, do not burst */
+			if((long)(timer->expires-now) <= 0)
+				timer->expires = now+timer->period;
+
+			_mp_ktimer_insert(hdl, timer);
+		}
+
+		mp_interrupt_enable();
+		timer->callback(timer);
+		mp_interrupt_disable();
+	}
+
+	mp_interrupt_enable();
+}
+
+/**
+ * @brief Get the number of ticks before the next expiration
+ *
+ * Used by the clock to sleep as long as possible, interrupts disabled
+ *
+ * @param[in] kernel Kernel handler
+ * @param[in] now Actual tick
+ * @return ticks to wait, 0 if a timer is expired or MP_TASK_NO_WAKEUP
+ */
+unsigned long mp_ktimer_next_wakeup(mp_kernel_t *kernel, unsigned long now) {
+	mp_ktimer_handler_t *hdl = &kernel->timers;
+	unsigned long wait = MP_TASK_NO_WAKEUP;
+	mp_list_item_t *item;
+	mp_ktimer_t *timer;
+	long delta;
+	int a;
+
+	if(hdl->armed == 0)
+		return(wait);
+
+	for(a=0; a<MP_KTIMER_SLOTS; a++) {
+		for(item=hdl->slots[a].first; item; item=item->next) {
+			timer = item->user;
+			delta = (long)(timer->expires-now);
+			if(delta <= 0)
+				return(0);
+			if((unsigned long)delta < wait)
+				wait = delta;
+		}
+	}
+
+	return(wait);
+}
+
+/**@}*/
+
+static void _mp_ktimer_insert(mp_ktimer_handler_t *hdl, mp_ktimer_t *timer) {
+	timer->list = &hdl->slots[timer->expires & _MASK];
+	mp_list_add_last(timer->list, &timer->item, timer);
+	hdl->armed++;
+}
+
+static void _mp_ktimer_remove(mp_ktimer_handler_t *hdl, mp_ktimer_t *timer) {
+	mp_list_remove(timer->list, &timer->item);
+	timer->list = NULL;
+	hdl->armed--;
+}
@@ -0,0 +1,336 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <mp.h>
+
+#ifdef MP_LOG
+
+MP_TASK(_mp_log_drain);
+
+static void _mp_log_header(unsigned char *buffer, unsigned int id, unsigned int size, uint32_t time);
+static void _mp_log_lost();
+static unsigned int _mp_log_put(unsigned char *buffer, unsigned int pos, unsigned int size, unsigned long value, unsigned int bytes);
+
+/**
+@defgroup mpCommonLog Binary log
+
+@ingroup mpCommon
+
+@brief Deferred formatting log drained over a serial port
+
+@version 1.0.0
+
+@author @htmlonly &copy; @endhtmlonly 2016
+Michael Vergoz <mv@verman.fr>
+
+@date 14 May 2016
+
+mp_log() replaces mp_printk() where formatting costs too much. The
+format string is placed into the mp_log section which is kept into the
+ELF image but not loaded on target. A call only walks the format to
+pack the raw arguments behind a 7 bytes header holding the offset of
+the string into the section, then copies the record into a ring of
+MP_LOG_SIZE bytes with interrupts disabled. No digit is ever produced
+on target and floating point arguments cost a conversion to float.
+
+A background task sends the ring over a serial port. The stream
+starts with a MP_LOG_SYNC record, records dropped on a full ring are
+accounted into a MP_LOG_LOST record. tools/log2text rebuilds the text
+with the strings of the image :
+
+@code
+mp_log_start(&olimex->kernel, &olimex->serial);
+mp_log("gyro x=%f y=%f z=%f", x, y, z);
+
+// host side
+// $ make log2text
+// $ ./tools/bin/log2text firmware.out capture.bin
+@endcode
+
+The format must be a string literal. Conversions are the mp_printk()
+ones (d i u x X o c p s f e g and the l modifier), strings are cut to
+MP_LOG_STRING characters and arguments to MP_LOG_ARGS bytes.
+
+Defining MP_LOG_PRINTK turns every mp_printk() into mp_log(). Without
+MP_LOG, mp_log() is mp_printk().
+
+@{
+*/
+
+/* linker provided start of the format strings */
+extern const char __start_mp_log[];
+
+/* keeps the section, and its start symbol, without any mp_log() call */
+const char mp_log_anchor[] MP_LOG_SECTION = "";
+
+static unsigned char __buffer[MP_LOG_SIZE];
+static mp_ring_t __ring;
+static volatile unsigned int __lost = 0;
+static volatile mp_bool_t __enabled = NO;
+
+static mp_serial_t *__serial = NULL;
+static mp_task_t *__task = NULL;
+
+/**
+ * @brief Start logging to a serial port
+ *
+ * @param[in] kernel Kernel handler
+ * @param[in] serial Opened serial port
+ * @return TRUE or FALSE
+ */
+mp_ret_t mp_log_start(mp_kernel_t *kernel, mp_serial_t *serial) {
+	unsigned char sync[MP_LOG_HEADER+3];
+
+	if(__task)
+		return(FALSE);
+
+	__task = mp_task_create(&kernel->tasks, "Log", _mp_log_drain, NULL, 10);
+	if(!__task)
+		return(FALSE);
+
+	__serial = serial;
+
+	/* stream header */
+	_mp_log_header(sync, MP_LOG_SYNC, 3, MP_CLOCK_HIRES_HZ);
+	sync[MP_LOG_HEADER] = MP_LOG_VERSION;
+	sync[MP_LOG_HEADER+1] = sizeof(int);
+	sync[MP_LOG_HEADER+2] = sizeof(void *);
+	mp_serial_write(serial, sync, sizeof(sync));
+
+	MP_INTERRUPT_SAFE_BEGIN
+	mp_ring_init(&__ring, __buffer, sizeof(__buffer));
+	__lost = 0;
+	__enabled = YES;
+	MP_INTERRUPT_SAFE_END
+
+	return(TRUE);
+}
+
+/**
+ * @brief Stop logging
+ */
+void mp_log_stop() {
+	__enabled = NO;
+
+	if(__task) {
+		mp_task_destroy(__task);
+		__task = NULL;
+	}
+}
+
+/**
+ * @brief Write a record, from any context
+ *
+ * Use mp_log() which places the format into the mp_log section.
+ *
+ * @param[in] fmt Format string from the mp_log section
+ */
+void mp_log_write(const char *fmt, ...) {
+	unsigned char buffer[MP_LOG_HEADER+MP_LOG_ARGS];
+	unsigned int size;
+	va_list ap;
+
+	if(__enabled == NO)
+		return;
+
+	va_start(ap, fmt);
+	size = mp_log_encode(buffer+MP_LOG_HEADER, MP_LOG_ARGS, fmt, ap);
+	va_end(ap);
+
+	MP_INTERRUPT_SAFE_BEGIN
+	/* pending drops are reported before the record */
+	if(mp_ring_space(&__ring) < MP_LOG_HEADER+size+(__lost > 0 ? MP_LOG_HEADER+2 : 0))
+		__lost++;
+	else {
+		_mp_log_lost();
+		_mp_log_header(buffer, fmt-__start_mp_log, size, mp_clock_hires());
+		mp_ring_write(&__ring, buffer, MP_LOG_HEADER+size);
+	}
+	MP_INTERRUPT_SAFE_END
+}
+
+/**
+ * @brief Pack the arguments of a format
+ *
+ * Packing stops on an unknown conversion or when the buffer is full,
+ * the decoder shows the missing arguments.
+ *
+ * @param[out] buffer Arguments buffer
+ * @param[in] size Size of the buffer
+ * @param[in] fmt Format string
+ * @param[in] ap Arguments
+ * @return Number of bytes written
+ */
+unsigned int mp_log_encode(unsigned char *buffer, unsigned int size, const char *fmt, va_list ap) {
+	unsigned int pos = 0;
+	unsigned int start;
+	mp_bool_t isLong;
+	const char *str;
+	unsigned int len;
+	float real;
+
+	for(; *fmt; fmt++) {
+		if(*fmt != '%')
+			continue;
+		fmt++;
+		start = pos;
+
+		/* flags, width and precision, '*' takes an int */
+		for(; *fmt; fmt++) {
+			if(*fmt == '*')
+				pos = _mp_log_put(buffer, pos, size, va_arg(ap, unsigned int), sizeof(int));
+			else if(!strchr("-+ #.0123456789", *fmt))
+				break;
+		}
+
+		isLong = NO;
+		if(*fmt == 'h')
+			fmt++;
+		else if(*fmt == 'l') {
+			isLong = YES;
+			fmt++;
+		}
+
+		switch(*fmt) {
+			case '%':
+				break;
+
+			case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+				if(isLong == YES)
+					pos = _mp_log_put(buffer, pos, size, va_arg(ap, unsigned long), 4);
+				else
+					pos = _mp_log_put(buffer, pos, size, va_arg(ap, unsigned int), sizeof(int));
+				break;
+
+			case 'p':
+				pos = _mp_log_put(buffer, pos, size, (unsigned long)va_arg(ap, void *), sizeof(void *));
+				break;
+
+			case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+				real = (float)va_arg(ap, double);
+				if(pos+sizeof(real) > size)
+					return(start);
+				memcpy(buffer+pos, &real, sizeof(real));
+				pos += sizeof(real);
+				break;
+
+			case 's':
+				str = va_arg(ap, const char *);
+				if(!str)
+					str = "(null)";
+				for(len=0; len < MP_LOG_STRING && str[len]; len++);
+				if(pos+1+len > size)
+					return(start);
+				buffer[pos++] = len;
+				memcpy(buffer+pos, str, len);
+				pos += len;
+				break;
+
+			default:
+				return(start);
+		}
+
+		/* drop the whole conversion */
+		if(pos > size)
+			return(start);
+	}
+
+	return(pos);
+}
+
+/**@}*/
+
+MP_TASK(_mp_log_drain) {
+	mp_ring_span_t span[2];
+	unsigned int budget;
+	unsigned int size;
+	int a;
+
+	if(task->signal == MP_TASK_SIG_STOP) {
+		mp_task_signal(task, MP_TASK_SIG_DEAD);
+		return;
+	}
+
+	/* report drops even when nothing is logged anymore */
+	if(__lost > 0) {
+		MP_INTERRUPT_SAFE_BEGIN
+		_mp_log_lost();
+		MP_INTERRUPT_SAFE_END
+	}
+
+	/* never give more than the serial can take, the stream has no resync */
+	if(__serial->useRing == YES)
+		budget = mp_ring_space(&__serial->txRing);
+	else
+		budget = MP_CIRCULAR_BUFFER_SIZE;
+
+	/* only the drain moves the tail */
+	mp_ring_peek(&__ring, span);
+	for(a=0; a<2 && budget > 0; a++) {
+		size = span[a].size < budget ? span[a].size : budget;
+		if(size == 0)
+			continue;
+		mp_serial_write(__serial, span[a].data, size);
+		mp_ring_consume(&__ring, size);
+		budget -= size;
+	}
+}
+
+static void _mp_log_header(unsigned char *buffer, unsigned int id, unsigned int size, uint32_t time) {
+	buffer[0] = id;
+	buffer[1] = id >> 8;
+	buffer[2] = size;
+	buffer[3] = time;
+	buffer[4] = time >> 8;
+	buffer[5] = time >> 16;
+	buffer[6] = time >> 24;
+}
+
+/* interrupts disabled */
+static void _mp_log_lost() {
+	unsigned char buffer[MP_LOG_HEADER+2];
+
+	if(__lost == 0 || mp_ring_space(&__ring) < sizeof(buffer))
+		return;
+
+	_mp_log_header(buffer, MP_LOG_LOST, 2, mp_clock_hires());
+	buffer[MP_LOG_HEADER] = __lost;
+	buffer[MP_LOG_HEADER+1] = __lost >> 8;
+	mp_ring_write(&__ring, buffer, sizeof(buffer));
+	__lost = 0;
+}
+
+/* pos beyond size marks an overflow */
+static unsigned int _mp_log_put(unsigned char *buffer, unsigned int pos, unsigned int size, unsigned long value, unsigned int bytes) {
+	unsigned int a;
+
+	if(pos+bytes > size)
+		return(size+1);
+
+	for(a=0; a<bytes; a++) {
+		buffer[pos++] = value;
+		value >>= 8;
+	}
+
+	return(pos);
+}
+
+#endif
@@ -22,15 +22,51 @@
 
 #ifdef SUPPORT_COMMON_MEM
 
+/* canary placed after the data, aligned for its type */
+#define _MEM_TAIL(size) \
+	(((size)+sizeof(unsigned long)-1) & ~(sizeof(unsigned long)-1))
+
+#define _MEM_CANARY(cls, chunk) \
+	(*(unsigned long *)((unsigned char *)(chunk)+_MEM_TAIL((cls)->size)))
+
+#ifdef MP_MEM_STATS
+	/* owner tag placed after the canary */
+	#define _MEM_OWNER_SIZE sizeof(const char *)
+	#define _MEM_OWNER(cls, chunk) \
+		(*(const char **)((unsigned char *)(chunk)+_MEM_TAIL((cls)->size)+sizeof(unsigned long)))
+#else
+	#define _MEM_OWNER_SIZE 0
+#endif
+
+/* tagged allocations are called by the mem.h macros */
+#undef mp_mem_alloc
+#undef mp_mem_alloc_isr
+
+/** { chunk size, number of chunks } sorted by size */
+static const unsigned short __mem_config[][2] = { MP_MEM_CLASSES };
+
+#define _MEM_CLASSES (sizeof(__mem_config)/sizeof(__mem_config[0]))
+
 #ifndef MP_COMMON_MEM_USE_MALLOC
-	/** linear allocation tab */
-	static unsigned char __line[MP_MEM_SIZE];
+	/** linear allocation tab, aligned for the canaries and the free links */
+	static unsigned long __line[(MP_MEM_SIZE+sizeof(unsigned long)-1)/sizeof(unsigned long)];
 #else
-	static unsigned char *__line = NULL;
+	static unsigned long *__line = NULL;
 #endif
 
-static mp_list_t __mem_free_root;
-static long __mem_allocated = 0;
+static mp_mem_class_t __mem_classes[_MEM_CLASSES];
+
+/** usage, updated with interrupts disabled */
+static mp_mem_stats_t __mem_stats;
+
+/** chunks reserved to interrupt handlers */
+static mp_mem_class_t __mem_isr;
+
+static mp_mem_class_t *_mp_mem_class(void *ptr);
+static unsigned char *_mp_mem_carve(mp_mem_class_t *cls, unsigned char *line, int size, int number);
+static void *_mp_mem_pop(mp_mem_class_t *cls, const char *owner);
+static void *_mp_mem_get(int size, const char *owner);
+static void _mp_mem_dump_class(mp_mem_class_t *cls, const char *name);
 
 /**
 @defgroup mpCommonMem Memory allocator
@@ -39,7 +75,7 @@ static long __mem_allocated = 0;
 
 @brief Tiny memory allocation system
 
-@version 1.0.0
+@version 1.1.0
 
 @author @htmlonly &copy; @endhtmlonly 2014
 Michael Vergoz <mv@verman.fr>
@@ -47,14 +83,33 @@ Michael Vergoz <mv@verman.fr>
 @date 03 Feb 2015
 
 miniPhi common memory is a library to manage memory allocations.
-It is a tiny version of malloc() and then without "size hashing" algo.
-This allocation system doesn't consume too much energy.
-
-Each block has the same size and the size of a block is defined
-in config.h by @ref MP_MEM_CHUNK (set to 1024 by default)
-
-The predefine memory space is set my the define @ref MP_MEM_SIZE
-(set to 50 by default) in config.h
+It is a tiny segregated allocator: the heap is cut in a few size
+classes each holding chunks of one size. A request is served by the
+smallest class fitting it, or by a larger one when that class is empty.
+Allocation and free are O(1), chunks of a class are chained in a free
+list through their data.
+
+Classes are defined in config.h by @ref MP_MEM_CLASSES as pairs of
+chunk size and number of chunks, sorted by size. The last class gets
+all the space left in @ref MP_MEM_SIZE and its size is the largest
+allocation, @ref MP_MEM_CHUNK by default.
+
+Every chunk is followed by a canary checked by mp_mem_free(), a
+corrupted chunk or a double free raises a kernel panic.
+
+Free lists are only touched with interrupts disabled, chunks can be
+freed from an interrupt handler. Handlers allocate with
+mp_mem_alloc_isr(): it takes one of the @ref MP_MEM_ISR_CHUNKS chunks
+reserved to them first, so a task draining the heap can not starve a
+receive path. It never panics, a failure is counted by
+mp_mem_overruns().
+
+mp_mem_stats_get() returns current and peak usage and the number of
+failed allocations, mp_mem_stats_dump() prints them with the lowest
+number of free chunks of each class, which is what you need to size
+@ref MP_MEM_SIZE and @ref MP_MEM_CLASSES. When @ref MP_MEM_STATS is
+defined every chunk is also tagged with the function which allocated
+it and the dump lists outstanding chunks by owner to find leaks.
 
 It is also possible to specify the section used for the linear memory
 if you wish (for example) to have an allocator in the Flash.
@@ -72,38 +127,93 @@ You can overwrite those values by defining your own config.h file.
 /**
   * HEAP memory chunk allocation
   * @param kernel The kernel context
-  * @param size Size of chunk, used as informational
+  * @param size Size of chunk
   * @return Point to a free space
   */
 void *mp_mem_alloc(mp_kernel_t *kernel, int size) {
-	mp_list_item_t *item;
-	mp_mem_chunk_t *chunk;
+	return(mp_mem_alloc_owner(kernel, size, NULL));
+}
+
+/**
+  * HEAP memory chunk allocation tagged with an owner
+  *
+  * With @ref MP_MEM_STATS mp_mem_alloc() is a macro calling it
+  * with the name of the calling function.
+  *
+  * @param kernel The kernel context
+  * @param size Size of chunk
+  * @param owner Static string shown by mp_mem_stats_dump()
+  * @return Point to a free space
+  */
+void *mp_mem_alloc_owner(mp_kernel_t *kernel, int size, const char *owner) {
+	void *chunk;
 
 	/* sanatize */
-	if(size >= MP_MEM_CHUNK) {
+	if(size > __mem_classes[_MEM_CLASSES-1].size) {
+		MP_INTERRUPT_SAFE_BEGIN
+		__mem_stats.failed++;
+		MP_INTERRUPT_SAFE_END
 		mp_kernel_panic(kernel, KPANIC_MEM_SIZE);
-		mp_printk("chunk is too low %d you are asking for %d", MP_MEM_CHUNK, size);
+		mp_printk("chunk is too low %d you are asking for %d", __mem_classes[_MEM_CLASSES-1].size, size);
 		return(NULL);
 	}
 
-	/* pop chunk */
-	item = __mem_free_root.first;
-	if(!item) {
+	chunk = _mp_mem_get(size, owner);
+	if(chunk == NULL) {
+		MP_INTERRUPT_SAFE_BEGIN
+		__mem_stats.failed++;
+		MP_INTERRUPT_SAFE_END
 		mp_kernel_panic(kernel, KPANIC_MEM_OOM);
 		mp_printk("chunk has no reach the limit increase MP_MEM_SIZE");
 		return(NULL);
 	}
 
-	/* get chunk */
-	chunk = item->user;
-
-	/* remove chunk from free and push it into used list */
-	mp_list_remove(&__mem_free_root, item);
-	memset(&chunk->data, 0, sizeof(chunk->data));
+	return(chunk);
+}
 
-	__mem_allocated++;
+/**
+  * HEAP memory chunk allocation from an interrupt handler
+  *
+  * Reserved chunks are used first then the heap. On failure the
+  * overrun counter is incremented, nothing is printed.
+  *
+  * @param kernel The kernel context
+  * @param size Size of chunk
+  * @return Point to a free space or NULL
+  */
+void *mp_mem_alloc_isr(mp_kernel_t *kernel, int size) {
+	return(mp_mem_alloc_isr_owner(kernel, size, NULL));
+}
 
-	return((void *)chunk);
+/**
+  * HEAP memory chunk allocation from an interrupt handler tagged with an owner
+  * @param kernel The kernel context
+  * @param size Size of chunk
+  * @param owner Static string shown by mp_mem_stats_dump()
+  * @return Point to a free space or NULL
+  */
+void *mp_mem_alloc_isr_owner(mp_kernel_t *kernel, int size, const char *owner) {
+	void *chunk = NULL;
+
+	if(size <= __mem_isr.size) {
+		MP_INTERRUPT_SAFE_BEGIN
+		chunk = _mp_mem_pop(&__mem_isr, owner);
+		MP_INTERRUPT_SAFE_END
+
+		if(chunk != NULL) {
+			memset(chunk, 0, size);
+			return(chunk);
+		}
+	}
+	if(size <= __mem_classes[_MEM_CLASSES-1].size)
+		chunk = _mp_mem_get(size, owner);
+	if(chunk == NULL) {
+		MP_INTERRUPT_SAFE_BEGIN
+		__mem_stats.overruns++;
+		__mem_stats.failed++;
+		MP_INTERRUPT_SAFE_END
+	}
+	return(chunk);
 }
 
 /**
@@ -113,18 +223,98 @@ void *mp_mem_alloc(mp_kernel_t *kernel, int size) {
   * @return Nothing
   */
 void mp_mem_free(mp_kernel_t *kernel, void *ptr) {
-	mp_mem_chunk_t *chunk = ptr;
-	if(chunk->canary != MEM_CANARY) {
+	mp_mem_class_t *cls;
+	unsigned long canary;
+
+	cls = _mp_mem_class(ptr);
+	if(cls == NULL) {
 		mp_kernel_panic(kernel, KPANIC_MEM_OOM);
-		mp_printk("Memory currupted");
+		mp_printk("Memory %p is not a chunk", ptr);
 		return;
 	}
-	memset(&chunk->item, 0, sizeof(chunk->item));
-	mp_list_add_first(&__mem_free_root, &chunk->item, chunk);
-	__mem_allocated--;
+
+	MP_INTERRUPT_SAFE_BEGIN
+	canary = _MEM_CANARY(cls, ptr);
+	if(canary == MEM_CANARY) {
+		/* push chunk */
+		_MEM_CANARY(cls, ptr) = MEM_FREED;
+		*(void **)ptr = cls->free;
+		cls->free = ptr;
+		cls->freeNumber++;
+
+		__mem_stats.chunks--;
+		__mem_stats.used -= cls->size;
+	}
+	MP_INTERRUPT_SAFE_END
+
+	if(canary == MEM_FREED) {
+		mp_kernel_panic(kernel, KPANIC_MEM_OOM);
+		mp_printk("Memory %p freed twice", ptr);
+	}
+	else if(canary != MEM_CANARY) {
+		mp_kernel_panic(kernel, KPANIC_MEM_OOM);
+		mp_printk("Memory currupted");
+	}
 }
 
+/**
+  * Number of failed allocations from interrupt handlers
+  * @return Overruns since mp_mem_erase()
+  */
+unsigned long mp_mem_overruns() {
+	return(__mem_stats.overruns);
+}
 
+/**
+  * Get a copy of the heap usage
+  * @param stats Statistics copy
+  */
+void mp_mem_stats_get(mp_mem_stats_t *stats) {
+	MP_INTERRUPT_SAFE_BEGIN
+	memcpy(stats, &__mem_stats, sizeof(*stats));
+	MP_INTERRUPT_SAFE_END
+}
+
+/**
+  * Reset peaks, failures and lowest free numbers to the current usage
+  */
+void mp_mem_stats_reset() {
+	int a;
+
+	MP_INTERRUPT_SAFE_BEGIN
+	__mem_stats.peak = __mem_stats.used;
+	__mem_stats.peakChunks = __mem_stats.chunks;
+	__mem_stats.failed = 0;
+	__mem_stats.overruns = 0;
+
+	__mem_isr.minFree = __mem_isr.freeNumber;
+	for(a=0; a<_MEM_CLASSES; a++)
+		__mem_classes[a].minFree = __mem_classes[a].freeNumber;
+	MP_INTERRUPT_SAFE_END
+}
+
+/**
+  * Dump heap usage through mp_printk()
+  *
+  * Each class shows its number of free chunks and the lowest number
+  * seen. With @ref MP_MEM_STATS outstanding chunks are listed by owner.
+  */
+void mp_mem_stats_dump() {
+	mp_mem_stats_t stats;
+	int a;
+
+	mp_mem_stats_get(&stats);
+
+	mp_printk("Mem stats: %lu/%lu bytes used, %lu peak, %u chunks, %u peak, %lu failed, %lu overruns",
+		stats.used, stats.total, stats.peak,
+		stats.chunks, stats.peakChunks,
+		stats.failed, stats.overruns
+	);
+
+	_mp_mem_dump_class(&__mem_isr, "isr");
+	for(a=0; a<_MEM_CLASSES; a++)
+		_mp_mem_dump_class(&__mem_classes[a], "class");
+}
 
 /**
   * erase HEAP memory
@@ -132,13 +322,11 @@ void mp_mem_free(mp_kernel_t *kernel, void *ptr) {
   * @return TRUE or FALSE
   */
 mp_ret_t mp_mem_erase(mp_kernel_t *kernel) {
-	mp_mem_chunk_t *chunk;
+	mp_mem_class_t *cls;
+	unsigned char *line;
+	int number;
 	int a;
 
-	/* erase list */
-	memset(&__mem_free_root, 0, sizeof(__mem_free_root));
-	mp_list_init(&__mem_free_root);
-
 #ifdef MP_COMMON_MEM_USE_MALLOC
 	__line = malloc(MP_MEM_SIZE);
 	if(!__line) {
@@ -146,32 +334,177 @@ mp_ret_t mp_mem_erase(mp_kernel_t *kernel) {
 		mp_kernel_panic(kernel, KPANIC_MEM_OOM);
 		return(FALSE);
 	}
+#endif
 
 	/* erase memory */
 	memset(__line, 0, MP_MEM_SIZE);
+	line = (unsigned char *)__line;
+	memset(&__mem_stats, 0, sizeof(__mem_stats));
+
+	/* reserved chunks first, as large as the largest class */
+	line = _mp_mem_carve(&__mem_isr, line, __mem_config[_MEM_CLASSES-1][0], MP_MEM_ISR_CHUNKS);
+	if(line != NULL)
+		__mem_stats.total += (unsigned long)__mem_isr.size*__mem_isr.number;
+
+	/* carve classes */
+	for(a=0; a<_MEM_CLASSES && line!=NULL; a++) {
+		cls = &__mem_classes[a];
+
+		/* the largest class takes the rest */
+		number = __mem_config[a][1];
+		if(a == _MEM_CLASSES-1)
+			number = -1;
+
+		line = _mp_mem_carve(cls, line, __mem_config[a][0], number);
+		if(line != NULL)
+			__mem_stats.total += (unsigned long)cls->size*cls->number;
+	}
 
-	/* initialize free chunks */
-	chunk = (mp_mem_chunk_t *)__line;
-#else
-	/* erase memory */
-	memset(&__line, 0, MP_MEM_SIZE);
+	if(line == NULL) {
+		mp_printk("Memory classes need more than MP_MEM_SIZE %d", MP_MEM_SIZE);
+		mp_kernel_panic(kernel, KPANIC_MEM_SIZE);
+		return(FALSE);
+	}
+
+	return(TRUE);
+}
+
+/**@}*/
 
-	/* initialize free chunks */
-	chunk = (mp_mem_chunk_t *)&__line;
+static unsigned char *_mp_mem_carve(mp_mem_class_t *cls, unsigned char *line, int size, int number) {
+	unsigned char *chunk;
+	unsigned char *end = (unsigned char *)__line+MP_MEM_SIZE;
+
+	cls->size = size;
+	if(cls->size < sizeof(void *))
+		cls->size = sizeof(void *);
+	cls->stride = _MEM_TAIL(cls->size)+sizeof(unsigned long)+_MEM_OWNER_SIZE;
+
+	/* negative number takes the rest */
+	if(number < 0)
+		number = (end-line)/cls->stride;
+	if((unsigned long)number*cls->stride > (unsigned long)(end-line))
+		return(NULL);
+	cls->number = number;
+
+	cls->start = line;
+	cls->end = line+(unsigned long)cls->number*cls->stride;
+
+	/* prepare free list, lowest addresses first */
+	cls->free = NULL;
+	cls->freeNumber = cls->number;
+	cls->minFree = cls->number;
+	for(; number>0; number--) {
+		chunk = cls->start+(unsigned long)(number-1)*cls->stride;
+		_MEM_CANARY(cls, chunk) = MEM_FREED;
+		*(void **)chunk = cls->free;
+		cls->free = chunk;
+	}
+
+	return(cls->end);
+}
+
+/* interrupts must be disabled */
+static void *_mp_mem_pop(mp_mem_class_t *cls, const char *owner) {
+	void *chunk = cls->free;
+
+	if(chunk == NULL)
+		return(NULL);
+
+	cls->free = *(void **)chunk;
+	cls->freeNumber--;
+	if(cls->freeNumber < cls->minFree)
+		cls->minFree = cls->freeNumber;
+	_MEM_CANARY(cls, chunk) = MEM_CANARY;
+#ifdef MP_MEM_STATS
+	_MEM_OWNER(cls, chunk) = owner;
 #endif
 
-	/* prepare linked list */
-	for(a=0; a<(MP_MEM_SIZE/sizeof(mp_mem_chunk_t))-1; chunk++, a++) {
-		memset(&chunk->item, 0, sizeof(chunk->item));
-		chunk->canary = MEM_CANARY;
-		chunk->id = a;
-		mp_list_add_last(&__mem_free_root, &chunk->item, chunk);
+	__mem_stats.chunks++;
+	if(__mem_stats.chunks > __mem_stats.peakChunks)
+		__mem_stats.peakChunks = __mem_stats.chunks;
+	__mem_stats.used += cls->size;
+	if(__mem_stats.used > __mem_stats.peak)
+		__mem_stats.peak = __mem_stats.used;
+
+	return(chunk);
+}
+
+static void *_mp_mem_get(int size, const char *owner) {
+	mp_mem_class_t *cls;
+	void *chunk = NULL;
 
+	/* smallest class fitting with a free chunk */
+	MP_INTERRUPT_SAFE_BEGIN
+	for(cls=__mem_classes; cls<__mem_classes+_MEM_CLASSES && chunk==NULL; cls++) {
+		if(cls->size >= size)
+			chunk = _mp_mem_pop(cls, owner);
 	}
+	MP_INTERRUPT_SAFE_END
 
-	return(TRUE);
+	if(chunk != NULL)
+		memset(chunk, 0, size);
+
+	return(chunk);
 }
 
-/**@}*/
+static mp_mem_class_t *_mp_mem_class(void *ptr) {
+	mp_mem_class_t *cls;
+	unsigned char *chunk = ptr;
+
+	if(chunk >= __mem_isr.start && chunk < __mem_isr.end) {
+		if((chunk-__mem_isr.start)%__mem_isr.stride != 0)
+			return(NULL);
+		return(&__mem_isr);
+	}
+
+	for(cls=__mem_classes; cls<__mem_classes+_MEM_CLASSES; cls++) {
+		if(chunk >= cls->start && chunk < cls->end) {
+			if((chunk-cls->start)%cls->stride != 0)
+				return(NULL);
+			return(cls);
+		}
+	}
+	return(NULL);
+}
+
+static void _mp_mem_dump_class(mp_mem_class_t *cls, const char *name) {
+#ifdef MP_MEM_STATS
+	unsigned char *chunk;
+	unsigned char *prev;
+	const char *owner;
+	int number;
+#endif
+
+	mp_printk("Mem %s %u: %u/%u free, %u lowest",
+		name, cls->size, cls->freeNumber, cls->number, cls->minFree
+	);
+
+#ifdef MP_MEM_STATS
+	/* one line per owner, counted at its first chunk */
+	for(chunk=cls->start; chunk<cls->end; chunk+=cls->stride) {
+		if(_MEM_CANARY(cls, chunk) != MEM_CANARY)
+			continue;
+		owner = _MEM_OWNER(cls, chunk);
+
+		for(prev=cls->start; prev<chunk; prev+=cls->stride) {
+			if(_MEM_CANARY(cls, prev) == MEM_CANARY && _MEM_OWNER(cls, prev) == owner)
+				break;
+		}
+		if(prev < chunk)
+			continue;
+
+		number = 0;
+		for(prev=chunk; prev<cls->end; prev+=cls->stride) {
+			if(_MEM_CANARY(cls, prev) == MEM_CANARY && _MEM_OWNER(cls, prev) == owner)
+				number++;
+		}
+
+		mp_printk("Mem %s %u: %d chunks held by %s",
+			name, cls->size, number, owner ? owner : "unknown"
+		);
+	}
+#endif
+}
 
 #endif
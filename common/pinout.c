@@ -2,21 +2,13 @@
 
 #ifdef SUPPORT_COMMON_PINOUT
 
-MP_TASK(onoffLive);
-MP_TASK(onoffStep);
+static void _mp_pinout_live(mp_ktimer_t *timer);
+static void _mp_pinout_step(mp_ktimer_t *timer);
 
-MP_TASK(onoffLive) {
-	mp_pinout_t *pinout = task->user;
+static void _mp_pinout_live(mp_ktimer_t *timer) {
+	mp_pinout_t *pinout = timer->user;
 	char turn;
 
-	/* acknowledge task end */
-	if(task->signal == MP_TASK_SIG_STOP) {
-		mp_gpio_unset(pinout->gpio);
-		mp_mem_free(pinout->kernel, pinout);
-		mp_task_signal(task, MP_TASK_SIG_DEAD);
-		return;
-	}
-
 	turn = pinout->turn == ON ? OFF : ON;
 	if(turn == ON)
 		mp_gpio_set(pinout->gpio);
@@ -25,26 +17,13 @@ MP_TASK(onoffLive) {
 
 	//mp_printk("Live pinout turn=%s count=%d", turn == ON ? "ON" : "OFF", pinout->count);
 
-	if(pinout->repeat >= 0) {
-		pinout->task->wakeup = onoffStep;
-		pinout->task->delay = pinout->step;
-		return;
-	}
-
-	mp_task_signal(task, MP_TASK_SIG_STOP);
+	if(pinout->repeat >= 0)
+		mp_ktimer_start(pinout->kernel, &pinout->timer, timer->name, pinout->step, 0, _mp_pinout_step, pinout);
 }
 
 
-MP_TASK(onoffStep) {
-	mp_pinout_t *pinout = task->user;
-
-	/* acknowledge task end */
-	if(task->signal == MP_TASK_SIG_STOP) {
-		mp_gpio_unset(pinout->gpio);
-		mp_mem_free(pinout->kernel, pinout);
-		mp_task_signal(task, MP_TASK_SIG_DEAD);
-		return;
-	}
+static void _mp_pinout_step(mp_ktimer_t *timer) {
+	mp_pinout_t *pinout = timer->user;
 
 	if(pinout->turn == ON)
 		mp_gpio_set(pinout->gpio);
@@ -54,45 +33,43 @@ MP_TASK(onoffStep) {
 	//mp_printk("Step pinout turn=%s", pinout->turn == ON ? "ON" : "OFF");
 
 	if(pinout->live > 0) {
-		/* change wakeup task */
-		pinout->task->wakeup = onoffLive;
-		pinout->task->delay = pinout->live;
+		mp_ktimer_start(pinout->kernel, &pinout->timer, timer->name, pinout->live, 0, _mp_pinout_live, pinout);
 		pinout->count++;
-		return;
 	}
-
-	mp_task_signal(task, MP_TASK_SIG_STOP);
 }
 
 /**
   * manipulate async ON/OFF pinout
   * @param kernel The kernel context
-  * @param type type of pinouts enumerate in mp_pinout_led_t
+  * @param pinout Pinout context, owned by the caller
+  * @param gpio The device pinout
   * @param turn if ON then pinout device will be set to ON, OFF turns off.
   * @param live number of time before to reverse position (0 no reverse position)
   * @param step delay before to repeat again
   * @param repeat  -1 = no repeat | 0 = infinite repeat more than 0 count
-  * @return The task used to schedule the device
+  * @param who Name of the timer
+  * @return TRUE if the device is scheduled
+  *
+  * The pinout can be scheduled again, a running sequence is stopped first.
+  * It must be zeroed before its first use.
   */
-mp_task_t *mp_pinout_onoff(mp_kernel_t *kernel, mp_gpio_port_t *gpio, char turn, int live, int step, int repeat, char *who) {
-	mp_pinout_t *pinout;
-
-	if(step > 0) {
-		pinout = mp_mem_alloc(kernel, sizeof(*pinout));
-		if(pinout == NULL)
-			return(NULL);
-		memset(pinout, 0, sizeof(*pinout));
+mp_ret_t mp_pinout_onoff(mp_kernel_t *kernel, mp_pinout_t *pinout, mp_gpio_port_t *gpio, char turn, int live, int step, int repeat, char *who) {
+	/* unlink the timer from the wheel before wiping it */
+	if(mp_ktimer_armed(&pinout->timer) == YES)
+		mp_ktimer_stop(kernel, &pinout->timer);
 
-		pinout->kernel = kernel;
-		pinout->gpio = gpio;
-		pinout->turn = turn;
-		pinout->live = live;
-		pinout->step = step;
-		pinout->repeat = repeat;
+	memset(pinout, 0, sizeof(*pinout));
 
-		pinout->task = mp_task_create(&kernel->tasks, who, onoffStep, pinout, step);
+	pinout->kernel = kernel;
+	pinout->gpio = gpio;
+	pinout->turn = turn;
+	pinout->live = live;
+	pinout->step = step;
+	pinout->repeat = repeat;
 
-		return(pinout->task);
+	if(step > 0) {
+		mp_ktimer_start(kernel, &pinout->timer, who, step, 0, _mp_pinout_step, pinout);
+		return(TRUE);
 	}
 	else {
 		if(turn == ON)
@@ -103,26 +80,21 @@ mp_task_t *mp_pinout_onoff(mp_kernel_t *kernel, mp_gpio_port_t *gpio, char turn,
 	}
 
 	if(live > 0) {
-		pinout = mp_mem_alloc(kernel, sizeof(*pinout));
-		if(pinout == NULL)
-			return(NULL);
-
-		memset(pinout, 0, sizeof(*pinout));
-
-		pinout->kernel = kernel;
-		pinout->gpio = gpio;
-		pinout->turn = turn;
-		pinout->live = live;
-		pinout->step = step;
-		pinout->repeat = repeat;
-
-		pinout->task = mp_task_create(&kernel->tasks, who, onoffLive, pinout, live);
-
-		return(pinout->task);
+		mp_ktimer_start(kernel, &pinout->timer, who, live, 0, _mp_pinout_live, pinout);
+		return(TRUE);
 	}
 
 
-	return(NULL);
+	return(FALSE);
+}
+
+/**
+  * stop an async ON/OFF pinout and turn the device off
+  * @param pinout Pinout context
+  */
+void mp_pinout_stop(mp_pinout_t *pinout) {
+	mp_ktimer_stop(pinout->kernel, &pinout->timer);
+	mp_gpio_unset(pinout->gpio);
 }
 
 #endif
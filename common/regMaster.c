@@ -22,38 +22,47 @@
 #include <mp.h>
 
 /* i2c master side implementation */
-static void _mp_regMaster_i2c_enableRX(mp_regMaster_t *cirr);
-static void _mp_regMaster_i2c_disableRX(mp_regMaster_t *cirr);
-static void _mp_regMaster_i2c_enableTX(mp_regMaster_t *cirr);
-static void _mp_regMaster_i2c_disableTX(mp_regMaster_t *cirr);
+static void _mp_regMaster_i2c_enableRX(mp_regMaster_bus_t *bus);
+static void _mp_regMaster_i2c_disableRX(mp_regMaster_bus_t *bus);
+static void _mp_regMaster_i2c_enableTX(mp_regMaster_bus_t *bus);
+static void _mp_regMaster_i2c_disableTX(mp_regMaster_bus_t *bus);
 static void _mp_regMaster_i2c_interrupt(mp_i2c_t *i2c, mp_i2c_flag_t flag);
-static void _mp_regMaster_i2c_asr(mp_regMaster_t *cirr, mp_regMaster_op_t *cur);
-
-static void _mp_regMaster_spi_enableRX(mp_regMaster_t *cirr);
-static void _mp_regMaster_spi_disableRX(mp_regMaster_t *cirr);
-static void _mp_regMaster_spi_enableTX(mp_regMaster_t *cirr);
-static void _mp_regMaster_spi_disableTX(mp_regMaster_t *cirr);
+static void _mp_regMaster_i2c_asr(mp_regMaster_bus_t *bus, mp_regMaster_op_t *cur);
+static void _mp_regMaster_i2c_rxStart(mp_regMaster_bus_t *bus, mp_regMaster_op_t *cur);
+static void _mp_regMaster_i2c_abort(mp_regMaster_bus_t *bus, mp_regMaster_op_t *cur, mp_regMaster_error_t error);
+
+static void _mp_regMaster_spi_enableRX(mp_regMaster_bus_t *bus);
+static void _mp_regMaster_spi_disableRX(mp_regMaster_bus_t *bus);
+static void _mp_regMaster_spi_enableTX(mp_regMaster_bus_t *bus);
+static void _mp_regMaster_spi_disableTX(mp_regMaster_bus_t *bus);
 static void _mp_regMaster_spi_interrupt(mp_spi_t *spi, mp_spi_iv_t iv);
-static void _mp_regMaster_spi_asr(mp_regMaster_t *cirr, mp_regMaster_op_t *cur);
+static void _mp_regMaster_spi_asr(mp_regMaster_bus_t *bus, mp_regMaster_op_t *cur);
+static void _mp_regMaster_spi_abort(mp_regMaster_bus_t *bus, mp_regMaster_op_t *cur, mp_regMaster_error_t error);
 
 MP_TASK(mp_regMaster_asr);
 
-static unsigned char _registers[256];
-static int _register_references = 0;
-
-static void _mp_regMaster_ginit(mp_kernel_t *kernel) {
-	int a;
-
-	for(a=0; a<256; a++)
-		_registers[a] = a;
-
-	_register_references++;
-}
-
-static void _mp_regMaster_gfini(mp_kernel_t *kernel) {
-	_register_references--;
-
-}
+static void _mp_regMaster_bus_i2c(mp_kernel_t *kernel, mp_regMaster_bus_t *bus, mp_i2c_t *i2c, char *who);
+static void _mp_regMaster_bus_spi(mp_kernel_t *kernel, mp_regMaster_bus_t *bus, mp_spi_t *spi, char *who);
+static mp_ret_t _mp_regMaster_attach(mp_kernel_t *kernel, mp_regMaster_t *cirr, mp_regMaster_bus_t *bus, mp_regMaster_op_t *ops, int opsSize, void *user, char *who);
+static void _mp_regMaster_detach(mp_regMaster_t *cirr);
+static void _mp_regMaster_leave(mp_regMaster_bus_t *bus, mp_regMaster_t *cirr);
+static void _mp_regMaster_pool(mp_regMaster_t *cirr, mp_regMaster_op_t *ops, int opsSize);
+static mp_regMaster_op_t *_mp_regMaster_operand(mp_regMaster_t *cirr, unsigned char lane);
+static void _mp_regMaster_release(mp_regMaster_t *cirr, mp_regMaster_op_t *operand);
+static void _mp_regMaster_push(mp_regMaster_t *cirr, mp_regMaster_op_t *operand);
+static mp_regMaster_t *_mp_regMaster_elect(mp_regMaster_bus_t *bus, unsigned char lane);
+static void _mp_regMaster_next(mp_regMaster_bus_t *bus);
+static void _mp_regMaster_end(mp_regMaster_bus_t *bus, mp_regMaster_op_t *operand);
+static void _mp_regMaster_done(mp_regMaster_bus_t *bus, mp_regMaster_op_t *operand);
+static void _mp_regMaster_fail(mp_regMaster_bus_t *bus, mp_regMaster_op_t *operand, mp_regMaster_error_t error);
+static void _mp_regMaster_watchdog(mp_ktimer_t *timer);
+static void _mp_regMaster_flush(mp_regMaster_t *cirr, mp_list_t *list);
+
+/* registered shared buses */
+static mp_list_t __buses;
+
+/* last client id, traced instead of the context address */
+static unsigned short __clientId;
 
 /**
 @defgroup mpCommonRegMaster Register Master communication
@@ -78,6 +87,7 @@ struct mp_drv_MPL3115A2_s {
 
 	mp_i2c_t i2c;
 	mp_regMaster_t regMaster;
+	mp_regMaster_op_t regMasterOps[MP_REGMASTER_OPS];
 
 	// [...]
 };
@@ -88,7 +98,8 @@ Here is an example using I2C
 
 @code
 ret = mp_regMaster_init_i2c(kernel, &MPL3115A2->regMaster,
-		&MPL3115A2->i2c, MPL3115A2, "MPL3115A2 I2C");
+		&MPL3115A2->i2c, MPL3115A2->regMasterOps, MP_REGMASTER_OPS,
+		MPL3115A2, "MPL3115A2 I2C");
 if(ret == FALSE) {
 	mp_printk("MPL3115A2 error while creating regMaster context");
 	mp_i2c_close(&MPL3115A2->i2c);
@@ -96,6 +107,15 @@ if(ret == FALSE) {
 }
 @endcode
 
+Operands are taken from the pool given at init, regMaster never
+touches the HEAP. An operand goes back to the pool once its callback
+returned, so size the pool for the longest burst a driver queues.
+When the pool is empty the enqueue functions return MP_REGMASTER_FULL
+and count the refusal in cirr->full, nothing is queued. Any result but
+TRUE is a failure. The pool is taken and refilled with interrupts
+disabled, then operations can be queued from an ISR (e.g. a DRDY
+interrupt) as well as from a task.
+
 
 In regMaster a read operation comes with a write before to read.
 This is how register communication works.
@@ -105,18 +125,25 @@ register(s) to write and the data to receive.
 The allocation of those pointers are not managed by regMaster then you
 will have to control the buffer by yourself.
 
-There are two ways to control it. Use a .bss pointer which doesn't
-need to be free as followed :
+Small transfers don't need any buffer. The *Reg() helpers copy the
+register and the value into the operand (up to MP_REGMASTER_PAYLOAD bytes)
+as followed :
 @code
-mp_regMaster_read(
+mp_regMaster_readReg(
 	&MPL3115A2->regMaster,
-	&_registers[MPL3115A2_WHO_AM_I], 1,
+	MPL3115A2_WHO_AM_I,
 	(unsigned char *)&MPL3115A2->whoIam, 1,
 	_mp_drv_MPL3115A2_onWhoIAm, MPL3115A2
 );
+
+mp_regMaster_writeReg(
+	&MPL3115A2->regMaster,
+	MPL3115A2_PT_DATA_CFG, 0x07,
+	NULL, NULL
+);
 @endcode
 
-Or use an allocated memory space in the HEAP to receive or emit information
+For larger transfers use an allocated memory space in the HEAP to receive or emit information
 and then you will have to the end callback to free the buffer :
 @code
 void _mp_drv_MPL3115A2_writeControl(mp_regMaster_op_t *operand, mp_bool_t terminate) {
@@ -141,117 +168,342 @@ mp_regMaster_write(
 );
 @endcode
 
+Operations are executed back-to-back. The interrupt which ends an
+operation starts the next pending one (with a repeated start after an
+I2C write) and the ASR task delivers the callbacks of all the ended
+operations in one run. Set bus->chain to NO to start every operation
+from the ASR instead.
+
+Several devices wired on one gate share a bus. The application opens
+the interface once and registers the bus, then each driver given this
+gate joins it as a client, with its own slave address or chip select,
+operand pool and ASR task, instead of opening the gate again :
+@code
+mp_i2c_open(kernel, &olimex->sensorsI2C, options, "Sensors");
+mp_i2c_setup(&olimex->sensorsI2C, setup);
+mp_regMaster_bus_init_i2c(kernel, &olimex->sensors, &olimex->sensorsI2C, "Sensors bus");
+
+// [...] in the driver, joins the shared bus or opens the gate
+ret = mp_regMaster_init_gate(kernel, &MPL3115A2->regMaster,
+		options, &MPL3115A2->i2c,
+		MPL3115A2->regMasterOps, MP_REGMASTER_OPS,
+		MPL3115A2, "MPL3115A2 I2C");
+mp_regMaster_setSlaveAddress(&MPL3115A2->regMaster, MPL3115A2_ADDRESS);
+@endcode
+
+The application terminates the drivers first, then the bus and the
+interface. Clients whose ASR did not run yet are detached by
+mp_regMaster_bus_fini() :
+@code
+mp_drv_INA219_fini(&olimex->ina219);
+mp_regMaster_bus_fini(&olimex->sensors);
+mp_i2c_close(&olimex->sensorsI2C);
+@endcode
+
+The bus owns the only interrupt handler of the gate. Each time it gets
+idle it elects the pending client with the highest priority (see
+mp_regMaster_setPriority()) and serves clients of equal priority round
+robin, one operand each, then a chatty device can not starve the others.
+
+Every bus has two lanes. Each operation is queued in the lane given
+at enqueue: mp_regMaster_readExt() and mp_regMaster_readRegExt() take
+it, the other functions use @ref MP_REGMASTER_LANE_BG. Drivers read
+their samples in @ref MP_REGMASTER_LANE_RT then a DRDY read never
+waits behind a configuration or a register dump. The lane is not a
+client state, a DRDY interrupt and a task can queue on the same client :
+@code
+mp_regMaster_readRegExt(&TMP006->regMaster, TMP006_REG_VOBJ,
+	(unsigned char *)&TMP006->rawVoltage, 2,
+	_mp_drv_TMP006_onRawVoltage, TMP006,
+	TRUE, MP_REGMASTER_LANE_RT);
+@endcode
+
+The bus elects the lane first, then the client in this lane. The RT lane
+is served first but after MP_REGMASTER_WEIGHT RT operands in a row one
+waiting BG operand goes (see mp_regMaster_setWeight(), 0 is strict).
+Build with MP_REGMASTER_STATS to account the queueing delay of each lane
+(see mp_regMaster_stats_dump()).
+
+A NACK, an arbitration lost or an operand owning the bus longer than
+MP_REGMASTER_TIMEOUT ticks (see mp_regMaster_setTimeout()) aborts the
+transfer. The bus ends a NACK with a stop, resets the USCI after an
+arbitration lost and recovers the I2C bus after a timeout (nine SCL
+clocks then a USCI reset). The operand is restarted up to
+MP_REGMASTER_RETRIES times (see mp_regMaster_setRetries()) then its
+callback gets terminate set to TRUE and the reason in operand->error :
+@code
+static void _mp_drv_XXX_onRead(mp_regMaster_op_t *operand, mp_bool_t terminate) {
+	if(terminate == TRUE) {
+		if(operand->error != MP_REGMASTER_ERR_STOP)
+			mp_printk("XXX: read failed with error %d", operand->error);
+		return;
+	}
+	// [...]
+}
+@endcode
+
 @{
 */
 
 /**
- * @brief Initiate circular register context
+ * @brief Initiate a shared I2C bus
  *
- * This initiates a circular register context
+ * The bus takes the interrupt of an opened and setup interface
+ * and is registered under its gate name for mp_regMaster_bus_handle().
  *
  * @param[in] kernel Kernel handler
- * @param[in] cirr Circular context.
- * @param[in] user User pointer embedded
+ * @param[in] bus Bus context
+ * @param[in] i2c Opened I2C interface
+ * @param[in] who Bus name
  */
-mp_ret_t mp_regMaster_init_i2c(
-		mp_kernel_t *kernel, mp_regMaster_t *cirr,
+mp_ret_t mp_regMaster_bus_init_i2c(
+		mp_kernel_t *kernel, mp_regMaster_bus_t *bus,
 		mp_i2c_t *i2c,
-		void *user,
 		char *who
 	) {
-	memset(cirr, 0, sizeof(*cirr));
+	if(mp_regMaster_bus_handle(i2c->gate->portDevice)) {
+		mp_printk("regMaster: gate %s has already a bus", i2c->gate->portDevice);
+		return(FALSE);
+	}
 
-	/* run ginit */
-	_mp_regMaster_ginit(kernel);
+	_mp_regMaster_bus_i2c(kernel, bus, i2c, who);
 
-	cirr->kernel = kernel;
+	mp_list_add_last(&__buses, &bus->item, bus);
+	return(TRUE);
+}
 
-	mp_list_init(&cirr->pending);
-	mp_list_init(&cirr->executing);
+/**
+ * @brief Initiate a shared SPI bus
+ *
+ * Same as mp_regMaster_bus_init_i2c(), clients are selected
+ * by their chip select.
+ *
+ * @param[in] kernel Kernel handler
+ * @param[in] bus Bus context
+ * @param[in] spi Opened SPI interface
+ * @param[in] who Bus name
+ */
+mp_ret_t mp_regMaster_bus_init_spi(
+		mp_kernel_t *kernel, mp_regMaster_bus_t *bus,
+		mp_spi_t *spi,
+		char *who
+	) {
+	if(mp_regMaster_bus_handle(spi->gate->portDevice)) {
+		mp_printk("regMaster: gate %s has already a bus", spi->gate->portDevice);
+		return(FALSE);
+	}
 
-	cirr->enableRX = _mp_regMaster_i2c_enableRX;
-	cirr->disableRX = _mp_regMaster_i2c_disableRX;
+	_mp_regMaster_bus_spi(kernel, bus, spi, who);
 
-	cirr->enableTX = _mp_regMaster_i2c_enableTX;
-	cirr->disableTX = _mp_regMaster_i2c_disableTX;
+	mp_list_add_last(&__buses, &bus->item, bus);
+	return(TRUE);
+}
 
-	cirr->asrCallback = _mp_regMaster_i2c_asr;
+/**
+ * @brief Terminate a shared bus
+ *
+ * Call it once the drivers of the clients have been terminated,
+ * the interface is left open and can be closed after. Clients
+ * still attached (their ASR has not run yet) are detached, their
+ * operands end with @ref MP_REGMASTER_ERR_STOP and any new
+ * operation is refused.
+ *
+ * @param[in] bus Bus context
+ */
+void mp_regMaster_bus_fini(mp_regMaster_bus_t *bus) {
+	mp_regMaster_t *cirr;
+
+	/* the interrupt elects the clients */
+	MP_INTERRUPT_SAFE_BEGIN
+	while(bus->clients.first) {
+		cirr = bus->clients.first->user;
+		_mp_regMaster_leave(bus, cirr);
+		cirr->bus = NULL;
+
+		/* its ASR flushes the operands, a stopping one does it anyway */
+		if(cirr->asr->signal == MP_TASK_SIG_SLEEP)
+			mp_task_signal(cirr->asr, MP_TASK_SIG_PENDING);
+	}
+	MP_INTERRUPT_SAFE_END
 
-	cirr->user = user;
+	bus->disableRX(bus);
+	bus->disableTX(bus);
 
-	cirr->i2c = i2c;
-	cirr->i2c->user = cirr;
+	mp_ktimer_stop(bus->kernel, &bus->watchdog);
 
-	cirr->disableRX(cirr);
-	cirr->disableRX(cirr);
+	mp_list_remove(&__buses, &bus->item);
+}
 
-	mp_i2c_setInterruption(i2c, _mp_regMaster_i2c_interrupt);
+/**
+ * @brief Get the shared bus of a gate
+ *
+ * @param[in] gate Gate name (e.g. USCI_B3) or NULL
+ * @return Bus context or NULL
+ */
+mp_regMaster_bus_t *mp_regMaster_bus_handle(char *gate) {
+	mp_regMaster_bus_t *bus;
+	mp_list_item_t *item;
+	mp_gate_t *g;
+
+	if(!gate)
+		return(NULL);
+
+	for(item=__buses.first; item; item=item->next) {
+		bus = item->user;
+		g = bus->type == MP_REGMASTER_I2C ? bus->i2c->gate : bus->spi->gate;
+		if(strcmp(gate, g->portDevice) == 0)
+			return(bus);
+	}
+	return(NULL);
+}
 
-	cirr->type = MP_REGMASTER_I2C;
+/**
+ * @brief Set the operand timeout of a bus
+ *
+ * The watchdog is armed when an operand takes the bus and stopped
+ * when it leaves it, an idle bus does not wake up the kernel. An
+ * operand owning the bus for timeout ticks fails, an I2C bus is
+ * recovered. The new timeout applies from the next started operand.
+ *
+ * @param[in] bus Bus context
+ * @param[in] timeout Ticks, @ref MP_REGMASTER_TIMEOUT by default, 0 disables
+ */
+void mp_regMaster_setTimeout(mp_regMaster_bus_t *bus, unsigned long timeout) {
+	bus->timeout = timeout;
+
+	if(timeout == 0)
+		mp_ktimer_stop(bus->kernel, &bus->watchdog);
+}
+
+/**
+ * @brief Initiate circular register context
+ *
+ * This initiates a circular register context owning
+ * a private bus on the I2C interface.
+ *
+ * @param[in] kernel Kernel handler
+ * @param[in] cirr Circular context.
+ * @param[in] i2c Opened I2C interface
+ * @param[in] ops Operand pool
+ * @param[in] opsSize Number of operands in the pool
+ * @param[in] user User pointer embedded
+ */
+mp_ret_t mp_regMaster_init_i2c(
+		mp_kernel_t *kernel, mp_regMaster_t *cirr,
+		mp_i2c_t *i2c,
+		mp_regMaster_op_t *ops, int opsSize,
+		void *user,
+		char *who
+	) {
+	memset(cirr, 0, sizeof(*cirr));
 
 	/* save actual slave address */
-	cirr->slaveAddress = mp_i2c_getSlaveAddress(cirr->i2c);
+	cirr->slaveAddress = mp_i2c_getSlaveAddress(i2c);
 
-	/* create task and place it in sleep mode */
-	cirr->asr = mp_task_create(&kernel->tasks, who, mp_regMaster_asr, cirr, 1000);
-	if(!cirr->asr)
-		return(FALSE);
+	_mp_regMaster_bus_i2c(kernel, &cirr->own, i2c, who);
 
-	mp_task_signal(cirr->asr, MP_TASK_SIG_SLEEP);
-	return(TRUE);
+	return(_mp_regMaster_attach(kernel, cirr, &cirr->own, ops, opsSize, user, who));
 }
 
 /**
  * @brief Initiate circular register context
  *
- * This initiates a circular register context
+ * This initiates a circular register context owning
+ * a private bus on the SPI interface.
  *
  * @param[in] kernel Kernel handler
  * @param[in] cirr Circular context.
+ * @param[in] spi Opened SPI interface
+ * @param[in] ops Operand pool
+ * @param[in] opsSize Number of operands in the pool
  * @param[in] user User pointer embedded
  */
 mp_ret_t mp_regMaster_init_spi(
 		mp_kernel_t *kernel, mp_regMaster_t *cirr,
 		mp_spi_t *spi,
+		mp_regMaster_op_t *ops, int opsSize,
 		void *user,
 		char *who
 	) {
 	memset(cirr, 0, sizeof(*cirr));
 
-	/* run ginit */
-	_mp_regMaster_ginit(kernel);
-
-	cirr->kernel = kernel;
-
-	mp_list_init(&cirr->pending);
-	mp_list_init(&cirr->executing);
-
-	cirr->enableRX = _mp_regMaster_spi_enableRX;
-	cirr->disableRX = _mp_regMaster_spi_disableRX;
-
-	cirr->enableTX = _mp_regMaster_spi_enableTX;
-	cirr->disableTX = _mp_regMaster_spi_disableTX;
-
-	cirr->asrCallback = _mp_regMaster_spi_asr;
+	_mp_regMaster_bus_spi(kernel, &cirr->own, spi, who);
 
-	cirr->user = user;
+	return(_mp_regMaster_attach(kernel, cirr, &cirr->own, ops, opsSize, user, who));
+}
 
-	cirr->spi = spi;
-	cirr->spi->user = cirr;
+/**
+ * @brief Initiate circular register context on a shared bus
+ *
+ * The context joins the bus as a new client. Set its slave
+ * address or chip select before queuing operations.
+ *
+ * @param[in] kernel Kernel handler
+ * @param[in] cirr Circular context.
+ * @param[in] bus Shared bus
+ * @param[in] ops Operand pool
+ * @param[in] opsSize Number of operands in the pool
+ * @param[in] user User pointer embedded
+ */
+mp_ret_t mp_regMaster_init_bus(
+		mp_kernel_t *kernel, mp_regMaster_t *cirr,
+		mp_regMaster_bus_t *bus,
+		mp_regMaster_op_t *ops, int opsSize,
+		void *user,
+		char *who
+	) {
+	memset(cirr, 0, sizeof(*cirr));
 
-	cirr->disableRX(cirr);
-	cirr->disableRX(cirr);
+	if(!bus)
+		return(FALSE);
 
-	mp_spi_setInterruption(spi, _mp_regMaster_spi_interrupt);
+	return(_mp_regMaster_attach(kernel, cirr, bus, ops, opsSize, user, who));
+}
 
-	cirr->type = MP_REGMASTER_SPI;
+/**
+ * @brief Initiate circular register context on the I2C gate of the options
+ *
+ * Joins the shared bus registered on the "gate" option, otherwise
+ * opens i2c as a 400kHz master and owns it as a private bus. On
+ * failure nothing is left opened. After success the client closes
+ * i2c on exit only when mp_regMaster_shared() is NO.
+ *
+ * @param[in] kernel Kernel handler
+ * @param[in] cirr Circular context.
+ * @param[in] options Driver options giving the gate
+ * @param[in] i2c I2C interface to open when the gate is not shared
+ * @param[in] ops Operand pool
+ * @param[in] opsSize Number of operands in the pool
+ * @param[in] user User pointer embedded
+ * @return TRUE or FALSE
+ */
+mp_ret_t mp_regMaster_init_gate(
+		mp_kernel_t *kernel, mp_regMaster_t *cirr,
+		mp_options_t *options, mp_i2c_t *i2c,
+		mp_regMaster_op_t *ops, int opsSize,
+		void *user,
+		char *who
+	) {
+	mp_regMaster_bus_t *bus;
+	mp_options_t setup[] = {
+		{ "frequency", "400000" },
+		{ "role", "master" },
+		{ NULL, NULL }
+	};
+
+	bus = mp_regMaster_bus_handle(mp_options_get(options, "gate"));
+	if(bus)
+		return(mp_regMaster_init_bus(kernel, cirr, bus, ops, opsSize, user, who));
+
+	if(mp_i2c_open(kernel, i2c, options, who) == FALSE)
+		return(FALSE);
 
-	/* create task and place it in sleep mode */
-	cirr->asr = mp_task_create(&kernel->tasks, who, mp_regMaster_asr, cirr, 1000);
-	if(!cirr->asr)
+	if(mp_i2c_setup(i2c, setup) == FALSE ||
+			mp_regMaster_init_i2c(kernel, cirr, i2c, ops, opsSize, user, who) == FALSE) {
+		mp_i2c_close(i2c);
 		return(FALSE);
+	}
 
-	mp_task_signal(cirr->asr, MP_TASK_SIG_SLEEP);
 	return(TRUE);
 }
 
@@ -265,13 +517,9 @@ mp_ret_t mp_regMaster_init_spi(
 void mp_regMaster_fini(mp_regMaster_t *cirr) {
 
 	/* regMaster is destructed using ASR task then
-	 * we just send stop signal and disable interrupts */
+	 * we just send stop signal, the ASR leaves the bus */
 	if(cirr->asr)
 		mp_task_destroy(cirr->asr);
-	if(cirr->disableRX)
-		cirr->disableRX(cirr);
-	if(cirr->disableTX)
-		cirr->disableTX(cirr);
 }
 
 
@@ -294,46 +542,92 @@ void mp_regMaster_fini(mp_regMaster_t *cirr) {
  * @param[in] callback Callback executed on the end of operation
  * @param[in] user User pointer embedded and passed as argument
  * @param[in] swap set to TRUE to swap RX buffer
+ * @param[in] lane Queue lane, @ref MP_REGMASTER_LANE_RT for samples
  */
 mp_ret_t mp_regMaster_readExt(
 		mp_regMaster_t *cirr,
 		unsigned char *reg, int regSize,
 		unsigned char *wait, int waitSize,
 		mp_regMaster_cb_t callback, void *user,
-		mp_bool_t swap
+		mp_bool_t swap, unsigned char lane
 	) {
 	mp_regMaster_op_t *operand;
 
-	/* allocate new operand */
-	operand = mp_mem_alloc(cirr->kernel, sizeof(*operand));
-	memset(operand, 0, sizeof(*operand));
-
-	if(cirr->type == MP_REGMASTER_I2C)
-		operand->slaveAddress = cirr->slaveAddress;
-	else
-		operand->chipSelect = cirr->chipSelect;
+	/* the bus has been terminated */
+	if(!cirr->bus)
+		return(FALSE);
 
-	operand->state = MP_REGMASTER_STATE_TX;
+	operand = _mp_regMaster_operand(cirr, lane);
+	if(!operand)
+		return(MP_REGMASTER_FULL);
 
 	operand->reg = reg;
 	operand->regSize = regSize;
-	operand->regPos = 0;
 
 	operand->wait = wait;
 	operand->waitSize = waitSize;
-	operand->waitPos = 0;
 
 	operand->callback = callback;
 	operand->user = user;
 
 	operand->swap = swap;
 
-	/* add operand at last pending */
-	mp_list_add_last(&cirr->pending, &operand->item, operand);
+	_mp_regMaster_push(cirr, operand);
+	return(TRUE);
+}
 
-	/* tell to the scheduler task pending */
-	mp_task_signal(cirr->asr, MP_TASK_SIG_PENDING);
+/**
+ * @brief Extended register read operation
+ *
+ * Same as mp_regMaster_readExt() but the register is copied
+ * into the operand. When wait is NULL the data are received
+ * into the operand too, then the callback finds them in
+ * operand->wait (up to MP_REGMASTER_PAYLOAD-1 bytes).
+ *
+ * @param[in] cirr Circular context.
+ * @param[in] reg Register to write
+ * @param[out] wait Buffer to fill or NULL
+ * @param[in] waitSize Number of bytes to read
+ * @param[in] callback Callback executed on the end of operation
+ * @param[in] user User pointer embedded and passed as argument
+ * @param[in] swap set to TRUE to swap RX buffer
+ * @param[in] lane Queue lane, @ref MP_REGMASTER_LANE_RT for samples
+ */
+mp_ret_t mp_regMaster_readRegExt(
+		mp_regMaster_t *cirr,
+		unsigned char reg,
+		unsigned char *wait, int waitSize,
+		mp_regMaster_cb_t callback, void *user,
+		mp_bool_t swap, unsigned char lane
+	) {
+	mp_regMaster_op_t *operand;
+
+	if(!wait && waitSize > MP_REGMASTER_PAYLOAD-1) {
+		mp_printk("regMaster(%p): inline read of %d bytes is too large", cirr, waitSize);
+		return(FALSE);
+	}
+
+	/* the bus has been terminated */
+	if(!cirr->bus)
+		return(FALSE);
+
+	operand = _mp_regMaster_operand(cirr, lane);
+	if(!operand)
+		return(MP_REGMASTER_FULL);
 
+	operand->payload[0] = reg;
+	operand->reg = operand->payload;
+	operand->regSize = 1;
+
+	operand->wait = wait ? wait : operand->payload+1;
+	operand->waitSize = waitSize;
+
+	operand->callback = callback;
+	operand->user = user;
+
+	operand->swap = swap;
+
+	_mp_regMaster_push(cirr, operand);
 	return(TRUE);
 }
 
@@ -355,101 +649,559 @@ mp_ret_t mp_regMaster_write(
 	) {
 	mp_regMaster_op_t *operand;
 
-	/* allocate new operand */
-	operand = mp_mem_alloc(cirr->kernel, sizeof(*operand));
-	memset(operand, 0, sizeof(*operand));
-
-	if(cirr->type == MP_REGMASTER_I2C)
-		operand->slaveAddress = cirr->slaveAddress;
-	else
-		operand->chipSelect = cirr->chipSelect;
+	/* the bus has been terminated */
+	if(!cirr->bus)
+		return(FALSE);
 
-	operand->state = MP_REGMASTER_STATE_TX;
+	operand = _mp_regMaster_operand(cirr, MP_REGMASTER_LANE_BG);
+	if(!operand)
+		return(MP_REGMASTER_FULL);
 
 	operand->reg = reg;
 	operand->regSize = regSize;
-	operand->regPos = 0;
 
 	operand->callback = callback;
 	operand->user = user;
 
-	/* add operand at last pending */
-	mp_list_add_last(&cirr->pending, &operand->item, operand);
+	_mp_regMaster_push(cirr, operand);
+	return(TRUE);
+}
 
-	/* tell to the scheduler task pending */
-	mp_task_signal(cirr->asr, MP_TASK_SIG_PENDING);
+/**
+ * @brief Start inline write operation
+ *
+ * Data are copied into the operand then the caller can use a stack
+ * buffer. Size is limited to MP_REGMASTER_PAYLOAD bytes.
+ * Prefer mp_regMaster_writeReg() and mp_regMaster_writeReg16().
+ *
+ * @param[in] cirr Circular context.
+ * @param[in] data Register and value to write
+ * @param[in] size Size of data
+ * @param[in] callback Callback executed on the end of operation (can be NULL)
+ * @param[in] user User pointer embedded and passed as argument
+ */
+mp_ret_t mp_regMaster_writeInline(
+		mp_regMaster_t *cirr,
+		unsigned char *data, int size,
+		mp_regMaster_cb_t callback, void *user
+	) {
+	mp_regMaster_op_t *operand;
+
+	if(size > MP_REGMASTER_PAYLOAD) {
+		mp_printk("regMaster(%p): inline write of %d bytes is too large", cirr, size);
+		return(FALSE);
+	}
 
+	/* the bus has been terminated */
+	if(!cirr->bus)
+		return(FALSE);
+
+	operand = _mp_regMaster_operand(cirr, MP_REGMASTER_LANE_BG);
+	if(!operand)
+		return(MP_REGMASTER_FULL);
+
+	memcpy(operand->payload, data, size);
+	operand->reg = operand->payload;
+	operand->regSize = size;
+
+	operand->callback = callback;
+	operand->user = user;
+
+	_mp_regMaster_push(cirr, operand);
 	return(TRUE);
 }
 
+#ifdef MP_REGMASTER_STATS
 /**
- * @brief Get HEAP memory for register
+ * @brief Get a copy of the queueing delay of a lane
  *
- * This function is very useful because it allows to get a valid HEAP pointer which contains the register to write.
- * In this case you don't need to allocate or free register after its usage.
- * Only limitation register is limited to 8bits.
+ * @param[in] bus Bus context
+ * @param[in] lane Queue lane
+ * @param[out] stats Statistics copy
+ */
+void mp_regMaster_stats_get(mp_regMaster_bus_t *bus, unsigned char lane, mp_regMaster_stats_t *stats) {
+	MP_INTERRUPT_SAFE_BEGIN
+	memcpy(stats, &bus->stats[lane], sizeof(*stats));
+	MP_INTERRUPT_SAFE_END
+}
+
+/**
+ * @brief Reset the queueing delay of all the lanes
  *
- * @param[in] reg Register content
- * @return HEAP memory pointer contains the register
+ * @param[in] bus Bus context
  */
-unsigned char *mp_regMaster_register(unsigned char reg) {
-	return(&_registers[reg]);
+void mp_regMaster_stats_reset(mp_regMaster_bus_t *bus) {
+	MP_INTERRUPT_SAFE_BEGIN
+	memset(bus->stats, 0, sizeof(bus->stats));
+	MP_INTERRUPT_SAFE_END
 }
 
+/**
+ * @brief Dump the queueing delay of all the lanes through mp_printk()
+ *
+ * @param[in] bus Bus context
+ */
+void mp_regMaster_stats_dump(mp_regMaster_bus_t *bus) {
+	mp_regMaster_stats_t stats;
+	unsigned char lane;
+
+	for(lane=0; lane<MP_REGMASTER_LANES; lane++) {
+		mp_regMaster_stats_get(bus, lane, &stats);
+
+		mp_printk("regMaster %s lane %s: %lu ops, wait %luus mean %luus max",
+			bus->who, lane == MP_REGMASTER_LANE_RT ? "RT" : "BG", stats.ops,
+			stats.ops > 0 ? mp_clock_hires_us(stats.waitTotal/stats.ops) : 0,
+			mp_clock_hires_us(stats.waitMax)
+		);
+	}
+}
+#endif
 
 /**@}*/
 
-static void _mp_regMaster_i2c_enableRX(mp_regMaster_t *cirr) {
-	mp_i2c_enable_rx(cirr->i2c);
+/* task context, releases a list the interrupt does not touch anymore */
+static void _mp_regMaster_flush(mp_regMaster_t *cirr, mp_list_t *list) {
+	mp_regMaster_op_t *cur;
+	mp_regMaster_op_t *next;
+
+	cur = list->first ? list->first->user : NULL;
+	while(cur) {
+		next = cur->item.next != NULL ? cur->item.next->user : NULL;
+
+		if(cur->error == MP_REGMASTER_OK)
+			cur->error = MP_REGMASTER_ERR_STOP;
+		if(cur->callback)
+			cur->callback(cur, TRUE);
+
+		mp_list_remove(list, &cur->item);
+		_mp_regMaster_release(cirr, cur);
+		cur = next;
+	}
 }
 
-static void _mp_regMaster_i2c_disableRX(mp_regMaster_t *cirr) {
-	mp_i2c_disable_rx(cirr->i2c);
+static void _mp_regMaster_bus_i2c(mp_kernel_t *kernel, mp_regMaster_bus_t *bus, mp_i2c_t *i2c, char *who) {
+	memset(bus, 0, sizeof(*bus));
+
+	bus->kernel = kernel;
+	bus->who = who;
+
+	mp_list_init(&bus->clients);
+
+	bus->enableRX = _mp_regMaster_i2c_enableRX;
+	bus->disableRX = _mp_regMaster_i2c_disableRX;
+
+	bus->enableTX = _mp_regMaster_i2c_enableTX;
+	bus->disableTX = _mp_regMaster_i2c_disableTX;
+
+	bus->asrCallback = _mp_regMaster_i2c_asr;
+	bus->abortCallback = _mp_regMaster_i2c_abort;
+
+	bus->chain = YES;
+	bus->weight = MP_REGMASTER_WEIGHT;
+	bus->retries = MP_REGMASTER_RETRIES;
+
+	bus->i2c = i2c;
+	bus->i2c->user = bus;
+
+	bus->disableRX(bus);
+	bus->disableTX(bus);
+
+	mp_i2c_setInterruption(i2c, _mp_regMaster_i2c_interrupt);
+
+	bus->type = MP_REGMASTER_I2C;
+
+	mp_regMaster_setTimeout(bus, MP_REGMASTER_TIMEOUT);
 }
 
-static void _mp_regMaster_i2c_enableTX(mp_regMaster_t *cirr) {
-	mp_i2c_enable_tx(cirr->i2c);
+static void _mp_regMaster_bus_spi(mp_kernel_t *kernel, mp_regMaster_bus_t *bus, mp_spi_t *spi, char *who) {
+	memset(bus, 0, sizeof(*bus));
+
+	bus->kernel = kernel;
+	bus->who = who;
+
+	mp_list_init(&bus->clients);
+
+	bus->enableRX = _mp_regMaster_spi_enableRX;
+	bus->disableRX = _mp_regMaster_spi_disableRX;
+
+	bus->enableTX = _mp_regMaster_spi_enableTX;
+	bus->disableTX = _mp_regMaster_spi_disableTX;
+
+	bus->asrCallback = _mp_regMaster_spi_asr;
+	bus->abortCallback = _mp_regMaster_spi_abort;
+
+	bus->chain = YES;
+	bus->weight = MP_REGMASTER_WEIGHT;
+	bus->retries = MP_REGMASTER_RETRIES;
+
+	bus->spi = spi;
+	bus->spi->user = bus;
+
+	bus->disableRX(bus);
+	bus->disableTX(bus);
+
+	mp_spi_setInterruption(spi, _mp_regMaster_spi_interrupt);
+
+	bus->type = MP_REGMASTER_SPI;
+
+	mp_regMaster_setTimeout(bus, MP_REGMASTER_TIMEOUT);
 }
 
-static void _mp_regMaster_i2c_disableTX(mp_regMaster_t *cirr) {
-	mp_i2c_disable_tx(cirr->i2c);
+static mp_ret_t _mp_regMaster_attach(mp_kernel_t *kernel, mp_regMaster_t *cirr, mp_regMaster_bus_t *bus, mp_regMaster_op_t *ops, int opsSize, void *user, char *who) {
+	int a;
+
+	cirr->kernel = kernel;
+	cirr->type = bus->type;
+	cirr->bus = bus;
+	cirr->user = user;
+	cirr->id = ++__clientId;
+
+	for(a=0; a<MP_REGMASTER_LANES; a++)
+		mp_list_init(&cirr->pending[a]);
+	mp_list_init(&cirr->executing);
+
+	_mp_regMaster_pool(cirr, ops, opsSize);
+
+	/* create task and place it in sleep mode */
+	cirr->asr = mp_task_create(&kernel->tasks, who, mp_regMaster_asr, cirr, 1000);
+	if(!cirr->asr)
+		return(FALSE);
+
+	mp_task_signal(cirr->asr, MP_TASK_SIG_SLEEP);
+
+	/* the interrupt elects the clients */
+	MP_INTERRUPT_SAFE_BEGIN
+	mp_list_add_last(&bus->clients, &cirr->item, cirr);
+	MP_INTERRUPT_SAFE_END
+
+	return(TRUE);
+}
+
+/* interrupts disabled, the client leaves its bus */
+static void _mp_regMaster_detach(mp_regMaster_t *cirr) {
+	mp_regMaster_bus_t *bus = cirr->bus;
+
+	_mp_regMaster_leave(bus, cirr);
+
+	/* the others go on */
+	_mp_regMaster_next(bus);
+}
+
+/* interrupts disabled, cancels the client from the bus queue */
+static void _mp_regMaster_leave(mp_regMaster_bus_t *bus, mp_regMaster_t *cirr) {
+	mp_regMaster_op_t *cur = bus->current;
+	mp_list_item_t *item;
+	int a;
+
+	/* abort our transfer */
+	if(bus->busy == YES && cur->cirr == cirr) {
+		bus->abortCallback(bus, cur, MP_REGMASTER_ERR_STOP);
+		mp_ktimer_stop(bus->kernel, &bus->watchdog);
+		bus->current = NULL;
+		bus->busy = NO;
+	}
+
+	for(a=0; a<MP_REGMASTER_LANES; a++) {
+		for(item=cirr->pending[a].first; item; item=item->next) {
+			bus->laneQueued[a]--;
+			bus->queued--;
+		}
+	}
+
+	mp_list_remove(&bus->clients, &cirr->item);
+	if(bus->last == cirr)
+		bus->last = NULL;
+}
+
+static void _mp_regMaster_pool(mp_regMaster_t *cirr, mp_regMaster_op_t *ops, int opsSize) {
+	int a;
+
+	cirr->ops = ops;
+	cirr->opsSize = opsSize;
+
+	mp_list_init(&cirr->free);
+	for(a=0; a<opsSize; a++)
+		mp_list_add_last(&cirr->free, &ops[a].item, &ops[a]);
+}
+
+/* drivers enqueue from their DRDY interrupt, the free list is masked */
+static mp_regMaster_op_t *_mp_regMaster_operand(mp_regMaster_t *cirr, unsigned char lane) {
+	mp_regMaster_op_t *operand = NULL;
+
+	/* take operand from the pool */
+	MP_INTERRUPT_SAFE_BEGIN
+	if(cirr->free.first) {
+		operand = cirr->free.first->user;
+		mp_list_remove(&cirr->free, &operand->item);
+	}
+	else
+		cirr->full++;
+	MP_INTERRUPT_SAFE_END
+
+	if(!operand)
+		return(NULL);
+
+	memset(operand, 0, sizeof(*operand));
+
+	if(cirr->type == MP_REGMASTER_I2C)
+		operand->slaveAddress = cirr->slaveAddress;
+	else
+		operand->chipSelect = cirr->chipSelect;
+
+	operand->state = MP_REGMASTER_STATE_TX;
+	operand->cirr = cirr;
+	operand->lane = lane;
+	return(operand);
+}
+
+static void _mp_regMaster_release(mp_regMaster_t *cirr, mp_regMaster_op_t *operand) {
+	MP_INTERRUPT_SAFE_BEGIN
+	mp_list_add_last(&cirr->free, &operand->item, operand);
+	MP_INTERRUPT_SAFE_END
+}
+
+static void _mp_regMaster_push(mp_regMaster_t *cirr, mp_regMaster_op_t *operand) {
+	mp_regMaster_bus_t *bus = cirr->bus;
+
+	MP_INTERRUPT_SAFE_BEGIN
+
+	/* add operand at last pending of its lane */
+	mp_list_add_last(&cirr->pending[operand->lane], &operand->item, operand);
+	bus->laneQueued[operand->lane]++;
+	bus->queued++;
+
+#ifdef MP_REGMASTER_STATS
+	operand->queued = mp_clock_hires();
+#endif
+
+	/* an idle bus starts at once */
+	if(bus->chain == YES)
+		_mp_regMaster_next(bus);
+
+	MP_INTERRUPT_SAFE_END
+
+	/* tell to the scheduler task pending */
+	if(bus->chain == NO)
+		mp_task_signal(cirr->asr, MP_TASK_SIG_PENDING);
+}
+
+/* interrupts disabled, lane first then highest priority pending client, round robin between equals */
+static mp_regMaster_t *_mp_regMaster_elect(mp_regMaster_bus_t *bus, unsigned char lane) {
+	mp_regMaster_t *cirr;
+	mp_regMaster_t *best = NULL;
+	mp_list_item_t *start;
+	mp_list_item_t *item;
+
+	/* start after the client served last */
+	start = bus->last && bus->last->item.next ? bus->last->item.next : bus->clients.first;
+	if(!start)
+		return(NULL);
+
+	item = start;
+	do {
+		cirr = item->user;
+		if(cirr->pending[lane].first && (!best || cirr->priority > best->priority))
+			best = cirr;
+		item = item->next ? item->next : bus->clients.first;
+	} while(item != start);
+
+	return(best);
+}
+
+/* interrupts disabled, starts the elected operand on an idle bus */
+static void _mp_regMaster_next(mp_regMaster_bus_t *bus) {
+	mp_regMaster_t *cirr;
+	mp_regMaster_op_t *cur;
+	unsigned char lane;
+#ifdef MP_REGMASTER_STATS
+	unsigned long wait;
+#endif
+
+	if(bus->busy == YES)
+		return;
+
+	/* nothing to watch on an idle bus */
+	if(bus->queued == 0) {
+		mp_ktimer_stop(bus->kernel, &bus->watchdog);
+		return;
+	}
+
+	/* RT first, BG gets one operand after weight RT in a row */
+	lane = MP_REGMASTER_LANE_RT;
+	if(bus->laneQueued[MP_REGMASTER_LANE_RT] == 0 ||
+			(bus->weight > 0 && bus->streak >= bus->weight &&
+			bus->laneQueued[MP_REGMASTER_LANE_BG] > 0))
+		lane = MP_REGMASTER_LANE_BG;
+
+	cirr = _mp_regMaster_elect(bus, lane);
+	if(!cirr)
+		return;
+
+	if(lane == MP_REGMASTER_LANE_RT && bus->laneQueued[MP_REGMASTER_LANE_BG] > 0)
+		bus->streak++;
+	else
+		bus->streak = 0;
+
+	cur = cirr->pending[lane].first->user;
+	bus->last = cirr;
+	bus->current = cur;
+	bus->busy = YES;
+	bus->serial++;
+
+	/* one shot per operand, the serial tells a late expiration */
+	if(bus->timeout > 0) {
+		bus->watched = bus->serial;
+		mp_ktimer_start(bus->kernel, &bus->watchdog, bus->who, bus->timeout, 0, _mp_regMaster_watchdog, bus);
+	}
+
+#ifdef MP_REGMASTER_STATS
+	wait = mp_clock_hires()-cur->queued;
+	bus->stats[lane].ops++;
+	bus->stats[lane].waitTotal += wait;
+	if(wait > bus->stats[lane].waitMax)
+		bus->stats[lane].waitMax = wait;
+#endif
+
+	MP_TRACE_EVENT(MP_TRACE_REGMASTER_START, cur->reg[0], cirr->id);
+
+	/* protocol asr */
+	bus->asrCallback(bus, cur);
+}
+
+/* interrupts disabled, the current operand leaves the bus for its ASR */
+static void _mp_regMaster_end(mp_regMaster_bus_t *bus, mp_regMaster_op_t *operand) {
+	mp_regMaster_t *cirr = operand->cirr;
+
+	MP_TRACE_EVENT(MP_TRACE_REGMASTER_DONE, operand->reg[0], cirr->id);
+
+	/* switch buffer into ASR space */
+	mp_list_switch_last(&cirr->executing, &cirr->pending[operand->lane], &operand->item);
+	mp_ktimer_stop(bus->kernel, &bus->watchdog);
+	bus->current = NULL;
+	bus->busy = NO;
+	bus->laneQueued[operand->lane]--;
+	bus->queued--;
+}
+
+/* from the interrupt, the current operand is over */
+static void _mp_regMaster_done(mp_regMaster_bus_t *bus, mp_regMaster_op_t *operand) {
+	mp_regMaster_t *cirr = operand->cirr;
+
+	_mp_regMaster_end(bus, operand);
+
+	mp_softirq_signal(cirr->asr, MP_TASK_SIG_PENDING);
+
+	if(bus->chain == YES)
+		_mp_regMaster_next(bus);
+}
+
+/* interrupts disabled, frees the bus then restarts the operand or ends it
+ * with the error, the caller wakes up the owner ASR and elects the next */
+static void _mp_regMaster_fail(mp_regMaster_bus_t *bus, mp_regMaster_op_t *operand, mp_regMaster_error_t error) {
+	bus->abortCallback(bus, operand, error);
+
+	if(error == MP_REGMASTER_ERR_NACK)
+		bus->nacks++;
+	else if(error == MP_REGMASTER_ERR_ARBITRATION)
+		bus->arbitrations++;
+	else if(error == MP_REGMASTER_ERR_TIMEOUT)
+		bus->timeouts++;
+
+	/* the operand stays first of its lane and is elected again */
+	if(operand->retries < bus->retries) {
+		operand->retries++;
+		operand->state = MP_REGMASTER_STATE_TX;
+		operand->regPos = 0;
+		operand->waitPos = 0;
+
+		mp_ktimer_stop(bus->kernel, &bus->watchdog);
+		bus->current = NULL;
+		bus->busy = NO;
+		bus->restarts++;
+		return;
+	}
+
+	operand->error = error;
+	_mp_regMaster_end(bus, operand);
+}
+
+/* kernel loop, the operand armed the watchdog has owned the bus too long */
+static void _mp_regMaster_watchdog(mp_ktimer_t *timer) {
+	mp_regMaster_bus_t *bus = timer->user;
+	mp_regMaster_op_t *cur;
+
+	mp_interrupt_disable();
+
+	cur = bus->current;
+	if(bus->busy == YES && bus->serial == bus->watched) {
+		_mp_regMaster_fail(bus, cur, MP_REGMASTER_ERR_TIMEOUT);
+		mp_task_signal(cur->cirr->asr, MP_TASK_SIG_PENDING);
+		_mp_regMaster_next(bus);
+	}
+
+	mp_interrupt_enable();
+}
+
+
+static void _mp_regMaster_i2c_enableRX(mp_regMaster_bus_t *bus) {
+	mp_i2c_enable_rx(bus->i2c);
+}
+
+static void _mp_regMaster_i2c_disableRX(mp_regMaster_bus_t *bus) {
+	mp_i2c_disable_rx(bus->i2c);
+}
+
+static void _mp_regMaster_i2c_enableTX(mp_regMaster_bus_t *bus) {
+	mp_i2c_enable_tx(bus->i2c);
+}
+
+static void _mp_regMaster_i2c_disableTX(mp_regMaster_bus_t *bus) {
+	mp_i2c_disable_tx(bus->i2c);
 }
 
 static void _mp_regMaster_i2c_interrupt(mp_i2c_t *i2c, mp_i2c_flag_t flag) {
-	mp_regMaster_t *cirr = i2c->user;
+	mp_regMaster_bus_t *bus = i2c->user;
 	mp_regMaster_op_t *operand;
 	int rest;
 
-	/* get first operand */
-	operand = cirr->pending.first ? cirr->pending.first->user : NULL;
+	/* get current operand */
+	operand = bus->current;
 	if(!operand)
 		return;
 
+	/* no acknowledge or another master won, the operand frees the bus */
+	if(flag == MP_I2C_FL_NACK || flag == MP_I2C_FL_AL) {
+		_mp_regMaster_fail(bus, operand,
+			flag == MP_I2C_FL_NACK ? MP_REGMASTER_ERR_NACK : MP_REGMASTER_ERR_ARBITRATION);
+
+		/* ends the operand or restarts it with chain set to NO */
+		mp_softirq_signal(operand->cirr->asr, MP_TASK_SIG_PENDING);
+
+		if(bus->chain == YES)
+			_mp_regMaster_next(bus);
+		return;
+	}
+
 	/* send registers */
 	if(operand->state == MP_REGMASTER_STATE_TX && flag == MP_I2C_FL_TX) {
 
 		/* check for end of register */
 		if(operand->regPos == operand->regSize) {
+			bus->disableTX(bus);
 
-			/* need to read data */
+			/* need to read data, repeated start */
 			if(operand->waitSize > 0) {
 				operand->state = MP_REGMASTER_STATE_RX;
-
-				mp_i2c_mode(i2c, 0);
-
-				cirr->enableRX(cirr);
-				cirr->disableTX(cirr);
+				_mp_regMaster_i2c_rxStart(bus, operand);
 			}
 			/* no need to read */
 			else {
-				mp_i2c_txStop(i2c);
-
-				/* switch buffer into ASR space */
-				mp_list_switch_last(&cirr->executing, &cirr->pending, &operand->item);
+				/* a chained operand restarts the bus itself */
+				if(bus->chain == NO || bus->queued == 1)
+					mp_i2c_txStop(i2c);
 
-				mp_task_signal(cirr->asr, MP_TASK_SIG_PENDING);
-
-				cirr->disableTX(cirr);
+				mp_i2c_disable_errors(i2c);
+				_mp_regMaster_done(bus, operand);
 			}
 		}
 		else
@@ -475,13 +1227,11 @@ static void _mp_regMaster_i2c_interrupt(mp_i2c_t *i2c, mp_i2c_flag_t flag) {
 		}
 
 		if(rest == 0) {
-			/* switch buffer into ASR space */
-			mp_list_switch_last(&cirr->executing, &cirr->pending, &operand->item);
-
-			mp_task_signal(cirr->asr, MP_TASK_SIG_PENDING);
+			bus->disableRX(bus);
+			bus->disableTX(bus);
+			mp_i2c_disable_errors(i2c);
 
-			cirr->disableRX(cirr);
-			cirr->disableTX(cirr);
+			_mp_regMaster_done(bus, operand);
 		}
 
 	}
@@ -490,34 +1240,61 @@ static void _mp_regMaster_i2c_interrupt(mp_i2c_t *i2c, mp_i2c_flag_t flag) {
 }
 
 
-static void _mp_regMaster_i2c_asr(mp_regMaster_t *cirr, mp_regMaster_op_t *cur) {
-	if(cur->state == MP_REGMASTER_STATE_TX) {
-		/* send slave address*/
-		mp_i2c_setSlaveAddress(cirr->i2c, cur->slaveAddress);
+static void _mp_regMaster_i2c_asr(mp_regMaster_bus_t *bus, mp_regMaster_op_t *cur) {
+	/* stop ending a previous read */
+	mp_i2c_waitStop(bus->i2c);
+
+	/* send slave address*/
+	mp_i2c_setSlaveAddress(bus->i2c, cur->slaveAddress);
 
-		/* change mode and here we go */
-		mp_i2c_mode(cirr->i2c, 1);
-		mp_i2c_txStart(cirr->i2c);
+	/* change mode and here we go */
+	mp_i2c_mode(bus->i2c, 1);
+	mp_i2c_txStart(bus->i2c);
+
+	mp_i2c_enable_errors(bus->i2c);
+	bus->enableTX(bus);
+}
 
-		cirr->enableTX(cirr);
+static void _mp_regMaster_i2c_abort(mp_regMaster_bus_t *bus, mp_regMaster_op_t *cur, mp_regMaster_error_t error) {
+	bus->disableTX(bus);
+	bus->disableRX(bus);
+	mp_i2c_disable_errors(bus->i2c);
+
+	switch(error) {
+		/* the USCI is back in slave mode */
+		case MP_REGMASTER_ERR_ARBITRATION:
+			mp_i2c_reset(bus->i2c);
+			break;
+
+		/* a slave may hold SDA */
+		case MP_REGMASTER_ERR_TIMEOUT:
+			mp_i2c_recover(bus->i2c);
+			bus->recoveries++;
+			break;
+
+		/* the master ends a NACK with a stop */
+		default:
+			mp_i2c_txStop(bus->i2c);
+			break;
 	}
-	else if(cur->state == MP_REGMASTER_STATE_RX) {
-		if(cur->waitSize == 1) {
-			mp_i2c_waitStop(cirr->i2c);
-			mp_i2c_mode(cirr->i2c, 0);
-			mp_i2c_txStart(cirr->i2c);
-			mp_i2c_waitStart(cirr->i2c);
-			mp_i2c_txStop(cirr->i2c);
-
-			cirr->enableRX(cirr);
-		}
-		else {
-			/* receiver mode */
-			mp_i2c_mode(cirr->i2c, 0);
-			mp_i2c_txStart(cirr->i2c);
+}
 
-			cirr->enableRX(cirr);
-		}
+static void _mp_regMaster_i2c_rxStart(mp_regMaster_bus_t *bus, mp_regMaster_op_t *cur) {
+	if(cur->waitSize == 1) {
+		mp_i2c_waitStop(bus->i2c);
+		mp_i2c_mode(bus->i2c, 0);
+		mp_i2c_txStart(bus->i2c);
+		mp_i2c_waitStart(bus->i2c);
+		mp_i2c_txStop(bus->i2c);
+
+		bus->enableRX(bus);
+	}
+	else {
+		/* receiver mode */
+		mp_i2c_mode(bus->i2c, 0);
+		mp_i2c_txStart(bus->i2c);
+
+		bus->enableRX(bus);
 	}
 }
 
@@ -525,81 +1302,67 @@ MP_TASK(mp_regMaster_asr) {
 	mp_regMaster_t *cirr = task->user;
 	mp_regMaster_op_t *cur;
 	mp_regMaster_op_t *next;
-	int canSleep = 0;
+	mp_list_t ended;
+	int a;
 
 	/* receive regMaster shutdown */
 	if(task->signal == MP_TASK_SIG_STOP) {
-		cirr->disableTX(cirr);
-		cirr->disableRX(cirr);
+		/* leave the bus, lists are ours after that */
+		mp_interrupt_disable();
+		if(cirr->bus)
+			_mp_regMaster_detach(cirr);
+		mp_interrupt_enable();
 
-		/* free pending list */
-		if(cirr->pending.first) {
-			cur = cirr->pending.first->user;
-			while(cur) {
-				next = cur->item.next != NULL ? cur->item.next->user : NULL;
+		/* a private bus goes with its client */
+		if(mp_regMaster_shared(cirr) == NO)
+			mp_ktimer_stop(cirr->kernel, &cirr->own.watchdog);
 
-				if(cur->callback)
-					cur->callback(cur, TRUE);
+		/* release pending lists */
+		for(a=0; a<MP_REGMASTER_LANES; a++)
+			_mp_regMaster_flush(cirr, &cirr->pending[a]);
 
-				mp_list_remove(&cirr->pending, &cur->item);
-				mp_mem_free(cirr->kernel, cur);
-				cur = next;
-			}
-		}
-
-		/* free executing list */
-		if(cirr->executing.first) {
-			cur = cirr->executing.first->user;
-			while(cur) {
-				next = cur->item.next != NULL ? cur->item.next->user : NULL;
-
-				if(cur->callback)
-					cur->callback(cur, TRUE);
-
-				mp_list_remove(&cirr->executing, &cur->item);
-				mp_mem_free(cirr->kernel, cur);
-				cur = next;
-			}
-		}
-
-		/* run ginit */
-		_mp_regMaster_gfini(cirr->kernel);
+		/* release executing list */
+		_mp_regMaster_flush(cirr, &cirr->executing);
 
 		/* acknowledging */
 		mp_task_signal(cirr->asr, MP_TASK_SIG_DEAD);
 		return;
 	}
 
+	/* take the ended operands, the bus goes on meanwhile and the
+	 * next ones wait for the next run, other clients run between */
 	mp_interrupt_disable();
+	ended = cirr->executing;
+	mp_list_init(&cirr->executing);
+	mp_interrupt_enable();
 
-	/* FIFO pop */
-	if(cirr->executing.first) {
-		cur = cirr->executing.first->user;
+	cur = ended.first ? ended.first->user : NULL;
+	while(cur) {
+		next = cur->item.next != NULL ? cur->item.next->user : NULL;
 
 		/* execute callback in asr mode */
 		if(cur->callback)
-			cur->callback(cur, FALSE);
+			cur->callback(cur, cur->error != MP_REGMASTER_OK ? TRUE : FALSE);
 
-		/* remove completely the buffer */
-		mp_list_remove(&cirr->executing, &cur->item);
-		mp_mem_free(cirr->kernel, cur);
+		/* give the operand back to the pool */
+		_mp_regMaster_release(cirr, cur);
+		cur = next;
+	}
 
-		/* more element */
+	/* the bus has been terminated, nobody starts our operands */
+	if(!cirr->bus) {
+		for(a=0; a<MP_REGMASTER_LANES; a++)
+			_mp_regMaster_flush(cirr, &cirr->pending[a]);
 	}
-	else
-		canSleep++;
 
-	/* pending request activate interruption */
-	if(cirr->pending.first) {
-		cur = cirr->pending.first->user;
+	mp_interrupt_disable();
 
-		/* protocol asr */
-		cirr->asrCallback(cirr, cur);
-	}
-	else
-		canSleep++;
+	/* pending request activate interruption */
+	if(cirr->bus)
+		_mp_regMaster_next(cirr->bus);
 
-	if(canSleep == 2)
+	/* the interrupt wakes up the ASR on the next end */
+	if(!cirr->executing.first)
 		mp_task_signal(cirr->asr, MP_TASK_SIG_SLEEP);
 
 	mp_interrupt_enable();
@@ -608,29 +1371,29 @@ MP_TASK(mp_regMaster_asr) {
 
 
 
-static void _mp_regMaster_spi_enableRX(mp_regMaster_t *cirr) {
-	mp_spi_enable_rx(cirr->spi);
+static void _mp_regMaster_spi_enableRX(mp_regMaster_bus_t *bus) {
+	mp_spi_enable_rx(bus->spi);
 }
 
-static void _mp_regMaster_spi_disableRX(mp_regMaster_t *cirr) {
-	mp_spi_disable_rx(cirr->spi);
+static void _mp_regMaster_spi_disableRX(mp_regMaster_bus_t *bus) {
+	mp_spi_disable_rx(bus->spi);
 }
 
-static void _mp_regMaster_spi_enableTX(mp_regMaster_t *cirr) {
-	mp_spi_enable_tx(cirr->spi);
+static void _mp_regMaster_spi_enableTX(mp_regMaster_bus_t *bus) {
+	mp_spi_enable_tx(bus->spi);
 }
 
-static void _mp_regMaster_spi_disableTX(mp_regMaster_t *cirr) {
-	mp_spi_disable_tx(cirr->spi);
+static void _mp_regMaster_spi_disableTX(mp_regMaster_bus_t *bus) {
+	mp_spi_disable_tx(bus->spi);
 }
 
 static void _mp_regMaster_spi_interrupt(mp_spi_t *spi, mp_spi_iv_t iv) {
-	mp_regMaster_t *cirr = spi->user;
+	mp_regMaster_bus_t *bus = spi->user;
 	mp_regMaster_op_t *operand;
 	int rest;
 
-	/* get first operand */
-	operand = cirr->pending.first ? cirr->pending.first->user : NULL;
+	/* get current operand */
+	operand = bus->current;
 	if(!operand)
 		return;
 
@@ -645,31 +1408,28 @@ static void _mp_regMaster_spi_interrupt(mp_spi_t *spi, mp_spi_iv_t iv) {
 			if(operand->waitSize > 0) {
 				operand->state = MP_REGMASTER_STATE_NULLRX;
 
-				cirr->disableTX(cirr);
-				cirr->enableRX(cirr);
+				bus->disableTX(bus);
+				bus->enableRX(bus);
 			}
 			/* no need to read */
 			else {
-				/* switch buffer into ASR space */
-				mp_list_switch_last(&cirr->executing, &cirr->pending, &operand->item);
-
-				mp_task_signal(cirr->asr, MP_TASK_SIG_PENDING);
-
-				cirr->disableRX(cirr);
-				cirr->disableTX(cirr);
+				bus->disableRX(bus);
+				bus->disableTX(bus);
 				mp_gpio_set(operand->chipSelect);
+
+				_mp_regMaster_done(bus, operand);
 			}
 		}
 		else if(operand->regPos == 2 && operand->waitSize == 0) {
 			operand->state = MP_REGMASTER_STATE_NULLTX;
-			cirr->enableRX(cirr);
-			cirr->disableTX(cirr);
+			bus->enableRX(bus);
+			bus->disableTX(bus);
 		}
 	}
 
 	/* read data, CTR and start has already been sent */
 	else if(operand->state == MP_REGMASTER_STATE_RX && iv == MP_SPI_IV_RX) {
-		mp_spi_tx(spi, cirr->nop);
+		mp_spi_tx(spi, operand->cirr->nop);
 
 		rest = operand->waitSize-operand->waitPos-1;
 
@@ -681,20 +1441,17 @@ static void _mp_regMaster_spi_interrupt(mp_spi_t *spi, mp_spi_iv_t iv) {
 		}
 
 		if(rest == 0) {
-			/* switch buffer into ASR space */
-			mp_list_switch_last(&cirr->executing, &cirr->pending, &operand->item);
-
-			mp_task_signal(cirr->asr, MP_TASK_SIG_PENDING);
-
-			cirr->disableRX(cirr);
-			cirr->disableTX(cirr);
+			bus->disableRX(bus);
+			bus->disableTX(bus);
 			mp_gpio_set(operand->chipSelect);
+
+			_mp_regMaster_done(bus, operand);
 		}
 	}
 	else if(operand->state == MP_REGMASTER_STATE_NULLRX && iv == MP_SPI_IV_RX) {
 		/* just ignore */
 		operand->state = MP_REGMASTER_STATE_RX;
-		mp_spi_tx(spi, cirr->nop);
+		mp_spi_tx(spi, operand->cirr->nop);
 		mp_spi_rx(spi);
 	}
 	else if(operand->state == MP_REGMASTER_STATE_NULLTX && iv == MP_SPI_IV_RX) {
@@ -702,21 +1459,27 @@ static void _mp_regMaster_spi_interrupt(mp_spi_t *spi, mp_spi_iv_t iv) {
 		operand->state = MP_REGMASTER_STATE_TX;
 		mp_spi_rx(spi);
 
-		cirr->enableTX(cirr);
-		cirr->disableRX(cirr);
+		bus->enableTX(bus);
+		bus->disableRX(bus);
 	}
 
 	return;
 }
 
-static void _mp_regMaster_spi_asr(mp_regMaster_t *cirr, mp_regMaster_op_t *cur) {
+static void _mp_regMaster_spi_abort(mp_regMaster_bus_t *bus, mp_regMaster_op_t *cur, mp_regMaster_error_t error) {
+	bus->disableTX(bus);
+	bus->disableRX(bus);
+	mp_gpio_set(cur->chipSelect);
+}
+
+static void _mp_regMaster_spi_asr(mp_regMaster_bus_t *bus, mp_regMaster_op_t *cur) {
 	mp_gpio_unset(cur->chipSelect);
 
 	if(cur->state == MP_REGMASTER_STATE_TX) {
-		cirr->enableTX(cirr);
+		bus->enableTX(bus);
 	}
 	else if(cur->state == MP_REGMASTER_STATE_RX) {
-		cirr->enableRX(cirr);
+		bus->enableRX(bus);
 
 	}
 
@@ -0,0 +1,301 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <mp.h>
+
+/**
+@defgroup mpCommonRing Byte ring
+
+@ingroup mpCommon
+
+@brief Single producer single consumer byte ring
+
+@version 1.0.0
+
+@author @htmlonly &copy; @endhtmlonly 2016
+Michael Vergoz <mv@verman.fr>
+
+@date 09 May 2016
+
+A ring is a power of two buffer given by the caller with two free
+running indexes : head is only written by the producer and tail only
+by the consumer. One interrupt handler and one task can then share it
+without disabling interrupts and without any allocation, which is the
+difference with @ref mpCommonCircular.
+
+A full ring drops the bytes and counts them as overruns. An
+mp_ring_read() asking for bytes on an empty ring counts an underrun,
+mp_ring_get() does not so that draining a ring until it returns FALSE
+counts nothing. Both counters are never reset by the ring itself.
+
+Producers and consumers can also work in place. mp_ring_reserve()
+returns the free region as two spans (the second one is empty unless
+the region wraps), the producer fills them and publishes the bytes
+with mp_ring_commit(). mp_ring_peek() and mp_ring_consume() do the
+same on the consumer side. Nothing is visible to the other side before
+commit or consume, which are functions and not macros so the compiler
+can not move the span accesses after them.
+
+@code
+static unsigned char _rxBuffer[64];
+
+mp_ring_init(&XXX->rx, _rxBuffer, sizeof(_rxBuffer));
+
+// into the RX interrupt
+mp_ring_put(&XXX->rx, mp_uart_rx(uart));
+
+// into the task
+while(mp_ring_get(&XXX->rx, &c) == TRUE)
+	...;
+@endcode
+
+@{
+*/
+
+/**
+ * @brief Initialize a ring
+ *
+ * @param[in] ring Ring
+ * @param[in] buffer Storage, must stay valid
+ * @param[in] size Size of the storage, a power of two up to 32768
+ * @return TRUE or FALSE
+ */
+mp_ret_t mp_ring_init(mp_ring_t *ring, unsigned char *buffer, unsigned int size) {
+	memset(ring, 0, sizeof(*ring));
+
+	if(size < 2 || size > 32768 || (size & (size-1)) != 0) {
+		mp_printk("Ring size %u is not a power of two", size);
+		return(FALSE);
+	}
+
+	ring->data = buffer;
+	ring->mask = size-1;
+
+	return(TRUE);
+}
+
+/**
+ * @brief Put one byte, producer side
+ *
+ * @param[in] ring Ring
+ * @param[in] c Byte
+ * @return TRUE or FALSE on overrun
+ */
+mp_bool_t mp_ring_put(mp_ring_t *ring, unsigned char c) {
+	unsigned short head = ring->head;
+
+	if((unsigned short)(head-ring->tail) > ring->mask) {
+		ring->overruns++;
+		return(FALSE);
+	}
+
+	ring->data[head & ring->mask] = c;
+	ring->head = head+1;
+	return(TRUE);
+}
+
+/**
+ * @brief Get one byte, consumer side
+ *
+ * @param[in] ring Ring
+ * @param[out] c Byte
+ * @return TRUE or FALSE when the ring is empty
+ */
+mp_bool_t mp_ring_get(mp_ring_t *ring, unsigned char *c) {
+	unsigned short tail = ring->tail;
+
+	if(tail == ring->head)
+		return(FALSE);
+
+	*c = ring->data[tail & ring->mask];
+	ring->tail = tail+1;
+	return(TRUE);
+}
+
+/**
+ * @brief Write bytes, producer side
+ *
+ * Bytes which don't fit are dropped and counted as overruns.
+ *
+ * @param[in] ring Ring
+ * @param[in] data Bytes to write
+ * @param[in] size Number of bytes
+ * @return Number of bytes written
+ */
+unsigned int mp_ring_write(mp_ring_t *ring, unsigned char *data, unsigned int size) {
+	unsigned short head = ring->head;
+	unsigned int space;
+	unsigned int a;
+
+	space = ring->mask+1-(unsigned short)(head-ring->tail);
+	if(size > space) {
+		ring->overruns += size-space;
+		size = space;
+	}
+
+	for(a=0; a<size; a++)
+		ring->data[(unsigned short)(head+a) & ring->mask] = data[a];
+
+	/* publish once every byte is stored */
+	ring->head = head+size;
+	return(size);
+}
+
+/**
+ * @brief Read bytes, consumer side
+ *
+ * Asking for bytes on an empty ring counts one underrun.
+ *
+ * @param[in] ring Ring
+ * @param[out] data Buffer to fill
+ * @param[in] size Size of the buffer
+ * @return Number of bytes read
+ */
+unsigned int mp_ring_read(mp_ring_t *ring, unsigned char *data, unsigned int size) {
+	unsigned short tail = ring->tail;
+	unsigned int count;
+	unsigned int a;
+
+	count = (unsigned short)(ring->head-tail);
+	if(count == 0) {
+		if(size > 0)
+			ring->underruns++;
+		return(0);
+	}
+	if(size > count)
+		size = count;
+
+	for(a=0; a<size; a++)
+		data[a] = ring->data[(unsigned short)(tail+a) & ring->mask];
+
+	/* release once every byte is copied */
+	ring->tail = tail+size;
+	return(size);
+}
+
+/**
+ * @brief Reserve a free region, producer side
+ *
+ * Nothing is published until mp_ring_commit(). A region smaller than
+ * size is not an overrun, the producer decides what to drop.
+ *
+ * @param[in] ring Ring
+ * @param[out] span Two spans describing the region
+ * @param[in] size Wanted size
+ * @return Size of the region, at most size
+ */
+unsigned int mp_ring_reserve(mp_ring_t *ring, mp_ring_span_t *span, unsigned int size) {
+	unsigned short head = ring->head;
+	unsigned int space;
+	unsigned int index;
+
+	space = ring->mask+1-(unsigned short)(head-ring->tail);
+	if(size > space)
+		size = space;
+
+	index = head & ring->mask;
+	span[0].data = (unsigned char *)ring->data+index;
+	span[0].size = ring->mask+1-index;
+	if(span[0].size > size)
+		span[0].size = size;
+
+	span[1].data = (unsigned char *)ring->data;
+	span[1].size = size-span[0].size;
+
+	return(size);
+}
+
+/**
+ * @brief Publish reserved bytes, producer side
+ *
+ * @param[in] ring Ring
+ * @param[in] size Number of bytes written into the reserved region
+ */
+void mp_ring_commit(mp_ring_t *ring, unsigned int size) {
+	ring->head = ring->head+size;
+}
+
+/**
+ * @brief Get the readable region, consumer side
+ *
+ * Bytes stay into the ring until mp_ring_consume().
+ *
+ * @param[in] ring Ring
+ * @param[out] span Two spans describing the region
+ * @return Size of the region
+ */
+unsigned int mp_ring_peek(mp_ring_t *ring, mp_ring_span_t *span) {
+	unsigned short tail = ring->tail;
+	unsigned int count;
+	unsigned int index;
+
+	count = (unsigned short)(ring->head-tail);
+
+	index = tail & ring->mask;
+	span[0].data = (unsigned char *)ring->data+index;
+	span[0].size = ring->mask+1-index;
+	if(span[0].size > count)
+		span[0].size = count;
+
+	span[1].data = (unsigned char *)ring->data;
+	span[1].size = count-span[0].size;
+
+	return(count);
+}
+
+/**
+ * @brief Release read bytes, consumer side
+ *
+ * @param[in] ring Ring
+ * @param[in] size Number of bytes consumed from the peeked region
+ */
+void mp_ring_consume(mp_ring_t *ring, unsigned int size) {
+	ring->tail = ring->tail+size;
+}
+
+/**
+ * @brief Copy bytes into a reserved region
+ *
+ * Helper for encoders filling a region piece by piece.
+ *
+ * @param[in] span Region from mp_ring_reserve()
+ * @param[in] offset Offset into the region
+ * @param[in] data Bytes to copy
+ * @param[in] size Number of bytes, offset+size must fit the region
+ */
+void mp_ring_span_write(mp_ring_span_t *span, unsigned int offset, unsigned char *data, unsigned int size) {
+	unsigned int first = 0;
+
+	if(offset < span[0].size) {
+		first = span[0].size-offset;
+		if(first > size)
+			first = size;
+		memcpy(span[0].data+offset, data, first);
+		offset = 0;
+	}
+	else
+		offset -= span[0].size;
+
+	if(size > first)
+		memcpy(span[1].data+offset, data+first, size-first);
+}
+
+/**@}*/
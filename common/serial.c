@@ -32,6 +32,14 @@ static void mp_serial_UART_rxIntEnable(mp_circular_t *cir);
 static void mp_serial_UART_txIntDisable(mp_circular_t *cir);
 static void mp_serial_UART_txIntEnable(mp_circular_t *cir);
 
+static void mp_serial_UART_dmaTx(mp_uart_t *uart);
+static void mp_serial_UART_dmaRx(mp_uart_t *uart);
+static void _mp_serial_dma_txNext(mp_serial_t *serial);
+static void _mp_serial_dma_rxSync(mp_serial_t *serial);
+static void _mp_serial_rxPrepare(mp_serial_t *serial);
+static void _mp_serial_txStart(mp_serial_t *serial);
+static void _mp_serial_dma_check(mp_ktimer_t *timer);
+
 mp_ret_t mp_serial_initUART(mp_kernel_t *kernel, mp_serial_t *serial, mp_uart_t *uart, char *who) {
 	mp_ret_t ret;
 
@@ -74,15 +82,155 @@ mp_ret_t mp_serial_initUART(mp_kernel_t *kernel, mp_serial_t *serial, mp_uart_t
 	return(TRUE);
 }
 
+/**
+ * @brief Serial over UART using byte rings
+ *
+ * Same as mp_serial_initUART() but bytes are kept into two static
+ * rings (see @ref mpCommonRing) : interrupt handlers never allocate
+ * nor mask anything. Received bytes are read with mp_serial_read().
+ *
+ * @param[in] kernel Kernel handler
+ * @param[in] serial Serial context
+ * @param[in] uart Opened UART
+ * @param[in] rxBuffer RX ring storage, power of two size
+ * @param[in] rxSize Size of rxBuffer
+ * @param[in] txBuffer TX ring storage, power of two size
+ * @param[in] txSize Size of txBuffer
+ * @param[in] who Name
+ * @return TRUE or FALSE
+ */
+mp_ret_t mp_serial_initUART_ring(
+		mp_kernel_t *kernel, mp_serial_t *serial, mp_uart_t *uart,
+		unsigned char *rxBuffer, unsigned int rxSize,
+		unsigned char *txBuffer, unsigned int txSize,
+		char *who
+	) {
+	memset(serial, 0, sizeof(*serial));
+
+	serial->kernel = kernel;
+	serial->uart = uart;
+	serial->useRing = YES;
+
+	if(!mp_ring_init(&serial->txRing, txBuffer, txSize)) {
+		mp_printk("Serial UART: Can not create TX ring");
+		return(FALSE);
+	}
+
+	if(!mp_ring_init(&serial->rxRing, rxBuffer, rxSize)) {
+		mp_printk("Serial UART: Can not create RX ring");
+		return(FALSE);
+	}
+
+	/* setup interruption vectors */
+	serial->uart->user = serial;
+	serial->uart->onRead = mp_serial_UART_rxInt;
+	serial->uart->onWrite = mp_serial_UART_txInt;
+
+	mp_uart_enable_rx_int(serial->uart);
+
+	mp_printk("Initialize Serial over UART ring: %s", who);
+
+	serial->opened = _MP_SERIAL_IS_OPEN;
+	return(TRUE);
+}
+
+/**
+ * @brief Serial over UART using the DMA channels
+ *
+ * Same rings than mp_serial_initUART_ring() but the UART must be opened
+ * with the dmaTx and dmaRx options. Contiguous parts of the TX ring are
+ * sent by one DMA transfer each, the RX channel writes the RX ring
+ * storage in a loop: no interrupt per byte on either side.
+ *
+ * Received bytes are still read with mp_serial_read(). The onDma
+ * callback, if any, tells when the RX ring is half filled, when the
+ * channel restarts at its beginning (from the DMA interrupt) and when
+ * the line gets idle (half and idle from the kernel loop, checked every
+ * MP_SERIAL_DMA_CHECK ticks). Unread bytes are overwritten after one
+ * lap, they are counted as RX ring overruns.
+ *
+ * @param[in] kernel Kernel handler
+ * @param[in] serial Serial context
+ * @param[in] uart UART opened with DMA channels
+ * @param[in] rxBuffer RX ring storage, power of two size
+ * @param[in] rxSize Size of rxBuffer
+ * @param[in] txBuffer TX ring storage, power of two size
+ * @param[in] txSize Size of txBuffer
+ * @param[in] who Name
+ * @return TRUE or FALSE
+ */
+mp_ret_t mp_serial_initUART_dma(
+		mp_kernel_t *kernel, mp_serial_t *serial, mp_uart_t *uart,
+		unsigned char *rxBuffer, unsigned int rxSize,
+		unsigned char *txBuffer, unsigned int txSize,
+		char *who
+	) {
+	memset(serial, 0, sizeof(*serial));
+
+	if(uart->dmaTx.opened != YES || uart->dmaRx.opened != YES) {
+		mp_printk("Serial UART: %s has no DMA channels", who);
+		return(FALSE);
+	}
+
+	serial->kernel = kernel;
+	serial->uart = uart;
+	serial->useRing = YES;
+	serial->useDma = YES;
+
+	if(!mp_ring_init(&serial->txRing, txBuffer, txSize)) {
+		mp_printk("Serial UART: Can not create TX ring");
+		return(FALSE);
+	}
+
+	if(!mp_ring_init(&serial->rxRing, rxBuffer, rxSize)) {
+		mp_printk("Serial UART: Can not create RX ring");
+		return(FALSE);
+	}
+
+	/* setup DMA vectors */
+	serial->uart->user = serial;
+	serial->uart->onRead = NULL;
+	serial->uart->onWrite = NULL;
+	serial->uart->onDmaTx = mp_serial_UART_dmaTx;
+	serial->uart->onDmaRx = mp_serial_UART_dmaRx;
+
+	serial->dmaRxHalf = YES;
+	mp_uart_dma_rx(serial->uart, rxBuffer, rxSize);
+
+	mp_ktimer_start(
+		kernel, &serial->dmaTimer, "Serial DMA",
+		MP_SERIAL_DMA_CHECK, MP_SERIAL_DMA_CHECK,
+		_mp_serial_dma_check, serial
+	);
+
+	mp_printk("Initialize Serial over UART DMA: %s", who);
+
+	serial->opened = _MP_SERIAL_IS_OPEN;
+	return(TRUE);
+}
+
 mp_ret_t mp_serial_fini(mp_serial_t *serial) {
 
 	serial->uart->onRead = NULL;
 	serial->uart->onWrite = NULL;
 	serial->uart->user = NULL;
 
-	mp_circular_fini(&serial->rxCir);
-	mp_circular_fini(&serial->txCir);
+	if(serial->useDma == YES) {
+		mp_ktimer_stop(serial->kernel, &serial->dmaTimer);
+		mp_uart_dma_stop(serial->uart);
+		serial->uart->onDmaTx = NULL;
+		serial->uart->onDmaRx = NULL;
+	}
+	else if(serial->useRing == YES) {
+		mp_uart_disable_rx_int(serial->uart);
+		mp_uart_disable_tx_int(serial->uart);
+	}
+	else {
+		mp_circular_fini(&serial->rxCir);
+		mp_circular_fini(&serial->txCir);
+	}
 
+	serial->opened = 0;
 	return(TRUE);
 }
 
@@ -92,10 +240,97 @@ void mp_serial_write(mp_serial_t *serial, unsigned char *input, int size) {
 	if(serial->opened != _MP_SERIAL_IS_OPEN)
 		return;
 
+	if(serial->useRing == YES) {
+		/* bytes not fitting are counted as TX ring overruns */
+		mp_ring_write(&serial->txRing, input, size);
+		_mp_serial_txStart(serial);
+		return;
+	}
+
 	mp_circular_write(&serial->txCir, input, size);
 
 }
 
+/**
+ * @brief Read received bytes, ring backend only
+ *
+ * @param[in] serial Serial context
+ * @param[out] output Buffer to fill
+ * @param[in] size Size of the buffer
+ * @return Number of bytes read
+ */
+int mp_serial_read(mp_serial_t *serial, unsigned char *output, int size) {
+	if(serial->opened != _MP_SERIAL_IS_OPEN || serial->useRing != YES)
+		return(0);
+
+	_mp_serial_rxPrepare(serial);
+
+	if(mp_ring_count(&serial->rxRing) == 0)
+		return(0);
+
+	return(mp_ring_read(&serial->rxRing, output, size));
+}
+
+/**
+ * @brief Received bytes in place, ring backend only
+ *
+ * Bytes stay into the RX ring until mp_serial_consume().
+ *
+ * @param[in] serial Serial context
+ * @param[out] span Two spans describing the bytes
+ * @return Number of bytes
+ */
+unsigned int mp_serial_peek(mp_serial_t *serial, mp_ring_span_t *span) {
+	if(serial->opened != _MP_SERIAL_IS_OPEN || serial->useRing != YES) {
+		span[0].size = span[1].size = 0;
+		return(0);
+	}
+
+	_mp_serial_rxPrepare(serial);
+
+	return(mp_ring_peek(&serial->rxRing, span));
+}
+
+/**
+ * @brief Release bytes given by mp_serial_peek()
+ *
+ * @param[in] serial Serial context
+ * @param[in] size Number of bytes
+ */
+void mp_serial_consume(mp_serial_t *serial, unsigned int size) {
+	mp_ring_consume(&serial->rxRing, size);
+}
+
+/**
+ * @brief Reserve room into the TX ring, ring backend only
+ *
+ * Nothing is sent before mp_serial_commit().
+ *
+ * @param[in] serial Serial context
+ * @param[out] span Two spans describing the room
+ * @param[in] size Wanted size
+ * @return Size of the room, at most size
+ */
+unsigned int mp_serial_reserve(mp_serial_t *serial, mp_ring_span_t *span, unsigned int size) {
+	if(serial->opened != _MP_SERIAL_IS_OPEN || serial->useRing != YES) {
+		span[0].size = span[1].size = 0;
+		return(0);
+	}
+
+	return(mp_ring_reserve(&serial->txRing, span, size));
+}
+
+/**
+ * @brief Send bytes written into the reserved room
+ *
+ * @param[in] serial Serial context
+ * @param[in] size Number of bytes written
+ */
+void mp_serial_commit(mp_serial_t *serial, unsigned int size) {
+	mp_ring_commit(&serial->txRing, size);
+	_mp_serial_txStart(serial);
+}
+
 /* UART predefined interfacing */
 static void mp_serial_UART_rxInt(mp_uart_t *uart) {
 	unsigned char chr;
@@ -105,6 +340,12 @@ static void mp_serial_UART_rxInt(mp_uart_t *uart) {
 	/* read register */
 	chr = mp_uart_rx(uart);
 
+	/* a full ring counts the overrun */
+	if(serial->useRing == YES) {
+		mp_ring_put(&serial->rxRing, chr);
+		return;
+	}
+
 	/* run circular interrupt service */
 	mp_circular_rxInterrupt(&serial->rxCir, chr);
 }
@@ -114,6 +355,16 @@ static void mp_serial_UART_txInt(mp_uart_t *uart) {
 	unsigned char toSend;
 	mp_bool_t done;
 
+	if(serial->useRing == YES) {
+		if(mp_ring_count(&serial->txRing) == 0) {
+			mp_uart_disable_tx_int(uart);
+			return;
+		}
+		mp_ring_get(&serial->txRing, &toSend);
+		mp_uart_tx(uart, toSend);
+		return;
+	}
+
 	/* run circular interrupt service */
 	toSend = mp_circular_txInterrupt(&serial->txCir, &done);
 	if(!done)
@@ -125,6 +376,11 @@ static void mp_serial_UART_txInt(mp_uart_t *uart) {
 
 static void mp_serial_UART_rxIntDisable(mp_circular_t *cir) {
 	mp_serial_t *serial = cir->user;
+
+	/* called by mp_circular_init() before the user is set */
+	if(!serial)
+		return;
+
 	mp_uart_disable_rx_int(serial->uart);
 	return;
 }
@@ -138,6 +394,11 @@ static void mp_serial_UART_rxIntEnable(mp_circular_t *cir) {
 
 static void mp_serial_UART_txIntDisable(mp_circular_t *cir) {
 	mp_serial_t *serial = cir->user;
+
+	/* called by mp_circular_init() before the user is set */
+	if(!serial)
+		return;
+
 	mp_uart_disable_tx_int(serial->uart);
 	return;
 }
@@ -148,5 +409,105 @@ static void mp_serial_UART_txIntEnable(mp_circular_t *cir) {
 
 }
 
+/* DMA interfacing */
+static void mp_serial_UART_dmaTx(mp_uart_t *uart) {
+	mp_serial_t *serial = uart->user;
+
+	mp_ring_consume(&serial->txRing, serial->dmaTxSize);
+	serial->dmaTxSize = 0;
+
+	_mp_serial_dma_txNext(serial);
+}
+
+static void mp_serial_UART_dmaRx(mp_uart_t *uart) {
+	mp_serial_t *serial = uart->user;
+
+	serial->dmaRxLap += serial->rxRing.mask+1;
+	serial->dmaRxHalf = YES;
+	serial->rxRing.head = serial->dmaRxLap+mp_uart_dma_rx_count(uart);
+
+	if(serial->onDma)
+		serial->onDma(serial, MP_SERIAL_DMA_FULL);
+}
+
+/* interrupts disabled or from the DMA interrupt */
+static void _mp_serial_dma_txNext(mp_serial_t *serial) {
+	mp_ring_span_t span[2];
+
+	if(serial->dmaTxSize != 0)
+		return;
+
+	/* the wrapped part goes with the next transfer */
+	if(mp_ring_peek(&serial->txRing, span) == 0)
+		return;
+
+	serial->dmaTxSize = span[0].size;
+	mp_uart_dma_tx(serial->uart, span[0].data, span[0].size);
+}
+
+/* ring backends, the transmitter may be idle */
+static void _mp_serial_txStart(mp_serial_t *serial) {
+	if(serial->useDma == YES) {
+		MP_INTERRUPT_SAFE_BEGIN
+		_mp_serial_dma_txNext(serial);
+		MP_INTERRUPT_SAFE_END
+	}
+	else
+		mp_uart_enable_tx_int(serial->uart);
+}
+
+/* before reading the RX ring */
+static void _mp_serial_rxPrepare(mp_serial_t *serial) {
+	unsigned int count;
+
+	if(serial->useDma != YES)
+		return;
+
+	_mp_serial_dma_rxSync(serial);
+
+	/* the channel does not wait for the reader */
+	count = mp_ring_count(&serial->rxRing);
+	if(count > serial->rxRing.mask+1) {
+		serial->rxRing.overruns += count-(serial->rxRing.mask+1);
+		serial->rxRing.tail = serial->rxRing.head-(serial->rxRing.mask+1);
+	}
+}
+
+/* the channel position gives the RX ring head, not from ISRs */
+static void _mp_serial_dma_rxSync(mp_serial_t *serial) {
+	MP_INTERRUPT_SAFE_BEGIN
+
+	serial->rxRing.head = serial->dmaRxLap+mp_uart_dma_rx_count(serial->uart);
+
+	MP_INTERRUPT_SAFE_END
+}
+
+static void _mp_serial_dma_check(mp_ktimer_t *timer) {
+	mp_serial_t *serial = timer->user;
+	unsigned short head;
+	unsigned int lap;
+
+	_mp_serial_dma_rxSync(serial);
+	head = serial->rxRing.head;
+
+	/* a lap done but not served is notified by the interrupt */
+	lap = (unsigned short)(head-serial->dmaRxLap);
+	if(serial->dmaRxHalf == YES && lap >= (serial->rxRing.mask+1)/2 && lap <= serial->rxRing.mask) {
+		serial->dmaRxHalf = NO;
+		if(serial->onDma)
+			serial->onDma(serial, MP_SERIAL_DMA_HALF);
+	}
+
+	if(head != serial->dmaRxSeen) {
+		serial->dmaRxSeen = head;
+		serial->dmaRxIdle = YES;
+	}
+	else if(serial->dmaRxIdle == YES) {
+		serial->dmaRxIdle = NO;
+		if(serial->onDma)
+			serial->onDma(serial, MP_SERIAL_DMA_IDLE);
+	}
+}
+
 #endif
 
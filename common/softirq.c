@@ -0,0 +1,173 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <mp.h>
+
+static mp_ret_t _mp_softirq_push(mp_softirq_t *sirq, mp_softirq_handler_t handler, void *user, unsigned char signal);
+
+/**
+@defgroup mpCommonSoftirq Deferred works
+
+@ingroup mpCommon
+
+@brief ISR to kernel loop deferred work ring
+
+@version 1.0.0
+
+@author @htmlonly &copy; @endhtmlonly 2016
+Michael Vergoz <mv@verman.fr>
+
+@date 18 Apr 2016
+
+ISRs must stay short and must not touch the task scheduler which is
+used by the kernel loop at the same moment. Instead an ISR posts a small
+work item into a single producer / single consumer ring and the kernel
+loop executes the whole batch at the beginning of each iteration.
+
+The ring has no lock : the head index is only written by the producer
+and the tail index only by the consumer. On MSP430 ISRs do not nest so
+all ISRs together act as the single producer. Posting from the main
+context is not allowed, use mp_task_signal() there.
+
+When the ring is full the post is accounted into the overrun counter and
+mp_softirq_signal() falls back to a direct mp_task_signal(). Increase
+MP_SOFTIRQ_SIZE if it happens.
+
+@code
+static void _mp_drv_XXX_onDRDY(void *user) {
+	mp_drv_XXX_t *XXX = user;
+
+	XXX->intSrc |= 0x1;
+	mp_softirq_signal(XXX->task, MP_TASK_SIG_PENDING);
+}
+@endcode
+
+@{
+*/
+
+#define _MASK (MP_SOFTIRQ_SIZE-1)
+
+/**
+ * @brief Initialize the kernel deferred work ring
+ *
+ * @param[in] kernel Kernel handler
+ */
+void mp_softirq_init(mp_kernel_t *kernel) {
+	memset((void *)&kernel->softirq, 0, sizeof(kernel->softirq));
+}
+
+/**
+ * @brief Post a function to execute from the kernel loop
+ *
+ * Only from ISR context
+ *
+ * @param[in] kernel Kernel handler
+ * @param[in] handler Function to execute
+ * @param[in] user User pointer given to handler
+ * @return TRUE or FALSE if the ring is full
+ */
+mp_ret_t mp_softirq_post(mp_kernel_t *kernel, mp_softirq_handler_t handler, void *user) {
+	return(_mp_softirq_push(&kernel->softirq, handler, user, 0));
+}
+
+/**
+ * @brief Signal a task from the kernel loop
+ *
+ * Only from ISR context. Replaces mp_task_signal() inside ISRs.
+ *
+ * @param[in] task Task to signal
+ * @param[in] signal Signal
+ */
+void mp_softirq_signal(mp_task_t *task, mp_task_signal_t signal) {
+	if(_mp_softirq_push(&task->handler->kernel->softirq, NULL, task, signal) == FALSE)
+		mp_task_signal(task, signal);
+}
+
+/**
+ * @brief Check for deferred works
+ *
+ * @param[in] kernel Kernel handler
+ * @return YES if the ring is not empty
+ */
+mp_bool_t mp_softirq_pending(mp_kernel_t *kernel) {
+	return(kernel->softirq.head != kernel->softirq.tail ? YES : NO);
+}
+
+/**
+ * @brief Execute posted works
+ *
+ * Called at the beginning of each kernel loop. Works posted during the
+ * drain are left for the next loop.
+ *
+ * @param[in] kernel Kernel handler
+ * @return Number of executed works
+ */
+unsigned int mp_softirq_drain(mp_kernel_t *kernel) {
+	mp_softirq_t *sirq = &kernel->softirq;
+	volatile mp_softirq_item_t *item;
+	mp_softirq_handler_t handler;
+	unsigned char head = sirq->head;
+	unsigned char tail = sirq->tail;
+	void *user;
+	unsigned int count = 0;
+
+	while(tail != head) {
+		item = &sirq->items[tail & _MASK];
+		handler = item->handler;
+		user = item->user;
+
+		if(handler)
+			handler(user);
+		else
+			mp_task_signal(user, (mp_task_signal_t)item->signal);
+
+		/* release the slot */
+		sirq->tail = ++tail;
+		count++;
+	}
+
+	return(count);
+}
+
+/**@}*/
+
+static mp_ret_t _mp_softirq_push(mp_softirq_t *sirq, mp_softirq_handler_t handler, void *user, unsigned char signal) {
+	unsigned char head = sirq->head;
+	volatile mp_softirq_item_t *item;
+
+	if((unsigned char)(head-sirq->tail) >= MP_SOFTIRQ_SIZE) {
+		sirq->overrun++;
+		return(FALSE);
+	}
+
+	item = &sirq->items[head & _MASK];
+	item->handler = handler;
+	item->user = user;
+	item->signal = signal;
+
+	/* publish the item */
+	sirq->head = head+1;
+
+	/* kernel loop may sleep */
+	mp_interrupt_lpm_exit();
+
+	return(TRUE);
+}
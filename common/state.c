@@ -75,6 +75,10 @@ Example 2 shows how to switch machine state n1 :
 mp_state_switch(&kernel->states, 1);
 @endcode
 
+Memory needed by a state only can be taken from an arena bound with
+mp_state_arena() (see @ref mpCommonArena), the arena is reset when
+the state is left then unset doesn't have to free it piece by piece.
+
 
 @{
 */
@@ -117,25 +121,31 @@ mp_ret_t mp_state_switch(mp_state_handler_t *hdl, char number) {
   * @param[in] hdl Context
   */
 void mp_state_tick(mp_state_handler_t *hdl) {
-	char save_state = hdl->changeState;
-	void *user = hdl->states[hdl->currentState].user;
+	unsigned char save_state = hdl->changeState;
+	unsigned char current = hdl->currentState;
+	void *user = hdl->states[current].user;
 
 	/* check for state change */
-	if(hdl->currentState != save_state) {
+	if(current != save_state) {
+		MP_TRACE_EVENT(MP_TRACE_STATE, save_state, 0);
+
 		mp_clock_reset(hdl->kernel);
 
 		/* unset the actual state */
-		hdl->states[hdl->currentState].unset(user);
+		hdl->states[current].unset(user);
+		if(hdl->states[current].arena)
+			mp_arena_reset(hdl->states[current].arena);
 
 		/* set new state*/
 		user = hdl->states[save_state].user;
 		hdl->states[save_state].set(user);
 
 		hdl->currentState = save_state;
+		current = save_state;
 	}
 
 	/* call the machine state */
-	hdl->states[hdl->currentState].tick(user);
+	hdl->states[current].tick(user);
 }
 
 /**
@@ -156,14 +166,15 @@ mp_ret_t mp_state_define(
 		mp_state_callback_t unset,
 		mp_state_callback_t tick
 	) {
+	unsigned char index = number;
 	mp_state_t *state;
 
 	/* assert */
-	if(number >= MP_STATE_MAX)
+	if(number < 0 || number >= MP_STATE_MAX)
 		return(FALSE);
 
 	/* get and assert state */
-	state = &hdl->states[number];
+	state = &hdl->states[index];
 	if(state->used == YES)
 		return(FALSE);
 
@@ -179,4 +190,23 @@ mp_ret_t mp_state_define(
 	return(TRUE);
 }
 
+/**
+  * @brief Bind an arena to a machine state
+  *
+  * The arena is reset once the state unset callback returns.
+  *
+  * @param[in] hdl Context
+  * @param[in] number Machine state number
+  * @param[in] arena Arena or NULL to unbind
+  * @return TRUE or FALSE
+  */
+mp_ret_t mp_state_arena(mp_state_handler_t *hdl, char number, mp_arena_t *arena) {
+	unsigned char index = number;
+
+	if(number < 0 || number >= MP_STATE_MAX)
+		return(FALSE);
+	hdl->states[index].arena = arena;
+	return(TRUE);
+}
+
 /**@}*/
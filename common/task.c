@@ -20,6 +20,15 @@
 
 #include <mp.h>
 
+static void _mp_task_queue(mp_task_t *task);
+static void _mp_task_unqueue(mp_task_t *task);
+
+static void _mp_task_heap_push(mp_task_handler_t *hdl, mp_task_t *task);
+static void _mp_task_heap_remove(mp_task_handler_t *hdl, mp_task_t *task);
+
+static void _mp_task_ready_add(mp_task_handler_t *hdl, mp_task_t *task);
+static void _mp_task_ready_remove(mp_task_handler_t *hdl, mp_task_t *task);
+
 /**
 @defgroup mpCommonTask Task manager
 
@@ -46,6 +55,7 @@ void mp_task_init(mp_kernel_t *kernel, mp_task_handler_t *hdl) {
 	int a;
 	for(a=0; a<MP_TASK_MAX; a++) {
 		task = &hdl->tasks[a];
+		task->heapIndex = -1;
 
 		/* add task into the free list */
 		mp_list_add_last(&hdl->freeList, &task->item, task);
@@ -102,6 +112,13 @@ mp_task_t *mp_task_create(mp_task_handler_t *hdl, char *name, mp_task_wakeup_t w
 	task->name = name;
 	task->wakeup = wakeup;
 	task->user = user;
+	task->heapIndex = -1;
+	task->ready = NO;
+
+#ifdef MP_TASK_STATS
+	memset(&task->stats, 0, sizeof(task->stats));
+	task->signaledArmed = NO;
+#endif
 
 	hdl->usedNumber++;
 
@@ -120,25 +137,51 @@ mp_ret_t mp_task_destroy(mp_task_t *task) {
 }
 
 void mp_task_signal(mp_task_t *task, mp_task_signal_t signal) {
+	mp_task_handler_t *hdl = task->handler;
+
+	MP_INTERRUPT_SAFE_BEGIN
+
 	if(task->signal != MP_TASK_SIG_SLEEP && signal == MP_TASK_SIG_SLEEP)
-		task->handler->sleepNumber++;
+		hdl->sleepNumber++;
 	else if(task->signal == MP_TASK_SIG_SLEEP && signal != MP_TASK_SIG_SLEEP)
-		task->handler->sleepNumber--;
+		hdl->sleepNumber--;
 
 	if(task->signal != MP_TASK_SIG_PENDING && signal == MP_TASK_SIG_PENDING)
-		task->handler->pendingNumber++;
+		hdl->pendingNumber++;
 	else if(task->signal == MP_TASK_SIG_PENDING && signal != MP_TASK_SIG_PENDING)
-		task->handler->pendingNumber--;
+		hdl->pendingNumber--;
+
+#ifdef MP_TASK_STATS
+	/* start the signal to dispatch latency */
+	if(task->signaledArmed == NO && (signal == MP_TASK_SIG_PENDING || signal == MP_TASK_SIG_STOP)) {
+		task->signaled = mp_clock_hires();
+		task->signaledArmed = YES;
+	}
+#endif
+
+	/* the running task is queued back by mp_task_tick() */
+	if(task != hdl->running)
+		_mp_task_unqueue(task);
 
 	task->signal = signal;
+
+	if(task != hdl->running)
+		_mp_task_queue(task);
+
+	MP_INTERRUPT_SAFE_END
+
 	mp_clock_task_change(task);
 }
 
 mp_task_tick_t mp_task_tick(mp_task_handler_t *hdl) {
 	unsigned long now;
-	mp_bool_t pass = NO;
-	mp_task_t *next;
+	unsigned int count;
+	mp_task_t *prev;
 	mp_task_t *seek;
+#ifdef MP_TASK_STATS
+	unsigned long start;
+	unsigned long elapsed;
+#endif
 
 	/* assert */
 	if(hdl->usedNumber == 0) {
@@ -150,49 +193,94 @@ mp_task_tick_t mp_task_tick(mp_task_handler_t *hdl) {
 	/* get clock */
 	now = mp_clock_ticks();
 
-	/* just send the message to all tasks */
-	seek = hdl->usedList.last->user;
-	while(seek != NULL) {
-		next = seek->item.prev != NULL ? seek->item.prev->user : NULL;
+	/* a stop has been sent : just send the message to all tasks */
+	if(hdl->signal == MP_TASK_SIG_STOP) {
+		seek = hdl->usedList.last->user;
+		while(seek != NULL) {
+			prev = seek->item.prev != NULL ? seek->item.prev->user : NULL;
+			if(seek->signal != MP_TASK_SIG_STOP && seek->signal != MP_TASK_SIG_DEAD)
+				mp_task_signal(seek, MP_TASK_SIG_STOP);
+			seek = prev;
+		}
+	}
+
+	/* move due tasks from the deadline heap into the ready list */
+	MP_INTERRUPT_SAFE_BEGIN
+	while(hdl->heapNumber > 0) {
+		seek = hdl->heap[0];
+		if(now-seek->check < seek->delay)
+			break;
 
-		/* check the task status : a stop has been sent */
-		if(hdl->signal == MP_TASK_SIG_STOP) {
-			mp_task_signal(seek, MP_TASK_SIG_STOP);
-			pass = YES;
+		_mp_task_heap_remove(hdl, seek);
+		_mp_task_ready_add(hdl, seek);
+	}
+	MP_INTERRUPT_SAFE_END
+
+	/*
+	 * only run what is ready now, a task made ready by a wakeup
+	 * will be executed on the next tick
+	 */
+	count = hdl->readyNumber;
+	while(count > 0) {
+		count--;
+
+		MP_INTERRUPT_SAFE_BEGIN
+		seek = hdl->readyList.first != NULL ? hdl->readyList.first->user : NULL;
+		if(seek != NULL) {
+			_mp_task_ready_remove(hdl, seek);
+			hdl->running = seek;
 		}
-		else if(seek->signal == MP_TASK_SIG_PENDING)
-			pass = YES;
-		else if(seek->signal == MP_TASK_SIG_SLEEP)
-			pass = NO;
-		else if(now-seek->check >= seek->delay)
-			pass = YES;
-		else
-			pass = NO;
+		MP_INTERRUPT_SAFE_END
+
+		if(seek == NULL)
+			break;
+
+		/* execute wakeup, a task killed outside its wakeup is only recycled */
+		if(seek->signal != MP_TASK_SIG_DEAD) {
+#ifdef MP_TASK_STATS
+			start = mp_clock_hires();
+			if(seek->signaledArmed == YES) {
+				elapsed = start-seek->signaled;
+				if(elapsed > seek->stats.latencyMax)
+					seek->stats.latencyMax = elapsed;
+				seek->signaledArmed = NO;
+			}
+#endif
 
-		if(pass == YES) {
-			/* execute wakeup */
+			MP_TRACE_EVENT(MP_TRACE_TASK_BEGIN, seek-hdl->tasks, 0);
 			seek->wakeup(seek);
+			MP_TRACE_EVENT(MP_TRACE_TASK_END, seek-hdl->tasks, 0);
+
+#ifdef MP_TASK_STATS
+			elapsed = mp_clock_hires()-start;
+			seek->stats.wakeups++;
+			seek->stats.execTotal += elapsed;
+			if(elapsed > seek->stats.execMax)
+				seek->stats.execMax = elapsed;
+#endif
+		}
 
-			/* signal was pending restore OK state */
-			//if(seek->signal == MP_TASK_SIG_PENDING)
-				//mp_task_signal(seek, MP_TASK_SIG_OK);
+		MP_INTERRUPT_SAFE_BEGIN
+		hdl->running = NULL;
 
-			/* acknowledge stop dead message */
-			if(seek->signal == MP_TASK_SIG_DEAD) {
-				/* remove from usedList */
-				mp_list_remove(&hdl->usedList, &seek->item);
+		/* acknowledge stop dead message */
+		if(seek->signal == MP_TASK_SIG_DEAD) {
+			/* remove from usedList */
+			mp_list_remove(&hdl->usedList, &seek->item);
 
-				/* add to freelist */
-				mp_list_add_last(&hdl->freeList, &seek->item, seek);
+			/* add to freelist */
+			seek->wakeup = NULL;
+			mp_list_add_last(&hdl->freeList, &seek->item, seek);
 
-				/* less task */
-				hdl->usedNumber--;
-			}
-			/* recycle check delay */
-			else
-				seek->check = now;
+			/* less task */
+			hdl->usedNumber--;
 		}
-		seek = next;
+		/* recycle check delay */
+		else {
+			seek->check = now;
+			_mp_task_queue(seek);
+		}
+		MP_INTERRUPT_SAFE_END
 	}
 
 	if(hdl->signal == MP_TASK_SIG_STOP && hdl->usedNumber == 0)
@@ -203,4 +291,209 @@ mp_task_tick_t mp_task_tick(mp_task_handler_t *hdl) {
 	return(MP_TASK_WORKING);
 }
 
+/**
+ * @brief Ticks to wait before the next task wakeup
+ *
+ * Used by the clock to sleep until the earliest deadline
+ *
+ * @param[in] hdl Task handler
+ * @param[in] now Actual clock ticks
+ * @return 0 if a task is ready or due, @ref MP_TASK_NO_WAKEUP if nothing is scheduled
+ */
+unsigned long mp_task_next_wakeup(mp_task_handler_t *hdl, unsigned long now) {
+	unsigned long wait = MP_TASK_NO_WAKEUP;
+	mp_task_t *first;
+
+	MP_INTERRUPT_SAFE_BEGIN
+
+	if(hdl->readyNumber > 0 || hdl->signal == MP_TASK_SIG_STOP)
+		wait = 0;
+	else if(hdl->heapNumber > 0) {
+		first = hdl->heap[0];
+		if(now-first->check >= first->delay)
+			wait = 0;
+		else
+			wait = first->delay-(now-first->check);
+	}
+
+	MP_INTERRUPT_SAFE_END
+
+	return(wait);
+}
+
+#ifdef MP_TASK_STATS
+/**
+ * @brief Get a copy of task runtime statistics
+ *
+ * @param[in] task Task
+ * @param[out] stats Statistics copy
+ */
+void mp_task_stats_get(mp_task_t *task, mp_task_stats_t *stats) {
+	MP_INTERRUPT_SAFE_BEGIN
+	memcpy(stats, &task->stats, sizeof(*stats));
+	MP_INTERRUPT_SAFE_END
+}
+
+/**
+ * @brief Reset runtime statistics of all used tasks
+ *
+ * @param[in] hdl Task handler
+ */
+void mp_task_stats_reset(mp_task_handler_t *hdl) {
+	mp_list_item_t *item;
+	mp_task_t *task;
+
+	MP_INTERRUPT_SAFE_BEGIN
+	for(item=hdl->usedList.first; item != NULL; item=item->next) {
+		task = item->user;
+		memset(&task->stats, 0, sizeof(task->stats));
+		task->signaledArmed = NO;
+	}
+	MP_INTERRUPT_SAFE_END
+}
+
+/**
+ * @brief Dump runtime statistics of all used tasks through mp_printk()
+ *
+ * @param[in] hdl Task handler
+ */
+void mp_task_stats_dump(mp_task_handler_t *hdl) {
+	mp_task_stats_t stats;
+	mp_list_item_t *item;
+	mp_task_t *task;
+
+	mp_printk("Task stats: %u used, %u sleeping, %u pending", hdl->usedNumber, hdl->sleepNumber, hdl->pendingNumber);
+
+	for(item=hdl->usedList.first; item != NULL; item=item->next) {
+		task = item->user;
+		mp_task_stats_get(task, &stats);
+
+		mp_printk("Task %s: %lu wakeups, exec %lums total %luus max, latency %luus max",
+			task->name, stats.wakeups,
+			mp_clock_hires_ms(stats.execTotal),
+			mp_clock_hires_us(stats.execMax),
+			mp_clock_hires_us(stats.latencyMax)
+		);
+	}
+}
+#endif
+
 /**@}*/
+
+/*
+ * A task lives in exactly one place depending on its signal :
+ * OK tasks are ordered by deadline into the heap, PENDING, STOP and DEAD
+ * tasks wait into the ready list and SLEEP tasks are nowhere until someone
+ * signals them. Those helpers must be called with interrupts disabled.
+ */
+static void _mp_task_queue(mp_task_t *task) {
+	mp_task_handler_t *hdl = task->handler;
+
+	/* released task */
+	if(task->wakeup == NULL)
+		return;
+
+	switch(task->signal) {
+		case MP_TASK_SIG_OK:
+			task->deadline = task->check+task->delay;
+			_mp_task_heap_push(hdl, task);
+			break;
+
+		case MP_TASK_SIG_PENDING:
+		case MP_TASK_SIG_STOP:
+		case MP_TASK_SIG_DEAD:
+			_mp_task_ready_add(hdl, task);
+			break;
+
+		default:
+			break;
+	}
+}
+
+static void _mp_task_unqueue(mp_task_t *task) {
+	mp_task_handler_t *hdl = task->handler;
+
+	if(task->heapIndex >= 0)
+		_mp_task_heap_remove(hdl, task);
+	if(task->ready == YES)
+		_mp_task_ready_remove(hdl, task);
+}
+
+static void _mp_task_ready_add(mp_task_handler_t *hdl, mp_task_t *task) {
+	mp_list_add_last(&hdl->readyList, &task->readyItem, task);
+	task->ready = YES;
+	hdl->readyNumber++;
+}
+
+static void _mp_task_ready_remove(mp_task_handler_t *hdl, mp_task_t *task) {
+	mp_list_remove(&hdl->readyList, &task->readyItem);
+	task->ready = NO;
+	hdl->readyNumber--;
+}
+
+static inline mp_bool_t _mp_task_heap_before(mp_task_t *a, mp_task_t *b) {
+	/* wrap safe */
+	return((long)(a->deadline-b->deadline) < 0 ? YES : NO);
+}
+
+static inline void _mp_task_heap_place(mp_task_handler_t *hdl, mp_task_t *task, int index) {
+	hdl->heap[index] = task;
+	task->heapIndex = index;
+}
+
+static void _mp_task_heap_up(mp_task_handler_t *hdl, int index) {
+	mp_task_t *task = hdl->heap[index];
+	int parent;
+
+	while(index > 0) {
+		parent = (index-1)/2;
+		if(_mp_task_heap_before(task, hdl->heap[parent]) == NO)
+			break;
+		_mp_task_heap_place(hdl, hdl->heap[parent], index);
+		index = parent;
+	}
+	_mp_task_heap_place(hdl, task, index);
+}
+
+static void _mp_task_heap_down(mp_task_handler_t *hdl, int index) {
+	mp_task_t *task = hdl->heap[index];
+	int number = hdl->heapNumber;
+	int child;
+
+	while((child = 2*index+1) < number) {
+		if(child+1 < number && _mp_task_heap_before(hdl->heap[child+1], hdl->heap[child]) == YES)
+			child++;
+		if(_mp_task_heap_before(hdl->heap[child], task) == NO)
+			break;
+		_mp_task_heap_place(hdl, hdl->heap[child], index);
+		index = child;
+	}
+	_mp_task_heap_place(hdl, task, index);
+}
+
+static void _mp_task_heap_push(mp_task_handler_t *hdl, mp_task_t *task) {
+	_mp_task_heap_place(hdl, task, hdl->heapNumber);
+	hdl->heapNumber++;
+	_mp_task_heap_up(hdl, task->heapIndex);
+}
+
+static void _mp_task_heap_remove(mp_task_handler_t *hdl, mp_task_t *task) {
+	int index = task->heapIndex;
+	mp_task_t *last;
+
+	task->heapIndex = -1;
+	hdl->heapNumber--;
+
+	/* it was the last one */
+	if(index == hdl->heapNumber)
+		return;
+
+	/* fill the hole with the last task */
+	last = hdl->heap[hdl->heapNumber];
+	_mp_task_heap_place(hdl, last, index);
+
+	if(index > 0 && _mp_task_heap_before(last, hdl->heap[(index-1)/2]) == YES)
+		_mp_task_heap_up(hdl, index);
+	else
+		_mp_task_heap_down(hdl, index);
+}
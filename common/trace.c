@@ -0,0 +1,242 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <mp.h>
+
+#ifdef MP_TRACE
+
+MP_TASK(_mp_trace_drain);
+
+static void _mp_trace_name(mp_serial_t *serial, unsigned char type, unsigned char id, char *name);
+
+/**
+@defgroup mpCommonTrace Kernel tracer
+
+@ingroup mpCommon
+
+@brief Binary event trace drained over a serial port
+
+@version 1.0.0
+
+@author @htmlonly &copy; @endhtmlonly 2016
+Michael Vergoz <mv@verman.fr>
+
+@date 29 Apr 2016
+
+When MP_TRACE is defined the kernel records task wakeups, ISR entry and
+exit, regMaster operations, state switches and LPM periods into a ring
+of MP_TRACE_SIZE records of 8 bytes timestamped with mp_clock_hires().
+Writing a record only copies 8 bytes with interrupts disabled. Records
+are dropped when the ring is full and accounted into a MP_TRACE_LOST
+record. The ISR of the drain port is not traced, each byte sent would
+otherwise add new records and the ring would fill with its own traffic.
+
+A background task sends the records over a serial port. The stream
+starts with a MP_TRACE_SYNC record giving the timestamp frequency and
+the names of the existing tasks and states. tools/trace2chrome converts
+a capture into a Chrome / Perfetto trace :
+
+@code
+mp_trace_start(&olimex->kernel, &olimex->serial);
+
+// host side
+// $ make trace2chrome
+// $ ./tools/bin/trace2chrome capture.bin > capture.json
+@endcode
+
+Without MP_TRACE the hooks compile to nothing.
+
+@{
+*/
+
+/* records sent per drain, keeps serial buffering small */
+#define _DRAIN_RECORDS (MP_CIRCULAR_BUFFER_SIZE/sizeof(mp_trace_record_t))
+
+#define _MASK (MP_TRACE_SIZE-1)
+
+static mp_trace_record_t __records[MP_TRACE_SIZE];
+static volatile unsigned char __head = 0;
+static volatile unsigned char __tail = 0;
+static volatile unsigned int __lost = 0;
+static volatile mp_bool_t __enabled = NO;
+
+/* traced id of the drain port vector, -1 when unknown */
+static int __muted = -1;
+
+static mp_serial_t *__serial = NULL;
+static mp_task_t *__task = NULL;
+
+/**
+ * @brief Start tracing to a serial port
+ *
+ * @param[in] kernel Kernel handler
+ * @param[in] serial Opened serial port
+ * @return TRUE or FALSE
+ */
+mp_ret_t mp_trace_start(mp_kernel_t *kernel, mp_serial_t *serial) {
+	mp_trace_record_t sync;
+	mp_list_item_t *item;
+	mp_task_t *task;
+	int a;
+
+	if(__task)
+		return(FALSE);
+
+	__task = mp_task_create(&kernel->tasks, "Trace", _mp_trace_drain, NULL, 10);
+	if(!__task)
+		return(FALSE);
+
+	__serial = serial;
+	__muted = -1;
+	if(serial->uart && serial->uart->gate)
+		__muted = (unsigned char)serial->uart->gate->_ISRVector;
+
+	/* stream header */
+	sync.time = MP_CLOCK_HIRES_HZ;
+	sync.type = MP_TRACE_SYNC;
+	sync.id = MP_TRACE_VERSION;
+	sync.arg = sizeof(sync);
+	mp_serial_write(serial, (unsigned char *)&sync, sizeof(sync));
+
+	for(item=kernel->tasks.usedList.first; item; item=item->next) {
+		task = item->user;
+		_mp_trace_name(serial, MP_TRACE_NAME_TASK, task-kernel->tasks.tasks, task->name);
+	}
+
+	for(a=0; a<MP_STATE_MAX; a++) {
+		if(kernel->states.states[a].used)
+			_mp_trace_name(serial, MP_TRACE_NAME_STATE, a, kernel->states.states[a].name);
+	}
+
+	MP_INTERRUPT_SAFE_BEGIN
+	__head = __tail = 0;
+	__lost = 0;
+	__enabled = YES;
+	MP_INTERRUPT_SAFE_END
+
+	return(TRUE);
+}
+
+/**
+ * @brief Stop tracing
+ */
+void mp_trace_stop() {
+	__enabled = NO;
+
+	if(__task) {
+		mp_task_destroy(__task);
+		__task = NULL;
+	}
+}
+
+/**
+ * @brief Record an event, from any context
+ *
+ * Prefer MP_TRACE_EVENT() which disappears without MP_TRACE
+ *
+ * @param[in] type mp_trace_type_t
+ * @param[in] id Event object
+ * @param[in] arg Event argument
+ */
+void mp_trace_write(unsigned char type, unsigned char id, unsigned short arg) {
+	mp_trace_record_t *record;
+
+	if(__enabled == NO)
+		return;
+
+	if((type == MP_TRACE_ISR_ENTER || type == MP_TRACE_ISR_EXIT) && id == __muted)
+		return;
+
+	MP_INTERRUPT_SAFE_BEGIN
+	if((unsigned char)(__head-__tail) >= MP_TRACE_SIZE)
+		__lost++;
+	else {
+		record = &__records[__head & _MASK];
+		record->time = mp_clock_hires();
+		record->type = type;
+		record->id = id;
+		record->arg = arg;
+		__head++;
+	}
+	MP_INTERRUPT_SAFE_END
+}
+
+/**@}*/
+
+MP_TASK(_mp_trace_drain) {
+	mp_trace_record_t buffer[_DRAIN_RECORDS];
+	unsigned int lost;
+	int count = 0;
+
+	if(task->signal == MP_TASK_SIG_STOP) {
+		mp_task_signal(task, MP_TASK_SIG_DEAD);
+		return;
+	}
+
+	MP_INTERRUPT_SAFE_BEGIN
+	lost = __lost;
+	__lost = 0;
+	MP_INTERRUPT_SAFE_END
+
+	/* only the drain moves the tail */
+	while(count < _DRAIN_RECORDS-(lost > 0 ? 1 : 0) && __tail != __head) {
+		memcpy(&buffer[count++], &__records[__tail & _MASK], sizeof(mp_trace_record_t));
+		__tail++;
+	}
+
+	/* drops happened after the records in the ring */
+	if(lost > 0) {
+		buffer[count].time = mp_clock_hires();
+		buffer[count].type = MP_TRACE_LOST;
+		buffer[count].id = 0;
+		buffer[count].arg = lost > 0xffff ? 0xffff : lost;
+		count++;
+	}
+
+	if(count > 0)
+		mp_serial_write(__serial, (unsigned char *)buffer, count*sizeof(mp_trace_record_t));
+}
+
+static void _mp_trace_name(mp_serial_t *serial, unsigned char type, unsigned char id, char *name) {
+	mp_trace_record_t record;
+	unsigned char pad[sizeof(record)];
+	int len = name ? strlen(name) : 0;
+
+	if(len > 0xff)
+		len = 0xff;
+
+	record.time = 0;
+	record.type = type;
+	record.id = id;
+	record.arg = len;
+	mp_serial_write(serial, (unsigned char *)&record, sizeof(record));
+
+	if(len > 0)
+		mp_serial_write(serial, (unsigned char *)name, len);
+
+	/* keep the stream aligned on records */
+	if(len % sizeof(record)) {
+		memset(pad, 0, sizeof(pad));
+		mp_serial_write(serial, pad, sizeof(record)-(len % sizeof(record)));
+	}
+}
+
+#endif
@@ -206,7 +206,7 @@ static void ___on_button(void *user) {
 	if(button->pressed == YES)
 		button->pressDelay = now;
 	else {
-		mp_task_signal(button->task, MP_TASK_SIG_PENDING);
+		mp_softirq_signal(button->task, MP_TASK_SIG_PENDING);
 		button->pressDelay = now-button->pressDelay;
 	}
 
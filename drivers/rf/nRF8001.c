@@ -71,6 +71,7 @@ mp_ret_t mp_drv_nRF8001_init(mp_kernel_t *kernel, mp_drv_nRF8001_t *nRF8001, mp_
 
 	memset(nRF8001, 0, sizeof(*nRF8001));
 	nRF8001->kernel = kernel;
+	mp_event_init(&nRF8001->events);
 
 	/* Reset IO */
 	value = mp_options_get(options, "reset");
@@ -189,7 +190,7 @@ mp_ret_t mp_drv_nRF8001_init(mp_kernel_t *kernel, mp_drv_nRF8001_t *nRF8001, mp_
 	}
 
 	/* set task sleeping */
-	mp_task_signal(nRF8001->task, MP_TASK_SIG_SLEEP);
+	mp_event_wait(&nRF8001->events, nRF8001->task, MP_NRF8001_EV_RX | MP_NRF8001_EV_TX, MP_EVENT_ANY);
 
 	mp_printk("nRF8001(%p) driver initialization in memory structure size of %d bytes", nRF8001, sizeof(*nRF8001));
 
@@ -240,7 +241,7 @@ mp_bool_t mp_drv_nRF8001_send_queue(mp_drv_nRF8001_t *nRF8001, mp_drv_nRF8001_ac
 	/* add queue at last pending */
 
 	mp_list_add_last(&nRF8001->pending_tx_pkts, &queue->item, queue);
-	mp_task_signal(nRF8001->task, MP_TASK_SIG_PENDING);
+	mp_event_set(&nRF8001->events, MP_NRF8001_EV_TX);
 
 	return(TRUE);
 }
@@ -339,7 +340,7 @@ static void _mp_drv_nRF8001_onIntRdyn(void *user) {
 MP_TASK(_mp_drv_nRF8001_ASR) {
 	mp_drv_nRF8001_t *nRF8001 = task->user;
 	mp_drv_nRF8001_aci_queue_t *queue;
-	char canRequestOff = 0;
+	unsigned int bits;
 
 	/* receive nRF8001 shutdown */
 	if(task->signal == MP_TASK_SIG_STOP) {
@@ -351,11 +352,13 @@ MP_TASK(_mp_drv_nRF8001_ASR) {
 		return;
 	}
 
+	bits = mp_event_take(&nRF8001->events, MP_NRF8001_EV_RX | MP_NRF8001_EV_TX, MP_EVENT_ANY);
+
 	/* protect linked-list */
 	mp_spi_disable_store(&nRF8001->spi);
 
 	/* RX packet pending */
-	if(nRF8001->duplexStatus & MP_NRF8001_DUPLEX_RX_PENDING) {
+	if(bits & MP_NRF8001_EV_RX) {
 		if(nRF8001->pending_rx_pkts.first) {
 			queue = nRF8001->pending_rx_pkts.first->user;
 			unsigned char opcode = queue->packet.payload[0];
@@ -369,12 +372,11 @@ MP_TASK(_mp_drv_nRF8001_ASR) {
 			/* switch to free rx pkts */
 			mp_list_add_first(&nRF8001->rx_pkts, &queue->item, queue);
 		}
-		else {
-			nRF8001->duplexStatus &= ~MP_NRF8001_DUPLEX_RX_PENDING;
-		}
+
+		/* one packet per wake up */
+		if(nRF8001->pending_rx_pkts.first)
+			mp_event_set(&nRF8001->events, MP_NRF8001_EV_RX);
 	}
-	else
-		canRequestOff++;
 
 	/* execute TX packets */
 	if(!nRF8001->current_tx_pkts && nRF8001->pending_tx_pkts.first) {
@@ -387,16 +389,12 @@ MP_TASK(_mp_drv_nRF8001_ASR) {
 			mp_gpio_unset(nRF8001->reqn);
 		}
 	}
-	else
-		canRequestOff++;
 
 	/* protect linked-list */
 	mp_spi_disable_restore(&nRF8001->spi);
 
-	/* disable all ? */
-	if(canRequestOff == 2) {
-		mp_task_signal(task, MP_TASK_SIG_SLEEP);
-	}
+	/* sleep until the next packet */
+	mp_event_wait(&nRF8001->events, task, MP_NRF8001_EV_RX | MP_NRF8001_EV_TX, MP_EVENT_ANY);
 }
 
 static void _mp_drv_nRF8001_spi_interrupt(mp_spi_t *spi, mp_spi_iv_t iv) {
@@ -424,11 +422,10 @@ static void _mp_drv_nRF8001_spi_interrupt(mp_spi_t *spi, mp_spi_iv_t iv) {
 					nRF8001->current_rx_pkts = NULL;
 
 					nRF8001->duplexStatus &= ~MP_NRF8001_DUPLEX_RX;
-					nRF8001->duplexStatus |= MP_NRF8001_DUPLEX_RX_PENDING;
 
 					nRF8001->statusByte = 0;
 
-					mp_task_signal(nRF8001->task, MP_TASK_SIG_PENDING);
+					mp_event_set_isr(&nRF8001->events, MP_NRF8001_EV_RX);
 
 					if(!nRF8001->current_tx_pkts) {
 						mp_spi_disable_both(&nRF8001->spi);
@@ -489,7 +486,7 @@ static void _mp_drv_nRF8001_spi_interrupt(mp_spi_t *spi, mp_spi_iv_t iv) {
 
 					nRF8001->duplexStatus &= ~MP_NRF8001_DUPLEX_TX;
 
-					mp_task_signal(nRF8001->task, MP_TASK_SIG_PENDING);
+					mp_event_set_isr(&nRF8001->events, MP_NRF8001_EV_TX);
 /*
 					if(!(nRF8001->duplexStatus & MP_NRF8001_DUPLEX_RX) && nRF8001->statusByte == 0) {
 						mp_spi_rx(spi);
@@ -80,43 +80,26 @@ mp_ret_t mp_drv_ADS1115_init(mp_kernel_t *kernel, mp_drv_ADS1115_t *ADS1115, mp_
 	else
 		ADS1115->drdy = NULL;
 
-	/* open spi */
-	ret = mp_i2c_open(kernel, &ADS1115->i2c, options, "ADS1115");
-	if(ret == FALSE)
-		return(FALSE);
-
-	mp_options_t setup[] = {
-		{ "frequency", "400000" },
-		{ "role", "master" },
-		{ NULL, NULL }
-	};
-	ret = mp_i2c_setup(&ADS1115->i2c, setup);
-	if(ret == FALSE) {
-		mp_i2c_close(&ADS1115->i2c);
-		return(FALSE);
-	}
-
-	/* set slave address */
-	mp_i2c_setSlaveAddress(&ADS1115->i2c, ADS1115_ADDRESS);
-
 	/* enable chip */
 	if(!ADS1115->drdy) {
 		mp_printk("ADS1115(%p): require DRDY interrupt for the moment", ADS1115);
-		mp_i2c_close(&ADS1115->i2c);
 		return(FALSE);
 	}
 
 	mp_printk("ADS1115(%p): Initializing", ADS1115);
 
-	/* create regmaster control */
-	ret = mp_regMaster_init_i2c(kernel, &ADS1115->regMaster,
-			&ADS1115->i2c, ADS1115, "ADS1115 I2C");
+	/* join the shared bus of the gate or open it */
+	ret = mp_regMaster_init_gate(kernel, &ADS1115->regMaster,
+			options, &ADS1115->i2c, ADS1115->regMasterOps, MP_REGMASTER_OPS,
+			ADS1115, "ADS1115 I2C");
 	if(ret == FALSE) {
 		mp_printk("ADS1115 error while creating regMaster context");
-		mp_i2c_close(&ADS1115->i2c);
 		return(FALSE);
 	}
 
+	/* set slave address */
+	mp_regMaster_setSlaveAddress(&ADS1115->regMaster, ADS1115_ADDRESS);
+
 	/* default config register */
 	ADS1115->config = 0x8583;
 
@@ -125,12 +108,12 @@ mp_ret_t mp_drv_ADS1115_init(mp_kernel_t *kernel, mp_drv_ADS1115_t *ADS1115, mp_
 	mp_drv_ADS1115_start(ADS1115);
 	mp_drv_ADS1115_updateConfig(ADS1115);
 
-	mp_regMaster_readExt(
+	mp_regMaster_readRegExt(
 		&ADS1115->regMaster,
-		mp_regMaster_register(ADS1015_REG_POINTER_CONFIG), 1,
+		ADS1015_REG_POINTER_CONFIG,
 		(unsigned char *)&ADS1115->config, 2,
 		_mp_drv_ADS1115_checkConfig, ADS1115,
-		TRUE // on the fly swap
+		TRUE, MP_REGMASTER_LANE_BG // on the fly swap
 	);
 
 
@@ -229,17 +212,12 @@ mp_ret_t mp_drv_ADS1115_updateConfig(mp_drv_ADS1115_t *ADS1115) {
 		return(FALSE);
 	}
 
-	/* load config buffer */
-	ADS1115->configBuffer[0] = ADS1015_REG_POINTER_CONFIG;
-	ADS1115->configBuffer[1] = (unsigned char)(ADS1115->config >> 8);
-	ADS1115->configBuffer[2] = (unsigned char)(ADS1115->config & 0xFF);
-
 	/* lock update */
 	ADS1115->flags |= ADS1115_FLAG_CONFIG;
 
-	mp_regMaster_write(
+	mp_regMaster_writeReg16(
 		&ADS1115->regMaster,
-		ADS1115->configBuffer, 3, // chelou ce cast en fait
+		ADS1015_REG_POINTER_CONFIG, ADS1115->config,
 		_mp_drv_ADS1115_onConfigUpdated, ADS1115
 	);
 
@@ -285,12 +263,12 @@ static void _mp_drv_ADS1115_onResult(mp_regMaster_op_t *operand, mp_bool_t termi
 	/* unlock update */
 	ADS1115->flags &= ~ADS1115_FLAG_CONFIG;
 
-	mp_regMaster_readExt(
+	mp_regMaster_readRegExt(
 		&ADS1115->regMaster,
-		mp_regMaster_register(ADS1015_REG_POINTER_CONVERT), 1,
+		ADS1015_REG_POINTER_CONVERT,
 		(unsigned char *)&ADS1115->value, 2,
 		_mp_drv_ADS1115_onResult, ADS1115,
-		TRUE // on the fly swap
+		TRUE, MP_REGMASTER_LANE_RT // on the fly swap
 	);
 }
 
@@ -298,12 +276,13 @@ static void _mp_drv_ADS1115_onResult(mp_regMaster_op_t *operand, mp_bool_t termi
 static void _mp_drv_ADS1115_onDRDY(void *user) {
 	mp_drv_ADS1115_t *ADS1115 = user;
 
-	mp_regMaster_readExt(
+	/* sample read goes before the configuration */
+	mp_regMaster_readRegExt(
 		&ADS1115->regMaster,
-		mp_regMaster_register(ADS1015_REG_POINTER_CONVERT), 1,
+		ADS1015_REG_POINTER_CONVERT,
 		(unsigned char *)&ADS1115->value, 2,
 		_mp_drv_ADS1115_onResult, ADS1115,
-		TRUE // on the fly swap
+		TRUE, MP_REGMASTER_LANE_RT // on the fly swap
 	);
 
 
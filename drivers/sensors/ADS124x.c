@@ -30,6 +30,7 @@ static void _mp_drv_ADS124X_onRegWrite(mp_regMaster_op_t *operand, mp_bool_t ter
 static void _mp_drv_ADS124X_onReset(mp_regMaster_op_t *operand, mp_bool_t terminate);
 static void _mp_drv_ADS124X_onWakeup(mp_regMaster_op_t *operand, mp_bool_t terminate);
 static void _mp_drv_ADS124X_onDummy(mp_regMaster_op_t *operand, mp_bool_t terminate);
+static mp_ret_t _mp_drv_ADS124X_command(mp_drv_ADS124X_t *ADS124X, unsigned char command, mp_regMaster_cb_t callback);
 
 MP_TASK(_mp_drv_ADS124X_ASR);
 
@@ -85,6 +86,7 @@ mp_ret_t mp_drv_ADS124X_init(mp_kernel_t *kernel, mp_drv_ADS124X_t *ADS124X, mp_
 
 	memset(ADS124X, 0, sizeof(*ADS124X));
 	ADS124X->kernel = kernel;
+	mp_event_init(&ADS124X->events);
 
 	/* version */
 	value = mp_options_get(options, "version");
@@ -217,7 +219,8 @@ mp_ret_t mp_drv_ADS124X_init(mp_kernel_t *kernel, mp_drv_ADS124X_t *ADS124X, mp_
 
 	/* create regmaster control */
 	ret = mp_regMaster_init_spi(kernel, &ADS124X->regMaster,
-			&ADS124X->spi, ADS124X, "ADS124X SPI");
+			&ADS124X->spi, ADS124X->regMasterOps, MP_REGMASTER_OPS,
+			ADS124X, "ADS124X SPI");
 	if(ret == FALSE) {
 		mp_printk("ADS124X(%p) error while creating regMaster context", ADS124X);
 		mp_spi_close(&ADS124X->spi);
@@ -233,21 +236,17 @@ mp_ret_t mp_drv_ADS124X_init(mp_kernel_t *kernel, mp_drv_ADS124X_t *ADS124X, mp_
 	mp_gpio_set(ADS124X->start);
 
 
-	mp_regMaster_write(
-		&ADS124X->regMaster,
-		mp_regMaster_register(ADS124X_SPI_RESET), 1,
-		_mp_drv_ADS124X_onReset, ADS124X
-	);
+	_mp_drv_ADS124X_command(ADS124X, ADS124X_SPI_RESET, _mp_drv_ADS124X_onReset);
 
 	mp_printk("ADS124X(%p): Initializing", ADS124X);
 
 	/*
-	mp_regMaster_readExt(
+	mp_regMaster_readRegExt(
 		&ADS124X->regMaster,
-		mp_regMaster_register(ADS1015_REG_POINTER_CONFIG), 1,
+		ADS1015_REG_POINTER_CONFIG,
 		(unsigned char *)&ADS124X->config, 2,
 		_mp_drv_ADS124X_checkConfig, ADS124X,
-		TRUE // on the fly swap
+		TRUE, MP_REGMASTER_LANE_BG // on the fly swap
 	);
 */
 
@@ -320,11 +319,7 @@ mp_ret_t mp_drv_ADS124X_wakeup(mp_drv_ADS124X_t *ADS124X, mp_regMaster_cb_t call
 	mp_drv_ADS124X_stopRead(ADS124X);
 
 	mp_regMaster_setChipSelect(&ADS124X->regMaster, ADS124X->cs);
-	mp_regMaster_write(
-		&ADS124X->regMaster,
-		mp_regMaster_register(ADS124X_SPI_WAKEUP), 1,
-		used, ADS124X
-	);
+	_mp_drv_ADS124X_command(ADS124X, ADS124X_SPI_WAKEUP, used);
 
 	return(TRUE);
 }
@@ -342,11 +337,7 @@ mp_ret_t mp_drv_ADS124X_sleep(mp_drv_ADS124X_t *ADS124X, mp_regMaster_cb_t callb
 
 	mp_printk("ADS124X(%p) Sending sleep", ADS124X);
 
-	mp_regMaster_write(
-		&ADS124X->regMaster,
-		mp_regMaster_register(ADS124X_SPI_SLEEP), 1,
-		used, ADS124X
-	);
+	_mp_drv_ADS124X_command(ADS124X, ADS124X_SPI_SLEEP, used);
 
 	return(TRUE);
 }
@@ -366,16 +357,30 @@ mp_ret_t mp_drv_ADS124X_writeRegister(mp_drv_ADS124X_t *ADS124X, mp_regMaster_cb
 	if(callback)
 		used = callback;
 
-	unsigned char *ptr = mp_mem_alloc(ADS124X->kernel, size+2);
-	unsigned char *src = ptr;
+	unsigned char buffer[MP_REGMASTER_PAYLOAD];
+	unsigned char *ptr;
+	unsigned char *src;
 	int a;
 
+	/* small writes are copied into the operand */
+	if(size+2 <= MP_REGMASTER_PAYLOAD)
+		src = buffer;
+	else {
+		src = mp_mem_alloc(ADS124X->kernel, size+2);
+		if(!src)
+			return(FALSE);
+	}
+
+	ptr = src;
 	*(ptr++) = ADS124X_SPI_WREG | from;
 	*(ptr++) = size-1;
 	for(a=0; a<size; a++)
-		*(ptr++) = regs[0];
+		*(ptr++) = regs[a];
 
 	mp_regMaster_setChipSelect(&ADS124X->regMaster, ADS124X->cs);
+	if(src == buffer)
+		return(mp_regMaster_writeInline(&ADS124X->regMaster, src, size+2, used, ADS124X));
+
 	mp_regMaster_write(
 		&ADS124X->regMaster,
 		src, size+2,
@@ -398,25 +403,29 @@ mp_ret_t mp_drv_ADS124X_readRegister(mp_drv_ADS124X_t *ADS124X, mp_regMaster_cb_
 	if(callback)
 		used = callback;
 
+	mp_regMaster_setChipSelect(&ADS124X->regMaster, ADS124X->cs);
+/*
 	unsigned char *ptr = mp_mem_alloc(ADS124X->kernel, size+2);
 	unsigned char *src = ptr;
 
 	*(ptr++) = ADS124X_SPI_RREG | from;
 	*ptr = size-1;
 
-	mp_regMaster_setChipSelect(&ADS124X->regMaster, ADS124X->cs);
-/*
 	mp_regMaster_readExt(
 		&ADS124X->regMaster,
 		src, 2,
 		(unsigned char *)&ADS124X->registerMap, size,
 		used, ADS124X,
-		FALSE
+		FALSE, MP_REGMASTER_LANE_BG
 	);
 */
 	return(TRUE);
 }
 
+static mp_ret_t _mp_drv_ADS124X_command(mp_drv_ADS124X_t *ADS124X, unsigned char command, mp_regMaster_cb_t callback) {
+	return(mp_regMaster_writeInline(&ADS124X->regMaster, &command, 1, callback, ADS124X));
+}
+
 static void _mp_drv_ADS124X_onRegdump(mp_regMaster_op_t *operand, mp_bool_t terminate) {
 	mp_drv_ADS124X_t *ADS124X = operand->user;
 	mp_mem_free(ADS124X->kernel, operand->reg);
@@ -436,7 +445,10 @@ static void _mp_drv_ADS124X_onRegdump(mp_regMaster_op_t *operand, mp_bool_t term
 
 static void _mp_drv_ADS124X_onRegWrite(mp_regMaster_op_t *operand, mp_bool_t terminate) {
 	mp_drv_ADS124X_t *ADS124X = operand->user;
-	mp_mem_free(ADS124X->kernel, operand->reg);
+
+	/* large writes don't fit into the operand */
+	if(operand->reg != operand->payload)
+		mp_mem_free(ADS124X->kernel, operand->reg);
 
 	if(terminate == YES)
 		return;
@@ -473,9 +485,6 @@ static void _mp_drv_ADS124X_onData(mp_regMaster_op_t *operand, mp_bool_t termina
 
 	//mp_printk("Data %ld - %x %x %x", value, operand->wait[2], operand->wait[1], operand->wait[0]);
 
-	mp_mem_free(ADS124X->kernel, operand->wait);
-	operand->wait = NULL;
-
 	if(ADS124X->onData)
 		ADS124X->onData(ADS124X, value);
 
@@ -505,8 +514,7 @@ static void _mp_drv_ADS124X_onDRDY(void *user) {
 	mp_drv_ADS124X_t *ADS124X = user;
 
 
-	ADS124X->onDrdy = 1;
-	mp_task_signal(ADS124X->task, MP_TASK_SIG_PENDING);
+	mp_event_set_isr(&ADS124X->events, MP_DRV_ADS124X_EV_DRDY);
 
 	//memset(src, 0, 3);
 /*
@@ -526,27 +534,23 @@ MP_TASK(_mp_drv_ADS124X_ASR) {
 		return;
 	}
 
-	mp_interrupt_disable();
 	/* data available */
-	if(ADS124X->onDrdy == 1) {
-		unsigned char *src = mp_mem_alloc(ADS124X->kernel, 10);
-
+	if(mp_event_take(&ADS124X->events, MP_DRV_ADS124X_EV_DRDY, MP_EVENT_ANY)) {
 		mp_regMaster_setChipSelect(&ADS124X->regMaster, ADS124X->cs);
 
-		mp_regMaster_readExt(
+		/* sample is received into the operand, it passes register dumps */
+		mp_regMaster_readRegExt(
 			&ADS124X->regMaster,
-			mp_regMaster_register(ADS124X_SPI_RDATA), 1,
-			src, 3,
+			ADS124X_SPI_RDATA,
+			NULL, 3,
 			_mp_drv_ADS124X_onData, ADS124X,
-			TRUE
+			TRUE, MP_REGMASTER_LANE_RT
 		);
 
 		//mp_printk("DRDY!!!!!!!!!!!");
-		ADS124X->onDrdy = 0;
 	}
-	mp_interrupt_enable();
 
-	mp_task_signal(ADS124X->task, MP_TASK_SIG_SLEEP);
+	mp_event_wait(&ADS124X->events, task, MP_DRV_ADS124X_EV_DRDY, MP_EVENT_ANY);
 
 
 }
@@ -87,34 +87,18 @@ mp_ret_t mp_drv_INA219_init(mp_kernel_t *kernel, mp_drv_INA219_t *INA219, mp_opt
 	memset(INA219, 0, sizeof(*INA219));
 	INA219->kernel = kernel;
 
-	/* open spi */
-	ret = mp_i2c_open(kernel, &INA219->i2c, options, "INA219");
-	if(ret == FALSE)
-		return(FALSE);
-
-	mp_options_t setup[] = {
-		{ "frequency", "400000" },
-		{ "role", "master" },
-		{ NULL, NULL }
-	};
-	ret = mp_i2c_setup(&INA219->i2c, setup);
-	if(ret == FALSE) {
-		mp_i2c_close(&INA219->i2c);
-		return(FALSE);
-	}
-
-	/* set slave address: make this changable */
-	mp_i2c_setSlaveAddress(&INA219->i2c, 0x40);
-
-	/* create regmaster control */
-	ret = mp_regMaster_init_i2c(kernel, &INA219->regMaster,
-			&INA219->i2c, INA219, "INA219 I2C");
+	/* join the shared bus of the gate or open it */
+	ret = mp_regMaster_init_gate(kernel, &INA219->regMaster,
+			options, &INA219->i2c, INA219->regMasterOps, MP_REGMASTER_OPS,
+			INA219, "INA219 I2C");
 	if(ret == FALSE) {
 		mp_printk("INA219 error while creating regMaster context");
-		mp_i2c_close(&INA219->i2c);
 		return(FALSE);
 	}
 
+	/* set slave address */
+	mp_regMaster_setSlaveAddress(&INA219->regMaster, 0x40);
+
 	/* create ASR task */
 	INA219->task = mp_task_create(&kernel->tasks, who, _mp_drv_INA219_ASR, INA219, 1000);
 	if(!INA219->task) {
@@ -130,20 +114,20 @@ mp_ret_t mp_drv_INA219_init(mp_kernel_t *kernel, mp_drv_INA219_t *INA219, mp_opt
 
 	mp_printk("INA219(%p): Initializing", INA219);
 
-	mp_regMaster_readExt(
+	mp_regMaster_readRegExt(
 		&INA219->regMaster,
-		mp_regMaster_register(0), 1,
+		0,
 		(unsigned char *)&INA219->configuration, 2,
 		_mp_drv_INA219_onConfiguration, INA219,
-		TRUE
+		TRUE, MP_REGMASTER_LANE_BG
 	);
 
-	mp_regMaster_readExt(
+	mp_regMaster_readRegExt(
 		&INA219->regMaster,
-		mp_regMaster_register(0), 1,
+		0,
 		(unsigned char *)&INA219->configuration, 2,
 		_mp_drv_INA219_onConfiguration, INA219,
-		TRUE
+		TRUE, MP_REGMASTER_LANE_BG
 	);
 
 	//mp_drv_INA219_update_busVoltage(INA219);
@@ -260,12 +244,12 @@ void mp_drv_INA219_setCalibration_16V_400mA(mp_drv_INA219_t *INA219) {
  * @param[in] INA219 context
  */
 void mp_drv_INA219_update_busVoltage(mp_drv_INA219_t *INA219) {
-	mp_regMaster_readExt(
+	mp_regMaster_readRegExt(
 		&INA219->regMaster,
-		mp_regMaster_register(INA219_REG_BUSVOLTAGE), 1,
+		INA219_REG_BUSVOLTAGE,
 		(unsigned char *)&INA219->rawBusVoltage, 2,
 		_mp_drv_INA219_busVoltage, INA219,
-		TRUE
+		TRUE, MP_REGMASTER_LANE_RT
 	);
 }
 
@@ -275,12 +259,12 @@ void mp_drv_INA219_update_busVoltage(mp_drv_INA219_t *INA219) {
  * @param[in] INA219 context
  */
 void mp_drv_INA219_update_shuntVoltage(mp_drv_INA219_t *INA219) {
-	mp_regMaster_readExt(
+	mp_regMaster_readRegExt(
 		&INA219->regMaster,
-		mp_regMaster_register(INA219_REG_SHUNTVOLTAGE), 1,
+		INA219_REG_SHUNTVOLTAGE,
 		(unsigned char *)&INA219->rawShuntVoltage, 2,
 		_mp_drv_INA219_shuntVoltage, INA219,
-		TRUE
+		TRUE, MP_REGMASTER_LANE_RT
 	);
 }
 
@@ -290,31 +274,23 @@ void mp_drv_INA219_update_shuntVoltage(mp_drv_INA219_t *INA219) {
  * @param[in] INA219 context
  */
 void mp_drv_INA219_update_current(mp_drv_INA219_t *INA219) {
-	mp_regMaster_readExt(
+	mp_regMaster_readRegExt(
 		&INA219->regMaster,
-		mp_regMaster_register(INA219_REG_CURRENT), 1,
+		INA219_REG_CURRENT,
 		(unsigned char *)&INA219->rawCurrent, 2,
 		_mp_drv_INA219_current, INA219,
-		TRUE
+		TRUE, MP_REGMASTER_LANE_RT
 	);
 }
 
 /**@}*/
 
 static void mp_drv_INA219_write(mp_drv_INA219_t *INA219, unsigned char address, unsigned short writeByte) {
-	unsigned char *ptr = mp_mem_alloc(INA219->kernel, 3);
-	unsigned char *src = ptr;
-
-	*(ptr++) = address;
-	*(ptr++) = (unsigned char)(writeByte >> 8);
-	*(ptr++) = (unsigned char)(writeByte & 0xFF);
-
-	mp_regMaster_write(
+	mp_regMaster_writeReg16(
 		&INA219->regMaster,
-		src, 3,
+		address, writeByte,
 		_mp_drv_INA219_writeControl, INA219
 	);
-
 }
 
 static void _mp_drv_INA219_onConfiguration(mp_regMaster_op_t *operand, mp_bool_t terminate) {
@@ -370,12 +346,12 @@ MP_TASK(_mp_drv_INA219_ASR) {
 	}
 
 
-	mp_regMaster_readExt(
+	mp_regMaster_readRegExt(
 		&INA219->regMaster,
-		mp_regMaster_register(0), 1,
+		0,
 		(unsigned char *)&INA219->configuration, 2,
 		_mp_drv_INA219_onConfiguration, INA219,
-		TRUE
+		TRUE, MP_REGMASTER_LANE_BG
 	);
 
 
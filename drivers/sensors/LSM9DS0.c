@@ -90,6 +90,7 @@ mp_ret_t mp_drv_LSM9DS0_init(mp_kernel_t *kernel, mp_drv_LSM9DS0_t *LSM9DS0, mp_
 
 	memset(LSM9DS0, 0, sizeof(*LSM9DS0));
 	LSM9DS0->kernel = kernel;
+	mp_event_init(&LSM9DS0->events);
 
 	/* protocol type */
 	value = mp_options_get(options, "protocol");
@@ -172,7 +173,8 @@ mp_ret_t mp_drv_LSM9DS0_init(mp_kernel_t *kernel, mp_drv_LSM9DS0_t *LSM9DS0, mp_
 
 		/* create regmaster control */
 		ret = mp_regMaster_init_spi(kernel, &LSM9DS0->regMaster,
-				&LSM9DS0->spi, LSM9DS0, "LSM9DS0 SPI");
+				&LSM9DS0->spi, LSM9DS0->regMasterOps, MP_DRV_LSM9DS0_OPS,
+				LSM9DS0, "LSM9DS0 SPI");
 		if(ret == FALSE) {
 			mp_printk("LSM9DS0 error while creating regMaster context");
 			mp_drv_LSM9DS0_fini(LSM9DS0);
@@ -184,38 +186,18 @@ mp_ret_t mp_drv_LSM9DS0_init(mp_kernel_t *kernel, mp_drv_LSM9DS0_t *LSM9DS0, mp_
 	}
 	/* using i2c */
 	else {
-		/* open spi */
-		ret = mp_i2c_open(kernel, &LSM9DS0->i2c, options, "LSM9DS0");
-		if(ret == FALSE) {
-			mp_printk("Error openning i2c interface");
-			mp_drv_LSM9DS0_fini(LSM9DS0);
-			return(FALSE);
-		}
-
-		mp_options_t setup[] = {
-			{ "frequency", "400000" },
-			{ "role", "master" },
-			{ NULL, NULL }
-		};
-		ret = mp_i2c_setup(&LSM9DS0->i2c, setup);
+		/* join the shared bus of the gate or open it */
+		ret = mp_regMaster_init_gate(kernel, &LSM9DS0->regMaster,
+				options, &LSM9DS0->i2c, LSM9DS0->regMasterOps, MP_DRV_LSM9DS0_OPS,
+				LSM9DS0, "LSM9DS0 I2C");
 		if(ret == FALSE) {
+			mp_printk("LSM9DS0 error while creating regMaster context");
 			mp_drv_LSM9DS0_fini(LSM9DS0);
 			return(FALSE);
 		}
 
-		LSM9DS0->init = 1;
-
 		/* set slave address */
-		mp_i2c_setSlaveAddress(&LSM9DS0->i2c, LSM9DS0_ADDRESS_ACCELMAG);
-
-		/* create regmaster control */
-		ret = mp_regMaster_init_i2c(kernel, &LSM9DS0->regMaster,
-				&LSM9DS0->i2c, LSM9DS0, "LSM9DS0 I2C");
-		if(ret == FALSE) {
-			mp_printk("LSM9DS0 error while creating regMaster context");
-			mp_drv_LSM9DS0_fini(LSM9DS0);
-			return(FALSE);
-		}
+		mp_regMaster_setSlaveAddress(&LSM9DS0->regMaster, LSM9DS0_ADDRESS_ACCELMAG);
 
 		LSM9DS0->init = 2;
 
@@ -314,12 +296,12 @@ mp_ret_t mp_drv_LSM9DS0_init(mp_kernel_t *kernel, mp_drv_LSM9DS0_t *LSM9DS0, mp_
 	mp_drv_LSM9DS0_xmRead(
 		LSM9DS0, WHO_AM_I_XM,
 		(unsigned char *)&LSM9DS0->buffer, 1,
-		_mp_drv_LSM9DS0_onXMWhoIAm
+		_mp_drv_LSM9DS0_onXMWhoIAm, MP_REGMASTER_LANE_BG
 	);
 	mp_drv_LSM9DS0_gRead(
 		LSM9DS0, WHO_AM_I_G,
 		(unsigned char *)&LSM9DS0->buffer, 1,
-		_mp_drv_LSM9DS0_onCSGWhoIAm
+		_mp_drv_LSM9DS0_onCSGWhoIAm, MP_REGMASTER_LANE_BG
 	);
 	/*
 	// Gyro initialization stuff:
@@ -376,7 +358,8 @@ mp_ret_t mp_drv_LSM9DS0_fini(mp_drv_LSM9DS0_t *LSM9DS0) {
 	if(LSM9DS0->init >= 1) {
 		if(LSM9DS0->protocol == MP_DRV_LSM9DS0_MODE_SPI)
 			mp_spi_close(&LSM9DS0->spi);
-		else
+		/* a shared bus belongs to the application */
+		else if(mp_regMaster_shared(&LSM9DS0->regMaster) == NO)
 			mp_i2c_close(&LSM9DS0->i2c);
 	}
 
@@ -395,33 +378,35 @@ mp_ret_t mp_drv_LSM9DS0_fini(mp_drv_LSM9DS0_t *LSM9DS0) {
  * @param[in] wait Buffer to fill
  * @param[in] waitSize Size of buffer to fill
  * @param[in] callback Executed regMaster callback
+ * @param[in] lane Queue lane, @ref MP_REGMASTER_LANE_RT for samples
  */
 void mp_drv_LSM9DS0_xmRead(
 		mp_drv_LSM9DS0_t *LSM9DS0,
 		unsigned char reg,
 		unsigned char *wait, int waitSize,
-		mp_regMaster_cb_t callback
+		mp_regMaster_cb_t callback, unsigned char lane
 	) {
-	unsigned char *subReg = NULL;
+	unsigned char subReg;
 
 	if(LSM9DS0->protocol == MP_DRV_LSM9DS0_MODE_I2C) {
 		mp_regMaster_setSlaveAddress(&LSM9DS0->regMaster, LSM9DS0_ADDRESS_ACCELMAG);
-		subReg = mp_regMaster_register(reg);
+		subReg = reg;
 	}
 	else {
 		mp_regMaster_setChipSelect(&LSM9DS0->regMaster, LSM9DS0->csXM);
 
 		if(waitSize > 1)
-			subReg = mp_regMaster_register(0xc0 | (reg & 0x3f)); /* one byte operation */
+			subReg = 0xc0 | (reg & 0x3f); /* one byte operation */
 		else
-			subReg = mp_regMaster_register(0x80 | (reg & 0x3f)); /* multi bytes operation */
+			subReg = 0x80 | (reg & 0x3f); /* multi bytes operation */
 	}
 
-	mp_regMaster_read(
+	mp_regMaster_readRegExt(
 		&LSM9DS0->regMaster,
-		subReg, 1,
+		subReg,
 		wait, waitSize,
-		callback, LSM9DS0
+		callback, LSM9DS0,
+		FALSE, lane
 	);
 }
 
@@ -442,25 +427,20 @@ void mp_drv_LSM9DS0_xmWrite(
 		unsigned char reg,
 		unsigned char value
 	) {
-	unsigned char *subReg = NULL;
-	unsigned char *ptr = mp_mem_alloc(LSM9DS0->kernel, 2);
-	unsigned char *src = ptr;
+	unsigned char subReg;
 
 	if(LSM9DS0->protocol == MP_DRV_LSM9DS0_MODE_I2C) {
 		mp_regMaster_setSlaveAddress(&LSM9DS0->regMaster, LSM9DS0_ADDRESS_ACCELMAG);
-		subReg = mp_regMaster_register(reg);
+		subReg = reg;
 	}
 	else {
 		mp_regMaster_setChipSelect(&LSM9DS0->regMaster, LSM9DS0->csXM);
-		subReg = mp_regMaster_register(reg & 0x3f);
+		subReg = reg & 0x3f;
 	}
 
-	*(ptr++) = *subReg;
-	*ptr = value;
-
-	mp_regMaster_write(
+	mp_regMaster_writeReg(
 		&LSM9DS0->regMaster,
-		src, 2,
+		subReg, value,
 		_mp_drv_LSM9DS0_onWrite, LSM9DS0
 	);
 }
@@ -476,33 +456,35 @@ void mp_drv_LSM9DS0_xmWrite(
  * @param[in] wait Buffer to fill
  * @param[in] waitSize Size of buffer to fill
  * @param[in] callback Executed regMaster callback
+ * @param[in] lane Queue lane, @ref MP_REGMASTER_LANE_RT for samples
  */
 void mp_drv_LSM9DS0_gRead(
 		mp_drv_LSM9DS0_t *LSM9DS0,
 		unsigned char reg,
 		unsigned char *wait, int waitSize,
-		mp_regMaster_cb_t callback
+		mp_regMaster_cb_t callback, unsigned char lane
 	) {
-	unsigned char *subReg = NULL;
+	unsigned char subReg;
 
 	if(LSM9DS0->protocol == MP_DRV_LSM9DS0_MODE_I2C) {
 		mp_regMaster_setSlaveAddress(&LSM9DS0->regMaster, LSM9DS0_ADDRESS_GYRO);
-		subReg = mp_regMaster_register(reg);
+		subReg = reg;
 	}
 	else {
 		mp_regMaster_setChipSelect(&LSM9DS0->regMaster, LSM9DS0->csG);
 
 		if(waitSize > 1)
-			subReg = mp_regMaster_register(0xc0 | (reg & 0x3f)); /* one byte operation */
+			subReg = 0xc0 | (reg & 0x3f); /* one byte operation */
 		else
-			subReg = mp_regMaster_register(0x80 | (reg & 0x3f)); /* multi bytes operation */
+			subReg = 0x80 | (reg & 0x3f); /* multi bytes operation */
 	}
 
-	mp_regMaster_read(
+	mp_regMaster_readRegExt(
 		&LSM9DS0->regMaster,
-		subReg, 1,
+		subReg,
 		wait, waitSize,
-		callback, LSM9DS0
+		callback, LSM9DS0,
+		FALSE, lane
 	);
 }
 
@@ -523,25 +505,20 @@ void mp_drv_LSM9DS0_gWrite(
 		unsigned char reg,
 		unsigned char value
 	) {
-	unsigned char *subReg = NULL;
-	unsigned char *ptr = mp_mem_alloc(LSM9DS0->kernel, 2);
-	unsigned char *src = ptr;
+	unsigned char subReg;
 
 	if(LSM9DS0->protocol == MP_DRV_LSM9DS0_MODE_I2C) {
 		mp_regMaster_setSlaveAddress(&LSM9DS0->regMaster, LSM9DS0_ADDRESS_GYRO);
-		subReg = mp_regMaster_register(reg);
+		subReg = reg;
 	}
 	else {
 		mp_regMaster_setChipSelect(&LSM9DS0->regMaster, LSM9DS0->csG);
-		subReg = mp_regMaster_register(reg & 0x3f);
+		subReg = reg & 0x3f;
 	}
 
-	*(ptr++) = *subReg;
-	*ptr = value;
-
-	mp_regMaster_write(
+	mp_regMaster_writeReg(
 		&LSM9DS0->regMaster,
-		src, 2,
+		subReg, value,
 		_mp_drv_LSM9DS0_onWrite, LSM9DS0
 	);
 }
@@ -816,7 +793,6 @@ static void _mp_drv_LSM9DS0_onXMWhoIAm(mp_regMaster_op_t *operand, mp_bool_t ter
 static void _mp_drv_LSM9DS0_onWrite(mp_regMaster_op_t *operand, mp_bool_t terminate) {
 	mp_drv_LSM9DS0_t *LSM9DS0 = operand->user;
 	mp_printk("LSM9DS0(%p) register write 0x%x = 0x%x using address 0x%x", LSM9DS0, operand->reg[0], operand->reg[1], operand->slaveAddress);
-	mp_mem_free(LSM9DS0->kernel, operand->reg);
 }
 
 
@@ -984,27 +960,22 @@ static void _mp_drv_LSM9DS0_onAccelCalibrationRead(mp_regMaster_op_t *operand, m
 
 static void _mp_drv_LSM9DS0_onDRDY(void *user) {
 	mp_drv_LSM9DS0_t *LSM9DS0 = user;
-	LSM9DS0->intSrc |= 0x1;
-
-	mp_task_signal(LSM9DS0->task, MP_TASK_SIG_PENDING);
+	mp_event_set_isr(&LSM9DS0->events, MP_DRV_LSM9DS0_EV_GYRO);
 }
 
 static void _mp_drv_LSM9DS0_onIntMag(void *user) {
 	mp_drv_LSM9DS0_t *LSM9DS0 = user;
-	LSM9DS0->intSrc |= 0x2;
-
-	mp_task_signal(LSM9DS0->task, MP_TASK_SIG_PENDING);
+	mp_event_set_isr(&LSM9DS0->events, MP_DRV_LSM9DS0_EV_MAG);
 }
 
 static void _mp_drv_LSM9DS0_onIntAcc(void *user) {
 	mp_drv_LSM9DS0_t *LSM9DS0 = user;
-	LSM9DS0->intSrc |= 0x4;
-
-	mp_task_signal(LSM9DS0->task, MP_TASK_SIG_PENDING);
+	mp_event_set_isr(&LSM9DS0->events, MP_DRV_LSM9DS0_EV_ACCEL);
 }
 
 MP_TASK(_mp_drv_LSM9DS0_ASR) {
 	mp_drv_LSM9DS0_t *LSM9DS0 = task->user;
+	unsigned int bits;
 
 	/* receive regMaster shutdown */
 	if(task->signal == MP_TASK_SIG_STOP) {
@@ -1025,31 +996,32 @@ MP_TASK(_mp_drv_LSM9DS0_ASR) {
 		return;
 	}
 
-	/* Gyro atomic read */
-	if(LSM9DS0->intSrc & 0x1) {
+	bits = mp_event_take(&LSM9DS0->events, MP_DRV_LSM9DS0_EV_ALL, MP_EVENT_ANY);
+
+	/* samples go before the configuration, Gyro atomic read */
+	if(bits & MP_DRV_LSM9DS0_EV_GYRO) {
 		if(LSM9DS0->gyroCal == 0) {
 			mp_drv_LSM9DS0_gRead(
 				LSM9DS0, OUT_X_L_G | 0x80,
 				(unsigned char *)&LSM9DS0->buffer, 6,
-				_mp_drv_LSM9DS0_onGyroRead
+				_mp_drv_LSM9DS0_onGyroRead, MP_REGMASTER_LANE_RT
 			);
 		}
 		else {
 			mp_drv_LSM9DS0_gRead(
 				LSM9DS0, OUT_X_L_G | 0x80,
 				(unsigned char *)&LSM9DS0->buffer, 6,
-				_mp_drv_LSM9DS0_onGyroCalibrationRead
+				_mp_drv_LSM9DS0_onGyroCalibrationRead, MP_REGMASTER_LANE_RT
 			);
 		}
-		LSM9DS0->intSrc &= ~0x1;
 	}
 
 	/* Magneto atomic read */
-	if(LSM9DS0->intSrc & 0x2) {
+	if(bits & MP_DRV_LSM9DS0_EV_MAG) {
 		mp_drv_LSM9DS0_xmRead(
 			LSM9DS0, OUT_X_L_M | 0x80,
 			(unsigned char *)&LSM9DS0->buffer, 6,
-			_mp_drv_LSM9DS0_onMagRead
+			_mp_drv_LSM9DS0_onMagRead, MP_REGMASTER_LANE_RT
 		);
 
 		/* check if temperature sensor is on */
@@ -1057,32 +1029,30 @@ MP_TASK(_mp_drv_LSM9DS0_ASR) {
 			mp_drv_LSM9DS0_xmRead(
 				LSM9DS0, OUT_TEMP_L_XM | 0x80,
 				(unsigned char *)&LSM9DS0->buffer, 2,
-				_mp_drv_LSM9DS0_onTemperatureRead
+				_mp_drv_LSM9DS0_onTemperatureRead, MP_REGMASTER_LANE_RT
 			);
-		LSM9DS0->intSrc &= ~0x2;
 	}
 
 	/* Accelero atomic read */
-	if(LSM9DS0->intSrc & 0x4) {
+	if(bits & MP_DRV_LSM9DS0_EV_ACCEL) {
 
 		if(LSM9DS0->accelCal == 0) {
 			mp_drv_LSM9DS0_xmRead(
 				LSM9DS0, OUT_X_L_A | 0x80,
 				(unsigned char *)&LSM9DS0->buffer, 6,
-				_mp_drv_LSM9DS0_onAccelRead
+				_mp_drv_LSM9DS0_onAccelRead, MP_REGMASTER_LANE_RT
 			);
 		}
 		else {
 			mp_drv_LSM9DS0_xmRead(
 				LSM9DS0, OUT_X_L_A | 0x80,
 				(unsigned char *)&LSM9DS0->buffer, 6,
-				_mp_drv_LSM9DS0_onAccelCalibrationRead
+				_mp_drv_LSM9DS0_onAccelCalibrationRead, MP_REGMASTER_LANE_RT
 			);
 		}
-		LSM9DS0->intSrc &= ~0x4;
 	}
 
-	mp_task_signal(LSM9DS0->task, MP_TASK_SIG_SLEEP);
+	mp_event_wait(&LSM9DS0->events, task, MP_DRV_LSM9DS0_EV_ALL, MP_EVENT_ANY);
 }
 
 
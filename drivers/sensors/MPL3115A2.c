@@ -27,13 +27,21 @@ static void _mp_drv_MPL3115A2_onDRDY(void *user);
 
 void mp_drv_MPL3115A2_setSeaLevel(mp_drv_MPL3115A2_t *MPL3115A2, int Pa);
 
-static void _mp_drv_MPL3115A2_onWhoIAm(mp_regMaster_op_t *operand, mp_bool_t terminate);
-static void _mp_drv_MPL3115A2_onSettings(mp_regMaster_op_t *operand, mp_bool_t terminate);
-static void _mp_drv_MPL3115A2_writeControl(mp_regMaster_op_t *operand, mp_bool_t terminate);
-static void _mp_drv_MPL3115A2_readPressureControl(mp_regMaster_op_t *operand, mp_bool_t terminate);
-static void _mp_drv_MPL3115A2_readAltimeterControl(mp_regMaster_op_t *operand, mp_bool_t terminate);
-static void _mp_drv_MPL3115A2_readTemperature(mp_regMaster_op_t *operand, mp_bool_t terminate);
-static void _mp_drv_MPL3115A2_readIntSource(mp_regMaster_op_t *operand, mp_bool_t terminate);
+static void _mp_drv_MPL3115A2_request(mp_drv_MPL3115A2_t *MPL3115A2, unsigned char request);
+static mp_bool_t _mp_drv_MPL3115A2_take(mp_drv_MPL3115A2_t *MPL3115A2, unsigned char request);
+static void _mp_drv_MPL3115A2_readPressure(mp_drv_MPL3115A2_t *MPL3115A2);
+static void _mp_drv_MPL3115A2_readAltimeter(mp_drv_MPL3115A2_t *MPL3115A2);
+static void _mp_drv_MPL3115A2_readTemperature(mp_drv_MPL3115A2_t *MPL3115A2);
+
+MP_TASK(_mp_drv_MPL3115A2_co);
+
+/* coroutine requests, serviced in this order */
+#define _REQ_INTERRUPT 0x01 /* write CTRL_REG5 and CTRL_REG4 */
+#define _REQ_TIMESTEP  0x02 /* write CTRL_REG2 */
+#define _REQ_SETTINGS  0x04 /* write CTRL_REG1 */
+#define _REQ_OST       0x08 /* toggle OST bit */
+#define _REQ_DRDY      0x10 /* read data */
+#define _REQ_READBACK  0x20 /* read CTRL_REG1 back into settings */
 
 /**
 @defgroup mpDriverFreescaleMPL3115A2 Freescale MPL3115A2
@@ -116,25 +124,6 @@ mp_ret_t mp_drv_MPL3115A2_init(mp_kernel_t *kernel, mp_drv_MPL3115A2_t *MPL3115A
 	else
 		MPL3115A2->drdy = NULL;
 
-	/* open spi */
-	ret = mp_i2c_open(kernel, &MPL3115A2->i2c, options, "MPL3115A2");
-	if(ret == FALSE)
-		return(FALSE);
-
-	mp_options_t setup[] = {
-		{ "frequency", "400000" },
-		{ "role", "master" },
-		{ NULL, NULL }
-	};
-	ret = mp_i2c_setup(&MPL3115A2->i2c, setup);
-	if(ret == FALSE) {
-		mp_i2c_close(&MPL3115A2->i2c);
-		return(FALSE);
-	}
-
-	/* set slave address */
-	mp_i2c_setSlaveAddress(&MPL3115A2->i2c, MPL3115A2_ADDRESS);
-
 	/* enable chip */
 	if(MPL3115A2->drdy) {
 		/* install drdy interrupt high > low */
@@ -147,62 +136,36 @@ mp_ret_t mp_drv_MPL3115A2_init(mp_kernel_t *kernel, mp_drv_MPL3115A2_t *MPL3115A
 	}
 	else {
 		mp_printk("MPL3115A2(%p): require DRDY interrupt for the moment", MPL3115A2);
-		mp_i2c_close(&MPL3115A2->i2c);
 		return(FALSE);
 	}
 
-	/* create regmaster control */
-	ret = mp_regMaster_init_i2c(kernel, &MPL3115A2->regMaster,
-			&MPL3115A2->i2c, MPL3115A2, "MPL3115A2 I2C");
+	/* join the shared bus of the gate or open it */
+	ret = mp_regMaster_init_gate(kernel, &MPL3115A2->regMaster,
+			options, &MPL3115A2->i2c, MPL3115A2->regMasterOps, MP_REGMASTER_OPS,
+			MPL3115A2, "MPL3115A2 I2C");
 	if(ret == FALSE) {
 		mp_printk("MPL3115A2 error while creating regMaster context");
-		mp_i2c_close(&MPL3115A2->i2c);
 		return(FALSE);
 	}
 
-	mp_printk("MPL3115A2(%p): Initializing", MPL3115A2);
+	/* set slave address */
+	mp_regMaster_setSlaveAddress(&MPL3115A2->regMaster, MPL3115A2_ADDRESS);
 
-	/* check for device id */
-	mp_regMaster_read(
-		&MPL3115A2->regMaster,
-		mp_regMaster_register(MPL3115A2_WHO_AM_I), 1,
-		(unsigned char *)&MPL3115A2->whoIam, 1,
-		_mp_drv_MPL3115A2_onWhoIAm, MPL3115A2
-	);
+	/* register sequences */
+	ret = mp_co_init(kernel, &MPL3115A2->co, who, _mp_drv_MPL3115A2_co, MPL3115A2);
+	if(ret == FALSE) {
+		mp_printk("MPL3115A2 error while creating coroutine");
+		mp_regMaster_fini(&MPL3115A2->regMaster);
+		if(mp_regMaster_shared(&MPL3115A2->regMaster) == NO)
+			mp_i2c_close(&MPL3115A2->i2c);
+		return(FALSE);
+	}
 
-	/* reset the device */
-	//mp_drv_MPL3115A2_reset(MPL3115A2);
+	mp_printk("MPL3115A2(%p): Initializing", MPL3115A2);
 
 	/* set altimeter mode */
 	mp_drv_MPL3115A2_setModeAltimeter(MPL3115A2);
 
-	/* Enable Data Flags in PT_DATA_CFG */
-	unsigned char *ptr = mp_mem_alloc(MPL3115A2->kernel, 2);
-	unsigned char *src = ptr;
-
-	*(ptr++) = MPL3115A2_PT_DATA_CFG;
-	*ptr = 0x07;
-
-	mp_regMaster_write(
-		&MPL3115A2->regMaster,
-		src, 2,
-		_mp_drv_MPL3115A2_writeControl, MPL3115A2
-	);
-
-	/* Set INT to Active Low Open Drain */
-	/*
-	ptr = mp_mem_alloc(MPL3115A2->kernel, 2);
-	src = ptr;
-
-	*(ptr++) = MPL3115A2_CTRL_REG3;
-	*ptr = 0x11;
-
-	mp_regMaster_write(
-		&MPL3115A2->regMaster,
-		src, 2,
-		_mp_drv_MPL3115A2_writeControl, MPL3115A2
-	);
-*/
 	/* enable interrupt but disable temperature */
 	mp_drv_MPL3115A2_enableTemperature(MPL3115A2);
 
@@ -213,84 +176,38 @@ mp_ret_t mp_drv_MPL3115A2_init(mp_kernel_t *kernel, mp_drv_MPL3115A2_t *MPL3115A
 	mp_drv_MPL3115A2_wakeUp(MPL3115A2);
 
 	/* get back reg1 */
-	mp_regMaster_read(
-		&MPL3115A2->regMaster,
-		mp_regMaster_register(MPL3115A2_CTRL_REG1), 1,
-		(unsigned char *)&MPL3115A2->settings, 1,
-		_mp_drv_MPL3115A2_onSettings, MPL3115A2
-	);
+	_mp_drv_MPL3115A2_request(MPL3115A2, _REQ_READBACK);
 
 	return(TRUE);
 }
 
 void mp_drv_MPL3115A2_fini(mp_drv_MPL3115A2_t *MPL3115A2) {
 	mp_printk("Unloading MPL3115A2 driver");
+	mp_co_fini(&MPL3115A2->co);
 }
 
 
 void mp_drv_MPL3115A2_sleep(mp_drv_MPL3115A2_t *MPL3115A2) {
 	MPL3115A2->settings &= ~(1<<0);
-	unsigned char *ptr = mp_mem_alloc(MPL3115A2->kernel, 2);
-	unsigned char *src = ptr;
-
-	*(ptr++) = MPL3115A2_CTRL_REG1;
-	*ptr = MPL3115A2->settings;
-
-	mp_regMaster_write(
-		&MPL3115A2->regMaster,
-		src, 2,
-		_mp_drv_MPL3115A2_writeControl, MPL3115A2
-	);
-
-
+	_mp_drv_MPL3115A2_request(MPL3115A2, _REQ_SETTINGS);
 }
 
 void mp_drv_MPL3115A2_wakeUp(mp_drv_MPL3115A2_t *MPL3115A2) {
 	MPL3115A2->settings |= (1<<0); //Set SBYB bit for Active mode
-	unsigned char *ptr = mp_mem_alloc(MPL3115A2->kernel, 2);
-	unsigned char *src = ptr;
-
-	*(ptr++) = MPL3115A2_CTRL_REG1;
-	*ptr = MPL3115A2->settings;
-
-	mp_regMaster_write(
-		&MPL3115A2->regMaster,
-		src, 2,
-		_mp_drv_MPL3115A2_writeControl, MPL3115A2
-	);
+	_mp_drv_MPL3115A2_request(MPL3115A2, _REQ_SETTINGS);
 }
 
 void mp_drv_MPL3115A2_reset(mp_drv_MPL3115A2_t *MPL3115A2) {
 	MPL3115A2->settings |= (1<<2);
-	unsigned char *ptr = mp_mem_alloc(MPL3115A2->kernel, 2);
-	unsigned char *src = ptr;
-
-	*(ptr++) = MPL3115A2_CTRL_REG1;
-	*ptr = MPL3115A2->settings;
-
-	mp_regMaster_write(
-		&MPL3115A2->regMaster,
-		src, 2,
-		_mp_drv_MPL3115A2_writeControl, MPL3115A2
-	);
+	_mp_drv_MPL3115A2_request(MPL3115A2, _REQ_SETTINGS);
 }
 
 mp_ret_t mp_drv_MPL3115A2_acquisitionTimeStep(mp_drv_MPL3115A2_t *MPL3115A2, unsigned char st) {
-	unsigned char *ptr = mp_mem_alloc(MPL3115A2->kernel, 2);
-	unsigned char *src = ptr;
-	unsigned char control = st;
-
 	if(st > 15)
 		return(FALSE);
 
-	*(ptr++) = MPL3115A2_CTRL_REG2;
-	*ptr = control;
-
-	mp_regMaster_write(
-		&MPL3115A2->regMaster,
-		src, 2,
-		_mp_drv_MPL3115A2_writeControl, MPL3115A2
-	);
+	MPL3115A2->timeStep = st;
+	_mp_drv_MPL3115A2_request(MPL3115A2, _REQ_TIMESTEP);
 
 	return(TRUE);
 }
@@ -303,20 +220,9 @@ void mp_drv_MPL3115A2_setModeBarometer(mp_drv_MPL3115A2_t *MPL3115A2) {
 	MPL3115A2->sensor = mp_sensor_register(MPL3115A2->kernel, MP_SENSOR_BAROMETER, "Barometer");
 
 	MPL3115A2->settings &= ~(1<<7); //Clear ALT bit
-	MPL3115A2->readerControl = _mp_drv_MPL3115A2_readPressureControl;
-
-	unsigned char *ptr = mp_mem_alloc(MPL3115A2->kernel, 2);
-	unsigned char *src = ptr;
-
-	*(ptr++) = MPL3115A2_CTRL_REG1;
-	*ptr = MPL3115A2->settings;
-
-	mp_regMaster_write(
-		&MPL3115A2->regMaster,
-		src, 2,
-		_mp_drv_MPL3115A2_writeControl, MPL3115A2
-	);
+	MPL3115A2->readerControl = _mp_drv_MPL3115A2_readPressure;
 
+	_mp_drv_MPL3115A2_request(MPL3115A2, _REQ_SETTINGS);
 }
 
 
@@ -329,19 +235,9 @@ void mp_drv_MPL3115A2_setModeAltimeter(mp_drv_MPL3115A2_t *MPL3115A2) {
 
 	/* request command */
 	MPL3115A2->settings |= (1<<7); //Set ALT bit
-	MPL3115A2->readerControl = _mp_drv_MPL3115A2_readAltimeterControl;
-	unsigned char *ptr = mp_mem_alloc(MPL3115A2->kernel, 2);
-	unsigned char *src = ptr;
-
-	*(ptr++) = MPL3115A2_CTRL_REG1;
-	*ptr = MPL3115A2->settings;
-
-	mp_regMaster_write(
-		&MPL3115A2->regMaster,
-		src, 2,
-		_mp_drv_MPL3115A2_writeControl, MPL3115A2
-	);
+	MPL3115A2->readerControl = _mp_drv_MPL3115A2_readAltimeter;
 
+	_mp_drv_MPL3115A2_request(MPL3115A2, _REQ_SETTINGS);
 }
 
 void mp_drv_MPL3115A2_setSeaLevel(mp_drv_MPL3115A2_t *MPL3115A2, int Pa) {
@@ -359,53 +255,12 @@ void mp_drv_MPL3115A2_setSeaLevel(mp_drv_MPL3115A2_t *MPL3115A2, int Pa) {
 
 
 void mp_drv_MPL3115A2_OST(mp_drv_MPL3115A2_t *MPL3115A2) {
-	unsigned char *ptr = mp_mem_alloc(MPL3115A2->kernel, 2);
-	unsigned char *src = ptr;
-
-	/* Clear OST bit */
-	MPL3115A2->settings &= ~(1<<1);
-
-	*(ptr++) = MPL3115A2_CTRL_REG1;
-	*ptr = MPL3115A2->settings;
-
-	mp_regMaster_write(
-		&MPL3115A2->regMaster,
-		src, 2,
-		_mp_drv_MPL3115A2_writeControl, MPL3115A2
-	);
-
-	/* Set OST bit */
-	MPL3115A2->settings |= (1<<1);
-
-	ptr = mp_mem_alloc(MPL3115A2->kernel, 2);
-	src = ptr;
-
-	*(ptr++) = MPL3115A2_CTRL_REG1;
-	*ptr = MPL3115A2->settings;
-
-	mp_regMaster_write(
-		&MPL3115A2->regMaster,
-		src, 2,
-		_mp_drv_MPL3115A2_writeControl, MPL3115A2
-	);
-
-
+	_mp_drv_MPL3115A2_request(MPL3115A2, _REQ_OST);
 }
 
 void mp_drv_MPL3115A2_OSTimer(mp_drv_MPL3115A2_t *MPL3115A2, mp_drv_MPL3115A_OS_t timer) {
 	MPL3115A2->settings |= (timer<<3);
-	unsigned char *ptr = mp_mem_alloc(MPL3115A2->kernel, 2);
-	unsigned char *src = ptr;
-
-	*(ptr++) = MPL3115A2_CTRL_REG1;
-	*ptr = MPL3115A2->settings;
-
-	mp_regMaster_write(
-		&MPL3115A2->regMaster,
-		src, 2,
-		_mp_drv_MPL3115A2_writeControl, MPL3115A2
-	);
-
+	_mp_drv_MPL3115A2_request(MPL3115A2, _REQ_SETTINGS);
 }
 
 
@@ -417,103 +272,116 @@ void mp_drv_MPL3115A2_enableTemperature(mp_drv_MPL3115A2_t *MPL3115A2) {
 		mp_sensor_unregister(MPL3115A2->kernel, MPL3115A2->sensor);
 	MPL3115A2->temperature = mp_sensor_register(MPL3115A2->kernel, MP_SENSOR_TEMPERATURE, "Temperature");
 
-	unsigned char *ptr = mp_mem_alloc(MPL3115A2->kernel, 2);
-	unsigned char *src = ptr;
-
-	/* Route DRDY INT to INT1 */
-	ptr = mp_mem_alloc(MPL3115A2->kernel, 2);
-	src = ptr;
-
-	*(ptr++) = MPL3115A2_CTRL_REG5;
-	*ptr = 0x81;
-
-	mp_regMaster_write(
-		&MPL3115A2->regMaster,
-		src, 2,
-		_mp_drv_MPL3115A2_writeControl, MPL3115A2
-	);
-
-	/* Enable DRDY Interrupt */
-	ptr = mp_mem_alloc(MPL3115A2->kernel, 2);
-	src = ptr;
-
-	*(ptr++) = MPL3115A2_CTRL_REG4;
-	*ptr = 0x81;
-
-	mp_regMaster_write(
-		&MPL3115A2->regMaster,
-		src, 2,
-		_mp_drv_MPL3115A2_writeControl, MPL3115A2
-	);
+	/* Route DRDY INT to INT1 and enable DRDY Interrupt */
+	MPL3115A2->interrupt = 0x81;
+	_mp_drv_MPL3115A2_request(MPL3115A2, _REQ_INTERRUPT);
 }
 
 void mp_drv_MPL3115A2_disableTemperature(mp_drv_MPL3115A2_t *MPL3115A2) {
-	unsigned char *ptr = mp_mem_alloc(MPL3115A2->kernel, 2);
-	unsigned char *src = ptr;
-
 	/* disable sensor */
 	if(MPL3115A2->temperature)
 		mp_sensor_unregister(MPL3115A2->kernel, MPL3115A2->sensor);
 
-	/* Route DRDY INT to INT1 */
-	ptr = mp_mem_alloc(MPL3115A2->kernel, 2);
-	src = ptr;
-
-	*(ptr++) = MPL3115A2_CTRL_REG5;
-	*ptr = 0x80;
+	MPL3115A2->interrupt = 0x80;
+	_mp_drv_MPL3115A2_request(MPL3115A2, _REQ_INTERRUPT);
+}
 
-	mp_regMaster_write(
-		&MPL3115A2->regMaster,
-		src, 2,
-		_mp_drv_MPL3115A2_writeControl, MPL3115A2
-	);
 
-	/* Enable DRDY Interrupt */
-	ptr = mp_mem_alloc(MPL3115A2->kernel, 2);
-	src = ptr;
+/**@}*/
 
-	*(ptr++) = MPL3115A2_CTRL_REG4;
-	*ptr = 0x80;
+MP_TASK(_mp_drv_MPL3115A2_co) {
+	mp_drv_MPL3115A2_t *MPL3115A2 = task->user;
+	mp_regMaster_t *regMaster = &MPL3115A2->regMaster;
+	mp_co_t *co = &MPL3115A2->co;
 
-	mp_regMaster_write(
-		&MPL3115A2->regMaster,
-		src, 2,
-		_mp_drv_MPL3115A2_writeControl, MPL3115A2
-	);
+	MP_CO_BEGIN(co);
 
-}
+	/* check for device id */
+	MP_CO_AWAIT_READ(co, regMaster, MPL3115A2_WHO_AM_I, &MPL3115A2->whoIam, 1);
+	if(MPL3115A2->whoIam != 0xc4) {
+		mp_printk("MPL3115A2(%p): Got who iam %x (bad), terminating", MPL3115A2, MPL3115A2->whoIam);
+		mp_regMaster_fini(regMaster);
+		MP_CO_EXIT(co);
+	}
+	mp_printk("MPL3115A2(%p): Got who iam %x (good)", MPL3115A2, MPL3115A2->whoIam);
 
+	/* Enable Data Flags in PT_DATA_CFG */
+	MP_CO_AWAIT_REG(co, regMaster, MPL3115A2_PT_DATA_CFG, 0x07);
 
-/**@}*/
+	while(1) {
+		MP_CO_WAIT_UNTIL(co, MPL3115A2->request != 0);
 
-static void _mp_drv_MPL3115A2_onWhoIAm(mp_regMaster_op_t *operand, mp_bool_t terminate) {
-	mp_drv_MPL3115A2_t *MPL3115A2 = operand->user;
-	if(MPL3115A2->whoIam != 0xc4) {
-		mp_printk("MPL3115A2(%p): Got who iam %x (bad), terminating", operand->user, MPL3115A2->whoIam);
-		mp_regMaster_fini(&MPL3115A2->regMaster);
+		if(_mp_drv_MPL3115A2_take(MPL3115A2, _REQ_INTERRUPT) == YES) {
+			MP_CO_AWAIT_REG(co, regMaster, MPL3115A2_CTRL_REG5, MPL3115A2->interrupt);
+			MP_CO_AWAIT_REG(co, regMaster, MPL3115A2_CTRL_REG4, MPL3115A2->interrupt);
+		}
+		else if(_mp_drv_MPL3115A2_take(MPL3115A2, _REQ_TIMESTEP) == YES) {
+			MP_CO_AWAIT_REG(co, regMaster, MPL3115A2_CTRL_REG2, MPL3115A2->timeStep);
+		}
+		else if(_mp_drv_MPL3115A2_take(MPL3115A2, _REQ_SETTINGS) == YES) {
+			MP_CO_AWAIT_REG(co, regMaster, MPL3115A2_CTRL_REG1, MPL3115A2->settings);
+		}
+		else if(_mp_drv_MPL3115A2_take(MPL3115A2, _REQ_OST) == YES) {
+			/* Clear OST bit */
+			MPL3115A2->settings &= ~(1<<1);
+			MP_CO_AWAIT_REG(co, regMaster, MPL3115A2_CTRL_REG1, MPL3115A2->settings);
+
+			/* Set OST bit */
+			MPL3115A2->settings |= (1<<1);
+			MP_CO_AWAIT_REG(co, regMaster, MPL3115A2_CTRL_REG1, MPL3115A2->settings);
+		}
+		else if(_mp_drv_MPL3115A2_take(MPL3115A2, _REQ_DRDY) == YES) {
+			/* samples go before the configuration */
+			MP_CO_AWAIT_SAMPLE(co, regMaster, MPL3115A2_INT_SOURCE, &MPL3115A2->intSource, 1);
+
+			/* OUT PRESSURE interrupt */
+			if(MPL3115A2->intSource & 0x80) {
+				MP_CO_AWAIT_SAMPLE(co, regMaster, MPL3115A2_OUT_P_MSB, MPL3115A2->data, 3);
+				MPL3115A2->readerControl(MPL3115A2);
+			}
+
+			/* OUT TEMPERATURE interrupt */
+			if(MPL3115A2->intSource & 1) {
+				MP_CO_AWAIT_SAMPLE(co, regMaster, MPL3115A2_OUT_T_MSB, MPL3115A2->data, 2);
+				_mp_drv_MPL3115A2_readTemperature(MPL3115A2);
+			}
+		}
+		else if(_mp_drv_MPL3115A2_take(MPL3115A2, _REQ_READBACK) == YES) {
+			MP_CO_AWAIT_READ(co, regMaster, MPL3115A2_CTRL_REG1, &MPL3115A2->settings, 1);
+			mp_printk("MPL3115A2(%p): Initial settings is %x", MPL3115A2, MPL3115A2->settings);
+		}
 	}
-	else
-		mp_printk("MPL3115A2(%p): Got who iam %x (good)", operand->user, MPL3115A2->whoIam);
+
+	MP_CO_END(co);
 }
 
-static void _mp_drv_MPL3115A2_onSettings(mp_regMaster_op_t *operand, mp_bool_t terminate) {
-	mp_drv_MPL3115A2_t *MPL3115A2 = operand->user;
-	mp_printk("MPL3115A2(%p): Initial settings is %x", operand->user, MPL3115A2->settings);
+static void _mp_drv_MPL3115A2_request(mp_drv_MPL3115A2_t *MPL3115A2, unsigned char request) {
+	MP_INTERRUPT_SAFE_BEGIN
+	MPL3115A2->request |= request;
+	MP_INTERRUPT_SAFE_END
+
+	mp_co_wakeup(&MPL3115A2->co);
 }
 
-static void _mp_drv_MPL3115A2_writeControl(mp_regMaster_op_t *operand, mp_bool_t terminate) {
-	mp_drv_MPL3115A2_t *MPL3115A2 = operand->user;
-	mp_mem_free(MPL3115A2->kernel, operand->reg);
-	//mp_printk("MPL3115A2(%p): Got write control", operand->user);
+static mp_bool_t _mp_drv_MPL3115A2_take(mp_drv_MPL3115A2_t *MPL3115A2, unsigned char request) {
+	mp_bool_t ret = NO;
+
+	MP_INTERRUPT_SAFE_BEGIN
+	if(MPL3115A2->request & request) {
+		MPL3115A2->request &= ~request;
+		ret = YES;
+	}
+	MP_INTERRUPT_SAFE_END
+
+	return(ret);
 }
 
-static void _mp_drv_MPL3115A2_readPressureControl(mp_regMaster_op_t *operand, mp_bool_t terminate) {
-	mp_drv_MPL3115A2_t *MPL3115A2 = operand->user;
+static void _mp_drv_MPL3115A2_readPressure(mp_drv_MPL3115A2_t *MPL3115A2) {
 	unsigned char msb, csb, lsb;
 
-	msb = operand->wait[0];
-	csb = operand->wait[1];
-	lsb = operand->wait[2];
+	msb = MPL3115A2->data[0];
+	csb = MPL3115A2->data[1];
+	lsb = MPL3115A2->data[2];
 
 	/* Pressure comes back as a left shifted 20 bit number */
 	unsigned long pressure_whole = (long)msb<<16 | (long)csb<<8 | (long)lsb;
@@ -526,14 +394,11 @@ static void _mp_drv_MPL3115A2_readPressureControl(mp_regMaster_op_t *operand, mp
 	MPL3115A2->sensor->barometer.result = (float)pressure_whole + pressure_decimal;
 
 	mp_printk("Got pressure information: %f", MPL3115A2->sensor->barometer.result);
-
-	mp_mem_free(MPL3115A2->kernel, operand->wait);
 }
 
-static void _mp_drv_MPL3115A2_readAltimeterControl(mp_regMaster_op_t *operand, mp_bool_t terminate) {
-	mp_drv_MPL3115A2_t *MPL3115A2 = operand->user;
-	float tempcsb = (operand->wait[2]>>4)/16.0;
-	float altitude = (float)( (operand->wait[0] << 8) | operand->wait[1]) + tempcsb;
+static void _mp_drv_MPL3115A2_readAltimeter(mp_drv_MPL3115A2_t *MPL3115A2) {
+	float tempcsb = (MPL3115A2->data[2]>>4)/16.0;
+	float altitude = (float)( (MPL3115A2->data[0] << 8) | MPL3115A2->data[1]) + tempcsb;
 
 	if(MPL3115A2->sensor->altimeter.conversion == MP_SENSOR_ALTIMETER_FEET)
 		MPL3115A2->sensor->altimeter.result = altitude;
@@ -541,16 +406,14 @@ static void _mp_drv_MPL3115A2_readAltimeterControl(mp_regMaster_op_t *operand, m
 		MPL3115A2->sensor->altimeter.result = altitude/MP_SENSOR_ALTIMETER_FMC;
 
 	//mp_printk("Got altimeter information: %f", MPL3115A2->sensor->altimeter.result);
-	mp_mem_free(MPL3115A2->kernel, operand->wait);
 }
 
-static void _mp_drv_MPL3115A2_readTemperature(mp_regMaster_op_t *operand, mp_bool_t terminate) {
-	mp_drv_MPL3115A2_t *MPL3115A2 = operand->user;
+static void _mp_drv_MPL3115A2_readTemperature(mp_drv_MPL3115A2_t *MPL3115A2) {
 	unsigned char msb, lsb;
 
 	if(MPL3115A2->temperature) {
-		msb = operand->wait[0];
-		lsb = operand->wait[1];
+		msb = MPL3115A2->data[0];
+		lsb = MPL3115A2->data[1];
 
 		/* Negative temperature fix by D.D.G. */
 		unsigned short foo = 0;
@@ -580,54 +443,14 @@ static void _mp_drv_MPL3115A2_readTemperature(mp_regMaster_op_t *operand, mp_boo
 
 		//mp_printk("Got temperature %f", temperature);
 	}
-
-	mp_mem_free(MPL3115A2->kernel, operand->wait);
-}
-
-static void _mp_drv_MPL3115A2_readIntSource(mp_regMaster_op_t *operand, mp_bool_t terminate) {
-	mp_drv_MPL3115A2_t *MPL3115A2 = operand->user;
-
-	//mp_printk("Got interrupt control: %x", operand->wait[0]);
-
-	/* OUT PRESSURE interrupt */
-	if(operand->wait[0] & 0x80) {
-		unsigned char *ptr = mp_mem_alloc(MPL3115A2->kernel, 6);
-
-		mp_regMaster_read(
-			&MPL3115A2->regMaster,
-			mp_regMaster_register(MPL3115A2_OUT_P_MSB), 1,
-			ptr, 3,
-			MPL3115A2->readerControl, MPL3115A2
-		);
-	}
-
-	/* OUT TEMPERATURE interrupt */
-	if(operand->wait[0] & 1) {
-		unsigned char *ptr = mp_mem_alloc(MPL3115A2->kernel, 6);
-
-		mp_regMaster_read(
-			&MPL3115A2->regMaster,
-			mp_regMaster_register(MPL3115A2_OUT_T_MSB), 1,
-			ptr, 3,
-			_mp_drv_MPL3115A2_readTemperature, MPL3115A2
-		);
-	}
-
-	mp_mem_free(MPL3115A2->kernel, operand->wait);
 }
 
 static void _mp_drv_MPL3115A2_onDRDY(void *user) {
 	mp_drv_MPL3115A2_t *MPL3115A2 = user;
 
-	/* run read */
-	unsigned char *ptr = mp_mem_alloc(MPL3115A2->kernel, 1);
-
-	mp_regMaster_read(
-		&MPL3115A2->regMaster,
-		mp_regMaster_register(MPL3115A2_INT_SOURCE), 1,
-		ptr, 1,
-		_mp_drv_MPL3115A2_readIntSource, MPL3115A2
-	);
+	/* data are read by the coroutine */
+	MPL3115A2->request |= _REQ_DRDY;
+	mp_softirq_signal(MPL3115A2->co.task, MP_TASK_SIG_PENDING);
 }
 
 
@@ -29,7 +29,6 @@ static void _mp_drv_TMP006_onDRDY(void *user);
 static void _mp_drv_TMP006_onManufacturerID(mp_regMaster_op_t *operand, mp_bool_t terminate);
 static void _mp_drv_TMP006_onDeviceID(mp_regMaster_op_t *operand, mp_bool_t terminate);
 static void _mp_drv_TMP006_onSettings(mp_regMaster_op_t *operand, mp_bool_t terminate);
-static void _mp_drv_TMP006_writeControl(mp_regMaster_op_t *operand, mp_bool_t terminate);
 static void _mp_drv_TMP006_onRawDieTemperature(mp_regMaster_op_t *operand, mp_bool_t terminate);
 static void _mp_drv_TMP006_onRawVoltage(mp_regMaster_op_t *operand, mp_bool_t terminate);
 
@@ -109,25 +108,6 @@ mp_sensor_t *mp_drv_TMP006_init(mp_kernel_t *kernel, mp_drv_TMP006_t *TMP006, mp
 	else
 		TMP006->drdy = NULL;
 
-	/* open spi */
-	ret = mp_i2c_open(kernel, &TMP006->i2c, options, "TMP006");
-	if(ret == FALSE)
-		return(NULL);
-
-	mp_options_t setup[] = {
-		{ "frequency", "400000" },
-		{ "role", "master" },
-		{ NULL, NULL }
-	};
-	ret = mp_i2c_setup(&TMP006->i2c, setup);
-	if(ret == FALSE) {
-		mp_i2c_close(&TMP006->i2c);
-		return(NULL);
-	}
-
-	/* set slave address */
-	mp_i2c_setSlaveAddress(&TMP006->i2c, 0x40);
-
 	/* enable chip */
 	if(TMP006->drdy) {
 		/* install drdy interrupt high > low */
@@ -140,20 +120,22 @@ mp_sensor_t *mp_drv_TMP006_init(mp_kernel_t *kernel, mp_drv_TMP006_t *TMP006, mp
 	}
 	else {
 		mp_printk("TMP006 require DRDY interrupt for the moment");
-		mp_i2c_close(&TMP006->i2c);
 		return(NULL);
 	}
 
-	/* create regmaster control */
-	ret = mp_regMaster_init_i2c(kernel, &TMP006->regMaster,
-			&TMP006->i2c, TMP006, "TMP006 I2C");
+	/* join the shared bus of the gate or open it */
+	ret = mp_regMaster_init_gate(kernel, &TMP006->regMaster,
+			options, &TMP006->i2c, TMP006->regMasterOps, MP_REGMASTER_OPS,
+			TMP006, "TMP006 I2C");
 	if(ret == FALSE) {
 		mp_printk("TMP006 error while creating regMaster context");
 		mp_gpio_release(TMP006->drdy);
-		mp_i2c_close(&TMP006->i2c);
 		return(NULL);
 	}
 
+	/* set slave address */
+	mp_regMaster_setSlaveAddress(&TMP006->regMaster, 0x40);
+
 	/* create sensor */
 	TMP006->sensor = mp_sensor_register(kernel, MP_SENSOR_TEMPERATURE, who);
 
@@ -164,30 +146,30 @@ mp_sensor_t *mp_drv_TMP006_init(mp_kernel_t *kernel, mp_drv_TMP006_t *TMP006, mp
 	mp_drv_TMP006_setB2(TMP006, TMP006_B2);
 	mp_drv_TMP006_setS0(TMP006, TMP006_S0);
 
-	mp_regMaster_readExt(
+	mp_regMaster_readRegExt(
 		&TMP006->regMaster,
-		mp_regMaster_register(TMP006_REG_WRITE_REG), 1,
+		TMP006_REG_WRITE_REG,
 		(unsigned char *)&TMP006->settings, 2,
 		_mp_drv_TMP006_onSettings, TMP006,
-		TRUE
+		TRUE, MP_REGMASTER_LANE_BG
 	);
 
 	/* read manufacturer */
-	mp_regMaster_readExt(
+	mp_regMaster_readRegExt(
 		&TMP006->regMaster,
-		mp_regMaster_register(TMP006_REG_MAN_ID), 1,
+		TMP006_REG_MAN_ID,
 		(unsigned char *)&TMP006->manufacturerId, 2,
 		_mp_drv_TMP006_onManufacturerID, TMP006,
-		TRUE
+		TRUE, MP_REGMASTER_LANE_BG
 	);
 
 	/* check for device id */
-	mp_regMaster_readExt(
+	mp_regMaster_readRegExt(
 		&TMP006->regMaster,
-		mp_regMaster_register(TMP006_REG_DEVICE_ID), 1,
+		TMP006_REG_DEVICE_ID,
 		(unsigned char *)&TMP006->deviceId, 2,
 		_mp_drv_TMP006_onDeviceID, TMP006,
-		TRUE
+		TRUE, MP_REGMASTER_LANE_BG
 	);
 
 
@@ -258,17 +240,10 @@ void mp_drv_TMP006_sample(mp_drv_TMP006_t *TMP006, mp_drv_TMP006_sample_t sample
 
 
 static void mp_drv_TMP006_write(mp_drv_TMP006_t *TMP006, unsigned char address, unsigned short writeByte) {
-	unsigned char *ptr = mp_mem_alloc(TMP006->kernel, 3);
-	unsigned char *src = ptr;
-
-	*(ptr++) = address;
-	*(ptr++) = (unsigned char)(writeByte>>8);
-	*(ptr++) = (unsigned char)(writeByte&0x0F);
-
-	mp_regMaster_write(
+	mp_regMaster_writeReg16(
 		&TMP006->regMaster,
-		src, 3,
-		_mp_drv_TMP006_writeControl, TMP006
+		address, writeByte,
+		NULL, NULL
 	);
 }
 
@@ -277,22 +252,22 @@ static void mp_drv_TMP006_write(mp_drv_TMP006_t *TMP006, unsigned char address,
 static void _mp_drv_TMP006_onDRDY(void *user) {
 	mp_drv_TMP006_t *TMP006 = user;
 
-	/* read die T */
-	mp_regMaster_readExt(
+	/* samples go before the configuration, read die T */
+	mp_regMaster_readRegExt(
 		&TMP006->regMaster,
-		mp_regMaster_register(TMP006_REG_TABT), 1,
+		TMP006_REG_TABT,
 		(unsigned char *)&TMP006->rawDieTemperature, 2,
 		_mp_drv_TMP006_onRawDieTemperature, TMP006,
-		TRUE
+		TRUE, MP_REGMASTER_LANE_RT
 	);
 
 	/* read voltage */
-	mp_regMaster_readExt(
+	mp_regMaster_readRegExt(
 		&TMP006->regMaster,
-		mp_regMaster_register(TMP006_REG_VOBJ), 1,
+		TMP006_REG_VOBJ,
 		(unsigned char *)&TMP006->rawVoltage, 2,
 		_mp_drv_TMP006_onRawVoltage, TMP006,
-		TRUE
+		TRUE, MP_REGMASTER_LANE_RT
 	);
 }
 
@@ -333,11 +308,6 @@ static void _mp_drv_TMP006_onSettings(mp_regMaster_op_t *operand, mp_bool_t term
 	mp_printk("TMP006(%p): Initial settings is 0x%x", operand->user, TMP006->settings);
 }
 
-static void _mp_drv_TMP006_writeControl(mp_regMaster_op_t *operand, mp_bool_t terminate) {
-	mp_drv_TMP006_t *TMP006 = operand->user;
-	mp_mem_free(TMP006->kernel, operand->reg);
-}
-
 
 
 static void _mp_drv_TMP006_onRawDieTemperature(mp_regMaster_op_t *operand, mp_bool_t terminate) {
@@ -0,0 +1,63 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _HAVE_MP_COMMON_ARENA_H
+	#define _HAVE_MP_COMMON_ARENA_H
+
+	/**
+	 * @defgroup mpCommonArena
+	 * @{
+	 */
+
+	typedef struct mp_arena_s mp_arena_t;
+
+	struct mp_arena_s {
+		/** backing buffer */
+		unsigned char *start;
+		unsigned char *end;
+
+		/** next free byte */
+		unsigned char *pos;
+
+		/** highest number of bytes used */
+		unsigned int peak;
+
+		/** failed allocations */
+		unsigned int failed;
+	};
+
+	/** @} */
+
+	void mp_arena_init(mp_arena_t *arena, void *buffer, unsigned int size);
+	void *mp_arena_alloc(mp_arena_t *arena, unsigned int size);
+	void mp_arena_reset(mp_arena_t *arena);
+
+	/**
+	 * @brief Number of bytes allocated in the arena
+	 *
+	 * @param[in] arena Arena
+	 * @return Used bytes
+	 */
+	static inline unsigned int mp_arena_used(mp_arena_t *arena) {
+		return(arena->pos-arena->start);
+	}
+
+#endif
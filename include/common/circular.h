@@ -65,6 +65,8 @@
 	mp_ret_t mp_circular_init(mp_kernel_t *kernel, mp_circular_t *cir, mp_circular_int_t enable, mp_circular_int_t disable);
 	void mp_circular_fini(mp_circular_t *cir);
 	mp_circular_buffer_t *mp_circular_read(mp_circular_t *cir);
+	unsigned char *mp_circular_peek(mp_circular_t *cir, int *size);
+	void mp_circular_consume(mp_circular_t *cir, int size);
 	mp_ret_t mp_circular_write(mp_circular_t *cir, unsigned char *data, int size);
 	void mp_circular_rxInterrupt(mp_circular_t *cir, unsigned char c);
 	unsigned char mp_circular_txInterrupt(mp_circular_t *cir, mp_bool_t *done);
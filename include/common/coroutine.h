@@ -0,0 +1,189 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _HAVE_MP_COMMON_COROUTINE_H
+	#define _HAVE_MP_COMMON_COROUTINE_H
+
+	/**
+	 * @defgroup mpCommonCoroutine
+	 * @{
+	 */
+
+	typedef struct mp_co_s mp_co_t;
+
+	struct mp_co_s {
+		/** resume point */
+		unsigned short line;
+
+		/** task executing the coroutine */
+		mp_task_t *task;
+
+		/** a regMaster operation is in flight */
+		mp_bool_t waiting;
+
+		/** the awaited operation has been queued */
+		mp_bool_t queued;
+
+		/** the awaited operation has been terminated by regMaster */
+		mp_bool_t terminate;
+
+		/** @ref mp_regMaster_error_t of the awaited operation */
+		unsigned char error;
+	};
+
+	/**
+	 * @brief Start the coroutine body
+	 *
+	 * Must be the first statement of the MP_TASK() executing the
+	 * coroutine. Local variables are not kept across awaits.
+	 *
+	 * @param[in] co Coroutine context
+	 */
+	#define MP_CO_BEGIN(co) \
+		if(task->signal == MP_TASK_SIG_STOP) { \
+			(co)->task = NULL; \
+			mp_task_signal(task, MP_TASK_SIG_DEAD); \
+			return; \
+		} \
+		switch((co)->line) { \
+			case 0:
+
+	/**
+	 * @brief End the coroutine body, next wakeup restarts from the beginning
+	 *
+	 * @param[in] co Coroutine context
+	 */
+	#define MP_CO_END(co) \
+		} \
+		MP_CO_EXIT(co)
+
+	/**
+	 * @brief Leave the coroutine, next wakeup restarts from the beginning
+	 *
+	 * @param[in] co Coroutine context
+	 */
+	#define MP_CO_EXIT(co) \
+		do { \
+			(co)->line = 0; \
+			mp_task_signal(task, MP_TASK_SIG_SLEEP); \
+			return; \
+		} while(0)
+
+	/* resume point of a regMaster operation, queue is retried until TRUE */
+	#define _MP_CO_AWAIT_OP(co, queue) \
+		(co)->line = __LINE__; \
+		(co)->queued = NO; \
+		case __LINE__: \
+		if((co)->queued == NO) { \
+			if((queue) != TRUE) { \
+				mp_task_signal(task, MP_TASK_SIG_OK); \
+				return; \
+			} \
+			(co)->queued = YES; \
+			mp_task_signal(task, MP_TASK_SIG_SLEEP); \
+			return; \
+		} \
+		if(mp_co_waiting(co) == YES) \
+			return; \
+		if((co)->terminate == YES) \
+			MP_CO_EXIT(co);
+
+	/**
+	 * @brief Write one register and resume when done
+	 *
+	 * When the operation can not be queued (empty operand pool) the
+	 * coroutine yields and queues it again on its next run, the
+	 * sequence is not lost.
+	 *
+	 * @param[in] co Coroutine context
+	 * @param[in] cirr regMaster context
+	 * @param[in] reg Register
+	 * @param[in] value Value to write
+	 */
+	#define MP_CO_AWAIT_REG(co, cirr, reg, value) \
+		_MP_CO_AWAIT_OP(co, mp_co_writeReg((co), (cirr), (reg), (value)))
+
+	/* resume point of a register read in a lane */
+	#define _MP_CO_AWAIT_READ(co, cirr, reg, wait, waitSize, lane) \
+		_MP_CO_AWAIT_OP(co, mp_co_readReg((co), (cirr), (reg), (wait), (waitSize), (lane)))
+
+	/**
+	 * @brief Read registers and resume when done
+	 *
+	 * Same failure path as MP_CO_AWAIT_REG()
+	 *
+	 * @param[in] co Coroutine context
+	 * @param[in] cirr regMaster context
+	 * @param[in] reg First register
+	 * @param[out] wait Buffer to fill
+	 * @param[in] waitSize Number of bytes to read
+	 */
+	#define MP_CO_AWAIT_READ(co, cirr, reg, wait, waitSize) \
+		_MP_CO_AWAIT_READ(co, cirr, reg, wait, waitSize, MP_REGMASTER_LANE_BG)
+
+	/**
+	 * @brief Read sample registers and resume when done
+	 *
+	 * Same as MP_CO_AWAIT_READ() in the @ref MP_REGMASTER_LANE_RT lane
+	 *
+	 * @param[in] co Coroutine context
+	 * @param[in] cirr regMaster context
+	 * @param[in] reg First register
+	 * @param[out] wait Buffer to fill
+	 * @param[in] waitSize Number of bytes to read
+	 */
+	#define MP_CO_AWAIT_SAMPLE(co, cirr, reg, wait, waitSize) \
+		_MP_CO_AWAIT_READ(co, cirr, reg, wait, waitSize, MP_REGMASTER_LANE_RT)
+
+	/**
+	 * @brief Sleep until cond is true
+	 *
+	 * cond is checked with interrupts disabled so it can be set from
+	 * an ISR followed by mp_co_wakeup()
+	 *
+	 * @param[in] co Coroutine context
+	 * @param[in] cond Condition
+	 */
+	#define MP_CO_WAIT_UNTIL(co, cond) \
+		(co)->line = __LINE__; \
+		case __LINE__: { \
+			mp_bool_t __co_wait = NO; \
+			MP_INTERRUPT_SAFE_BEGIN \
+			if(!(cond)) { \
+				__co_wait = YES; \
+				mp_task_signal(task, MP_TASK_SIG_SLEEP); \
+			} \
+			MP_INTERRUPT_SAFE_END \
+			if(__co_wait == YES) \
+				return; \
+		}
+
+	/**@}*/
+
+	mp_ret_t mp_co_init(mp_kernel_t *kernel, mp_co_t *co, char *who, mp_task_wakeup_t body, void *user);
+	void mp_co_fini(mp_co_t *co);
+	void mp_co_wakeup(mp_co_t *co);
+	mp_bool_t mp_co_waiting(mp_co_t *co);
+
+	mp_ret_t mp_co_writeReg(mp_co_t *co, mp_regMaster_t *cirr, unsigned char reg, unsigned char value);
+	mp_ret_t mp_co_readReg(mp_co_t *co, mp_regMaster_t *cirr, unsigned char reg, unsigned char *wait, int waitSize, unsigned char lane);
+
+#endif
@@ -0,0 +1,63 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _HAVE_MP_COMMON_EVENT_H
+	#define _HAVE_MP_COMMON_EVENT_H
+
+	/**
+	 * @defgroup mpCommonEvent
+	 * @{
+	 */
+
+	typedef struct mp_event_s mp_event_t;
+
+	typedef enum {
+		/** wake up when at least one bit of the mask is set */
+		MP_EVENT_ANY,
+
+		/** wake up when all bits of the mask are set */
+		MP_EVENT_ALL,
+	} mp_event_mode_t;
+
+	struct mp_event_s {
+		/** raised bits */
+		volatile unsigned int bits;
+
+		/** waiting task, NULL when nobody waits */
+		mp_task_t *volatile task;
+
+		/** bits expected by the waiting task */
+		unsigned int mask;
+
+		/** expectation mode */
+		mp_event_mode_t mode;
+	};
+
+	/** @} */
+
+	void mp_event_init(mp_event_t *event);
+	void mp_event_set(mp_event_t *event, unsigned int bits);
+	void mp_event_set_isr(mp_event_t *event, unsigned int bits);
+	void mp_event_clear(mp_event_t *event, unsigned int bits);
+	unsigned int mp_event_take(mp_event_t *event, unsigned int mask, mp_event_mode_t mode);
+	mp_bool_t mp_event_wait(mp_event_t *event, mp_task_t *task, unsigned int mask, mp_event_mode_t mode);
+
+#endif
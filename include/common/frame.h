@@ -0,0 +1,106 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _HAVE_MP_COMMON_FRAME_H
+	#define _HAVE_MP_COMMON_FRAME_H
+
+	#ifdef SUPPORT_COMMON_FRAME
+		/**
+		 * @defgroup mpCommonFrame
+		 * @{
+		 */
+
+		typedef struct mp_frame_s mp_frame_t;
+
+		typedef void (*mp_frame_on_t)(mp_frame_t *frame, unsigned char *data, unsigned int size);
+
+		typedef enum {
+			/** consistent overhead byte stuffing, frames end with 0x00 */
+			MP_FRAME_COBS = 1,
+
+			/** RFC 1055, frames end with 0xc0 */
+			MP_FRAME_SLIP = 2,
+		} mp_frame_codec_t;
+
+		/** largest encoded size of n bytes, delimiters included */
+		#define MP_FRAME_COBS_MAX(n) ((n)+(n)/254+2)
+		#define MP_FRAME_SLIP_MAX(n) (2*(n)+2)
+
+		struct mp_frame_s {
+			/** serial line, ring or DMA backend */
+			mp_serial_t *serial;
+
+			mp_frame_codec_t codec;
+
+			/** decoded frame storage */
+			unsigned char *buffer;
+			unsigned int size;
+
+			/** called for each complete frame */
+			mp_frame_on_t onFrame;
+			void *user;
+
+			/** internal: decoded bytes of the current frame */
+			unsigned int length;
+
+			/** internal: COBS code of the current block, 0 before the first one */
+			unsigned char code;
+
+			/** internal: COBS bytes left into the current block */
+			unsigned char left;
+
+			/** internal: SLIP escape received */
+			mp_bool_t escape;
+
+			/** internal: dropping bytes up to the next delimiter */
+			mp_bool_t discard;
+
+			/** frames delivered */
+			unsigned long frames;
+
+			/** frames dropped on a coding error */
+			unsigned long errors;
+
+			/** frames dropped because they do not fit the storage */
+			unsigned long overflows;
+
+			/** frames not sent, the TX ring was full */
+			unsigned long drops;
+		};
+
+		/** @} */
+
+		mp_ret_t mp_frame_init(mp_frame_t *frame, mp_serial_t *serial, mp_frame_codec_t codec,
+				unsigned char *buffer, unsigned int size, mp_frame_on_t onFrame, void *user);
+		void mp_frame_fini(mp_frame_t *frame);
+
+		void mp_frame_input(mp_frame_t *frame, unsigned char *data, unsigned int size);
+		void mp_frame_poll(mp_frame_t *frame);
+		mp_ret_t mp_frame_write(mp_frame_t *frame, unsigned char *data, unsigned int size);
+
+		unsigned int mp_frame_encode(mp_frame_codec_t codec, unsigned char *input, unsigned int size,
+				unsigned char *output, unsigned int outSize);
+		unsigned int mp_frame_encode_span(mp_frame_codec_t codec, unsigned char *input, unsigned int size,
+				mp_ring_span_t *span);
+		unsigned int mp_frame_scan(unsigned char *data, unsigned int size, unsigned char c);
+	#endif
+
+#endif
@@ -0,0 +1,85 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _HAVE_MP_COMMON_KTIMER_H
+	#define _HAVE_MP_COMMON_KTIMER_H
+
+	#if (MP_KTIMER_SLOTS & (MP_KTIMER_SLOTS-1))
+		#error "MP_KTIMER_SLOTS must be a power of two"
+	#endif
+
+	/**
+	 * @defgroup mpCommonKtimer
+	 * @{
+	 */
+
+	typedef struct mp_ktimer_handler_s mp_ktimer_handler_t;
+	typedef struct mp_ktimer_s mp_ktimer_t;
+
+	typedef void (*mp_ktimer_cb_t)(mp_ktimer_t *timer);
+
+	struct mp_ktimer_s {
+		/** timer name */
+		char *name;
+
+		/** absolute tick of the expiration */
+		unsigned long expires;
+
+		/** reload delay, 0 for a one-shot timer */
+		unsigned long period;
+
+		/** expiration callback */
+		mp_ktimer_cb_t callback;
+
+		/** user pointer */
+		void *user;
+
+		/** list holding the timer, NULL when not armed */
+		mp_list_t *list;
+
+		/** list input */
+		mp_list_item_t item;
+	};
+
+	struct mp_ktimer_handler_s {
+		/** timers hashed by expiration tick */
+		mp_list_t slots[MP_KTIMER_SLOTS];
+
+		/** last serviced tick */
+		unsigned long current;
+
+		/** number of armed timers */
+		unsigned int armed;
+	};
+
+	/** @} */
+
+	void mp_ktimer_init(mp_kernel_t *kernel);
+
+	void mp_ktimer_start(mp_kernel_t *kernel, mp_ktimer_t *timer, char *name,
+			unsigned long delay, unsigned long period, mp_ktimer_cb_t callback, void *user);
+	void mp_ktimer_stop(mp_kernel_t *kernel, mp_ktimer_t *timer);
+	mp_bool_t mp_ktimer_armed(mp_ktimer_t *timer);
+
+	void mp_ktimer_tick(mp_kernel_t *kernel);
+	unsigned long mp_ktimer_next_wakeup(mp_kernel_t *kernel, unsigned long now);
+
+#endif
@@ -0,0 +1,90 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _HAVE_MP_COMMON_LOG_H
+	#define _HAVE_MP_COMMON_LOG_H
+
+	#ifdef MP_LOG
+
+	#ifndef SUPPORT_COMMON_SERIAL
+		#error "MP_LOG needs SUPPORT_COMMON_SERIAL"
+	#endif
+
+	#if (MP_LOG_SIZE & (MP_LOG_SIZE-1))
+		#error "MP_LOG_SIZE must be a power of two"
+	#endif
+
+	/**
+	 * @defgroup mpCommonLog
+	 * @{
+	 */
+
+	/** stream format version given by MP_LOG_SYNC */
+	#define MP_LOG_VERSION 1
+
+	/** format strings go there, the linker does not load it on target */
+	#define MP_LOG_SECTION __attribute__((section("mp_log")))
+
+	/** id = MP_LOG_SYNC, time = MP_CLOCK_HIRES_HZ,
+	 * args = version, sizeof(int), sizeof(void *) */
+	#define MP_LOG_SYNC 0xffff
+
+	/** id = MP_LOG_LOST, args = 16 bits number of records dropped */
+	#define MP_LOG_LOST 0xfffe
+
+	/**
+	 * record header, little endian :
+	 * - 16 bits offset of the format string into the mp_log section
+	 * - 8 bits size of the arguments following the header
+	 * - 32 bits mp_clock_hires() timestamp
+	 *
+	 * arguments are packed in format order : int and pointers at
+	 * their target size, long on 32 bits, floating point as 32 bits
+	 * float and strings as a length byte followed by the characters
+	 */
+	#define MP_LOG_HEADER 7
+
+	/**
+	 * @brief Binary log
+	 *
+	 * The format string must be a literal. Only its id and the raw
+	 * arguments are written, tools/log2text formats them on the host.
+	 *
+	 * @param[in] fmt Format string
+	 * @param[in] args Format argument
+	 */
+	#define mp_log(fmt, args...) do { \
+		static const char _mp_log_fmt[] MP_LOG_SECTION = fmt; \
+		mp_log_write(_mp_log_fmt, ##args); \
+	} while(0)
+
+	/** @} */
+
+	mp_ret_t mp_log_start(mp_kernel_t *kernel, mp_serial_t *serial);
+	void mp_log_stop();
+	void mp_log_write(const char *fmt, ...);
+	unsigned int mp_log_encode(unsigned char *buffer, unsigned int size, const char *fmt, va_list ap);
+
+	#else
+		#define mp_log(fmt, args...) mp_printk(fmt, ##args)
+	#endif
+
+#endif
@@ -23,20 +23,78 @@
 
 	#ifdef SUPPORT_COMMON_MEM
 
-		typedef struct mp_mem_chunk_s mp_mem_chunk_t;
+		typedef struct mp_mem_class_s mp_mem_class_t;
 
 		#define MEM_CANARY 0xdeadbeef
+		#define MEM_FREED  0xfee1dead
 
-		struct mp_mem_chunk_s {
-			unsigned char data[MP_MEM_CHUNK];
-			unsigned long canary;
-			unsigned int id;
-			mp_list_item_t item;
+		/** one size class, chunks are data then a canary */
+		struct mp_mem_class_s {
+			/** usable size of a chunk */
+			unsigned short size;
+
+			/** number of chunks */
+			unsigned short number;
+
+			/** distance between two chunks */
+			unsigned short stride;
+
+			/** number of free chunks */
+			unsigned short freeNumber;
+
+			/** lowest number of free chunks since mp_mem_stats_reset() */
+			unsigned short minFree;
+
+			/** chunks of the class */
+			unsigned char *start;
+			unsigned char *end;
+
+			/** first free chunk, the link is kept in the data */
+			void *free;
+		};
+
+		typedef struct mp_mem_stats_s mp_mem_stats_t;
+
+		/** heap usage, sizes are usable chunk sizes */
+		struct mp_mem_stats_s {
+			/** allocated chunks */
+			unsigned short chunks;
+
+			/** highest number of allocated chunks */
+			unsigned short peakChunks;
+
+			/** bytes held by allocated chunks */
+			unsigned long used;
+
+			/** highest used value */
+			unsigned long peak;
+
+			/** bytes of all the chunks */
+			unsigned long total;
+
+			/** failed allocations, overruns included */
+			unsigned long failed;
+
+			/** failed allocations from interrupt handlers */
+			unsigned long overruns;
 		};
 
 		mp_ret_t mp_mem_erase(mp_kernel_t *kernel);
 		void *mp_mem_alloc(mp_kernel_t *kernel, int size);
+		void *mp_mem_alloc_isr(mp_kernel_t *kernel, int size);
+		void *mp_mem_alloc_owner(mp_kernel_t *kernel, int size, const char *owner);
+		void *mp_mem_alloc_isr_owner(mp_kernel_t *kernel, int size, const char *owner);
 		void mp_mem_free(mp_kernel_t *kernel, void *ptr);
+		unsigned long mp_mem_overruns();
+		void mp_mem_stats_get(mp_mem_stats_t *stats);
+		void mp_mem_stats_reset();
+		void mp_mem_stats_dump();
+
+		#ifdef MP_MEM_STATS
+			/* tag chunks with the calling function */
+			#define mp_mem_alloc(kernel, size) mp_mem_alloc_owner(kernel, size, __func__)
+			#define mp_mem_alloc_isr(kernel, size) mp_mem_alloc_isr_owner(kernel, size, __func__)
+		#endif
 	#endif
 
 #endif
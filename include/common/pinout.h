@@ -3,7 +3,7 @@
 
 	#ifdef SUPPORT_COMMON_PINOUT
 		typedef struct mp_pinout_s {
-			mp_task_t *task;
+			mp_ktimer_t timer;
 			mp_gpio_port_t *gpio;
 			mp_kernel_t *kernel;
 			int turn;
@@ -13,7 +13,8 @@
 			int count;
 		} mp_pinout_t;
 
-		mp_task_t *mp_pinout_onoff(mp_kernel_t *kernel, mp_gpio_port_t *gpio, char turn, int live, int step, int repeat, char *who);
+		mp_ret_t mp_pinout_onoff(mp_kernel_t *kernel, mp_pinout_t *pinout, mp_gpio_port_t *gpio, char turn, int live, int step, int repeat, char *who);
+		void mp_pinout_stop(mp_pinout_t *pinout);
 	#endif
 
 #endif
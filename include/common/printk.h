@@ -40,7 +40,11 @@
 	 * @param[in] a Format string
 	 * @param[in] args Format argument
 	 */
-	#define mp_printk(a, args...) mp_printk_call(mp_printk_user, a, ##args)
+	#if defined(MP_LOG) && defined(MP_LOG_PRINTK)
+		#define mp_printk(a, args...) mp_log(a, ##args)
+	#else
+		#define mp_printk(a, args...) mp_printk_call(mp_printk_user, a, ##args)
+	#endif
 
 	typedef void (*mp_printk_call_t)(void *user, char *fmt, ...);
 
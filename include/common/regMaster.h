@@ -29,21 +29,71 @@
 	#define MP_REGMASTER_STATE_RX     2
 	#define MP_REGMASTER_STATE_NULLRX 3
 	#define MP_REGMASTER_STATE_NULLTX 4
+
+	/** enqueue result when the operand pool is empty */
+	#define MP_REGMASTER_FULL -1
+
+	/** real-time lane, sample reads */
+	#define MP_REGMASTER_LANE_RT 0
+	/** background lane, configuration and dumps */
+	#define MP_REGMASTER_LANE_BG 1
+	#define MP_REGMASTER_LANES   2
 	/**
 	 * @defgroup mpCommonRegMaster
 	 * @{
 	 */
 	typedef struct mp_regMaster_op_s mp_regMaster_op_t;
 	typedef struct mp_regMaster_s mp_regMaster_t;
+	typedef struct mp_regMaster_bus_s mp_regMaster_bus_t;
+
+	/** operand->error when the callback is executed */
+	typedef enum {
+		/** operation done */
+		MP_REGMASTER_OK = 0,
+
+		/** regMaster has been terminated */
+		MP_REGMASTER_ERR_STOP,
+
+		/** the slave does not acknowledge */
+		MP_REGMASTER_ERR_NACK,
+
+		/** another master won the bus */
+		MP_REGMASTER_ERR_ARBITRATION,
+
+		/** the operation did not end in time, the bus has been recovered */
+		MP_REGMASTER_ERR_TIMEOUT,
+
+		/** the operand pool was empty, the coroutine queues again (coroutines only) */
+		MP_REGMASTER_ERR_QUEUE,
+	} mp_regMaster_error_t;
 
 	typedef void (*mp_regMaster_cb_t)(mp_regMaster_op_t *operand, mp_bool_t terminate);
-	typedef void (*mp_regMaster_int_t)(mp_regMaster_t *cirr);
-	typedef void (*mp_regMaster_asr_t)(mp_regMaster_t *cirr, mp_regMaster_op_t *cur);
+	typedef void (*mp_regMaster_int_t)(mp_regMaster_bus_t *bus);
+	typedef void (*mp_regMaster_asr_t)(mp_regMaster_bus_t *bus, mp_regMaster_op_t *cur);
+	typedef void (*mp_regMaster_abort_t)(mp_regMaster_bus_t *bus, mp_regMaster_op_t *cur, mp_regMaster_error_t error);
+
+#ifdef MP_REGMASTER_STATS
+	typedef struct mp_regMaster_stats_s mp_regMaster_stats_t;
+
+	/** Queueing delay of a lane, in mp_clock_hires() units (MP_CLOCK_HIRES_HZ) */
+	struct mp_regMaster_stats_s {
+		/** number of started operands */
+		unsigned long ops;
 
+		/** cumulative delay between the enqueue and the start */
+		unsigned long waitTotal;
+
+		/** longest delay between the enqueue and the start */
+		unsigned long waitMax;
+	};
+#endif
 
 	struct mp_regMaster_op_s {
 		char state;
 
+		/** Inline register/payload area used by the *Reg() helpers */
+		unsigned char payload[MP_REGMASTER_PAYLOAD];
+
 		unsigned char *reg;
 		int regSize;
 		int regPos;
@@ -63,32 +113,44 @@
 		/** Activate swap */
 		mp_bool_t swap;
 
+		/** Owner client */
+		mp_regMaster_t *cirr;
+
+		/** Queue lane */
+		unsigned char lane;
+
+		/** @ref mp_regMaster_error_t, terminate is TRUE if not MP_REGMASTER_OK */
+		unsigned char error;
+
+		/** restarts after a failure */
+		unsigned char retries;
+
+#ifdef MP_REGMASTER_STATS
+		/** enqueue time */
+		unsigned long queued;
+#endif
+
 		/** Linked items */
 		mp_list_item_t item;
 	};
 
-	struct mp_regMaster_s {
+	/**
+	 * @brief Physical bus shared by regMaster clients
+	 *
+	 * The bus owns the interface interrupt and elects the
+	 * next operand between the clients.
+	 */
+	struct mp_regMaster_bus_s {
 		char type;
 
 		mp_kernel_t *kernel;
 
-		mp_list_t executing;
-		mp_list_t pending;
-
 		mp_regMaster_int_t enableRX;
 		mp_regMaster_int_t disableRX;
 
 		mp_regMaster_int_t enableTX;
 		mp_regMaster_int_t disableTX;
 
-		/** On bus error */
-		//mp_regMaster_int_t error;
-
-		union {
-			mp_gpio_port_t *chipSelect;
-			unsigned char slaveAddress;
-		};
-
 		union {
 			mp_i2c_t *i2c;
 			mp_spi_t *spi;
@@ -97,6 +159,81 @@
 		/* Protocol ASR */
 		mp_regMaster_asr_t asrCallback;
 
+		/* Protocol abort of the current operand, frees the bus */
+		mp_regMaster_abort_t abortCallback;
+
+		/** attached clients */
+		mp_list_t clients;
+
+		/** client served last, round robin origin */
+		mp_regMaster_t *last;
+
+		/** operand owning the bus */
+		mp_regMaster_op_t *current;
+
+		/** operands queued by all the clients */
+		volatile int queued;
+
+		/** operands queued per lane */
+		volatile int laneQueued[MP_REGMASTER_LANES];
+
+		/** RT operands served in a row while BG waits, 0 is strict */
+		unsigned char weight;
+		unsigned char streak;
+
+		/** an operand owns the bus */
+		volatile mp_bool_t busy;
+
+		/** start the next operand from the interrupt, YES by default */
+		mp_bool_t chain;
+
+		/** restarts of a failed operand before its callback gets the error */
+		unsigned char retries;
+
+		/** ticks an operand may own the bus, 0 disables the watchdog */
+		unsigned long timeout;
+		mp_ktimer_t watchdog;
+
+		/** started operands and the one the watchdog is armed for */
+		unsigned int serial;
+		unsigned int watched;
+
+		/** failures, restarts and recoveries */
+		unsigned long nacks;
+		unsigned long arbitrations;
+		unsigned long timeouts;
+		unsigned long restarts;
+		unsigned long recoveries;
+
+		char *who;
+
+#ifdef MP_REGMASTER_STATS
+		mp_regMaster_stats_t stats[MP_REGMASTER_LANES];
+#endif
+
+		/** registered buses */
+		mp_list_item_t item;
+	};
+
+	struct mp_regMaster_s {
+		char type;
+
+		mp_kernel_t *kernel;
+
+		/** bus carrying the operands */
+		mp_regMaster_bus_t *bus;
+
+		/** client number, 1 for the first attached */
+		unsigned short id;
+
+		mp_list_t executing;
+		mp_list_t pending[MP_REGMASTER_LANES];
+
+		union {
+			mp_gpio_port_t *chipSelect;
+			unsigned char slaveAddress;
+		};
+
 		void *user;
 
 		/** Padding NOP */
@@ -104,19 +241,69 @@
 
 		mp_task_t *asr;
 
+		/** higher is elected first, equal clients are served round robin */
+		unsigned char priority;
 
+		/** operand pool given at init */
+		mp_regMaster_op_t *ops;
+		int opsSize;
+		mp_list_t free;
 
+		/** enqueues refused on an empty pool */
+		unsigned long full;
+
+		/** bus clients */
+		mp_list_item_t item;
+
+		/** private bus of mp_regMaster_init_i2c() and mp_regMaster_init_spi() */
+		mp_regMaster_bus_t own;
 	};
 
+	mp_ret_t mp_regMaster_bus_init_i2c(
+		mp_kernel_t *kernel, mp_regMaster_bus_t *bus,
+		mp_i2c_t *i2c,
+		char *who
+	);
+	mp_ret_t mp_regMaster_bus_init_spi(
+		mp_kernel_t *kernel, mp_regMaster_bus_t *bus,
+		mp_spi_t *spi,
+		char *who
+	);
+	void mp_regMaster_bus_fini(mp_regMaster_bus_t *bus);
+	mp_regMaster_bus_t *mp_regMaster_bus_handle(char *gate);
+	void mp_regMaster_setTimeout(mp_regMaster_bus_t *bus, unsigned long timeout);
+
+#ifdef MP_REGMASTER_STATS
+	void mp_regMaster_stats_get(mp_regMaster_bus_t *bus, unsigned char lane, mp_regMaster_stats_t *stats);
+	void mp_regMaster_stats_reset(mp_regMaster_bus_t *bus);
+	void mp_regMaster_stats_dump(mp_regMaster_bus_t *bus);
+#endif
+
 	mp_ret_t mp_regMaster_init_i2c(
 		mp_kernel_t *kernel, mp_regMaster_t *cirr,
 		mp_i2c_t *i2c,
+		mp_regMaster_op_t *ops, int opsSize,
 		void *user,
 		char *who
 	);
 	mp_ret_t mp_regMaster_init_spi(
 		mp_kernel_t *kernel, mp_regMaster_t *cirr,
 		mp_spi_t *spi,
+		mp_regMaster_op_t *ops, int opsSize,
+		void *user,
+		char *who
+	);
+	mp_ret_t mp_regMaster_init_bus(
+		mp_kernel_t *kernel, mp_regMaster_t *cirr,
+		mp_regMaster_bus_t *bus,
+		mp_regMaster_op_t *ops, int opsSize,
+		void *user,
+		char *who
+	);
+	mp_ret_t mp_regMaster_init_gate(
+		mp_kernel_t *kernel, mp_regMaster_t *cirr,
+		mp_options_t *options, mp_i2c_t *i2c,
+		mp_regMaster_op_t *ops, int opsSize,
 		void *user,
 		char *who
 	);
@@ -126,14 +313,25 @@
 		unsigned char *reg, int regSize,
 		unsigned char *wait, int waitSize,
 		mp_regMaster_cb_t callback, void *user,
-		mp_bool_t swap
+		mp_bool_t swap, unsigned char lane
 	);
 	mp_ret_t mp_regMaster_write(
 		mp_regMaster_t *cirr,
 		unsigned char *reg, int regSize,
 		mp_regMaster_cb_t callback, void *user
 	);
-	unsigned char *mp_regMaster_register(unsigned char reg);
+	mp_ret_t mp_regMaster_readRegExt(
+		mp_regMaster_t *cirr,
+		unsigned char reg,
+		unsigned char *wait, int waitSize,
+		mp_regMaster_cb_t callback, void *user,
+		mp_bool_t swap, unsigned char lane
+	);
+	mp_ret_t mp_regMaster_writeInline(
+		mp_regMaster_t *cirr,
+		unsigned char *data, int size,
+		mp_regMaster_cb_t callback, void *user
+	);
 
 	/**
 	 * @brief Start circular register read operation
@@ -142,7 +340,8 @@
 	 *
 	 * When callback() is executed you must take care of the allocated
 	 * pointer (if used). The terminate boolean argument is set to TRUE
-	 * to notify whether regMaster has been shutdown.
+	 * when the operation failed, operand->error tells why
+	 * (@ref MP_REGMASTER_ERR_STOP when regMaster has been shutdown).
 	 * In this case you must stop actions and free buffers if needed.
 	 *
 	 * @param[in] cirr Circular context.
@@ -159,7 +358,77 @@
 			unsigned char *wait, int waitSize,
 			mp_regMaster_cb_t callback, void *user
 		) {
-		return(mp_regMaster_readExt(cirr, reg, regSize, wait, waitSize, callback, user, FALSE));
+		return(mp_regMaster_readExt(cirr, reg, regSize, wait, waitSize, callback, user, FALSE, MP_REGMASTER_LANE_BG));
+	}
+
+	/**
+	 * @brief Start register read operation
+	 *
+	 * Same as mp_regMaster_read() but the register is copied into
+	 * the operand then there is nothing to keep alive or to free.
+	 *
+	 * @param[in] cirr Circular context.
+	 * @param[in] reg Register to write
+	 * @param[out] wait Buffer to fill
+	 * @param[in] waitSize Number of bytes to read
+	 * @param[in] callback Callback executed on the end of operation
+	 * @param[in] user User pointer embedded and passed as argument
+	 */
+	static inline mp_ret_t mp_regMaster_readReg(
+			mp_regMaster_t *cirr,
+			unsigned char reg,
+			unsigned char *wait, int waitSize,
+			mp_regMaster_cb_t callback, void *user
+		) {
+		return(mp_regMaster_readRegExt(cirr, reg, wait, waitSize, callback, user, FALSE, MP_REGMASTER_LANE_BG));
+	}
+
+	/**
+	 * @brief Start 8 bits register write operation
+	 *
+	 * Register and value are copied into the operand, no allocation
+	 * and no free callback are needed.
+	 *
+	 * @param[in] cirr Circular context.
+	 * @param[in] reg Register to write
+	 * @param[in] value Value of the register
+	 * @param[in] callback Callback executed on the end of operation (can be NULL)
+	 * @param[in] user User pointer embedded and passed as argument
+	 */
+	static inline mp_ret_t mp_regMaster_writeReg(
+			mp_regMaster_t *cirr,
+			unsigned char reg, unsigned char value,
+			mp_regMaster_cb_t callback, void *user
+		) {
+		unsigned char data[2];
+
+		data[0] = reg;
+		data[1] = value;
+		return(mp_regMaster_writeInline(cirr, data, 2, callback, user));
+	}
+
+	/**
+	 * @brief Start 16 bits register write operation
+	 *
+	 * Same as mp_regMaster_writeReg(), value is sent MSB first.
+	 *
+	 * @param[in] cirr Circular context.
+	 * @param[in] reg Register to write
+	 * @param[in] value Value of the register
+	 * @param[in] callback Callback executed on the end of operation (can be NULL)
+	 * @param[in] user User pointer embedded and passed as argument
+	 */
+	static inline mp_ret_t mp_regMaster_writeReg16(
+			mp_regMaster_t *cirr,
+			unsigned char reg, unsigned short value,
+			mp_regMaster_cb_t callback, void *user
+		) {
+		unsigned char data[3];
+
+		data[0] = reg;
+		data[1] = (unsigned char)(value >> 8);
+		data[2] = (unsigned char)(value & 0xff);
+		return(mp_regMaster_writeInline(cirr, data, 3, callback, user));
 	}
 
 	/**
@@ -204,5 +473,66 @@
 		cirr->chipSelect = port;
 	}
 
+	/**
+	 * @brief Set client priority on its bus
+	 *
+	 * The bus elects the pending client with the highest
+	 * priority, clients of equal priority are served round robin.
+	 *
+	 * @param[in] cirr Circular context.
+	 * @param[in] priority Client priority, 0 by default
+	 */
+	static inline void mp_regMaster_setPriority(
+			mp_regMaster_t *cirr,
+			unsigned char priority
+		) {
+		cirr->priority = priority;
+	}
+
+	/**
+	 * @brief Set the lane weight of a bus
+	 *
+	 * With a weight of 0 the RT lane is strict and may hold
+	 * the BG lane as long as it has operands. Otherwise one BG
+	 * operand is served after weight RT operands in a row.
+	 *
+	 * @param[in] bus Bus context
+	 * @param[in] weight RT operands in a row, @ref MP_REGMASTER_WEIGHT by default
+	 */
+	static inline void mp_regMaster_setWeight(
+			mp_regMaster_bus_t *bus,
+			unsigned char weight
+		) {
+		bus->weight = weight;
+	}
+
+	/**
+	 * @brief Set the retry policy of a bus
+	 *
+	 * A NACK, an arbitration lost or a timeout restarts the operand
+	 * up to retries times, then its callback gets the error.
+	 *
+	 * @param[in] bus Bus context
+	 * @param[in] retries Restarts, @ref MP_REGMASTER_RETRIES by default
+	 */
+	static inline void mp_regMaster_setRetries(
+			mp_regMaster_bus_t *bus,
+			unsigned char retries
+		) {
+		bus->retries = retries;
+	}
+
+	/**
+	 * @brief Whether the client has joined a shared bus
+	 *
+	 * A shared bus is owned by the application, the client
+	 * must not close its interface.
+	 *
+	 * @param[in] cirr Circular context.
+	 */
+	static inline mp_bool_t mp_regMaster_shared(mp_regMaster_t *cirr) {
+		return(cirr->bus != &cirr->own ? YES : NO);
+	}
+
 	/** @} */
 #endif
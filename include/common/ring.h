@@ -0,0 +1,92 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _HAVE_MP_COMMON_RING_H
+	#define _HAVE_MP_COMMON_RING_H
+
+	/**
+	 * @defgroup mpCommonRing
+	 * @{
+	 */
+
+	typedef struct mp_ring_s mp_ring_t;
+	typedef struct mp_ring_span_s mp_ring_span_t;
+
+	/** contiguous part of a ring, a region is made of two spans */
+	struct mp_ring_span_s {
+		unsigned char *data;
+		unsigned int size;
+	};
+
+	struct mp_ring_s {
+		/** storage, volatile to keep data and index stores ordered */
+		volatile unsigned char *data;
+
+		/** size-1, size is a power of two */
+		unsigned short mask;
+
+		/** free running index written by the producer only */
+		volatile unsigned short head;
+
+		/** free running index written by the consumer only */
+		volatile unsigned short tail;
+
+		/** bytes dropped because the ring was full */
+		volatile unsigned long overruns;
+
+		/** mp_ring_read() calls asking for bytes on an empty ring */
+		volatile unsigned long underruns;
+	};
+
+	/** @} */
+
+	mp_ret_t mp_ring_init(mp_ring_t *ring, unsigned char *buffer, unsigned int size);
+	mp_bool_t mp_ring_put(mp_ring_t *ring, unsigned char c);
+	mp_bool_t mp_ring_get(mp_ring_t *ring, unsigned char *c);
+	unsigned int mp_ring_write(mp_ring_t *ring, unsigned char *data, unsigned int size);
+	unsigned int mp_ring_read(mp_ring_t *ring, unsigned char *data, unsigned int size);
+	unsigned int mp_ring_reserve(mp_ring_t *ring, mp_ring_span_t *span, unsigned int size);
+	void mp_ring_commit(mp_ring_t *ring, unsigned int size);
+	unsigned int mp_ring_peek(mp_ring_t *ring, mp_ring_span_t *span);
+	void mp_ring_consume(mp_ring_t *ring, unsigned int size);
+	void mp_ring_span_write(mp_ring_span_t *span, unsigned int offset, unsigned char *data, unsigned int size);
+
+	/**
+	 * @brief Number of bytes waiting into the ring
+	 *
+	 * @param[in] ring Ring
+	 * @return Bytes to read
+	 */
+	static inline unsigned int mp_ring_count(mp_ring_t *ring) {
+		return((unsigned short)(ring->head-ring->tail));
+	}
+
+	/**
+	 * @brief Number of bytes which can be written
+	 *
+	 * @param[in] ring Ring
+	 * @return Free bytes
+	 */
+	static inline unsigned int mp_ring_space(mp_ring_t *ring) {
+		return(ring->mask+1-mp_ring_count(ring));
+	}
+
+#endif
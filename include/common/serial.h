@@ -32,6 +32,19 @@
 		typedef unsigned char (*mp_serial_onRx_t)(mp_serial_t *serial);
 		typedef void (*mp_serial_onInt_t)(mp_serial_t *serial);
 
+		typedef enum {
+			/** half of the RX ring has been filled since the last lap */
+			MP_SERIAL_DMA_HALF = 1,
+
+			/** the RX channel restarted at the beginning of the ring */
+			MP_SERIAL_DMA_FULL = 2,
+
+			/** bytes then nothing during MP_SERIAL_DMA_CHECK ticks */
+			MP_SERIAL_DMA_IDLE = 3,
+		} mp_serial_dma_event_t;
+
+		typedef void (*mp_serial_onDma_t)(mp_serial_t *serial, mp_serial_dma_event_t event);
+
 
 		struct mp_serial_interface_s {
 			mp_serial_onTx_t tx;
@@ -52,14 +65,59 @@
 			mp_circular_t txCir;
 			mp_circular_t rxCir;
 
+			/** ring backend, used instead of the circulars */
+			mp_bool_t useRing;
+			mp_ring_t txRing;
+			mp_ring_t rxRing;
+
+			/** DMA backend, the rings are filled and drained by the UART channels */
+			mp_bool_t useDma;
+
+			/** DMA receive notifications, FULL comes from the DMA interrupt */
+			mp_serial_onDma_t onDma;
+			void *user;
+
+			/** internal: RX ring head at the beginning of the current lap */
+			unsigned short dmaRxLap;
+
+			/** internal: RX ring head seen by the previous idle check */
+			unsigned short dmaRxSeen;
+
+			/** internal: half and idle notifications to come */
+			mp_bool_t dmaRxHalf;
+			mp_bool_t dmaRxIdle;
+
+			/** internal: size of the TX block owned by the channel */
+			unsigned int dmaTxSize;
+
+			/** internal: half and idle checks */
+			mp_ktimer_t dmaTimer;
+
 			char opened;
 		};
 
 		mp_ret_t mp_serial_initUART(mp_kernel_t *kernel, mp_serial_t *serial, mp_uart_t *uart, char *who);
+		mp_ret_t mp_serial_initUART_ring(
+			mp_kernel_t *kernel, mp_serial_t *serial, mp_uart_t *uart,
+			unsigned char *rxBuffer, unsigned int rxSize,
+			unsigned char *txBuffer, unsigned int txSize,
+			char *who
+		);
+		mp_ret_t mp_serial_initUART_dma(
+			mp_kernel_t *kernel, mp_serial_t *serial, mp_uart_t *uart,
+			unsigned char *rxBuffer, unsigned int rxSize,
+			unsigned char *txBuffer, unsigned int txSize,
+			char *who
+		);
 		mp_ret_t mp_serial_fini(mp_serial_t *serial);
 
 
 		void mp_serial_write(mp_serial_t *serial, unsigned char *input, int size);
+		int mp_serial_read(mp_serial_t *serial, unsigned char *output, int size);
+		unsigned int mp_serial_peek(mp_serial_t *serial, mp_ring_span_t *span);
+		void mp_serial_consume(mp_serial_t *serial, unsigned int size);
+		unsigned int mp_serial_reserve(mp_serial_t *serial, mp_ring_span_t *span, unsigned int size);
+		void mp_serial_commit(mp_serial_t *serial, unsigned int size);
 	#endif
 
 #endif
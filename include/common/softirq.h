@@ -0,0 +1,72 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _HAVE_MP_COMMON_SOFTIRQ_H
+	#define _HAVE_MP_COMMON_SOFTIRQ_H
+
+	#if (MP_SOFTIRQ_SIZE & (MP_SOFTIRQ_SIZE-1)) || MP_SOFTIRQ_SIZE > 128
+		#error "MP_SOFTIRQ_SIZE must be a power of two <= 128"
+	#endif
+
+	/**
+	 * @defgroup mpCommonSoftirq
+	 * @{
+	 */
+
+	typedef struct mp_softirq_s mp_softirq_t;
+	typedef struct mp_softirq_item_s mp_softirq_item_t;
+
+	typedef void (*mp_softirq_handler_t)(void *user);
+
+	struct mp_softirq_item_s {
+		/** deferred function, NULL for a task signal */
+		mp_softirq_handler_t handler;
+
+		/** handler user pointer or task to signal */
+		void *user;
+
+		/** signal to deliver when handler is NULL */
+		unsigned char signal;
+	};
+
+	struct mp_softirq_s {
+		/** ring of deferred works */
+		volatile mp_softirq_item_t items[MP_SOFTIRQ_SIZE];
+
+		/** free running producer index, only written by ISRs */
+		volatile unsigned char head;
+
+		/** free running consumer index, only written by the kernel loop */
+		volatile unsigned char tail;
+
+		/** number of posts which did not fit into the ring */
+		volatile unsigned int overrun;
+	};
+
+	/** @} */
+
+	void mp_softirq_init(mp_kernel_t *kernel);
+	mp_ret_t mp_softirq_post(mp_kernel_t *kernel, mp_softirq_handler_t handler, void *user);
+	void mp_softirq_signal(mp_task_t *task, mp_task_signal_t signal);
+	mp_bool_t mp_softirq_pending(mp_kernel_t *kernel);
+	unsigned int mp_softirq_drain(mp_kernel_t *kernel);
+
+#endif
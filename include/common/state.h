@@ -19,6 +19,9 @@
 		mp_state_callback_t set;
 		mp_state_callback_t unset;
 		mp_state_callback_t tick;
+
+		/** arena reset after unset, can be NULL */
+		mp_arena_t *arena;
 	};
 
 	struct mp_state_handler_s {
@@ -44,4 +47,5 @@
 		mp_state_callback_t unset,
 		mp_state_callback_t tick
 	);
+	mp_ret_t mp_state_arena(mp_state_handler_t *hdl, char number, mp_arena_t *arena);
 #endif
@@ -45,6 +45,25 @@
 
 	typedef void (*mp_task_wakeup_t)(mp_task_t *task);
 
+#ifdef MP_TASK_STATS
+	typedef struct mp_task_stats_s mp_task_stats_t;
+
+	/** Time values are in mp_clock_hires() units (MP_CLOCK_HIRES_HZ) */
+	struct mp_task_stats_s {
+		/** number of wakeup executions */
+		unsigned long wakeups;
+
+		/** cumulative execution time */
+		unsigned long execTotal;
+
+		/** longest execution time */
+		unsigned long execMax;
+
+		/** longest delay between a pending/stop signal and the wakeup */
+		unsigned long latencyMax;
+	};
+#endif
+
 	struct mp_task_s {
 		/** Connected to handler */
 		mp_task_handler_t *handler;
@@ -67,8 +86,31 @@
 		/** actual signal */
 		mp_task_signal_t signal;
 
+		/** absolute tick of the next wake up (check + delay) */
+		unsigned long deadline;
+
+		/** position into the deadline heap, -1 when out of the heap */
+		int heapIndex;
+
+		/** is the task linked into the ready list ? */
+		mp_bool_t ready;
+
 		/** list input */
 		mp_list_item_t item;
+
+		/** ready list input */
+		mp_list_item_t readyItem;
+
+#ifdef MP_TASK_STATS
+		/** runtime accounting */
+		mp_task_stats_t stats;
+
+		/** when the task has been made ready by a signal */
+		unsigned long signaled;
+
+		/** is signaled waiting for a wakeup ? */
+		mp_bool_t signaledArmed;
+#endif
 	};
 
 	struct mp_task_handler_s {
@@ -93,6 +135,21 @@
 		/** free organized list */
 		mp_list_t freeList;
 
+		/** deadline ordered min-heap of OK tasks */
+		mp_task_t *heap[MP_TASK_MAX];
+
+		/** number of tasks into the heap */
+		unsigned int heapNumber;
+
+		/** tasks to run on the next tick (pending, stopping, due) */
+		mp_list_t readyList;
+
+		/** number of tasks into the ready list */
+		unsigned int readyNumber;
+
+		/** task actually executed by mp_task_tick() */
+		mp_task_t *running;
+
 		/** global signal */
 		mp_task_signal_t signal;
 	};
@@ -109,6 +166,15 @@
 	void mp_task_signal(mp_task_t *task, mp_task_signal_t signal);
 
 	mp_task_tick_t mp_task_tick(mp_task_handler_t *hdl);
+	unsigned long mp_task_next_wakeup(mp_task_handler_t *hdl, unsigned long now);
+
+	#define MP_TASK_NO_WAKEUP (~0UL)
+
+#ifdef MP_TASK_STATS
+	void mp_task_stats_get(mp_task_t *task, mp_task_stats_t *stats);
+	void mp_task_stats_reset(mp_task_handler_t *hdl);
+	void mp_task_stats_dump(mp_task_handler_t *hdl);
+#endif
 
 	#define MP_TASK(name) void name(mp_task_t *task)
 
@@ -0,0 +1,102 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _HAVE_MP_COMMON_TRACE_H
+	#define _HAVE_MP_COMMON_TRACE_H
+
+	#ifdef MP_TRACE
+
+	#ifndef SUPPORT_COMMON_SERIAL
+		#error "MP_TRACE needs SUPPORT_COMMON_SERIAL"
+	#endif
+
+	/* head and tail are 8 bits, a full ring of 256 would look empty */
+	#if (MP_TRACE_SIZE & (MP_TRACE_SIZE-1)) || MP_TRACE_SIZE > 128
+		#error "MP_TRACE_SIZE must be a power of two <= 128"
+	#endif
+
+	/**
+	 * @defgroup mpCommonTrace
+	 * @{
+	 */
+
+	/** stream format version given by MP_TRACE_SYNC */
+	#define MP_TRACE_VERSION 1
+
+	typedef enum {
+		/** time = MP_CLOCK_HIRES_HZ, id = MP_TRACE_VERSION */
+		MP_TRACE_SYNC = 0x00,
+
+		/** id = task slot */
+		MP_TRACE_TASK_BEGIN = 0x01,
+		MP_TRACE_TASK_END = 0x02,
+
+		/** id = interrupt vector */
+		MP_TRACE_ISR_ENTER = 0x03,
+		MP_TRACE_ISR_EXIT = 0x04,
+
+		/** id = first register, arg = regMaster client id */
+		MP_TRACE_REGMASTER_START = 0x05,
+		MP_TRACE_REGMASTER_DONE = 0x06,
+
+		/** id = new state number */
+		MP_TRACE_STATE = 0x07,
+
+		MP_TRACE_LPM_ENTER = 0x08,
+		MP_TRACE_LPM_EXIT = 0x09,
+
+		/** arg = number of records dropped on full ring, saturated to 0xffff */
+		MP_TRACE_LOST = 0x0a,
+
+		/** id = task slot or state number, arg = name length,
+		 * followed by the name padded to a record size multiple */
+		MP_TRACE_NAME_TASK = 0x10,
+		MP_TRACE_NAME_STATE = 0x11,
+	} mp_trace_type_t;
+
+	typedef struct mp_trace_record_s mp_trace_record_t;
+
+	/** 8 bytes little endian record */
+	struct mp_trace_record_s {
+		/** mp_clock_hires() timestamp */
+		uint32_t time;
+
+		/** mp_trace_type_t */
+		uint8_t type;
+
+		uint8_t id;
+
+		uint16_t arg;
+	};
+
+	/** @} */
+
+	mp_ret_t mp_trace_start(mp_kernel_t *kernel, mp_serial_t *serial);
+	void mp_trace_stop();
+	void mp_trace_write(unsigned char type, unsigned char id, unsigned short arg);
+
+	#define MP_TRACE_EVENT(type, id, arg) mp_trace_write((type), (id), (arg))
+
+	#else
+		#define MP_TRACE_EVENT(type, id, arg)
+	#endif
+
+#endif
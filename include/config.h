@@ -38,8 +38,9 @@
 
 	#define SUPPORT_COMMON_MEM /* enable tiny-malloc */
 	#define SUPPORT_COMMON_SERIAL /* serial interface */
+	//#define SUPPORT_COMMON_FRAME /* COBS/SLIP frames over serial */
 	//#define SUPPORT_COMMON_HCI /* HCI interface */
-	#define SUPPORT_COMMON_PINOUT /* enable pinout feature, need mem support */
+	#define SUPPORT_COMMON_PINOUT /* enable pinout feature */
 	//#define SUPPORT_COMMON_QUATERNION /* enable quaternion feature */
 	#define SUPPORT_COMMON_SENSOR /* enable sensor feature */
 	#define SUPPORT_COMMON_CIRCULAR /* enable circular buffering */
@@ -53,6 +54,10 @@
 		#define MP_CLOCK_HE_FREQ MHZ25_t
 	#endif
 
+	#ifndef MP_CLOCK_TICKLESS
+		//#define MP_CLOCK_TICKLESS /* sleep until the next task deadline instead of a 1 kHz tick */
+	#endif
+
 	/* sensor configuration */
 
 	/* mem configuration */
@@ -61,7 +66,19 @@
 	#endif
 
 	#ifndef MP_MEM_CHUNK
-		#define MP_MEM_CHUNK 50    /* fixed size of a chunck */
+		#define MP_MEM_CHUNK 50    /* largest chunk */
+	#endif
+
+	#ifndef MP_MEM_CLASSES
+		#define MP_MEM_CLASSES { 4, 16 }, { 16, 8 }, { 32, 6 }, { MP_MEM_CHUNK, 8 } /* { size, chunks } sorted, the last class takes the rest of the heap */
+	#endif
+
+	#ifndef MP_MEM_ISR_CHUNKS
+		#define MP_MEM_ISR_CHUNKS 2 /* largest chunks reserved to mp_mem_alloc_isr() */
+	#endif
+
+	#ifndef MP_MEM_STATS
+		//#define MP_MEM_STATS /* tag chunks with their owner for mp_mem_stats_dump() */
 	#endif
 
 	#ifndef MP_COMMON_MEM_USE_MALLOC
@@ -73,6 +90,80 @@
 		#define MP_TASK_MAX 10 /* number of maximum task per instance */
 	#endif
 
+	/* softirq configuration */
+	#ifndef MP_SOFTIRQ_SIZE
+		#define MP_SOFTIRQ_SIZE 16 /* ISR deferred works ring, power of two */
+	#endif
+
+	/* software timer configuration */
+	#ifndef MP_KTIMER_SLOTS
+		#define MP_KTIMER_SLOTS 16 /* timer wheel size, power of two */
+	#endif
+
+	#ifndef MP_TASK_STATS
+		//#define MP_TASK_STATS /* per task runtime and latency accounting */
+	#endif
+
+	/* trace configuration */
+	#ifndef MP_TRACE
+		//#define MP_TRACE /* binary kernel event trace, need serial support */
+	#endif
+
+	#ifndef MP_TRACE_SIZE
+		#define MP_TRACE_SIZE 64 /* number of 8 bytes trace records, power of two <= 128 */
+	#endif
+
+	/* log configuration */
+	#ifndef MP_LOG
+		//#define MP_LOG /* deferred formatting binary log, need serial support */
+	#endif
+
+	#ifndef MP_LOG_PRINTK
+		//#define MP_LOG_PRINTK /* mp_printk() goes through mp_log() when MP_LOG is defined */
+	#endif
+
+	#ifndef MP_LOG_SIZE
+		#define MP_LOG_SIZE 256 /* log ring bytes, power of two */
+	#endif
+
+	#ifndef MP_LOG_ARGS
+		#define MP_LOG_ARGS 32 /* maximum argument bytes of a log record */
+	#endif
+
+	#ifndef MP_LOG_STRING
+		#define MP_LOG_STRING 16 /* maximum characters of a logged string */
+	#endif
+
+	/* regMaster configuration */
+	#ifndef MP_REGMASTER_PAYLOAD
+		#define MP_REGMASTER_PAYLOAD 4 /* inline register/payload bytes of an operand */
+	#endif
+
+	#ifndef MP_REGMASTER_OPS
+		#define MP_REGMASTER_OPS 8 /* operand pool of a driver regMaster */
+	#endif
+
+	#ifndef MP_REGMASTER_WEIGHT
+		#define MP_REGMASTER_WEIGHT 4 /* RT operands served in a row while BG waits, 0 is strict */
+	#endif
+
+	#ifndef MP_REGMASTER_STATS
+		//#define MP_REGMASTER_STATS /* per lane queueing delay accounting */
+	#endif
+
+	#ifndef MP_REGMASTER_TIMEOUT
+		#define MP_REGMASTER_TIMEOUT 20 /* ticks an operand may own the bus, 0 disables the watchdog */
+	#endif
+
+	#ifndef MP_REGMASTER_RETRIES
+		#define MP_REGMASTER_RETRIES 2 /* restarts of a failed operand */
+	#endif
+
+	/* serial configuration */
+	#ifndef MP_SERIAL_DMA_CHECK
+		#define MP_SERIAL_DMA_CHECK 2 /* ticks between DMA half and idle checks */
+	#endif
+
 	/* state configuration */
 	#ifndef MP_STATE_MAX
 		#define MP_STATE_MAX 5 /* maximum number of machine states */
@@ -94,10 +94,14 @@
 		#define MP_NRF8001_DUPLEX_TX         0x1
 		#define MP_NRF8001_DUPLEX_RX         0x2
 		#define MP_NRF8001_DUPLEX_TX_PENDING 0x4
-		#define MP_NRF8001_DUPLEX_RX_PENDING 0x8
 		/** Duplex status */
 		unsigned char duplexStatus;
 
+		#define MP_NRF8001_EV_RX 0x1 /* received packets pending */
+		#define MP_NRF8001_EV_TX 0x2 /* packets to send or TX terminated */
+		/** ASR events */
+		mp_event_t events;
+
 		/** Dummy internal status byte from RX packet */
 		unsigned char statusByte;
 
@@ -39,6 +39,7 @@
 		mp_i2c_t i2c;
 
 		mp_regMaster_t regMaster;
+		mp_regMaster_op_t regMasterOps[MP_REGMASTER_OPS];
 
 		mp_gpio_port_t *drdy;
 
@@ -48,8 +49,6 @@
 
 		unsigned char flags;
 
-		unsigned char configBuffer[3];
-
 		unsigned short value;
 	};
 
@@ -54,6 +54,7 @@
 
 		/* reg master handler */
 		mp_regMaster_t regMaster;
+		mp_regMaster_op_t regMasterOps[MP_REGMASTER_OPS];
 
 		/* DRDY GPIO */
 		mp_gpio_port_t *drdy;
@@ -73,7 +74,9 @@
 		/** User pointer */
 		void *user;
 
-		char onDrdy;
+		/** MP_DRV_ADS124X_EV_DRDY : conversion available */
+		#define MP_DRV_ADS124X_EV_DRDY 0x1
+		mp_event_t events;
 
 		/* internal register map */
 		//unsigned char registerMap[_ADS124X_REGCOUNT+1];
@@ -37,6 +37,7 @@
 		mp_i2c_t i2c;
 
 		mp_regMaster_t regMaster;
+		mp_regMaster_op_t regMasterOps[MP_REGMASTER_OPS];
 
 		unsigned short configuration;
 		unsigned short calibrationVal;
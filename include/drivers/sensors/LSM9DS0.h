@@ -31,6 +31,9 @@
 	#define MP_DRV_LSM9DS0_MODE_I2C 1
 	#define MP_DRV_LSM9DS0_MODE_SPI 2
 
+	/** gyro and accel/mag setup bursts share the regMaster pool */
+	#define MP_DRV_LSM9DS0_OPS (MP_REGMASTER_OPS*2)
+
 	#define LSM9DS0_ADDRESS_ACCELMAG           (0x1D)         // 3B >> 1 = 7bit default
 	#define LSM9DS0_ADDRESS_GYRO               (0x6B)         // D6 >> 1 = 7bit default
 
@@ -133,11 +136,15 @@
 
 		/**
 		 * Internal interrupt source
-		 * - 0x1 : Gyro pending
-		 * - 0x2 : Magneto pending
-		 * - 0x4 : Accelero pending
+		 * - MP_DRV_LSM9DS0_EV_GYRO : Gyro pending
+		 * - MP_DRV_LSM9DS0_EV_MAG : Magneto pending
+		 * - MP_DRV_LSM9DS0_EV_ACCEL : Accelero pending
 		 * */
-		unsigned char intSrc:4;
+		#define MP_DRV_LSM9DS0_EV_GYRO  0x1
+		#define MP_DRV_LSM9DS0_EV_MAG   0x2
+		#define MP_DRV_LSM9DS0_EV_ACCEL 0x4
+		#define MP_DRV_LSM9DS0_EV_ALL   0x7
+		mp_event_t events;
 
 		char protocol:2;
 		char drdyCount:2;
@@ -163,6 +170,7 @@
 		};
 
 		mp_regMaster_t regMaster;
+		mp_regMaster_op_t regMasterOps[MP_DRV_LSM9DS0_OPS];
 
 		unsigned char buffer[6];
 
@@ -224,7 +232,7 @@
 		mp_drv_LSM9DS0_t *LSM9DS0,
 		unsigned char reg,
 		unsigned char *wait, int waitSize,
-		mp_regMaster_cb_t callback
+		mp_regMaster_cb_t callback, unsigned char lane
 	);
 	void mp_drv_LSM9DS0_xmWrite(
 		mp_drv_LSM9DS0_t *LSM9DS0,
@@ -236,7 +244,7 @@
 		mp_drv_LSM9DS0_t *LSM9DS0,
 		unsigned char reg,
 		unsigned char *wait, int waitSize,
-		mp_regMaster_cb_t callback
+		mp_regMaster_cb_t callback, unsigned char lane
 	);
 	void mp_drv_LSM9DS0_gWrite(
 		mp_drv_LSM9DS0_t *LSM9DS0,
@@ -32,6 +32,8 @@
 
 	typedef struct mp_drv_MPL3115A2_s mp_drv_MPL3115A2_t;
 
+	typedef void (*mp_drv_MPL3115A2_reader_t)(mp_drv_MPL3115A2_t *MPL3115A2);
+
 	struct mp_drv_MPL3115A2_s {
 		/** kernel handler */
 		mp_kernel_t *kernel;
@@ -39,6 +41,7 @@
 		mp_i2c_t i2c;
 
 		mp_regMaster_t regMaster;
+		mp_regMaster_op_t regMasterOps[MP_REGMASTER_OPS];
 
 		mp_gpio_port_t *drdy;
 
@@ -46,11 +49,28 @@
 
 		mp_sensor_t *temperature;
 
+		/** CTRL_REG1 shadow */
 		unsigned char settings;
 
-		char whoIam;
+		/** CTRL_REG2 shadow */
+		unsigned char timeStep;
+
+		/** CTRL_REG4/CTRL_REG5 value */
+		unsigned char interrupt;
+
+		unsigned char whoIam;
+
+		/** pending requests for the coroutine */
+		unsigned char request;
+
+		unsigned char intSource;
+
+		unsigned char data[3];
+
+		mp_drv_MPL3115A2_reader_t readerControl;
 
-		mp_regMaster_cb_t readerControl;
+		/** register sequences */
+		mp_co_t co;
 	};
 
 	typedef enum {
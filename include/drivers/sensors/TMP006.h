@@ -38,6 +38,7 @@
 		mp_gpio_port_t *drdy;
 
 		mp_regMaster_t regMaster;
+		mp_regMaster_op_t regMasterOps[MP_REGMASTER_OPS];
 
 		mp_sensor_t *sensor;
 
@@ -74,6 +74,9 @@
 
 	#include "common/list.h"
 	#include "common/task.h"
+	#include "common/softirq.h"
+	#include "common/event.h"
+	#include "common/ktimer.h"
 
 	#ifdef __MSP430__
 		#include <msp430.h>
@@ -84,6 +87,15 @@
 		#include <stdarg.h>
 		#include <msp430/internal.h>
 
+		#define PI (355.0 / 113.0)
+	#elif defined(__unix__)
+		#include <math.h>
+		#include <string.h>
+		#include <stdio.h>
+		#include <stdlib.h>
+		#include <stdarg.h>
+		#include <posix/internal.h>
+
 		#define PI (355.0 / 113.0)
 	#endif
 
@@ -102,15 +114,21 @@
 
 	#include "common/utils.h"
 	#include "common/mem.h"
+	#include "common/arena.h"
 	#include "common/circular.h"
+	#include "common/ring.h"
 	#include "common/state.h"
 	#include "common/hci.h"
 	#include "common/serial.h"
+	#include "common/frame.h"
+	#include "common/trace.h"
 	#include "common/pinout.h"
 	#include "common/printk.h"
+	#include "common/log.h"
 	#include "common/quaternion.h"
 	#include "common/sensor.h"
 	#include "common/regMaster.h"
+	#include "common/coroutine.h"
 	#include "common/kalman.h"
 
 	/* Bluetooth */
@@ -128,7 +146,7 @@
 	#include "drivers/sensors/MPL3115A2.h"
 	#include "drivers/sensors/ADS1115.h"
 	#include "drivers/sensors/INA219.h"
-	#include "drivers/sensors/ADS124X.h"
+	#include "drivers/sensors/ADS124x.h"
 
 	#define MP_KERNEL_VERSION "1.0.5"
 
@@ -148,6 +166,12 @@
 		/** Kernel tasks */
 		mp_task_handler_t tasks;
 
+		/** ISR deferred works */
+		mp_softirq_t softirq;
+
+		/** Kernel software timers */
+		mp_ktimer_handler_t timers;
+
 		/** Sensors handler */
 		mp_sensor_handler_t sensors;
 
@@ -165,6 +189,8 @@
 		mp_sensor_t *sensorMCU;
 
 		mp_arch_msp430_t msp430;
+#elif defined(__unix__)
+		mp_arch_posix_t posix;
 #endif
 
 	};
@@ -26,6 +26,9 @@
 	/* Auxilary clock */
 	#define ACLK_FREQ_HZ ((unsigned int)32768)
 
+	/* mp_clock_hires() resolution */
+	#define MP_CLOCK_HIRES_HZ ((unsigned long)ACLK_FREQ_HZ)
+
 	typedef struct mp_clock_freq_settings_s {
 		unsigned char ID;
 		unsigned char DCORSEL;
@@ -70,6 +73,9 @@
 	void mp_clock_wakeup(mp_kernel_t *kernel);
 
 	unsigned long mp_clock_ticks();
+	unsigned long mp_clock_hires();
+	unsigned long mp_clock_hires_ms(unsigned long hires);
+	unsigned long mp_clock_hires_us(unsigned long hires);
 	unsigned long mp_clock_get_speed();
 	const char *mp_clock_name(mp_clock_freq_t clock);
 
@@ -0,0 +1,84 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _HAVE_MSP430_DMA_H
+	#define _HAVE_MSP430_DMA_H
+
+	typedef struct mp_dma_s mp_dma_t;
+
+	typedef void (*mp_dma_on_t)(mp_dma_t *dma);
+
+	/* transfer flags */
+	#define MP_DMA_SRC_INCR 0x01
+	#define MP_DMA_DST_INCR 0x02
+	#define MP_DMA_REPEAT   0x04
+
+	/* F5438 trigger sources */
+	#define MP_DMA_TRIGGER_UCA0RX 16
+	#define MP_DMA_TRIGGER_UCA0TX 17
+	#define MP_DMA_TRIGGER_UCB0RX 18
+	#define MP_DMA_TRIGGER_UCB0TX 19
+	#define MP_DMA_TRIGGER_UCA1RX 20
+	#define MP_DMA_TRIGGER_UCA1TX 21
+	#define MP_DMA_TRIGGER_UCB1RX 22
+	#define MP_DMA_TRIGGER_UCB1TX 23
+
+	#define MP_DMA_CHANNELS 3
+
+	struct mp_dma_s {
+		/** channel number */
+		unsigned char channel;
+
+		/** opened with mp_dma_open() */
+		mp_bool_t opened;
+
+		/** called from the DMA interrupt at the end of a transfer */
+		mp_dma_on_t onDone;
+		void *user;
+
+		char *who;
+	};
+
+	mp_ret_t mp_dma_init();
+	mp_ret_t mp_dma_fini();
+	mp_ret_t mp_dma_open(mp_dma_t *dma, char *channel, char *who);
+	mp_ret_t mp_dma_close(mp_dma_t *dma);
+
+	void mp_dma_start(mp_dma_t *dma, unsigned char trigger, unsigned char flags,
+			volatile void *src, volatile void *dst, unsigned int size);
+	void mp_dma_stop(mp_dma_t *dma);
+	unsigned int mp_dma_remaining(mp_dma_t *dma);
+	mp_bool_t mp_dma_pending(mp_dma_t *dma);
+
+	/* machine specs, one 16 bytes block per channel from DMA0CTL */
+	#define _DMA_CTL 0x00
+	#define _DMA_SA  0x02
+	#define _DMA_DA  0x06
+	#define _DMA_SZ  0x0a
+
+	#define _DMA_REG16(_channel, _type) \
+		*((volatile unsigned int *)((unsigned int)&DMA0CTL+(_channel)*0x10+_type))
+
+	/* trigger selection, one byte per channel from DMACTL0 */
+	#define _DMA_TSEL(_channel) \
+		*((volatile unsigned char *)((unsigned int)&DMACTL0+(_channel)))
+
+#endif
@@ -27,6 +27,7 @@
 
 	typedef enum {
 		MP_I2C_FL_NACK = USCI_I2C_UCNACKIFG,
+		MP_I2C_FL_AL = USCI_I2C_UCALIFG,
 		MP_I2C_FL_STOP = USCI_I2C_UCSTPIFG,
 		MP_I2C_FL_START = USCI_I2C_UCSTTIFG,
 		MP_I2C_FL_TX = USCI_I2C_UCTXIFG,
@@ -73,6 +74,8 @@
 	mp_ret_t mp_i2c_open(mp_kernel_t *kernel, mp_i2c_t *i2c, mp_options_t *options, char *who);
 	mp_ret_t mp_i2c_setup(mp_i2c_t *i2c, mp_options_t *options);
 	mp_ret_t mp_i2c_close(mp_i2c_t *i2c);
+	void mp_i2c_reset(mp_i2c_t *i2c);
+	void mp_i2c_recover(mp_i2c_t *i2c);
 
 	#define _I2C_REG8(_port, _type) \
 		*((volatile char *)(_port->_baseAddress+_type))
@@ -98,6 +101,14 @@
 		_I2C_REG8(i2c->gate, _I2C_IE) &= ~UCTXIE;
 	}
 
+	static inline void mp_i2c_enable_errors(mp_i2c_t *i2c) {
+		_I2C_REG8(i2c->gate, _I2C_IE) |= UCNACKIE | UCALIE;
+	}
+
+	static inline void mp_i2c_disable_errors(mp_i2c_t *i2c) {
+		_I2C_REG8(i2c->gate, _I2C_IE) &= ~(UCNACKIE | UCALIE);
+	}
+
 
 	static inline unsigned char mp_i2c_rx(mp_i2c_t *i2c) {
 		return(_I2C_REG8(i2c->gate, _I2C_RXBUF));
@@ -44,6 +44,7 @@ Michael Vergoz <mv@verman.fr>
 	#include "timer.h"
 	#include "clock.h"
 	#include "i2c.h"
+	#include "dma.h"
 	#include "uart.h"
 	#include "spi.h"
 	#include "adc.h"
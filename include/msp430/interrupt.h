@@ -22,6 +22,7 @@
 	void mp_interrupt_disable();
 	mp_bool_t mp_interrupt_state();
 	void mp_interrupt_restore(mp_bool_t state);
+	void mp_interrupt_lpm_exit();
 
 	#define MP_INTERRUPT_SAFE_BEGIN { mp_bool_t _____state = mp_interrupt_state(); \
 		mp_interrupt_disable();
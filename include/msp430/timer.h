@@ -89,6 +89,7 @@
 		/* MSP430 dependent */
 		unsigned short *regCTL;
 		unsigned short *regCCTL0;
+		unsigned short *regR;
 		unsigned short *regCCR0;
 		unsigned short *regIV;
 	};
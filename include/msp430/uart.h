@@ -46,9 +46,22 @@
 		/** internal: txd_port */
 		mp_gpio_port_t *txd_port;
 
+		/** DMA channels, opened with the dmaTx and dmaRx options */
+		mp_dma_t dmaTx;
+		mp_dma_t dmaRx;
 
+		/** end of a DMA transmit block */
+		mp_uart_on_t onDmaTx;
 
+		/** end of a DMA receive lap, the channel restarts at the beginning */
+		mp_uart_on_t onDmaRx;
 
+		/** internal: DMA trigger sources of the gate */
+		unsigned char dmaTxTrigger;
+		unsigned char dmaRxTrigger;
+
+		/** internal: DMA receive storage size */
+		unsigned int dmaRxSize;
 	};
 
 	mp_ret_t mp_uart_init();
@@ -57,6 +70,11 @@
 	mp_ret_t mp_uart_setup(mp_uart_t *uart, mp_options_t *options);
 	mp_ret_t mp_uart_close(mp_uart_t *uart);
 
+	mp_ret_t mp_uart_dma_tx(mp_uart_t *uart, unsigned char *data, unsigned int size);
+	mp_ret_t mp_uart_dma_rx(mp_uart_t *uart, unsigned char *buffer, unsigned int size);
+	unsigned int mp_uart_dma_rx_count(mp_uart_t *uart);
+	void mp_uart_dma_stop(mp_uart_t *uart);
+
 	/* machine specs */
 	#define _UART_CTLW0   0x00
 	#define _UART_CTL0    0x01
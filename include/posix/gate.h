@@ -0,0 +1,60 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _HAVE_POSIX_GATE_H
+	#define _HAVE_POSIX_GATE_H
+
+	typedef struct mp_gate_s mp_gate_t;
+
+	struct mp_gate_s {
+		/** Gate name */
+		char *portDevice;
+
+		/** gate user flags */
+		unsigned char gateFlags;
+
+		/** is uart gate busy ? */
+		mp_bool_t isBusy;
+
+		/** busy by who ? */
+		char *byWho;
+
+		/** internal: ISR vector */
+		unsigned int _ISRVector;
+
+		/** posix: emulated interrupt enable register */
+		volatile unsigned char ie;
+
+		/** posix: emulated interrupt flag register */
+		volatile unsigned char ifg;
+
+		/** posix: simulated devices wired on the gate */
+		mp_list_t devices;
+	};
+
+	void mp_gate_init(mp_kernel_t *kernel);
+	void mp_gate_fini(mp_kernel_t *kernel);
+	mp_gate_t *mp_gate_handle(char *id, char *who);
+	void mp_gate_release(mp_gate_t *gate);
+
+	mp_gate_t *mp_posix_gate_get(char *id);
+	void mp_posix_gate_update(mp_gate_t *gate);
+#endif
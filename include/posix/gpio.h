@@ -0,0 +1,109 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _HAVE_POSIX_GPIO_H
+	#define _HAVE_POSIX_GPIO_H
+
+	/* compatible API */
+	typedef enum {
+		MP_GPIO_INPUT = 1,
+		MP_GPIO_OUTPUT = 2,
+	} mp_gpio_direction_t;
+
+	typedef struct mp_gpio_port_s mp_gpio_port_t;
+
+	struct mp_gpio_port_s {
+		/* common part */
+
+		/** port number */
+		unsigned int port;
+
+		/** pin number */
+		unsigned int pin;
+
+		/** who is the handler */
+		char *who;
+
+		/** pin used */
+		mp_bool_t used;
+
+		/** pin is interruptible */
+		char direction;
+
+		/** interrupt callback  */
+		mp_interrupt_cb_t callback;
+
+		/** callback user pointer */
+		void *user;
+
+		/* if YES then unset/set is reversed */
+		char reverse;
+
+		/* posix: emulated pin registers */
+		volatile unsigned char in;
+		volatile unsigned char out;
+		volatile unsigned char ie;
+		volatile unsigned char ies;
+		volatile unsigned char ifg;
+
+		/* posix: software interrupt vector, 0 when not interruptible */
+		unsigned char isr;
+	};
+
+	void mp_gpio_init();
+	void mp_gpio_fini();
+	mp_gpio_port_t *mp_gpio_handle(unsigned int port, unsigned int slot, char *who);
+	mp_gpio_port_t *mp_gpio_text_handle(char *text, char *who);
+	mp_ret_t mp_gpio_release(mp_gpio_port_t *port);
+	mp_ret_t mp_gpio_direction(mp_gpio_port_t *port, mp_gpio_direction_t direction);
+	mp_bool_t mp_gpio_read(mp_gpio_port_t *port);
+
+	void mp_gpio_set(mp_gpio_port_t *port);
+	void mp_gpio_unset(mp_gpio_port_t *port);
+	void mp_gpio_turn(mp_gpio_port_t *port);
+
+	mp_ret_t mp_gpio_interrupt_set(mp_gpio_port_t *port, mp_interrupt_cb_t in, void *user, char *who);
+	mp_ret_t mp_gpio_interrupt_unset(mp_gpio_port_t *port);
+
+	void mp_posix_gpio_input(mp_gpio_port_t *port, mp_bool_t level);
+	mp_bool_t mp_posix_gpio_output(mp_gpio_port_t *port);
+
+	static inline void mp_gpio_interrupt_enable(mp_gpio_port_t *port) {
+		port->ie = YES;
+	}
+
+	static inline void mp_gpio_interrupt_disable(mp_gpio_port_t *port) {
+		port->ie = NO;
+	}
+
+	static inline void mp_gpio_interrupt_lo2hi(mp_gpio_port_t *port) {
+		port->ies = NO;
+	}
+
+	static inline void mp_gpio_interrupt_hi2lo(mp_gpio_port_t *port) {
+		port->ies = YES;
+	}
+
+	static inline void mp_gpio_interrupt_hilo_switch(mp_gpio_port_t *port) {
+		port->ies ^= 1;
+	}
+
+#endif
@@ -0,0 +1,169 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _HAVE_POSIX_I2C_H
+	#define _HAVE_POSIX_I2C_H
+
+	typedef struct mp_i2c_s mp_i2c_t;
+	typedef struct mp_posix_i2c_device_s mp_posix_i2c_device_t;
+
+	typedef void (*mp_i2c_callback_t)(mp_i2c_t *);
+
+	/* flags are also the emulated IFG/IE bits */
+	typedef enum {
+		MP_I2C_FL_NACK = 0x20,
+		MP_I2C_FL_AL = 0x10,
+		MP_I2C_FL_STOP = 0x08,
+		MP_I2C_FL_START = 0x04,
+		MP_I2C_FL_TX = 0x02,
+		MP_I2C_FL_RX = 0x01,
+	} mp_i2c_flag_t;
+
+	typedef void (*mp_i2c_interrupt_t)(mp_i2c_t *i2c, mp_i2c_flag_t flag);
+
+	/** faults injected by mp_posix_i2c_fault() */
+	typedef enum {
+		MP_POSIX_I2C_FAULT_NONE,
+
+		/** the address is not acknowledged */
+		MP_POSIX_I2C_FAULT_NACK,
+
+		/** another master wins the arbitration */
+		MP_POSIX_I2C_FAULT_ARBITRATION,
+
+		/** the slave holds SDA low until mp_i2c_recover() */
+		MP_POSIX_I2C_FAULT_HOLD,
+	} mp_posix_i2c_fault_t;
+
+	struct mp_i2c_s {
+		mp_i2c_interrupt_t intDispatch;
+
+		/** internal: gate */
+		mp_gate_t *gate;
+		mp_gpio_port_t *sda;
+		mp_gpio_port_t *clk;
+
+		mp_list_item_t item;
+
+		void *user;
+
+		/* posix: emulated USCI_B state */
+		unsigned char slaveAddress;
+		unsigned char myAddress;
+		unsigned char transmitter;
+		unsigned char rxbuf;
+		mp_bool_t started;
+		mp_bool_t inflight;
+		mp_bool_t rxFull;
+		mp_bool_t stopRequest;
+		mp_posix_i2c_device_t *device;
+
+		/** SDA held low by a slave */
+		mp_bool_t held;
+	};
+
+	/**
+	 * @brief Simulated I2C slave
+	 *
+	 * A device is wired on a gate with mp_posix_i2c_attach() and is
+	 * selected by its address on each start condition. Callbacks
+	 * are executed in ISR context.
+	 */
+	struct mp_posix_i2c_device_s {
+		/** 7 bits slave address */
+		unsigned char address;
+
+		/** start condition, read is YES for a master receiver */
+		void (*onStart)(mp_posix_i2c_device_t *device, mp_bool_t read);
+
+		/** byte written by the master */
+		void (*onWrite)(mp_posix_i2c_device_t *device, unsigned char data);
+
+		/** byte read by the master */
+		unsigned char (*onRead)(mp_posix_i2c_device_t *device);
+
+		/** stop condition */
+		void (*onStop)(mp_posix_i2c_device_t *device);
+
+		void *user;
+
+		/** injected fault and the number of starts it hits */
+		mp_posix_i2c_fault_t fault;
+		unsigned int faultCount;
+
+		mp_list_item_t item;
+	};
+
+	mp_ret_t mp_i2c_init();
+	mp_ret_t mp_i2c_fini();
+	mp_ret_t mp_i2c_open(mp_kernel_t *kernel, mp_i2c_t *i2c, mp_options_t *options, char *who);
+	mp_ret_t mp_i2c_setup(mp_i2c_t *i2c, mp_options_t *options);
+	mp_ret_t mp_i2c_close(mp_i2c_t *i2c);
+
+	void mp_i2c_enable_rx(mp_i2c_t *i2c);
+	void mp_i2c_disable_rx(mp_i2c_t *i2c);
+	void mp_i2c_enable_tx(mp_i2c_t *i2c);
+	void mp_i2c_disable_tx(mp_i2c_t *i2c);
+	unsigned char mp_i2c_rx(mp_i2c_t *i2c);
+	void mp_i2c_tx(mp_i2c_t *i2c, unsigned char data);
+	void mp_i2c_txStop(mp_i2c_t *i2c);
+	void mp_i2c_txStart(mp_i2c_t *i2c);
+	void mp_i2c_enable_errors(mp_i2c_t *i2c);
+	void mp_i2c_disable_errors(mp_i2c_t *i2c);
+	void mp_i2c_reset(mp_i2c_t *i2c);
+	void mp_i2c_recover(mp_i2c_t *i2c);
+
+	mp_ret_t mp_posix_i2c_attach(char *gate, mp_posix_i2c_device_t *device);
+	void mp_posix_i2c_detach(char *gate, mp_posix_i2c_device_t *device);
+	void mp_posix_i2c_fault(mp_posix_i2c_device_t *device, mp_posix_i2c_fault_t fault, unsigned int count);
+
+	/* transfers complete synchronously on the host */
+	static inline void mp_i2c_waitRX(mp_i2c_t *i2c) { }
+	static inline void mp_i2c_waitTX(mp_i2c_t *i2c) { }
+	static inline void mp_i2c_waitStop(mp_i2c_t *i2c) { }
+	static inline void mp_i2c_waitStart(mp_i2c_t *i2c) { }
+	static inline void mp_i2c_txNACK(mp_i2c_t *i2c) { }
+
+	static inline void mp_i2c_clearFlags(mp_i2c_t *i2c) {
+		i2c->gate->ifg = 0;
+	}
+
+	static inline void mp_i2c_mode(mp_i2c_t *i2c, char mode)  {
+		i2c->transmitter = mode;
+	}
+
+	static inline void mp_i2c_setSlaveAddress(mp_i2c_t *i2c, unsigned short address) {
+		i2c->slaveAddress = address;
+	}
+
+	static inline unsigned char mp_i2c_getSlaveAddress(mp_i2c_t *i2c) {
+		return(i2c->slaveAddress);
+	}
+
+	static inline void mp_i2c_setMyAddress(mp_i2c_t *i2c, unsigned short address) {
+		i2c->myAddress = address;
+	}
+
+	static inline void mp_i2c_setInterruption(mp_i2c_t *i2c, mp_i2c_interrupt_t cb) {
+		i2c->intDispatch = cb;
+	}
+
+#endif
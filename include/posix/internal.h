@@ -0,0 +1,80 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**
+@defgroup mpArchPosix POSIX host
+
+@ingroup mpArch
+
+@brief Runs the kernel and the drivers as a Linux process
+
+@author @htmlonly &copy; @endhtmlonly 2016
+Michael Vergoz <mv@verman.fr>
+
+@date 17 Oct 2016
+
+The POSIX port implements the same architecture API than the MSP430 one
+so common/ and drivers/ compile unchanged for a host executable.
+
+@li interrupts are signals (SIGALRM for timers, SIGIO for file descriptors)
+and mp_interrupt_disable() blocks them, an ISR is a signal handler or a
+software vector raised while interrupts are enabled
+@li low power mode is sigsuspend()
+@li gates, GPIO, I2C and SPI are software stand-ins, the host attaches
+simulated devices to them
+@li UART gates are backed by a pseudo terminal or any file given with the
+"device" option
+
+*/
+
+#ifndef _HAVE_POSIX_INTERNAL_H
+	#define _HAVE_POSIX_INTERNAL_H
+
+	#define FLOAT_DIV(a, b) (float)((float)a/(float)b)
+
+	#include <stdint.h>
+	#include <stdbool.h>
+
+	#include "gate.h"
+	#include "interrupt.h"
+	#include "gpio.h"
+	#include "timer.h"
+	#include "clock.h"
+	#include "i2c.h"
+	#include "dma.h"
+	#include "uart.h"
+	#include "spi.h"
+
+	typedef struct mp_arch_posix_s mp_arch_posix_t;
+
+	struct mp_arch_posix_s {
+		mp_clock_sched_t scheduler;
+	};
+
+	mp_ret_t mp_machine_init(mp_kernel_t *kernel);
+	mp_ret_t mp_machine_fini(mp_kernel_t *kernel);
+	void mp_machine_state_set(mp_kernel_t *kernel);
+	void mp_machine_state_unset(mp_kernel_t *kernel);
+
+	void mp_posix_quit(void);
+	mp_bool_t mp_posix_quitting(void);
+
+#endif
@@ -0,0 +1,77 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _HAVE_POSIX_INTERRUPT_H
+	#define _HAVE_POSIX_INTERRUPT_H
+
+	typedef void (*mp_interrupt_cb_t)(void *user);
+
+	typedef struct mp_interrupt_s mp_interrupt_t;
+
+	struct mp_interrupt_s {
+		mp_interrupt_cb_t callback;
+
+		void *user;
+
+		char *who;
+
+	};
+
+	/* software vectors, lower number is served first */
+	#define POSIX_TIMER_A0_VECTOR 0
+	#define POSIX_TIMER_A1_VECTOR 1
+	#define POSIX_TIMER_B0_VECTOR 2
+	#define POSIX_PORT1_VECTOR    3
+	#define POSIX_PORT2_VECTOR    4
+	#define POSIX_USCI_A0_VECTOR  5
+	#define POSIX_USCI_A1_VECTOR  6
+	#define POSIX_USCI_A2_VECTOR  7
+	#define POSIX_USCI_A3_VECTOR  8
+	#define POSIX_USCI_B0_VECTOR  9
+	#define POSIX_USCI_B1_VECTOR  10
+	#define POSIX_USCI_B2_VECTOR  11
+	#define POSIX_USCI_B3_VECTOR  12
+	#define POSIX_DMA_VECTOR      13
+
+	#define POSIX_MAX_VECTORS     14
+
+	mp_ret_t mp_interrupt_init();
+	mp_ret_t mp_interrupt_fini();
+	mp_interrupt_t *mp_interrupt_set(int vector, mp_interrupt_cb_t in, void *user, char *who);
+	mp_ret_t mp_interrupt_unset(int vector);
+
+	void mp_interrupt_enable();
+	void mp_interrupt_disable();
+	mp_bool_t mp_interrupt_state();
+	void mp_interrupt_restore(mp_bool_t state);
+	void mp_interrupt_lpm_exit();
+
+	void mp_posix_interrupt_raise(int vector);
+	void mp_posix_interrupt_io(int vector, mp_bool_t watch);
+	void mp_posix_interrupt_wait(void);
+	void mp_posix_interrupt_signal(int vector);
+	unsigned long mp_posix_interrupt_served(int vector);
+
+	#define MP_INTERRUPT_SAFE_BEGIN { mp_bool_t _____state = mp_interrupt_state(); \
+		mp_interrupt_disable();
+
+	#define MP_INTERRUPT_SAFE_END mp_interrupt_restore(_____state); }
+#endif
@@ -0,0 +1,141 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _HAVE_POSIX_SPI_H
+	#define _HAVE_POSIX_SPI_H
+
+	typedef struct mp_spi_s mp_spi_t;
+	typedef struct mp_posix_spi_device_s mp_posix_spi_device_t;
+
+	/* values are also the emulated IFG/IE bits */
+	typedef enum {
+		MP_SPI_IV_TX = 0x02,
+		MP_SPI_IV_RX = 0x01,
+	} mp_spi_iv_t;
+
+	typedef void (*mp_spi_interrupt_t)(mp_spi_t *spi, mp_spi_iv_t iv);
+
+	struct mp_spi_s {
+
+		/** SPI frequency */
+		unsigned long frequency;
+
+		/** internal: gate */
+		mp_gate_t *gate;
+		mp_gpio_port_t *simo;
+		mp_gpio_port_t *somi;
+		mp_gpio_port_t *clk;
+		mp_list_item_t item;
+
+		mp_spi_interrupt_t intDispatch;
+		void *user;
+
+		mp_task_t *task;
+
+		unsigned char ie;
+
+		/* posix: emulated receive buffer */
+		unsigned char rxbuf;
+	};
+
+	/**
+	 * @brief Simulated SPI slave
+	 *
+	 * A device is wired on a gate with mp_posix_spi_attach(). When
+	 * select is set the device only answers while the pin is driven low.
+	 * The callback is executed in ISR context.
+	 */
+	struct mp_posix_spi_device_s {
+		/** chip select, NULL when always selected */
+		mp_gpio_port_t *select;
+
+		/** full duplex byte exchange */
+		unsigned char (*onExchange)(mp_posix_spi_device_t *device, unsigned char data);
+
+		void *user;
+
+		mp_list_item_t item;
+	};
+
+	void mp_spi_init();
+	void mp_spi_fini();
+	mp_ret_t mp_spi_open(
+		mp_kernel_t *kernel,
+		mp_spi_t *spi,
+		mp_options_t *options,
+		char *who
+	);
+	mp_ret_t mp_spi_setup(mp_spi_t *spi, mp_options_t *options);
+	mp_ret_t mp_spi_close(mp_spi_t *spi);
+
+	unsigned char mp_spi_rx(mp_spi_t *spi);
+	void mp_spi_tx(mp_spi_t *spi, unsigned char data);
+
+	mp_ret_t mp_posix_spi_attach(char *gate, mp_posix_spi_device_t *device);
+	void mp_posix_spi_detach(char *gate, mp_posix_spi_device_t *device);
+
+	static inline void mp_spi_enable_rx(mp_spi_t *spi) {
+		spi->gate->ie |= MP_SPI_IV_RX;
+		spi->ie |= MP_SPI_IV_RX;
+		mp_posix_gate_update(spi->gate);
+	}
+
+	static inline void mp_spi_disable_rx(mp_spi_t *spi) {
+		spi->gate->ie &= ~MP_SPI_IV_RX;
+		spi->ie &= ~MP_SPI_IV_RX;
+	}
+
+	static inline void mp_spi_enable_tx(mp_spi_t *spi) {
+		spi->gate->ie |= MP_SPI_IV_TX;
+		spi->ie |= MP_SPI_IV_TX;
+		mp_posix_gate_update(spi->gate);
+	}
+
+	static inline void mp_spi_disable_tx(mp_spi_t *spi) {
+		spi->gate->ie &= ~MP_SPI_IV_TX;
+		spi->ie &= ~MP_SPI_IV_TX;
+	}
+
+	static inline void mp_spi_enable_both(mp_spi_t *spi) {
+		spi->gate->ie |= MP_SPI_IV_TX | MP_SPI_IV_RX;
+		spi->ie |= MP_SPI_IV_TX | MP_SPI_IV_RX;
+		mp_posix_gate_update(spi->gate);
+	}
+
+	static inline void mp_spi_disable_both(mp_spi_t *spi) {
+		spi->gate->ie &= ~(MP_SPI_IV_TX | MP_SPI_IV_RX);
+		spi->ie &= ~(MP_SPI_IV_TX | MP_SPI_IV_RX);
+	}
+
+	static inline void mp_spi_disable_store(mp_spi_t *spi) {
+		spi->gate->ie &= ~(MP_SPI_IV_TX | MP_SPI_IV_RX);
+	}
+
+	static inline void mp_spi_disable_restore(mp_spi_t *spi) {
+		spi->gate->ie = spi->ie;
+		mp_posix_gate_update(spi->gate);
+	}
+
+	static inline void mp_spi_setInterruption(mp_spi_t *spi, mp_spi_interrupt_t cb) {
+		spi->intDispatch = cb;
+	}
+
+#endif
@@ -0,0 +1,77 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _HAVE_POSIX_TIMER_H
+	#define _HAVE_POSIX_TIMER_H
+
+	#include <time.h>
+
+	typedef struct mp_timer_s mp_timer_t;
+
+	typedef void (*mp_timer_interrupt_t)(mp_timer_t *timer);
+
+	struct mp_timer_s {
+		/** Related kernel information */
+		mp_kernel_t *kernel;
+
+		/** Who own the timer */
+		char *who;
+
+		/** Timer frequency, 0 in continuous mode */
+		unsigned long frequency;
+
+		/** Embedded user pointer */
+		void *user;
+
+		/** Associated gate */
+		mp_gate_t *gate;
+
+		mp_timer_interrupt_t isr;
+
+		/** posix: interrupt enabled */
+		volatile mp_bool_t enabled;
+
+		/** posix: kernel timer delivering SIGALRM */
+		timer_t id;
+
+		/** posix: expirations merged in the last signal */
+		volatile int overrun;
+	};
+
+	mp_ret_t mp_timer_init(mp_kernel_t *kernel);
+	void mp_timer_fini(mp_kernel_t *kernel);
+
+	mp_ret_t mp_timer_create(mp_kernel_t *kernel, mp_timer_t *timer, mp_options_t *options, char *who);
+	void mp_timer_destroy(mp_timer_t *timer);
+
+	mp_ret_t mp_timer_set_interrupt(mp_timer_t *timer, mp_timer_interrupt_t isr);
+	mp_ret_t mp_timer_unset_interrupt(mp_timer_t *timer);
+
+	void mp_posix_timer_oneshot(mp_timer_t *timer, unsigned long usec);
+
+	static inline void mp_timer_enable_interrupt(mp_timer_t *timer) {
+		timer->enabled = YES;
+	}
+
+	static inline void mp_timer_disable_interrupt(mp_timer_t *timer) {
+		timer->enabled = NO;
+	}
+#endif
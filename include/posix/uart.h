@@ -0,0 +1,147 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _HAVE_POSIX_UART_H
+	#define _HAVE_POSIX_UART_H
+
+	#ifndef POSIX_UART_RX_SIZE
+		#define POSIX_UART_RX_SIZE 64
+	#endif
+
+	#ifndef POSIX_UART_TX_SIZE
+		#define POSIX_UART_TX_SIZE 64
+	#endif
+
+	/* emulated IFG/IE bits */
+	#define POSIX_UART_RX 0x01
+	#define POSIX_UART_TX 0x02
+
+	typedef struct mp_uart_s mp_uart_t;
+
+	typedef void (*mp_uart_on_t)(mp_uart_t *uart);
+
+	struct mp_uart_s {
+		/** Kernel handler */
+		mp_kernel_t *kernel;
+
+		/** Baud rate */
+		unsigned long baudRate;
+
+		mp_uart_on_t onWrite;
+		mp_uart_on_t onRead;
+		void *user;
+
+		/** internal: UART gate */
+		mp_gate_t *gate;
+
+		/** internal: rxd_port */
+		mp_gpio_port_t *rxd_port;
+
+		/** internal: txd_port */
+		mp_gpio_port_t *txd_port;
+
+		/** DMA channels, opened with the dmaTx and dmaRx options */
+		mp_dma_t dmaTx;
+		mp_dma_t dmaRx;
+
+		/** end of a DMA transmit block */
+		mp_uart_on_t onDmaTx;
+
+		/** end of a DMA receive lap, the channel restarts at the beginning */
+		mp_uart_on_t onDmaRx;
+
+		/** internal: DMA trigger sources of the gate */
+		unsigned char dmaTxTrigger;
+		unsigned char dmaRxTrigger;
+
+		/** internal: DMA receive storage size */
+		unsigned int dmaRxSize;
+
+		/** posix: backing file descriptor */
+		int fd;
+
+		/** posix: bytes read but not yet taken by mp_uart_rx() */
+		unsigned char rx[POSIX_UART_RX_SIZE];
+		unsigned int rxHead;
+		unsigned int rxTail;
+
+		/** posix: bytes dropped because the peer does not read */
+		unsigned long txDropped;
+
+		/** posix: bytes shifted out, written at the end of the ISR */
+		unsigned char tx[POSIX_UART_TX_SIZE];
+		unsigned int txLength;
+
+		/** posix: serving the gate vector */
+		mp_bool_t inside;
+
+		/** posix: emulated TXBUF and RXBUF, DMA side */
+		volatile unsigned char txbuf;
+		volatile unsigned char rxbuf;
+	};
+
+	mp_ret_t mp_uart_init();
+	mp_ret_t mp_uart_fini();
+	mp_ret_t mp_uart_open(mp_kernel_t *kernel, mp_uart_t *uart, mp_options_t *options, char *who);
+	mp_ret_t mp_uart_setup(mp_uart_t *uart, mp_options_t *options);
+	mp_ret_t mp_uart_close(mp_uart_t *uart);
+
+	void mp_uart_tx(mp_uart_t *uart, unsigned char data);
+	unsigned char mp_uart_rx(mp_uart_t *uart);
+
+	mp_ret_t mp_uart_dma_tx(mp_uart_t *uart, unsigned char *data, unsigned int size);
+	mp_ret_t mp_uart_dma_rx(mp_uart_t *uart, unsigned char *buffer, unsigned int size);
+	unsigned int mp_uart_dma_rx_count(mp_uart_t *uart);
+	void mp_uart_dma_stop(mp_uart_t *uart);
+
+	static inline char mp_uart_isBusy(mp_uart_t *uart) {
+		return(0);
+	}
+
+	static inline char mp_uart_hasOverrun(mp_uart_t *uart) {
+		return(0);
+	}
+
+	static inline void mp_uart_enable_rx(mp_uart_t *uart) { }
+
+	static inline void mp_uart_disable_rx(mp_uart_t *uart) { }
+
+	static inline void mp_uart_enable_tx_int(mp_uart_t *uart) {
+		/* TXBUF is empty as soon as a byte is written */
+		uart->gate->ifg |= POSIX_UART_TX;
+		uart->gate->ie |= POSIX_UART_TX;
+		mp_posix_gate_update(uart->gate);
+	}
+
+	static inline void mp_uart_disable_tx_int(mp_uart_t *uart) {
+		uart->gate->ie &= ~POSIX_UART_TX;
+	}
+
+	static inline void mp_uart_enable_rx_int(mp_uart_t *uart) {
+		uart->gate->ie |= POSIX_UART_RX;
+		mp_posix_gate_update(uart->gate);
+	}
+
+	static inline void mp_uart_disable_rx_int(mp_uart_t *uart) {
+		uart->gate->ie &= ~POSIX_UART_RX;
+	}
+
+#endif
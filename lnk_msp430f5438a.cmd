@@ -151,6 +151,9 @@ SECTIONS
 
 	.patch     : {} > FLASH
 
+    /* mp_log() format strings, kept into the image for tools/log2text */
+    mp_log      : {} > FLASH, type = COPY, START(__start_mp_log)
+
     .infoA     : {} > INFOA              /* MSP430 INFO FLASH Memory segments */
     .infoB     : {} > INFOB
     .infoC     : {} > INFOC
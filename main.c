@@ -72,6 +72,10 @@ struct olimex_msp430_s {
 
 	mp_serial_t serial;
 
+	/** sensors share USCI_B3 */
+	mp_i2c_t sensorsI2C;
+	mp_regMaster_bus_t sensors;
+
 	//mp_drv_TMP006_t tmp006;
 //	mp_drv_MPL3115A2_t bat;
 
@@ -88,6 +92,9 @@ struct olimex_msp430_s {
 
 	mp_drv_led_t systemRed;
 	mp_drv_led_t systemGreen;
+
+	mp_pinout_t greenBlink;
+	mp_pinout_t systemBlink;
 };
 
 static void __olimex_onBoot(void *user);
@@ -314,6 +321,37 @@ static void __olimex_state_op_set(void *user) {
 		1000, 2, __olimex_on_button_power, olimex
 	);
 
+	/*
+	 * Shared I2C bus for the sensors below
+	 * gate = USCI_B3
+	 * SDA = 10.1 / ext 1-17
+	 * SCL = 10.2 / ext 1-16
+	 *
+	 * Drivers given this gate join the bus instead of opening it
+	 */
+	{
+		mp_options_t options[] = {
+			{ "gate", "USCI_B3" },
+			{ "sda", "p10.1" },
+			{ "clk", "p10.2" },
+			{ NULL, NULL }
+		};
+		mp_options_t setup[] = {
+			{ "frequency", "400000" },
+			{ "role", "master" },
+			{ NULL, NULL }
+		};
+
+		ret = mp_i2c_open(&olimex->kernel, &olimex->sensorsI2C, options, "Sensors I2C");
+		if(ret == TRUE)
+			ret = mp_i2c_setup(&olimex->sensorsI2C, setup);
+		if(ret == TRUE) {
+			ret = mp_regMaster_bus_init_i2c(&olimex->kernel, &olimex->sensors, &olimex->sensorsI2C, "Sensors bus");
+			if(ret == FALSE)
+				mp_i2c_close(&olimex->sensorsI2C);
+		}
+	}
+
 	/*
 	 * Configuration for TMP006 example
 	 * gate = USCI_B3
@@ -450,8 +488,8 @@ static void __olimex_state_op_set(void *user) {
 	}
 */
 	/* pinout */
-	mp_pinout_onoff(&olimex->kernel, olimex->green_led.gpio, ON, 10, 1010, 0, "Blinking green - Power ON");
-	mp_pinout_onoff(&olimex->kernel, olimex->systemGreen.gpio, ON, 20, 500, 0, "Test");
+	mp_pinout_onoff(&olimex->kernel, &olimex->greenBlink, olimex->green_led.gpio, ON, 10, 1010, 0, "Blinking green - Power ON");
+	mp_pinout_onoff(&olimex->kernel, &olimex->systemBlink, olimex->systemGreen.gpio, ON, 20, 500, 0, "Test");
 
 	mp_printk("miniPhi - version %s", olimex->kernel.version);
 
@@ -480,6 +518,16 @@ static void __olimex_state_op_unset(void *user) {
 
 	//mp_serial_fini(&olimex->uart_usb_rs232);
 
+	mp_pinout_stop(&olimex->greenBlink);
+	mp_pinout_stop(&olimex->systemBlink);
+
+	/* sensors leave their bus then it goes */
+	mp_drv_INA219_fini(&olimex->ina219);
+	if(mp_regMaster_bus_handle("USCI_B3") == &olimex->sensors) {
+		mp_regMaster_bus_fini(&olimex->sensors);
+		mp_i2c_close(&olimex->sensorsI2C);
+	}
+
 	mp_drv_led_fini(&olimex->red_led);
 	mp_drv_led_fini(&olimex->green_led);
 
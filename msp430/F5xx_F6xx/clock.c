@@ -60,6 +60,26 @@ static void _set_timer(mp_kernel_t *kernel);
 #pragma DATA_SECTION(__ticks, ".sysmem")
 static unsigned long __ticks;
 
+#ifdef MP_CLOCK_TICKLESS
+	/*
+	 * TA1 runs continuous on ACLK and ticks are computed from the counter.
+	 * One tick is 32768/1000 counts, that is 4096/125 : the remainder is
+	 * kept in 1/4096 of tick so the clock does not drift.
+	 */
+	#define _TICKLESS_GUARD 32768 /* counts between two forced updates (1s) */
+	#define _TICKLESS_MAX_WAIT 1000 /* longest programmed sleep in ticks */
+
+	static mp_timer_t *__tickTimer;
+	static unsigned int __tickCounter;
+	static unsigned int __tickRemain;
+	static unsigned long __tickHires;
+
+	static void _tickless_update(void);
+	static unsigned int _tickless_counter(void);
+#else
+	static mp_kernel_t *__kernel;
+#endif
+
 static const mp_clock_freq_settings_t _mp_clock_freq_settings[] = {
 	{MHZ1_t, DCORSEL_2, _VCORE_1MHZ, 30},  /* MHZ1_t. */
 	{MHZ4_t, DCORSEL_4, _VCORE_4MHZ, 122}, /* MHZ4_t. */
@@ -190,11 +210,74 @@ mp_ret_t mp_clock_high_energy(mp_kernel_t *kernel) {
 	return(TRUE);
 }
 
+#ifdef MP_CLOCK_TICKLESS
+void mp_clock_schedule(mp_kernel_t *kernel) {
+	mp_clock_sched_t *sched = &kernel->msp430.scheduler;
+	unsigned long wait;
+	unsigned long timers;
+	unsigned int counts;
+
+	mp_interrupt_disable();
+
+	_tickless_update();
+
+	/* something to do now */
+	wait = mp_task_next_wakeup(&kernel->tasks, __ticks);
+	timers = mp_ktimer_next_wakeup(kernel, __ticks);
+	if(timers < wait)
+		wait = timers;
+	if(wait == 0 || mp_softirq_pending(kernel) == YES) {
+		mp_interrupt_enable();
+		DEBUG_LED_SWITCH;
+		return;
+	}
+
+	/* longer sleeps are cut by the guard compare */
+	if(wait < _TICKLESS_MAX_WAIT) {
+		counts = ((wait<<12)-__tickRemain+124)/125;
+		*__tickTimer->regCCR0 = __tickCounter+counts;
+
+		/* deadline passed while programming the compare */
+		if(_tickless_counter()-__tickCounter >= counts) {
+			*__tickTimer->regCCR0 = __tickCounter+_TICKLESS_GUARD;
+			mp_interrupt_enable();
+			return;
+		}
+	}
+
+	DEBUG_LED_OFF;
+
+	sched->schedulerOff = TRUE;
+
+	MP_TRACE_EVENT(MP_TRACE_LPM_ENTER, 3, 0);
+
+	/* wake up on the compare or when an ISR makes a task ready */
+	_BIS_SR(LPM3_bits + GIE);
+
+	MP_TRACE_EVENT(MP_TRACE_LPM_EXIT, 3, 0);
+
+	sched->schedulerOff = FALSE;
+
+	mp_interrupt_enable();
+}
+#else
 void mp_clock_schedule(mp_kernel_t *kernel) {
 	mp_clock_sched_t *sched = &kernel->msp430.scheduler;
+	unsigned long timers;
 
 	if(sched->longestDelay > 0 || kernel->tasks.usedNumber == kernel->tasks.sleepNumber) {
-		if(kernel->tasks.pendingNumber == 0) {
+		if(kernel->tasks.pendingNumber == 0 && mp_softirq_pending(kernel) == NO) {
+
+			MP_INTERRUPT_SAFE_BEGIN
+			timers = mp_ktimer_next_wakeup(kernel, mp_clock_ticks());
+			MP_INTERRUPT_SAFE_END
+
+			/* a software timer is due, do not sleep */
+			if(timers == 0) {
+				sched->longestDelay = 0;
+				sched->shortestDelay = ~(sched->longestDelay)-1;
+				return;
+			}
 
 			DEBUG_LED_OFF;
 
@@ -203,11 +286,20 @@ void mp_clock_schedule(mp_kernel_t *kernel) {
 			if(sched->longestDelay == 0)
 				sched->currentWait = mp_clock_get_speed()/MSP430_TICK_RATE_HZ/100;
 
+			/* wake up for the next software timer */
+			if(timers < sched->currentWait)
+				sched->currentWait = timers;
+
 			sched->schedulerOff = TRUE;
 
+			MP_TRACE_EVENT(MP_TRACE_LPM_ENTER, 3, 0);
+
 			_BIS_SR(LPM3_bits + GIE);
 
-			while(sched->currentWait-1 > 0 && kernel->tasks.pendingNumber == 0)
+			MP_TRACE_EVENT(MP_TRACE_LPM_EXIT, 3, 0);
+
+			while(sched->currentWait-1 > 0 && kernel->tasks.pendingNumber == 0 &&
+					mp_softirq_pending(kernel) == NO)
 				__delay_cycles(1);
 
 
@@ -224,11 +316,21 @@ void mp_clock_schedule(mp_kernel_t *kernel) {
 
 	DEBUG_LED_SWITCH;
 }
+#endif
 
 void mp_clock_task_change(mp_task_t *task) {
 	mp_kernel_t *kernel = task->handler->kernel;
 	mp_clock_sched_t *sched = &kernel->msp430.scheduler;
 
+#ifdef MP_CLOCK_TICKLESS
+	/* deadlines come from the task heap, only wake up on events */
+	if(task->signal == MP_TASK_SIG_PENDING || task->signal == MP_TASK_SIG_STOP) {
+		if(sched->schedulerOff == TRUE)
+			mp_interrupt_lpm_exit();
+	}
+	return;
+#endif
+
 	switch(task->signal) {
 		case MP_TASK_SIG_SLEEP:
 		case MP_TASK_SIG_OK:
@@ -252,13 +354,97 @@ void mp_clock_task_change(mp_task_t *task) {
 
 
 unsigned long mp_clock_ticks() {
+#ifdef MP_CLOCK_TICKLESS
+	unsigned long ticks;
+
+	/* timer not yet running */
+	if(__tickTimer == NULL)
+		return(__ticks);
+
+	MP_INTERRUPT_SAFE_BEGIN
+	_tickless_update();
+	ticks = __ticks;
+	MP_INTERRUPT_SAFE_END
+
+	return(ticks);
+#else
 	return(__ticks);
+#endif
 }
 
+/**
+ * @brief High resolution time
+ *
+ * Time in ACLK counts (@ref MP_CLOCK_HIRES_HZ) taken from the tick timer,
+ * it keeps running in LPM3
+ *
+ * @return Actual time
+ */
+unsigned long mp_clock_hires() {
+	unsigned long hires;
+#ifdef MP_CLOCK_TICKLESS
+	/* timer not yet running */
+	if(__tickTimer == NULL)
+		return(0);
+
+	MP_INTERRUPT_SAFE_BEGIN
+	_tickless_update();
+	hires = __tickHires;
+	MP_INTERRUPT_SAFE_END
+#else
+	mp_timer_t *timer;
+	unsigned long ticks;
+	unsigned int counter;
+
+	/* timer not yet running */
+	if(__kernel == NULL)
+		return(0);
+	timer = &__kernel->tickTimer;
+
+	MP_INTERRUPT_SAFE_BEGIN
+	counter = *timer->regR;
+	ticks = __ticks;
+
+	/* the counter rolled over but the ISR did not run yet */
+	if(*timer->regCCTL0 & CCIFG) {
+		counter = *timer->regR;
+		ticks++;
+	}
+
+	hires = ticks*(*timer->regCCR0+1)+counter;
+	MP_INTERRUPT_SAFE_END
+#endif
+	return(hires);
+}
+
+/**
+ * @brief Convert a high resolution duration to milliseconds
+ *
+ * The conversion is split so it fits into 32 bits
+ *
+ * @param[in] hires Duration in @ref MP_CLOCK_HIRES_HZ counts
+ * @return Milliseconds
+ */
+unsigned long mp_clock_hires_ms(unsigned long hires) {
+	return((hires/MP_CLOCK_HIRES_HZ)*1000+((hires%MP_CLOCK_HIRES_HZ)*1000)/MP_CLOCK_HIRES_HZ);
+}
+
+/**
+ * @brief Convert a high resolution duration to microseconds
+ *
+ * The conversion is split so it fits into 32 bits
+ *
+ * @param[in] hires Duration in @ref MP_CLOCK_HIRES_HZ counts
+ * @return Microseconds
+ */
+unsigned long mp_clock_hires_us(unsigned long hires) {
+	unsigned long rem = (hires%MP_CLOCK_HIRES_HZ)*1000;
+	return(mp_clock_hires_ms(hires)*1000+((rem%MP_CLOCK_HIRES_HZ)*1000)/MP_CLOCK_HIRES_HZ);
+}
 
 void mp_clock_delay(int delay) {
-	unsigned long local = __ticks+delay;
-	while(__ticks < local);
+	unsigned long local = mp_clock_ticks()+delay;
+	while(mp_clock_ticks() < local);
 }
 
 void mp_clock_nanoDelay(unsigned long delay) {
@@ -505,6 +691,58 @@ static void __start_crystal(void) {
 }
 
 
+#ifdef MP_CLOCK_TICKLESS
+/* read TA1R twice as it is clocked by ACLK asynchronously to MCLK */
+static unsigned int _tickless_counter(void) {
+	unsigned int a, b;
+
+	do {
+		a = *__tickTimer->regR;
+		b = *__tickTimer->regR;
+	} while(a != b);
+
+	return(a);
+}
+
+/* must be called with interrupts disabled */
+static void _tickless_update(void) {
+	unsigned int counter = _tickless_counter();
+	unsigned long scaled;
+
+	scaled = (unsigned long)(unsigned int)(counter-__tickCounter)*125+__tickRemain;
+
+	__tickHires += (unsigned int)(counter-__tickCounter);
+	__ticks += scaled>>12;
+	__tickRemain = scaled&0xfff;
+	__tickCounter = counter;
+}
+
+static void _mp_clock_tickless_timer(mp_timer_t *timer) {
+	_tickless_update();
+
+	/* never let the counter wrap between two updates */
+	*timer->regCCR0 = __tickCounter+_TICKLESS_GUARD;
+}
+
+static void _set_timer(mp_kernel_t *kernel) {
+	mp_options_t options[] = {
+		{ "gate", "TIMER_A1" },
+		{ "frequency", "32768" },
+		{ "mode", "cont" },
+		{ NULL, NULL }
+	};
+	__ticks = 0;
+	__tickRemain = 0;
+	__tickCounter = 0;
+	__tickHires = 0;
+	if(mp_timer_create(kernel, &kernel->tickTimer, options, "MSP430 Timer") == FALSE)
+		return;
+	*kernel->tickTimer.regCCR0 = _TICKLESS_GUARD;
+	__tickTimer = &kernel->tickTimer;
+	mp_timer_set_interrupt(&kernel->tickTimer, _mp_clock_tickless_timer);
+	mp_timer_enable_interrupt(&kernel->tickTimer);
+}
+#else
 void _mp_clock_system_timer(mp_timer_t *timer) {
 	mp_clock_sched_t *sched = &timer->kernel->msp430.scheduler;
 
@@ -533,9 +771,11 @@ static void _set_timer(mp_kernel_t *kernel) {
 	};
 	__ticks = 0;
 	mp_timer_create(kernel, &kernel->tickTimer, options, "MSP430 Timer");
+	__kernel = kernel;
 	mp_timer_set_interrupt(&kernel->tickTimer, _mp_clock_system_timer);
 	mp_timer_enable_interrupt(&kernel->tickTimer);
 }
+#endif
 
 /* disable Watchdog at pre init in order to use correctly eabi */
 int _system_pre_init(void) {
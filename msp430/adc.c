@@ -329,10 +329,13 @@ void __attribute__ ((interrupt(ADC12_VECTOR))) ADC12ISR (void)
 				break;
 			adc->result = ADC12MEM0;
 
-			mp_task_signal(adc->task, MP_TASK_SIG_PENDING);
+			mp_softirq_signal(adc->task, MP_TASK_SIG_PENDING);
 
 			adc->state = 2;
 			ADC12IFG = 0;
+
+			/* not dispatched by mp_interrupt, leave LPM here */
+			LPM3_EXIT;
 			break;
 		default: break;
 	}
@@ -0,0 +1,178 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <mp.h>
+
+static void _mp_dma_interrupt(void *user);
+
+static mp_dma_t *__dma[MP_DMA_CHANNELS];
+
+/**
+@defgroup mpArchTiMSP430DMA DMA controller
+
+@ingroup mpArchTiMSP430
+
+@brief Byte transfers between memory and peripherals
+
+@author @htmlonly &copy; @endhtmlonly 2016
+Michael Vergoz <mv@verman.fr>
+
+@date 09 May 2016
+
+A channel moves one byte at each edge of its trigger (the IFG of a
+peripheral), the CPU is only interrupted when the whole block is done.
+With MP_DMA_REPEAT the channel reloads its addresses and size at the
+end of the block and goes on, which gives a circular receive buffer.
+
+Addresses are written as 16 bits words, memory given to a channel
+must stay below 64K (small data model).
+
+@{
+*/
+
+mp_ret_t mp_dma_init() {
+	memset(__dma, 0, sizeof(__dma));
+
+	/* let the CPU finish its read-modify-write instructions */
+	DMACTL4 = DMARMWDIS;
+
+	mp_interrupt_set(DMA_VECTOR, _mp_dma_interrupt, NULL, "DMA");
+
+	return(TRUE);
+}
+
+mp_ret_t mp_dma_fini() {
+	int a;
+
+	for(a=0; a<MP_DMA_CHANNELS; a++)
+		_DMA_REG16(a, _DMA_CTL) = 0;
+
+	mp_interrupt_unset(DMA_VECTOR);
+
+	return(TRUE);
+}
+
+/**
+ * @brief Take a DMA channel
+ *
+ * @param[in] dma Channel context
+ * @param[in] channel Channel number as text, "0" to "2"
+ * @param[in] who Name
+ * @return TRUE or FALSE
+ */
+mp_ret_t mp_dma_open(mp_dma_t *dma, char *channel, char *who) {
+	int number = atoi(channel);
+
+	memset(dma, 0, sizeof(*dma));
+
+	if(number < 0 || number >= MP_DMA_CHANNELS || __dma[number] != NULL) {
+		mp_printk("DMA - Can not handle channel %s for %s", channel, who);
+		return(FALSE);
+	}
+
+	dma->channel = number;
+	dma->who = who;
+	dma->opened = YES;
+
+	_DMA_REG16(number, _DMA_CTL) = 0;
+	__dma[number] = dma;
+
+	return(TRUE);
+}
+
+mp_ret_t mp_dma_close(mp_dma_t *dma) {
+	if(dma->opened != YES)
+		return(FALSE);
+
+	mp_dma_stop(dma);
+	__dma[dma->channel] = NULL;
+	dma->opened = NO;
+
+	return(TRUE);
+}
+
+/**
+ * @brief Program and enable a byte transfer
+ *
+ * @param[in] dma Channel
+ * @param[in] trigger Trigger source, MP_DMA_TRIGGER_*
+ * @param[in] flags MP_DMA_SRC_INCR, MP_DMA_DST_INCR, MP_DMA_REPEAT
+ * @param[in] src Source address
+ * @param[in] dst Destination address
+ * @param[in] size Number of bytes, at least 1
+ */
+void mp_dma_start(mp_dma_t *dma, unsigned char trigger, unsigned char flags,
+		volatile void *src, volatile void *dst, unsigned int size) {
+	unsigned int ctl = DMASRCBYTE | DMADSTBYTE | DMAIE;
+
+	if(flags & MP_DMA_SRC_INCR)
+		ctl |= DMASRCINCR_3;
+	if(flags & MP_DMA_DST_INCR)
+		ctl |= DMADSTINCR_3;
+	if(flags & MP_DMA_REPEAT)
+		ctl |= DMADT_4;
+
+	/* no critical section, it is also called from ISRs */
+	_DMA_REG16(dma->channel, _DMA_CTL) = 0;
+	_DMA_TSEL(dma->channel) = trigger;
+	_DMA_REG16(dma->channel, _DMA_SA) = (unsigned int)src;
+	_DMA_REG16(dma->channel, _DMA_DA) = (unsigned int)dst;
+	_DMA_REG16(dma->channel, _DMA_SZ) = size;
+	_DMA_REG16(dma->channel, _DMA_CTL) = ctl | DMAEN;
+}
+
+void mp_dma_stop(mp_dma_t *dma) {
+	_DMA_REG16(dma->channel, _DMA_CTL) &= ~(DMAEN | DMAIE | DMAIFG);
+}
+
+/**
+ * @brief Bytes left before the end of the current block
+ *
+ * @param[in] dma Channel
+ * @return Size register, reloaded at the end of a repeated block
+ */
+unsigned int mp_dma_remaining(mp_dma_t *dma) {
+	return(_DMA_REG16(dma->channel, _DMA_SZ));
+}
+
+/**
+ * @brief A block is done but its interrupt has not been served yet
+ *
+ * @param[in] dma Channel
+ * @return YES or NO
+ */
+mp_bool_t mp_dma_pending(mp_dma_t *dma) {
+	return(_DMA_REG16(dma->channel, _DMA_CTL) & DMAIFG ? YES : NO);
+}
+
+/**@}*/
+
+static void _mp_dma_interrupt(void *user) {
+	unsigned int iv;
+	mp_dma_t *dma;
+
+	/* reading DMAIV clears the highest pending flag */
+	while((iv = DMAIV) != 0) {
+		dma = __dma[(iv>>1)-1];
+		if(dma && dma->onDone)
+			dma->onDone(dma);
+	}
+}
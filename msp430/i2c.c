@@ -21,6 +21,10 @@
 #include "mp.h"
 
 static void mp_i2c_interruptDispatch(void *user);
+static void _mp_i2c_halfBit();
+
+/* half SCL period of the recovery, 5 us up to 25 MHz */
+#define _RECOVER_HALF_CYCLES 125
 
 /* internal pointers */
 static mp_list_t __i2c;
@@ -172,6 +176,83 @@ mp_ret_t mp_i2c_close(mp_i2c_t *i2c) {
 	return(TRUE);
 }
 
+/**
+ * @brief Reset the USCI in master mode
+ *
+ * An arbitration lost leaves the USCI in slave mode. UCSWRST
+ * clears the flags and the interrupt enables.
+ *
+ * @param[in] i2c I2C context
+ */
+void mp_i2c_reset(mp_i2c_t *i2c) {
+	MP_INTERRUPT_SAFE_BEGIN
+
+	_I2C_REG8(i2c->gate, _I2C_CTL1) |= UCSWRST;
+	_I2C_REG8(i2c->gate, _I2C_CTL0) |= UCMST;
+	_I2C_REG8(i2c->gate, _I2C_CTL1) &= ~(UCSWRST);
+
+	MP_INTERRUPT_SAFE_END
+}
+
+/**
+ * @brief Free a bus held by a slave then reset the USCI
+ *
+ * A slave stopped in the middle of a byte holds SDA low. Up to
+ * nine SCL clocks let it shift the byte out, then a stop condition
+ * is sent by hand before the USCI takes the pins back.
+ *
+ * @param[in] i2c I2C context
+ */
+void mp_i2c_recover(mp_i2c_t *i2c) {
+	unsigned char sda = 1<<i2c->sda->pin;
+	unsigned char clk = 1<<i2c->clk->pin;
+	int a;
+
+	MP_INTERRUPT_SAFE_BEGIN
+
+	_I2C_REG8(i2c->gate, _I2C_CTL1) |= UCSWRST;
+
+	/* pins as GPIO, SDA released, SCL driven high */
+	_GPIO_REG8(i2c->sda, _GPIO_DIR) &= ~sda;
+	_GPIO_REG8(i2c->sda, _GPIO_OUT) &= ~sda;
+	_GPIO_REG8(i2c->clk, _GPIO_OUT) |= clk;
+	_GPIO_REG8(i2c->clk, _GPIO_DIR) |= clk;
+	_GPIO_REG8(i2c->sda, _GPIO_SEL) &= ~sda;
+	_GPIO_REG8(i2c->clk, _GPIO_SEL) &= ~clk;
+
+	/* clock until the slave releases SDA */
+	for(a=0; a<9 && !(_GPIO_REG8(i2c->sda, _GPIO_IN) & sda); a++) {
+		_GPIO_REG8(i2c->clk, _GPIO_OUT) &= ~clk;
+		_mp_i2c_halfBit();
+		_GPIO_REG8(i2c->clk, _GPIO_OUT) |= clk;
+		_mp_i2c_halfBit();
+	}
+
+	/* stop condition, SDA rises while SCL is high */
+	_GPIO_REG8(i2c->clk, _GPIO_OUT) &= ~clk;
+	_mp_i2c_halfBit();
+	_GPIO_REG8(i2c->sda, _GPIO_DIR) |= sda;
+	_mp_i2c_halfBit();
+	_GPIO_REG8(i2c->clk, _GPIO_OUT) |= clk;
+	_mp_i2c_halfBit();
+	_GPIO_REG8(i2c->sda, _GPIO_DIR) &= ~sda;
+	_mp_i2c_halfBit();
+
+	/* give the pins back */
+	_GPIO_REG8(i2c->clk, _GPIO_DIR) &= ~clk;
+	_GPIO_REG8(i2c->sda, _GPIO_SEL) |= sda;
+	_GPIO_REG8(i2c->clk, _GPIO_SEL) |= clk;
+
+	_I2C_REG8(i2c->gate, _I2C_CTL0) |= UCMST;
+	_I2C_REG8(i2c->gate, _I2C_CTL1) &= ~(UCSWRST);
+
+	MP_INTERRUPT_SAFE_END
+}
+
+static void _mp_i2c_halfBit() {
+	__delay_cycles(_RECOVER_HALF_CYCLES);
+}
+
 
 static void mp_i2c_interruptDispatch(void *user) {
 	mp_i2c_t *i2c = user;
@@ -14,6 +14,7 @@ static void __dummy_int();
 /* 100 shall be enougth for all msp430 series */
 static mp_interrupt_t __interrupts[_MAX_INTERRUPTS];
 static mp_bool_t __state = NO;
+static volatile mp_bool_t __lpm_exit = NO;
 
 mp_ret_t mp_interrupt_init() {
 	mp_interrupt_t *inter;
@@ -78,11 +79,17 @@ void mp_interrupt_enable() {
 }
 
 void mp_interrupt_disable() {
+	/* already masked (e.g. inside an ISR), __state belongs to the main context */
+	if(!(__get_SR_register() & GIE))
+		return;
 	__state = NO;
 	__disable_interrupt();
 }
 
 mp_bool_t mp_interrupt_state() {
+	/* GIE is cleared inside an ISR, __state only follows the main context */
+	if(!(__get_SR_register() & GIE))
+		return(NO);
 	return(__state);
 }
 
@@ -93,18 +100,36 @@ void mp_interrupt_restore(mp_bool_t state) {
 		mp_interrupt_disable();
 }
 
+/**
+ * @brief Leave low power mode at the end of the current ISR
+ *
+ * Needed when an ISR which does not exit LPM by itself makes a task ready
+ */
+void mp_interrupt_lpm_exit() {
+	__lpm_exit = YES;
+}
+
 static void __dummy_int() { }
 
 #define _INSIDE_ISR(V) \
 	__interrupt void V##_isr(void) { \
 		mp_interrupt_t *__i = &__interrupts[V-_FACTOR]; \
+		MP_TRACE_EVENT(MP_TRACE_ISR_ENTER, V, 0); \
 		__i->callback(__i->user); \
+		MP_TRACE_EVENT(MP_TRACE_ISR_EXIT, V, 0); \
+		if(__lpm_exit == YES) { \
+			__lpm_exit = NO; \
+			LPM3_EXIT; \
+		} \
 	}
 
 #define _INSIDE_ISR_LPM(V) \
 	__interrupt void V##_isr(void) { \
 		mp_interrupt_t *__i = &__interrupts[V-_FACTOR]; \
+		MP_TRACE_EVENT(MP_TRACE_ISR_ENTER, V, 0); \
 		__i->callback(__i->user); \
+		MP_TRACE_EVENT(MP_TRACE_ISR_EXIT, V, 0); \
+		__lpm_exit = NO; \
 		LPM3_EXIT; \
 	}
 
@@ -148,6 +173,11 @@ _INSIDE_ISR(USCI_A2_VECTOR);
 _INSIDE_ISR(USCI_A3_VECTOR);
 #endif
 
+#ifdef DMA_VECTOR
+#pragma vector=DMA_VECTOR
+_INSIDE_ISR(DMA_VECTOR);
+#endif
+
 #ifdef PORT1_VECTOR
 #pragma vector=PORT1_VECTOR
 _INSIDE_ISR(PORT1_VECTOR);
@@ -77,6 +77,9 @@ mp_ret_t mp_machine_init(mp_kernel_t *kernel) {
 	/* set high energy */
 	mp_clock_high_energy(kernel);
 
+	/* initialize DMA */
+	mp_dma_init();
+
 	/* intialize UART */
 	mp_uart_init();
 
@@ -100,6 +103,9 @@ mp_ret_t mp_machine_fini(mp_kernel_t *kernel) {
 	/* intialize UART */
 	mp_uart_fini();
 
+	/* terminate DMA */
+	mp_dma_fini();
+
 	/* terminate clock */
 	mp_clock_fini(kernel);
 
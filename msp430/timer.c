@@ -117,6 +117,7 @@ mp_ret_t mp_timer_create(mp_kernel_t *kernel, mp_timer_t *timer, mp_options_t *o
 	/* prepare alignement */
 	timer->regCTL = (unsigned short *)timer->gate->_baseAddress;
 	timer->regCCTL0 = (unsigned short *)(timer->gate->_baseAddress+0x2);
+	timer->regR = (unsigned short *)(timer->gate->_baseAddress+0x10);
 	timer->regCCR0 = (unsigned short *)(timer->gate->_baseAddress+0x12);
 	timer->regIV = (unsigned short *)(timer->gate->_baseAddress+0x2e);
 
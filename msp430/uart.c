@@ -21,6 +21,9 @@
 #include <mp.h>
 
 static void _mp_uart_interrupt(void *user);
+static mp_ret_t _mp_uart_dma_open(mp_uart_t *uart, mp_options_t *options, char *who);
+static void _mp_uart_dma_txDone(mp_dma_t *dma);
+static void _mp_uart_dma_rxDone(mp_dma_t *dma);
 
 
 /**
@@ -84,6 +87,12 @@ mp_ret_t mp_uart_open(mp_kernel_t *kernel, mp_uart_t *uart, mp_options_t *option
 	/* setup */
 	mp_uart_setup(uart, options);
 
+	/* optional DMA channels */
+	if(_mp_uart_dma_open(uart, options, who) == FALSE) {
+		mp_uart_close(uart);
+		return(FALSE);
+	}
+
 	return(TRUE);
 }
 
@@ -202,6 +211,10 @@ mp_ret_t mp_uart_setup(mp_uart_t *uart, mp_options_t *options) {
 
 mp_ret_t mp_uart_close(mp_uart_t *uart) {
 
+	/* release DMA channels */
+	mp_dma_close(&uart->dmaTx);
+	mp_dma_close(&uart->dmaRx);
+
 	/* remove interrupt */
 	mp_interrupt_unset(uart->gate->_ISRVector);
 
@@ -231,17 +244,140 @@ mp_ret_t mp_uart_close(mp_uart_t *uart) {
 
 
 
-// int used to indicate a request for more new data
-/*
-void hal_uart_dma_receive_block(uint8_t *buffer, uint16_t len){
-	UCA2IE &= ~UCRXIE ; // disable RX interrupts
-	rx_buffer_ptr = buffer;
-	bytes_to_read = len;
-	UCA2IE |= UCRXIE; // enable RX interrupts
-	hal_uart_dma_enable_rx(); // enable receive
+/**
+ * @brief Transmit a block through the TX DMA channel
+ *
+ * The channel writes TXBUF at each TXIFG, onDmaTx() is called from the
+ * DMA interrupt once the last byte is into TXBUF. The block must stay
+ * valid until then.
+ *
+ * @param[in] uart UART opened with the dmaTx option
+ * @param[in] data Bytes to send
+ * @param[in] size Number of bytes
+ * @return TRUE or FALSE
+ */
+mp_ret_t mp_uart_dma_tx(mp_uart_t *uart, unsigned char *data, unsigned int size) {
+	if(uart->dmaTx.opened != YES || size == 0)
+		return(FALSE);
+
+	/* TXIFG belongs to the channel */
+	_UART_REG8(uart->gate, _UART_IE) &= ~UCTXIE;
+
+	mp_dma_start(
+		&uart->dmaTx, uart->dmaTxTrigger, MP_DMA_SRC_INCR,
+		data, &_UART_REG8(uart->gate, _UART_TXBUF), size
+	);
+
+	/* TXIFG is already set and the trigger is an edge */
+	_UART_REG8(uart->gate, _UART_IFG) &= ~UCTXIFG;
+	_UART_REG8(uart->gate, _UART_IFG) |= UCTXIFG;
+
+	return(TRUE);
+}
+
+/**
+ * @brief Receive continuously into a circular buffer
+ *
+ * The RX DMA channel fills buffer and restarts at its beginning,
+ * onDmaRx() is called from the DMA interrupt at each lap. Progress
+ * inside the lap is given by mp_uart_dma_rx_count().
+ *
+ * @param[in] uart UART opened with the dmaRx option
+ * @param[in] buffer Storage
+ * @param[in] size Size of the storage
+ * @return TRUE or FALSE
+ */
+mp_ret_t mp_uart_dma_rx(mp_uart_t *uart, unsigned char *buffer, unsigned int size) {
+	if(uart->dmaRx.opened != YES || size == 0)
+		return(FALSE);
+
+	/* RXIFG belongs to the channel */
+	_UART_REG8(uart->gate, _UART_IE) &= ~UCRXIE;
+
+	uart->dmaRxSize = size;
+	mp_dma_start(
+		&uart->dmaRx, uart->dmaRxTrigger, MP_DMA_DST_INCR | MP_DMA_REPEAT,
+		&_UART_REG8(uart->gate, _UART_RXBUF), buffer, size
+	);
+
+	return(TRUE);
+}
+
+/**
+ * @brief Bytes received since the last onDmaRx() call
+ *
+ * A lap done but not yet served counts for the whole buffer.
+ *
+ * @param[in] uart UART receiving with mp_uart_dma_rx()
+ * @return Number of bytes
+ */
+unsigned int mp_uart_dma_rx_count(mp_uart_t *uart) {
+	unsigned int remaining;
+	mp_bool_t pending;
+
+	/* a lap may end between both reads */
+	do {
+		remaining = mp_dma_remaining(&uart->dmaRx);
+		pending = mp_dma_pending(&uart->dmaRx);
+	} while(remaining != mp_dma_remaining(&uart->dmaRx));
+
+	return(uart->dmaRxSize-remaining+(pending == YES ? uart->dmaRxSize : 0));
+}
+
+void mp_uart_dma_stop(mp_uart_t *uart) {
+	if(uart->dmaTx.opened == YES)
+		mp_dma_stop(&uart->dmaTx);
+	if(uart->dmaRx.opened == YES)
+		mp_dma_stop(&uart->dmaRx);
+}
+
+static mp_ret_t _mp_uart_dma_open(mp_uart_t *uart, mp_options_t *options, char *who) {
+	char *value;
+
+	/* only USCI_A0 and USCI_A1 can trigger a channel */
+	if(strcmp(uart->gate->portDevice, "USCI_A0") == 0) {
+		uart->dmaTxTrigger = MP_DMA_TRIGGER_UCA0TX;
+		uart->dmaRxTrigger = MP_DMA_TRIGGER_UCA0RX;
+	}
+	else if(strcmp(uart->gate->portDevice, "USCI_A1") == 0) {
+		uart->dmaTxTrigger = MP_DMA_TRIGGER_UCA1TX;
+		uart->dmaRxTrigger = MP_DMA_TRIGGER_UCA1RX;
+	}
+
+	value = mp_options_get(options, "dmaTx");
+	if(value) {
+		if(uart->dmaTxTrigger == 0 || mp_dma_open(&uart->dmaTx, value, who) == FALSE) {
+			mp_printk("UART - Can not use DMA TX for %s", who);
+			return(FALSE);
+		}
+		uart->dmaTx.onDone = _mp_uart_dma_txDone;
+		uart->dmaTx.user = uart;
+	}
+
+	value = mp_options_get(options, "dmaRx");
+	if(value) {
+		if(uart->dmaRxTrigger == 0 || mp_dma_open(&uart->dmaRx, value, who) == FALSE) {
+			mp_printk("UART - Can not use DMA RX for %s", who);
+			return(FALSE);
+		}
+		uart->dmaRx.onDone = _mp_uart_dma_rxDone;
+		uart->dmaRx.user = uart;
+	}
+
+	return(TRUE);
+}
+
+static void _mp_uart_dma_txDone(mp_dma_t *dma) {
+	mp_uart_t *uart = dma->user;
+	if(uart->onDmaTx)
+		uart->onDmaTx(uart);
 }
 
-*/
+static void _mp_uart_dma_rxDone(mp_dma_t *dma) {
+	mp_uart_t *uart = dma->user;
+	if(uart->onDmaRx)
+		uart->onDmaRx(uart);
+}
 
 static void _mp_uart_interrupt(void *user) {
 	mp_uart_t *uart = user;
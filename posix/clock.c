@@ -0,0 +1,327 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <mp.h>
+
+#include <time.h>
+
+static void _set_timer(mp_kernel_t *kernel);
+static unsigned long _elapsed(unsigned long hz);
+static void _leave(mp_kernel_t *kernel);
+
+static struct timespec __origin;
+static mp_clock_freq_t __frequency;
+
+#ifdef MP_CLOCK_TICKLESS
+	#define _TICKLESS_MAX_WAIT 1000 /* longest programmed sleep in ticks */
+
+	static mp_timer_t *__tickTimer;
+#else
+	static volatile unsigned long __ticks;
+#endif
+
+/* speed reported to drivers computing prescalers */
+static const unsigned long _mp_clock_freq_speed[] = {
+	1000000, 4000000, 8000000, 12000000, 16000000, 20000000, 25000000
+};
+
+static const char *_mp_clock_freq_name[] = {
+	"1Mhz", "4Mhz", "8Mhz", "12Mhz", "16Mhz", "20Mhz", "25Mhz"
+};
+
+/**
+@defgroup mpArchPosixClock The clock system
+
+@ingroup mpArchPosix
+
+@brief Ticks and low power mode on the host
+
+@author @htmlonly &copy; @endhtmlonly 2016
+Michael Vergoz <mv@verman.fr>
+
+@date 17 Oct 2016
+
+Time is CLOCK_MONOTONIC since mp_clock_init(). Without MP_CLOCK_TICKLESS
+TIMER_A1 interrupts at POSIX_TICK_RATE_HZ and counts the ticks like on the
+target. With MP_CLOCK_TICKLESS ticks are read from the clock and TIMER_A1
+is programmed once per sleep.
+
+Low power mode is mp_posix_interrupt_wait(), the process sleeps until the
+next signal.
+
+@{
+*/
+
+mp_ret_t mp_clock_init(mp_kernel_t *kernel) {
+	memset(&kernel->posix.scheduler, 0, sizeof(kernel->posix.scheduler));
+
+	clock_gettime(CLOCK_MONOTONIC, &__origin);
+
+	__frequency = MP_CLOCK_LE_FREQ;
+
+	/* tick timer */
+	_set_timer(kernel);
+
+	return(TRUE);
+}
+
+mp_ret_t mp_clock_fini(mp_kernel_t *kernel) {
+	mp_timer_destroy(&kernel->tickTimer);
+#ifdef MP_CLOCK_TICKLESS
+	__tickTimer = NULL;
+#endif
+	return(TRUE);
+}
+
+void mp_clock_reset(mp_kernel_t *kernel) {
+	memset(&kernel->posix.scheduler, 0, sizeof(kernel->posix.scheduler));
+}
+
+mp_ret_t mp_clock_low_energy(mp_kernel_t *kernel) {
+	kernel->posix.scheduler.clockState = 0;
+	__frequency = MP_CLOCK_LE_FREQ;
+	kernel->posix.scheduler.schedulerOff = FALSE;
+	return(TRUE);
+}
+
+mp_ret_t mp_clock_high_energy(mp_kernel_t *kernel) {
+	kernel->posix.scheduler.clockState = 1;
+	__frequency = MP_CLOCK_HE_FREQ;
+	kernel->posix.scheduler.schedulerOff = FALSE;
+	return(TRUE);
+}
+
+#ifdef MP_CLOCK_TICKLESS
+void mp_clock_schedule(mp_kernel_t *kernel) {
+	mp_clock_sched_t *sched = &kernel->posix.scheduler;
+	unsigned long now;
+	unsigned long wait;
+	unsigned long timers;
+
+	_leave(kernel);
+
+	mp_interrupt_disable();
+
+	/* something to do now */
+	now = mp_clock_ticks();
+	wait = mp_task_next_wakeup(&kernel->tasks, now);
+	timers = mp_ktimer_next_wakeup(kernel, now);
+	if(timers < wait)
+		wait = timers;
+	if(wait == 0 || mp_softirq_pending(kernel) == YES) {
+		mp_interrupt_enable();
+		return;
+	}
+
+	/* longer sleeps are cut */
+	if(wait > _TICKLESS_MAX_WAIT)
+		wait = _TICKLESS_MAX_WAIT;
+	mp_posix_timer_oneshot(__tickTimer, wait*(1000000/POSIX_TICK_RATE_HZ));
+
+	sched->schedulerOff = TRUE;
+	sched->sleeps++;
+
+	MP_TRACE_EVENT(MP_TRACE_LPM_ENTER, 3, 0);
+
+	/* wake up on the timer or when an ISR makes a task ready */
+	mp_posix_interrupt_wait();
+
+	MP_TRACE_EVENT(MP_TRACE_LPM_EXIT, 3, 0);
+
+	sched->schedulerOff = FALSE;
+
+	mp_interrupt_enable();
+}
+#else
+void mp_clock_schedule(mp_kernel_t *kernel) {
+	mp_clock_sched_t *sched = &kernel->posix.scheduler;
+
+	_leave(kernel);
+
+	/*
+	 * due tasks and timers are checked on every tick, waiting for
+	 * the next interrupt costs at most one tick of latency
+	 */
+	mp_interrupt_disable();
+	if(kernel->tasks.pendingNumber == 0 && mp_softirq_pending(kernel) == NO) {
+		sched->schedulerOff = TRUE;
+		sched->sleeps++;
+
+		MP_TRACE_EVENT(MP_TRACE_LPM_ENTER, 3, 0);
+
+		/* until the next tick or any other interrupt */
+		mp_posix_interrupt_wait();
+
+		MP_TRACE_EVENT(MP_TRACE_LPM_EXIT, 3, 0);
+
+		sched->schedulerOff = FALSE;
+	}
+	mp_interrupt_enable();
+
+	/* reset scheduler */
+	sched->longestDelay = 0;
+	sched->shortestDelay = ~(sched->longestDelay)-1;
+}
+#endif
+
+void mp_clock_task_change(mp_task_t *task) {
+	mp_kernel_t *kernel = task->handler->kernel;
+	mp_clock_sched_t *sched = &kernel->posix.scheduler;
+
+	switch(task->signal) {
+		case MP_TASK_SIG_SLEEP:
+		case MP_TASK_SIG_OK:
+			if(task->delay > sched->longestDelay)
+				sched->longestDelay = task->delay;
+			if(task->delay < sched->shortestDelay)
+				sched->shortestDelay = task->delay;
+			break;
+
+		case MP_TASK_SIG_STOP:
+		case MP_TASK_SIG_PENDING:
+			sched->shortestDelay = 0;
+			sched->longestDelay = 0;
+			break;
+
+		default:
+			break;
+	}
+}
+
+unsigned long mp_clock_ticks() {
+#ifdef MP_CLOCK_TICKLESS
+	return(_elapsed(POSIX_TICK_RATE_HZ));
+#else
+	return(__ticks);
+#endif
+}
+
+/**
+ * @brief High resolution time
+ *
+ * Time in microseconds (@ref MP_CLOCK_HIRES_HZ)
+ *
+ * @return Actual time
+ */
+unsigned long mp_clock_hires() {
+	return(_elapsed(MP_CLOCK_HIRES_HZ));
+}
+
+/**
+ * @brief Convert a high resolution duration to milliseconds
+ *
+ * @param[in] hires Duration in @ref MP_CLOCK_HIRES_HZ counts
+ * @return Milliseconds
+ */
+unsigned long mp_clock_hires_ms(unsigned long hires) {
+	return(hires/1000);
+}
+
+/**
+ * @brief Convert a high resolution duration to microseconds
+ *
+ * @param[in] hires Duration in @ref MP_CLOCK_HIRES_HZ counts
+ * @return Microseconds
+ */
+unsigned long mp_clock_hires_us(unsigned long hires) {
+	/* the host counts microseconds */
+	return(hires);
+}
+
+void mp_clock_delay(int delay) {
+	struct timespec req;
+
+	req.tv_sec = delay/1000;
+	req.tv_nsec = (delay%1000)*1000000L;
+	while(nanosleep(&req, &req) != 0);
+}
+
+void mp_clock_nanoDelay(unsigned long delay) {
+	struct timespec req;
+
+	req.tv_sec = 0;
+	req.tv_nsec = delay;
+	while(nanosleep(&req, &req) != 0);
+}
+
+unsigned long mp_clock_get_speed() {
+	return(_mp_clock_freq_speed[__frequency]);
+}
+
+const char *mp_clock_name(mp_clock_freq_t clock) {
+	return(_mp_clock_freq_name[clock]);
+}
+
+/** @} */
+
+/* the kernel loop never returns, leave the process from there */
+static void _leave(mp_kernel_t *kernel) {
+	if(mp_posix_quitting() == NO)
+		return;
+	mp_kernel_fini(kernel);
+	exit(EXIT_SUCCESS);
+}
+
+static unsigned long _elapsed(unsigned long hz) {
+	struct timespec now;
+	unsigned long long ns;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	ns = (unsigned long long)(now.tv_sec-__origin.tv_sec)*1000000000ULL+
+		now.tv_nsec-__origin.tv_nsec;
+
+	return(ns/(1000000000ULL/hz));
+}
+
+#ifdef MP_CLOCK_TICKLESS
+static void _mp_clock_tickless_timer(mp_timer_t *timer) {
+	/* only there to leave low power mode */
+}
+
+static void _set_timer(mp_kernel_t *kernel) {
+	mp_options_t options[] = {
+		{ "gate", "TIMER_A1" },
+		{ "mode", "cont" },
+		{ NULL, NULL }
+	};
+	if(mp_timer_create(kernel, &kernel->tickTimer, options, "POSIX Timer") == FALSE)
+		return;
+	__tickTimer = &kernel->tickTimer;
+	mp_timer_set_interrupt(&kernel->tickTimer, _mp_clock_tickless_timer);
+	mp_timer_enable_interrupt(&kernel->tickTimer);
+}
+#else
+static void _mp_clock_system_timer(mp_timer_t *timer) {
+	__ticks++;
+}
+
+static void _set_timer(mp_kernel_t *kernel) {
+	mp_options_t options[] = {
+		{ "gate", "TIMER_A1" },
+		{ "frequency", "1000" },
+		{ NULL, NULL }
+	};
+	__ticks = 0;
+	mp_timer_create(kernel, &kernel->tickTimer, options, "POSIX Timer");
+	mp_timer_set_interrupt(&kernel->tickTimer, _mp_clock_system_timer);
+	mp_timer_enable_interrupt(&kernel->tickTimer);
+}
+#endif
@@ -0,0 +1,195 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <mp.h>
+
+static void _mp_dma_interrupt(void *user);
+
+/* emulated channel registers */
+#define _DMA_EN  0x01
+#define _DMA_IFG 0x02
+
+typedef struct {
+	unsigned char ctl;
+	unsigned char flags;
+	unsigned char trigger;
+
+	volatile unsigned char *src;
+	volatile unsigned char *dst;
+	unsigned int size;
+
+	/* reloaded at the end of a repeated block */
+	volatile unsigned char *srcStart;
+	volatile unsigned char *dstStart;
+	unsigned int sizeStart;
+
+	mp_dma_t *dma;
+} _dma_channel_t;
+
+static _dma_channel_t __channels[MP_DMA_CHANNELS];
+
+/**
+@defgroup mpArchPosixDMA DMA stand-in
+
+@ingroup mpArchPosix
+
+@brief Channel registers moved by the peripheral stand-ins
+
+@author @htmlonly &copy; @endhtmlonly 2016
+Michael Vergoz <mv@verman.fr>
+
+@date 17 Oct 2016
+
+Same API than the MSP430 DMA controller. A stand-in peripheral calls
+mp_posix_dma_trigger() where the hardware would raise the trigger IFG,
+the enabled channel waiting for it moves one byte, decrements its size
+and raises the DMA vector at the end of the block.
+
+@{
+*/
+
+mp_ret_t mp_dma_init() {
+	memset(__channels, 0, sizeof(__channels));
+
+	mp_interrupt_set(POSIX_DMA_VECTOR, _mp_dma_interrupt, NULL, "DMA");
+
+	return(TRUE);
+}
+
+mp_ret_t mp_dma_fini() {
+	mp_interrupt_unset(POSIX_DMA_VECTOR);
+
+	return(TRUE);
+}
+
+mp_ret_t mp_dma_open(mp_dma_t *dma, char *channel, char *who) {
+	int number = atoi(channel);
+
+	memset(dma, 0, sizeof(*dma));
+
+	if(number < 0 || number >= MP_DMA_CHANNELS || __channels[number].dma != NULL) {
+		mp_printk("DMA - Can not handle channel %s for %s", channel, who);
+		return(FALSE);
+	}
+
+	dma->channel = number;
+	dma->who = who;
+	dma->opened = YES;
+
+	memset(&__channels[number], 0, sizeof(__channels[number]));
+	__channels[number].dma = dma;
+
+	return(TRUE);
+}
+
+mp_ret_t mp_dma_close(mp_dma_t *dma) {
+	if(dma->opened != YES)
+		return(FALSE);
+
+	mp_dma_stop(dma);
+	__channels[dma->channel].dma = NULL;
+	dma->opened = NO;
+
+	return(TRUE);
+}
+
+void mp_dma_start(mp_dma_t *dma, unsigned char trigger, unsigned char flags,
+		volatile void *src, volatile void *dst, unsigned int size) {
+	_dma_channel_t *channel = &__channels[dma->channel];
+
+	/* enabled last, the channel can be triggered from a signal */
+	channel->ctl = 0;
+	channel->flags = flags;
+	channel->trigger = trigger;
+	channel->src = channel->srcStart = src;
+	channel->dst = channel->dstStart = dst;
+	channel->size = channel->sizeStart = size;
+	channel->ctl = _DMA_EN;
+}
+
+void mp_dma_stop(mp_dma_t *dma) {
+	__channels[dma->channel].ctl = 0;
+}
+
+unsigned int mp_dma_remaining(mp_dma_t *dma) {
+	return(__channels[dma->channel].size);
+}
+
+mp_bool_t mp_dma_pending(mp_dma_t *dma) {
+	return(__channels[dma->channel].ctl & _DMA_IFG ? YES : NO);
+}
+
+/**
+ * @brief Raise a trigger
+ *
+ * Called by stand-ins with interrupts disabled or from their ISR
+ *
+ * @param[in] trigger MP_DMA_TRIGGER_*
+ * @return YES when a channel moved a byte
+ */
+mp_bool_t mp_posix_dma_trigger(unsigned char trigger) {
+	_dma_channel_t *channel;
+	int a;
+
+	for(a=0; a<MP_DMA_CHANNELS; a++) {
+		channel = &__channels[a];
+		if(!(channel->ctl & _DMA_EN) || channel->trigger != trigger)
+			continue;
+
+		*channel->dst = *channel->src;
+		if(channel->flags & MP_DMA_SRC_INCR)
+			channel->src++;
+		if(channel->flags & MP_DMA_DST_INCR)
+			channel->dst++;
+
+		if(--channel->size == 0) {
+			if(channel->flags & MP_DMA_REPEAT) {
+				channel->src = channel->srcStart;
+				channel->dst = channel->dstStart;
+				channel->size = channel->sizeStart;
+			}
+			else
+				channel->ctl &= ~_DMA_EN;
+
+			channel->ctl |= _DMA_IFG;
+			mp_posix_interrupt_raise(POSIX_DMA_VECTOR);
+		}
+		return(YES);
+	}
+	return(NO);
+}
+
+/**@}*/
+
+static void _mp_dma_interrupt(void *user) {
+	_dma_channel_t *channel;
+	int a;
+
+	for(a=0; a<MP_DMA_CHANNELS; a++) {
+		channel = &__channels[a];
+		if(!(channel->ctl & _DMA_IFG))
+			continue;
+
+		channel->ctl &= ~_DMA_IFG;
+		if(channel->dma && channel->dma->onDone)
+			channel->dma->onDone(channel->dma);
+	}
+}
@@ -0,0 +1,119 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * POSIX host gates, same names than the MSP430F5438 ones
+ */
+
+#include <mp.h>
+
+typedef struct {
+	char *portDevice;
+	unsigned int vector;
+} _gate_def_t;
+
+static const _gate_def_t __gate_defs[] = {
+	{ "USCI_A0", POSIX_USCI_A0_VECTOR },
+	{ "USCI_B0", POSIX_USCI_B0_VECTOR },
+	{ "USCI_A1", POSIX_USCI_A1_VECTOR },
+	{ "USCI_B1", POSIX_USCI_B1_VECTOR },
+	{ "USCI_A2", POSIX_USCI_A2_VECTOR },
+	{ "USCI_B2", POSIX_USCI_B2_VECTOR },
+	{ "USCI_A3", POSIX_USCI_A3_VECTOR },
+	{ "USCI_B3", POSIX_USCI_B3_VECTOR },
+	{ "TIMER_A0", POSIX_TIMER_A0_VECTOR },
+	{ "TIMER_A1", POSIX_TIMER_A1_VECTOR },
+	{ "TIMER_B0", POSIX_TIMER_B0_VECTOR },
+};
+
+#define _GATE_COUNT (sizeof(__gate_defs)/sizeof(__gate_defs[0]))
+
+static mp_gate_t __gate[_GATE_COUNT];
+
+void mp_gate_init(mp_kernel_t *kernel) {
+	mp_gate_t *gate;
+	int a;
+
+	memset(&__gate, 0, sizeof(__gate));
+
+	for(a=0; a<_GATE_COUNT; a++) {
+		gate = &__gate[a];
+		gate->portDevice = __gate_defs[a].portDevice;
+		gate->_ISRVector = __gate_defs[a].vector;
+		gate->isBusy = NO;
+		mp_list_init(&gate->devices);
+	}
+}
+
+void mp_gate_fini(mp_kernel_t *kernel) {
+	/* none */
+
+}
+
+mp_gate_t *mp_gate_handle(char *id, char *who) {
+	mp_gate_t *gate;
+
+	gate = mp_posix_gate_get(id);
+	if(gate == NULL || gate->isBusy == YES)
+		return(NULL);
+
+	gate->isBusy = YES;
+	gate->byWho = who;
+	return(gate);
+}
+
+void mp_gate_release(mp_gate_t *gate) {
+	gate->isBusy = NO;
+	gate->byWho = NULL;
+	gate->ie = 0;
+	gate->ifg = 0;
+}
+
+/**
+ * @brief Lookup a gate without taking it
+ *
+ * Used by the host to wire simulated devices
+ *
+ * @param[in] id Gate name
+ * @return Gate or NULL
+ */
+mp_gate_t *mp_posix_gate_get(char *id) {
+	int a;
+
+	for(a=0; a<_GATE_COUNT; a++) {
+		if(strcmp(id, __gate[a].portDevice) == 0)
+			return(&__gate[a]);
+	}
+	return(NULL);
+}
+
+/**
+ * @brief Raise the gate vector when an enabled flag is set
+ *
+ * Stand-ins call it each time IE or IFG changes, it gives the level
+ * triggered behaviour of the USCI interrupts
+ *
+ * @param[in] gate Gate
+ */
+void mp_posix_gate_update(mp_gate_t *gate) {
+	if(gate->ie & gate->ifg)
+		mp_posix_interrupt_raise(gate->_ISRVector);
+}
@@ -0,0 +1,198 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <mp.h>
+
+static void _receive_port_interrupt(void *user);
+
+#define _GPIO_PORTS 12
+
+static mp_gpio_port_t __ports[_GPIO_PORTS*8+1];
+
+void mp_gpio_init() {
+	mp_gpio_port_t *p;
+	int port;
+	int a;
+
+	memset(&__ports, 0, sizeof(__ports));
+
+	for(port=1; port<=_GPIO_PORTS; port++) {
+		for(a=0; a<8; a++) {
+			p = &__ports[port*8-7+a];
+			p->port = port;
+			p->pin = a;
+			p->used = NO;
+			if(port == 1)
+				p->isr = POSIX_PORT1_VECTOR;
+			else if(port == 2)
+				p->isr = POSIX_PORT2_VECTOR;
+		}
+	}
+
+	mp_interrupt_set(POSIX_PORT1_VECTOR, _receive_port_interrupt, &__ports[1], "PORT 1");
+	mp_interrupt_set(POSIX_PORT2_VECTOR, _receive_port_interrupt, &__ports[9], "PORT 2");
+}
+
+void mp_gpio_fini() {
+	mp_interrupt_unset(POSIX_PORT1_VECTOR);
+	mp_interrupt_unset(POSIX_PORT2_VECTOR);
+}
+
+mp_gpio_port_t *mp_gpio_handle(unsigned int port, unsigned int slot, char *who) {
+	mp_gpio_port_t *porthdl;
+
+	if(port < 1 || port > _GPIO_PORTS || slot > 7)
+		return(NULL);
+
+	/* get port */
+	porthdl = &__ports[port*8-7+slot];
+
+	/* port inuse */
+	porthdl->used = YES;
+	porthdl->who = who;
+
+	/* select the port */
+	return(porthdl);
+}
+
+/* format pX.X */
+mp_gpio_port_t *mp_gpio_text_handle(char *text, char *who) {
+	unsigned int port;
+	unsigned int pin;
+
+	if(sscanf(text, "p%u.%u", &port, &pin) != 2)
+		return(NULL);
+
+	return(mp_gpio_handle(port, pin, who));
+}
+
+mp_ret_t mp_gpio_release(mp_gpio_port_t *port) {
+	port->used = NO;
+	port->who = NULL;
+	port->direction = 0;
+	port->out = port->reverse == YES ? 1 : 0;
+	port->ie = NO;
+	port->ifg = NO;
+
+	/* remove callback */
+	port->callback = NULL;
+
+	return(TRUE);
+}
+
+mp_ret_t mp_gpio_direction(mp_gpio_port_t *port, mp_gpio_direction_t direction) {
+	port->direction = direction;
+	return(TRUE);
+}
+
+mp_ret_t mp_gpio_interrupt_set(mp_gpio_port_t *port, mp_interrupt_cb_t in, void *user, char *who) {
+	/* not interruptible */
+	if(port->isr == 0)
+		return(FALSE);
+
+	port->callback = in;
+	port->user = user;
+
+	/* set port input */
+	mp_gpio_direction(port, MP_GPIO_INPUT);
+
+	/* IFG cleared */
+	port->ifg = NO;
+
+	return(TRUE);
+}
+
+mp_ret_t mp_gpio_interrupt_unset(mp_gpio_port_t *port) {
+	port->ie = NO;
+	port->ifg = NO;
+	return(TRUE);
+}
+
+mp_bool_t mp_gpio_read(mp_gpio_port_t *port) {
+	return(port->in ? ON : OFF);
+}
+
+void mp_gpio_set(mp_gpio_port_t *port) {
+	if(port->used != YES && port->direction == MP_GPIO_OUTPUT)
+		return;
+	port->out = port->reverse == YES ? 0 : 1;
+}
+
+void mp_gpio_unset(mp_gpio_port_t *port) {
+	if(port->used != YES && port->direction == MP_GPIO_OUTPUT)
+		return;
+	port->out = port->reverse == YES ? 1 : 0;
+}
+
+void mp_gpio_turn(mp_gpio_port_t *port) {
+	if(port->used != YES && port->direction == MP_GPIO_OUTPUT)
+		return;
+	port->out ^= 1;
+}
+
+/**
+ * @brief Drive an input pin from the host
+ *
+ * Sets IFG and raises the port vector on the edge selected by
+ * mp_gpio_interrupt_lo2hi() or mp_gpio_interrupt_hi2lo()
+ *
+ * @param[in] port GPIO port
+ * @param[in] level New pin level
+ */
+void mp_posix_gpio_input(mp_gpio_port_t *port, mp_bool_t level) {
+	unsigned char old = port->in;
+
+	port->in = level ? 1 : 0;
+	if(old == port->in || port->isr == 0)
+		return;
+
+	/* IES set selects the high to low transition */
+	if((port->ies && old) || (!port->ies && !old)) {
+		port->ifg = YES;
+		if(port->ie)
+			mp_posix_interrupt_raise(port->isr);
+	}
+}
+
+/**
+ * @brief Read the level driven on an output pin
+ *
+ * @param[in] port GPIO port
+ * @return Level of the pin
+ */
+mp_bool_t mp_posix_gpio_output(mp_gpio_port_t *port) {
+	return(port->out ? ON : OFF);
+}
+
+static void _receive_port_interrupt(void *user) {
+	mp_gpio_port_t *portBase = user;
+	mp_gpio_port_t *port;
+	int a;
+
+	for(a=0; a<8; a++) {
+		port = portBase+a;
+		if(port->ifg && port->ie) {
+			port->ifg = NO;
+			if(port->callback)
+				port->callback(port->user);
+		}
+	}
+}
@@ -0,0 +1,165 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Configuration of the host executable, given with
+ * -DMP_MY_CONFIG -include posix/host/config.h
+ */
+
+#ifndef _HAVE_CONFIG_H
+	#define _HAVE_CONFIG_H
+
+	#define _DEBUG
+
+	#define SUPPORT_DRV_LED
+	#define SUPPORT_DRV_BUTTON
+	#define SUPPORT_DRV_INA219
+
+	#define SUPPORT_COMMON_MEM /* enable tiny-malloc */
+	#define SUPPORT_COMMON_SERIAL /* serial interface */
+	#define SUPPORT_COMMON_FRAME /* COBS/SLIP frames over serial */
+	#define SUPPORT_COMMON_PINOUT /* enable pinout feature */
+	#define SUPPORT_COMMON_SENSOR /* enable sensor feature */
+	#define SUPPORT_COMMON_CIRCULAR /* enable circular buffering */
+
+	/* clock manager */
+	#ifndef MP_CLOCK_LE_FREQ
+		#define MP_CLOCK_LE_FREQ MHZ1_t
+	#endif
+
+	#ifndef MP_CLOCK_HE_FREQ
+		#define MP_CLOCK_HE_FREQ MHZ25_t
+	#endif
+
+	#ifndef MP_CLOCK_TICKLESS
+		//#define MP_CLOCK_TICKLESS /* sleep until the next task deadline instead of a 1 kHz tick */
+	#endif
+
+	/* mem configuration */
+	#ifndef MP_MEM_SIZE
+		#define MP_MEM_SIZE  8192 /* total memory allowed for heap */
+	#endif
+
+	#ifndef MP_MEM_CHUNK
+		#define MP_MEM_CHUNK 112   /* largest chunk, room for 64 bits pointers */
+	#endif
+
+	#ifndef MP_MEM_CLASSES
+		#define MP_MEM_CLASSES { 8, 32 }, { 16, 32 }, { 32, 16 }, { MP_MEM_CHUNK, 32 } /* { size, chunks } sorted, the last class takes the rest of the heap */
+	#endif
+
+	#ifndef MP_MEM_SPACING
+		#define MP_MEM_SPACING 8 /* chunk room kept by circular buffers for alignment */
+	#endif
+
+	#ifndef MP_MEM_ISR_CHUNKS
+		#define MP_MEM_ISR_CHUNKS 4 /* largest chunks reserved to mp_mem_alloc_isr() */
+	#endif
+
+	#ifndef MP_MEM_STATS
+		//#define MP_MEM_STATS /* tag chunks with their owner for mp_mem_stats_dump() */
+	#endif
+
+	/* task configuration */
+	#ifndef MP_TASK_MAX
+		#define MP_TASK_MAX 10 /* number of maximum task per instance */
+	#endif
+
+	/* softirq configuration */
+	#ifndef MP_SOFTIRQ_SIZE
+		#define MP_SOFTIRQ_SIZE 16 /* ISR deferred works ring, power of two */
+	#endif
+
+	/* software timer configuration */
+	#ifndef MP_KTIMER_SLOTS
+		#define MP_KTIMER_SLOTS 16 /* timer wheel size, power of two */
+	#endif
+
+	#ifndef MP_TASK_STATS
+		//#define MP_TASK_STATS /* per task runtime and latency accounting */
+	#endif
+
+	/* trace configuration */
+	#ifndef MP_TRACE
+		//#define MP_TRACE /* binary kernel event trace, need serial support */
+	#endif
+
+	#ifndef MP_TRACE_SIZE
+		#define MP_TRACE_SIZE 64 /* number of 8 bytes trace records, power of two <= 128 */
+	#endif
+
+	/* log configuration */
+	#ifndef MP_LOG
+		//#define MP_LOG /* deferred formatting binary log, need serial support */
+	#endif
+
+	#ifndef MP_LOG_PRINTK
+		//#define MP_LOG_PRINTK /* mp_printk() goes through mp_log() when MP_LOG is defined */
+	#endif
+
+	#ifndef MP_LOG_SIZE
+		#define MP_LOG_SIZE 256 /* log ring bytes, power of two */
+	#endif
+
+	#ifndef MP_LOG_ARGS
+		#define MP_LOG_ARGS 48 /* maximum argument bytes of a log record, room for 64 bits pointers */
+	#endif
+
+	#ifndef MP_LOG_STRING
+		#define MP_LOG_STRING 16 /* maximum characters of a logged string */
+	#endif
+
+	/* regMaster configuration */
+	#ifndef MP_REGMASTER_PAYLOAD
+		#define MP_REGMASTER_PAYLOAD 4 /* inline register/payload bytes of an operand */
+	#endif
+
+	#ifndef MP_REGMASTER_OPS
+		#define MP_REGMASTER_OPS 8 /* operand pool of a driver regMaster */
+	#endif
+
+	#ifndef MP_REGMASTER_WEIGHT
+		#define MP_REGMASTER_WEIGHT 4 /* RT operands served in a row while BG waits, 0 is strict */
+	#endif
+
+	#ifndef MP_REGMASTER_STATS
+		//#define MP_REGMASTER_STATS /* per lane queueing delay accounting */
+	#endif
+
+	#ifndef MP_REGMASTER_TIMEOUT
+		#define MP_REGMASTER_TIMEOUT 20 /* ticks an operand may own the bus, 0 disables the watchdog */
+	#endif
+
+	#ifndef MP_REGMASTER_RETRIES
+		#define MP_REGMASTER_RETRIES 2 /* restarts of a failed operand */
+	#endif
+
+	/* serial configuration */
+	#ifndef MP_SERIAL_DMA_CHECK
+		#define MP_SERIAL_DMA_CHECK 2 /* ticks between DMA half and idle checks */
+	#endif
+
+	/* state configuration */
+	#ifndef MP_STATE_MAX
+		#define MP_STATE_MAX 5 /* maximum number of machine states */
+	#endif
+
+#endif
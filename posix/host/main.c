@@ -0,0 +1,306 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Host board: runs the kernel loop as a Linux process on top of
+ * the POSIX architecture. Peripherals are software stand-ins, the
+ * UART is exposed as a pseudo terminal (lines typed there are echoed)
+ * and an INA219 is simulated on the I2C bus.
+ *
+ *   ./posix/bin/miniphi [-d seconds]
+ */
+
+#include <mp.h>
+#include <unistd.h>
+
+/* use reserved number 1 to define the host state machine */
+#define HOST_OP MP_KERNEL_RES01
+
+typedef struct host_board_s host_board_t;
+typedef struct host_ina219_s host_ina219_t;
+
+/* simulated INA219: big endian 16 bits registers behind a pointer */
+struct host_ina219_s {
+	mp_posix_i2c_device_t device;
+
+	unsigned short registers[6];
+	unsigned char pointer;
+	unsigned char position;
+};
+
+struct host_board_s {
+	mp_kernel_t kernel;
+
+	mp_drv_led_t led;
+	mp_pinout_t blink;
+
+	mp_uart_t uart;
+	mp_serial_t serial;
+	mp_bool_t serialOpened;
+	unsigned char serialRx[64];
+	unsigned char serialTx[512];
+
+	host_ina219_t ina219Sim;
+	mp_drv_INA219_t ina219;
+
+	mp_ktimer_t report;
+	mp_ktimer_t duration;
+
+	unsigned long seconds;
+};
+
+static void _host_onBoot(void *user);
+static void _host_state_op_set(void *user);
+static void _host_state_op_unset(void *user);
+static void _host_state_op_tick(void *user);
+
+static void _host_printk(void *user, char *fmt, ...);
+static void _host_report(mp_ktimer_t *timer);
+static void _host_duration(mp_ktimer_t *timer);
+static void _host_serial_onDma(mp_serial_t *serial, mp_serial_dma_event_t event);
+
+static void _host_ina219_onStart(mp_posix_i2c_device_t *device, mp_bool_t read);
+static void _host_ina219_onWrite(mp_posix_i2c_device_t *device, unsigned char data);
+static unsigned char _host_ina219_onRead(mp_posix_i2c_device_t *device);
+
+static host_board_t _host;
+
+int main(int argc, char **argv) {
+	host_board_t *host = &_host;
+	int opt;
+
+	memset(host, 0, sizeof(*host));
+
+	while((opt = getopt(argc, argv, "d:")) != -1) {
+		switch(opt) {
+			case 'd':
+				host->seconds = strtoul(optarg, NULL, 10);
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-d seconds]\n", argv[0]);
+				return(EXIT_FAILURE);
+		}
+	}
+
+	/* initialize kernel */
+	mp_kernel_init(&host->kernel, _host_onBoot, host);
+
+	/* printk on the standard error */
+	mp_printk_set(_host_printk, host);
+
+	/* define host OP machine state */
+	mp_state_define(
+		&host->kernel.states,
+		HOST_OP, "OP", host,
+		_host_state_op_set,
+		_host_state_op_unset,
+		_host_state_op_tick
+	);
+
+	/* master loop, leaves the process on mp_posix_quit() */
+	mp_kernel_loop(&host->kernel);
+
+	/* terminate kernel */
+	mp_kernel_fini(&host->kernel);
+
+	return(0);
+}
+
+static void _host_onBoot(void *user) {
+	host_board_t *host = user;
+
+	/* switch to host operationnal state */
+	mp_kernel_state(&host->kernel, HOST_OP);
+}
+
+static void _host_state_op_set(void *user) {
+	host_board_t *host = user;
+	mp_ret_t ret;
+
+	mp_clock_high_energy(&host->kernel);
+
+	/* blinking led */
+	{
+		mp_options_t options[] = {
+			{ "port", "p10.6" },
+			{ NULL, NULL }
+		};
+		ret = mp_drv_led_init(&host->kernel, &host->led, options, "Host LED");
+		if(ret == TRUE)
+			mp_pinout_onoff(&host->kernel, &host->blink, host->led.gpio, ON, 0, 500, 0, "Host blink");
+	}
+
+	/* serial over a pseudo terminal, moved by the DMA stand-in */
+	{
+		mp_options_t options[] = {
+			{ "gate", "USCI_A0" },
+			{ "txd", "p3.4" },
+			{ "rxd", "p3.5" },
+			{ "baudRate", "9600" },
+			{ "dmaTx", "0" },
+			{ "dmaRx", "1" },
+			{ NULL, NULL }
+		};
+		ret = mp_uart_open(&host->kernel, &host->uart, options, "Host UART");
+		if(ret == TRUE)
+			host->serialOpened = mp_serial_initUART_dma(
+				&host->kernel, &host->serial, &host->uart,
+				host->serialRx, sizeof(host->serialRx),
+				host->serialTx, sizeof(host->serialTx),
+				"Host serial"
+			);
+		if(host->serialOpened == YES) {
+			host->serial.onDma = _host_serial_onDma;
+			host->serial.user = host;
+		}
+	}
+
+	/* simulated INA219 wired on USCI_B3 */
+	{
+		host_ina219_t *sim = &host->ina219Sim;
+
+		sim->registers[INA219_REG_CONFIG] = 0x399f;
+		sim->registers[INA219_REG_SHUNTVOLTAGE] = 0x0fa0;
+		sim->registers[INA219_REG_BUSVOLTAGE] = 0x5d98;
+		sim->registers[INA219_REG_CURRENT] = 0x03e8;
+
+		sim->device.address = INA219_ADDRESS;
+		sim->device.onStart = _host_ina219_onStart;
+		sim->device.onWrite = _host_ina219_onWrite;
+		sim->device.onRead = _host_ina219_onRead;
+		sim->device.user = sim;
+		mp_posix_i2c_attach("USCI_B3", &sim->device);
+
+		mp_options_t options[] = {
+			{ "gate", "USCI_B3" },
+			{ "sda", "p10.1" },
+			{ "clk", "p10.2" },
+			{ NULL, NULL }
+		};
+		mp_drv_INA219_init(&host->kernel, &host->ina219, options, "Ti INA219");
+	}
+
+	mp_ktimer_start(&host->kernel, &host->report, "Host report",
+			1000, 1000, _host_report, host);
+
+	if(host->seconds > 0)
+		mp_ktimer_start(&host->kernel, &host->duration, "Host duration",
+				host->seconds*1000, 0, _host_duration, host);
+}
+
+static void _host_state_op_unset(void *user) {
+	host_board_t *host = user;
+
+	mp_ktimer_stop(&host->kernel, &host->report);
+	mp_ktimer_stop(&host->kernel, &host->duration);
+
+	mp_drv_INA219_fini(&host->ina219);
+	mp_posix_i2c_detach("USCI_B3", &host->ina219Sim.device);
+
+	if(host->serialOpened == YES) {
+		mp_serial_fini(&host->serial);
+		mp_uart_close(&host->uart);
+	}
+
+	mp_pinout_stop(&host->blink);
+	mp_drv_led_fini(&host->led);
+}
+
+static void _host_state_op_tick(void *user) {
+	/* nothing */
+}
+
+static void _host_printk(void *user, char *fmt, ...) {
+	va_list args;
+
+	va_start(args, fmt);
+	vfprintf(stderr, fmt, args);
+	va_end(args);
+	fputc('\n', stderr);
+}
+
+static void _host_report(mp_ktimer_t *timer) {
+	host_board_t *host = timer->user;
+	char buffer[80];
+	int size;
+
+	/* values of the previous period */
+	size = snprintf(buffer, sizeof(buffer), "bus=0x%04x shunt=0x%04x current=0x%04x\r\n",
+			host->ina219.rawBusVoltage, host->ina219.rawShuntVoltage,
+			host->ina219.rawCurrent);
+
+	mp_printk("%.*s", size-2, buffer);
+	if(host->serialOpened == YES)
+		mp_serial_write(&host->serial, (unsigned char *)buffer, size);
+
+	mp_drv_INA219_update_busVoltage(&host->ina219);
+	mp_drv_INA219_update_shuntVoltage(&host->ina219);
+	mp_drv_INA219_update_current(&host->ina219);
+}
+
+/* echo, FULL comes from the DMA interrupt and is left to the others */
+static void _host_serial_onDma(mp_serial_t *serial, mp_serial_dma_event_t event) {
+	unsigned char buffer[32];
+	int size;
+
+	if(event == MP_SERIAL_DMA_FULL)
+		return;
+
+	while((size = mp_serial_read(serial, buffer, sizeof(buffer))) > 0)
+		mp_serial_write(serial, buffer, size);
+}
+
+static void _host_duration(mp_ktimer_t *timer) {
+	mp_printk("Host duration elapsed");
+	mp_posix_quit();
+}
+
+static void _host_ina219_onStart(mp_posix_i2c_device_t *device, mp_bool_t read) {
+	host_ina219_t *sim = device->user;
+
+	/* a write selects the register, a read starts from its MSB */
+	sim->position = 0;
+}
+
+static void _host_ina219_onWrite(mp_posix_i2c_device_t *device, unsigned char data) {
+	host_ina219_t *sim = device->user;
+	unsigned short *reg;
+
+	if(sim->position == 0) {
+		sim->pointer = data % 6;
+		sim->position++;
+		return;
+	}
+
+	reg = &sim->registers[sim->pointer];
+	if(sim->position == 1)
+		*reg = (*reg & 0x00ff) | (data << 8);
+	else
+		*reg = (*reg & 0xff00) | data;
+	sim->position++;
+}
+
+static unsigned char _host_ina219_onRead(mp_posix_i2c_device_t *device) {
+	host_ina219_t *sim = device->user;
+	unsigned short reg = sim->registers[sim->pointer];
+
+	return((sim->position++ & 1) ? reg & 0xff : reg >> 8);
+}
@@ -0,0 +1,430 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <mp.h>
+
+static void mp_i2c_interruptDispatch(void *user);
+static void _land(mp_i2c_t *i2c);
+static void _stop(mp_i2c_t *i2c);
+static mp_bool_t _fault(mp_i2c_t *i2c);
+
+/* internal pointers */
+static mp_list_t __i2c;
+static unsigned int __i2c_count;
+
+/**
+@defgroup mpArchPosixI2C I2C stand-in
+
+@ingroup mpArchPosix
+
+@brief USCI_B master emulation talking to simulated devices
+
+@author @htmlonly &copy; @endhtmlonly 2016
+Michael Vergoz <mv@verman.fr>
+
+@date 17 Oct 2016
+
+Transfers complete instantly. A start condition selects the device wired
+on the gate with the slave address, NACK is flagged when there is none.
+
+Faults are injected per device with mp_posix_i2c_fault() : a NACK of the
+address, an arbitration lost or a slave holding SDA low. A held bus
+does not raise any flag anymore until mp_i2c_recover().
+
+In receiver mode the byte in flight lands in RXBUF once RXBUF is empty, a
+stop requested before it lands makes it the last one, as on the USCI.
+
+@{
+*/
+
+mp_ret_t mp_i2c_init() {
+	mp_list_init(&__i2c);
+	__i2c_count = 0;
+	return(TRUE);
+}
+
+mp_ret_t mp_i2c_fini() {
+	return(TRUE);
+}
+
+mp_ret_t mp_i2c_open(mp_kernel_t *kernel, mp_i2c_t *i2c, mp_options_t *options, char *who) {
+	char *value;
+
+	/* get gate Id*/
+	value = mp_options_get(options, "gate");
+	if(!value)
+		return(FALSE);
+	i2c->gate = mp_gate_handle(value, "I2C");
+	if(i2c->gate == NULL) {
+		mp_printk("I2C - No gate specify (USCI_B) for %s", who);
+		return(FALSE);
+	}
+
+	/* sda */
+	value = mp_options_get(options, "sda");
+	if(!value) {
+		mp_printk("I2C - No SDA port for %s", who);
+		mp_i2c_close(i2c);
+		return(FALSE);
+	}
+	i2c->sda = mp_gpio_text_handle(value, "I2C SDA");
+	if(!i2c->sda) {
+		mp_printk("I2C - Can not handle GPIO SDA for %s using %s", who, value);
+		mp_i2c_close(i2c);
+		return(FALSE);
+	}
+
+	/* clk */
+	value = mp_options_get(options, "clk");
+	if(!value) {
+		mp_printk("I2C - No CLK port for %s", who);
+		mp_i2c_close(i2c);
+		return(FALSE);
+	}
+	i2c->clk = mp_gpio_text_handle(value, "I2C CLK");
+	if(!i2c->clk) {
+		mp_printk("I2C - Can not handle GPIO CLK for %s using %s", who, value);
+		mp_i2c_close(i2c);
+		return(FALSE);
+	}
+	return(TRUE);
+}
+
+mp_ret_t mp_i2c_setup(mp_i2c_t *i2c, mp_options_t *options) {
+	char *value;
+
+	/* frequency */
+	value = mp_options_get(options, "frequency");
+	if(!value) {
+		mp_printk("I2C - No frequency specify");
+		mp_i2c_close(i2c);
+		return(FALSE);
+	}
+
+	MP_INTERRUPT_SAFE_BEGIN
+
+	i2c->started = NO;
+	i2c->inflight = NO;
+	i2c->stopRequest = NO;
+	i2c->rxFull = NO;
+	i2c->device = NULL;
+	i2c->held = NO;
+
+	/* disable interrupts */
+	i2c->gate->ie = 0;
+	i2c->gate->ifg = 0;
+
+	/* place interrupt */
+	mp_interrupt_set(i2c->gate->_ISRVector, mp_i2c_interruptDispatch, i2c, i2c->gate->portDevice);
+
+	MP_INTERRUPT_SAFE_END
+
+	/* list */
+	mp_list_add_last(&__i2c, &i2c->item, i2c);
+	__i2c_count++;
+	return(TRUE);
+}
+
+mp_ret_t mp_i2c_close(mp_i2c_t *i2c) {
+
+	if(i2c->gate) {
+		/* disable interrupts */
+		mp_i2c_disable_tx(i2c);
+		mp_i2c_disable_rx(i2c);
+		mp_interrupt_unset(i2c->gate->_ISRVector);
+	}
+
+	if(i2c->sda)
+		mp_gpio_release(i2c->sda);
+
+	if(i2c->clk)
+		mp_gpio_release(i2c->clk);
+
+	if(i2c->gate)
+		mp_gate_release(i2c->gate);
+
+	if(i2c->item.user == i2c) {
+		mp_list_remove(&__i2c, &i2c->item);
+		__i2c_count--;
+	}
+
+	return(TRUE);
+}
+
+void mp_i2c_enable_rx(mp_i2c_t *i2c) {
+	i2c->gate->ie |= MP_I2C_FL_RX;
+	_land(i2c);
+	mp_posix_gate_update(i2c->gate);
+}
+
+void mp_i2c_disable_rx(mp_i2c_t *i2c) {
+	i2c->gate->ie &= ~MP_I2C_FL_RX;
+}
+
+void mp_i2c_enable_tx(mp_i2c_t *i2c) {
+	i2c->gate->ie |= MP_I2C_FL_TX;
+	mp_posix_gate_update(i2c->gate);
+}
+
+void mp_i2c_disable_tx(mp_i2c_t *i2c) {
+	i2c->gate->ie &= ~MP_I2C_FL_TX;
+}
+
+void mp_i2c_enable_errors(mp_i2c_t *i2c) {
+	i2c->gate->ie |= MP_I2C_FL_NACK | MP_I2C_FL_AL;
+	mp_posix_gate_update(i2c->gate);
+}
+
+void mp_i2c_disable_errors(mp_i2c_t *i2c) {
+	i2c->gate->ie &= ~(MP_I2C_FL_NACK | MP_I2C_FL_AL);
+}
+
+unsigned char mp_i2c_rx(mp_i2c_t *i2c) {
+	unsigned char data = i2c->rxbuf;
+
+	i2c->gate->ifg &= ~MP_I2C_FL_RX;
+	i2c->rxFull = NO;
+	_land(i2c);
+	mp_posix_gate_update(i2c->gate);
+	return(data);
+}
+
+void mp_i2c_tx(mp_i2c_t *i2c, unsigned char data) {
+	if(i2c->started == NO || i2c->transmitter == 0 || i2c->device == NULL)
+		return;
+
+	i2c->gate->ifg &= ~MP_I2C_FL_TX;
+	if(i2c->device->onWrite)
+		i2c->device->onWrite(i2c->device, data);
+
+	/* shifted out, TXBUF free again */
+	i2c->gate->ifg |= MP_I2C_FL_TX;
+	mp_posix_gate_update(i2c->gate);
+}
+
+void mp_i2c_txStop(mp_i2c_t *i2c) {
+	if(i2c->started == NO)
+		return;
+
+	/* the byte in flight will be the last one */
+	if(i2c->transmitter == 0 && i2c->inflight == YES) {
+		i2c->stopRequest = YES;
+		_land(i2c);
+	}
+	else
+		_stop(i2c);
+	mp_posix_gate_update(i2c->gate);
+}
+
+void mp_i2c_txStart(mp_i2c_t *i2c) {
+	mp_posix_i2c_device_t *device;
+	mp_list_item_t *item;
+
+	/* SDA low, nothing moves */
+	if(i2c->held == YES)
+		return;
+
+	i2c->gate->ifg &= ~(MP_I2C_FL_TX | MP_I2C_FL_RX | MP_I2C_FL_NACK | MP_I2C_FL_AL);
+	i2c->stopRequest = NO;
+	i2c->inflight = NO;
+	i2c->rxFull = NO;
+	i2c->device = NULL;
+
+	/* address the slave */
+	for(item=i2c->gate->devices.first; item; item=item->next) {
+		device = item->user;
+		if(device->address == i2c->slaveAddress) {
+			i2c->device = device;
+			break;
+		}
+	}
+
+	if(i2c->device == NULL) {
+		i2c->started = NO;
+		i2c->gate->ifg |= MP_I2C_FL_NACK;
+		mp_posix_gate_update(i2c->gate);
+		return;
+	}
+
+	if(i2c->device->faultCount > 0 && _fault(i2c) == YES)
+		return;
+
+	i2c->started = YES;
+	if(i2c->device->onStart)
+		i2c->device->onStart(i2c->device, i2c->transmitter == 0 ? YES : NO);
+
+	if(i2c->transmitter != 0)
+		i2c->gate->ifg |= MP_I2C_FL_TX;
+	else
+		i2c->inflight = YES;
+
+	mp_posix_gate_update(i2c->gate);
+}
+
+/**
+ * @brief Wire a simulated device on an I2C gate
+ *
+ * @param[in] gate Gate name
+ * @param[in] device Device
+ * @return TRUE or FALSE
+ */
+mp_ret_t mp_posix_i2c_attach(char *gate, mp_posix_i2c_device_t *device) {
+	mp_gate_t *g = mp_posix_gate_get(gate);
+
+	if(g == NULL)
+		return(FALSE);
+	mp_list_add_last(&g->devices, &device->item, device);
+	return(TRUE);
+}
+
+void mp_posix_i2c_detach(char *gate, mp_posix_i2c_device_t *device) {
+	mp_gate_t *g = mp_posix_gate_get(gate);
+
+	if(g != NULL)
+		mp_list_remove(&g->devices, &device->item);
+}
+
+/**
+ * @brief Inject a fault on the next starts addressing a device
+ *
+ * @param[in] device Device
+ * @param[in] fault Fault
+ * @param[in] count Number of faulty starts
+ */
+void mp_posix_i2c_fault(mp_posix_i2c_device_t *device, mp_posix_i2c_fault_t fault, unsigned int count) {
+	MP_INTERRUPT_SAFE_BEGIN
+	device->fault = fault;
+	device->faultCount = fault != MP_POSIX_I2C_FAULT_NONE ? count : 0;
+	MP_INTERRUPT_SAFE_END
+}
+
+/**
+ * @brief Reset the USCI in master mode
+ *
+ * Flags and interrupt enables are cleared as with UCSWRST.
+ *
+ * @param[in] i2c I2C context
+ */
+void mp_i2c_reset(mp_i2c_t *i2c) {
+	i2c->started = NO;
+	i2c->inflight = NO;
+	i2c->stopRequest = NO;
+	i2c->rxFull = NO;
+	i2c->device = NULL;
+
+	i2c->gate->ie = 0;
+	i2c->gate->ifg = 0;
+}
+
+/**
+ * @brief Free a bus held by a slave then reset the USCI
+ *
+ * Nine SCL clocks let the slave shift out the byte it is holding.
+ *
+ * @param[in] i2c I2C context
+ */
+void mp_i2c_recover(mp_i2c_t *i2c) {
+	i2c->held = NO;
+	mp_i2c_reset(i2c);
+}
+
+/**@}*/
+
+/* injected fault on a start, YES when the start does not go further */
+static mp_bool_t _fault(mp_i2c_t *i2c) {
+	mp_posix_i2c_device_t *device = i2c->device;
+
+	device->faultCount--;
+
+	switch(device->fault) {
+		case MP_POSIX_I2C_FAULT_NACK:
+			i2c->started = NO;
+			i2c->device = NULL;
+			i2c->gate->ifg |= MP_I2C_FL_NACK;
+			break;
+
+		/* USCI falls back to slave mode */
+		case MP_POSIX_I2C_FAULT_ARBITRATION:
+			i2c->started = NO;
+			i2c->device = NULL;
+			i2c->gate->ifg |= MP_I2C_FL_AL;
+			break;
+
+		case MP_POSIX_I2C_FAULT_HOLD:
+			i2c->started = YES;
+			i2c->held = YES;
+			break;
+
+		default:
+			return(NO);
+	}
+
+	mp_posix_gate_update(i2c->gate);
+	return(YES);
+}
+
+static void _stop(mp_i2c_t *i2c) {
+	if(i2c->device && i2c->device->onStop)
+		i2c->device->onStop(i2c->device);
+	i2c->started = NO;
+	i2c->inflight = NO;
+	i2c->stopRequest = NO;
+	i2c->gate->ifg &= ~MP_I2C_FL_TX;
+}
+
+/* move the byte in flight into RXBUF */
+static void _land(mp_i2c_t *i2c) {
+	if(i2c->inflight == NO || i2c->rxFull == YES)
+		return;
+
+	i2c->rxbuf = i2c->device->onRead ? i2c->device->onRead(i2c->device) : 0xff;
+	i2c->rxFull = YES;
+	i2c->gate->ifg |= MP_I2C_FL_RX;
+
+	if(i2c->stopRequest == YES)
+		_stop(i2c);
+}
+
+static void mp_i2c_interruptDispatch(void *user) {
+	mp_i2c_t *i2c = user;
+	unsigned char pending = i2c->gate->ifg & i2c->gate->ie;
+	mp_i2c_flag_t iv;
+
+	/* same priority than UCBxIV, reading it clears the flag */
+	if(pending & MP_I2C_FL_AL)
+		iv = MP_I2C_FL_AL;
+	else if(pending & MP_I2C_FL_NACK)
+		iv = MP_I2C_FL_NACK;
+	else if(pending & MP_I2C_FL_RX)
+		iv = MP_I2C_FL_RX;
+	else if(pending & MP_I2C_FL_TX)
+		iv = MP_I2C_FL_TX;
+	else
+		return;
+
+	i2c->gate->ifg &= ~iv;
+
+	if(i2c->intDispatch)
+		i2c->intDispatch(i2c, iv);
+
+	/* level triggered */
+	mp_posix_gate_update(i2c->gate);
+}
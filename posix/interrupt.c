@@ -0,0 +1,307 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <mp.h>
+
+#include <signal.h>
+
+static void __dummy_int();
+static void _dispatch(void);
+static void _signal_io(int sig);
+
+static mp_interrupt_t __interrupts[POSIX_MAX_VECTORS];
+
+/* signals standing for hardware interrupt lines */
+static sigset_t __lines;
+
+/* GIE of the main context */
+static volatile mp_bool_t __state;
+
+/* nesting of the ISR context */
+static volatile int __inside;
+
+/* raised vectors not yet served */
+static volatile unsigned int __pending;
+
+/* vectors raised on SIGIO */
+static volatile unsigned int __io;
+
+/* number of ISR calls per vector */
+static unsigned long __served[POSIX_MAX_VECTORS];
+
+/**
+@defgroup mpArchPosixInterrupt Interrupts
+
+@ingroup mpArchPosix
+
+@brief Software vectors served from signal handlers
+
+@author @htmlonly &copy; @endhtmlonly 2016
+Michael Vergoz <mv@verman.fr>
+
+@date 17 Oct 2016
+
+An interrupt line is a signal: SIGALRM for the timers and SIGIO for file
+descriptors. Stand-in peripherals raise their vector with
+mp_posix_interrupt_raise(). Disabling interrupts only clears a software
+GIE, no system call: a vector raised meanwhile is left pending and served
+as soon as interrupts are enabled again, like a pending IFG on the target.
+
+ISRs never nest, a vector raised from an ISR is served when the current
+one returns.
+
+@{
+*/
+
+mp_ret_t mp_interrupt_init() {
+	struct sigaction sa;
+	int a;
+
+	memset(__interrupts, 0, sizeof(__interrupts));
+	memset(__served, 0, sizeof(__served));
+	for(a=0; a<POSIX_MAX_VECTORS; a++)
+		__interrupts[a].callback = __dummy_int;
+
+	__pending = 0;
+	__io = 0;
+	__inside = 0;
+
+	sigemptyset(&__lines);
+	sigaddset(&__lines, SIGALRM);
+	sigaddset(&__lines, SIGIO);
+
+	/* start with interrupts disabled */
+	__state = NO;
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = _signal_io;
+	sa.sa_mask = __lines;
+	sa.sa_flags = SA_RESTART;
+	sigaction(SIGIO, &sa, NULL);
+
+	return(TRUE);
+}
+
+mp_ret_t mp_interrupt_fini() {
+	mp_interrupt_disable();
+	signal(SIGIO, SIG_DFL);
+	return(TRUE);
+}
+
+mp_interrupt_t *mp_interrupt_set(int vector, mp_interrupt_cb_t in, void *user, char *who) {
+	mp_interrupt_t *inter;
+
+	if(vector < 0 || vector >= POSIX_MAX_VECTORS)
+		return(NULL);
+
+	MP_INTERRUPT_SAFE_BEGIN
+
+	inter = &__interrupts[vector];
+
+	if(inter->callback != __dummy_int)
+		inter = NULL; /* already used */
+	else {
+		inter->callback = in;
+		inter->user = user;
+		inter->who = who;
+	}
+
+	MP_INTERRUPT_SAFE_END
+
+	return(inter);
+}
+
+mp_ret_t mp_interrupt_unset(int vector) {
+	if(vector < 0 || vector >= POSIX_MAX_VECTORS)
+		return(FALSE);
+
+	MP_INTERRUPT_SAFE_BEGIN
+
+	__interrupts[vector].callback = __dummy_int;
+	__interrupts[vector].user = NULL;
+	__interrupts[vector].who = NULL;
+	__atomic_fetch_and(&__pending, ~(1<<vector), __ATOMIC_SEQ_CST);
+	__atomic_fetch_and(&__io, ~(1<<vector), __ATOMIC_SEQ_CST);
+
+	MP_INTERRUPT_SAFE_END
+	return(TRUE);
+}
+
+void mp_interrupt_enable() {
+	/* ISRs run with the lines masked */
+	if(__inside > 0)
+		return;
+
+	/* signals run on this thread, a compiler fence orders them */
+	__atomic_store_n(&__state, YES, __ATOMIC_RELAXED);
+	__atomic_signal_fence(__ATOMIC_SEQ_CST);
+
+	/* serve what has been raised while disabled */
+	if(__atomic_load_n(&__pending, __ATOMIC_RELAXED))
+		_dispatch();
+}
+
+void mp_interrupt_disable() {
+	if(__inside > 0)
+		return;
+	__atomic_store_n(&__state, NO, __ATOMIC_RELAXED);
+	__atomic_signal_fence(__ATOMIC_SEQ_CST);
+}
+
+mp_bool_t mp_interrupt_state() {
+	if(__inside > 0)
+		return(NO);
+	return(__state);
+}
+
+void mp_interrupt_restore(mp_bool_t state) {
+	if(state == ON)
+		mp_interrupt_enable();
+	else
+		mp_interrupt_disable();
+}
+
+/**
+ * @brief Leave low power mode at the end of the current ISR
+ *
+ * Nothing to do on the host, sigsuspend() returns after any ISR
+ */
+void mp_interrupt_lpm_exit() { }
+
+/**
+ * @brief Raise a software vector
+ *
+ * Safe from the main context and from ISRs (signal handlers)
+ *
+ * @param[in] vector Vector to raise
+ */
+void mp_posix_interrupt_raise(int vector) {
+	__atomic_fetch_or(&__pending, 1<<vector, __ATOMIC_SEQ_CST);
+
+	/* interrupts enabled in the main context */
+	if(__atomic_load_n(&__state, __ATOMIC_SEQ_CST) == YES)
+		_dispatch();
+}
+
+/**
+ * @brief Raise a vector on each SIGIO
+ *
+ * Used by file descriptor backed stand-ins which poll their descriptor
+ * from the ISR
+ *
+ * @param[in] vector Vector to raise
+ * @param[in] watch YES to raise on SIGIO, NO to stop
+ */
+void mp_posix_interrupt_io(int vector, mp_bool_t watch) {
+	if(watch == YES)
+		__atomic_fetch_or(&__io, 1<<vector, __ATOMIC_SEQ_CST);
+	else
+		__atomic_fetch_and(&__io, ~(1<<vector), __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief Low power mode
+ *
+ * Called with interrupts disabled, waits for a line unless a vector
+ * is already pending. Raised vectors are served by the next
+ * mp_interrupt_enable()
+ */
+void mp_posix_interrupt_wait(void) {
+	sigset_t old;
+	sigset_t wait;
+
+	sigprocmask(SIG_BLOCK, &__lines, &old);
+
+	if(__atomic_load_n(&__pending, __ATOMIC_SEQ_CST) == 0) {
+		wait = old;
+		sigdelset(&wait, SIGALRM);
+		sigdelset(&wait, SIGIO);
+		sigsuspend(&wait);
+	}
+
+	sigprocmask(SIG_SETMASK, &old, NULL);
+}
+
+/**
+ * @brief Serve a vector from a signal handler
+ *
+ * Lines are masked by the signal handler
+ *
+ * @param[in] vector Vector to serve
+ */
+void mp_posix_interrupt_signal(int vector) {
+	mp_posix_interrupt_raise(vector);
+}
+
+/**
+ * @brief Number of times a vector has been served
+ *
+ * @param[in] vector Vector
+ * @return ISR calls since mp_interrupt_init()
+ */
+unsigned long mp_posix_interrupt_served(int vector) {
+	if(vector < 0 || vector >= POSIX_MAX_VECTORS)
+		return(0);
+	return(__served[vector]);
+}
+
+/**@}*/
+
+static void __dummy_int() { }
+
+/*
+ * from a signal handler or from the main context with interrupts
+ * enabled, a signal caught while serving only leaves its vector pending
+ */
+static void _dispatch(void) {
+	mp_interrupt_t *inter;
+	unsigned int pending;
+	int vector;
+
+	do {
+		if(__atomic_fetch_add(&__inside, 1, __ATOMIC_SEQ_CST) > 0) {
+			__atomic_fetch_sub(&__inside, 1, __ATOMIC_SEQ_CST);
+			return;
+		}
+
+		while((pending = __atomic_load_n(&__pending, __ATOMIC_SEQ_CST)) != 0) {
+			vector = __builtin_ctz(pending);
+			__atomic_fetch_and(&__pending, ~(1<<vector), __ATOMIC_SEQ_CST);
+
+			inter = &__interrupts[vector];
+			__served[vector]++;
+			MP_TRACE_EVENT(MP_TRACE_ISR_ENTER, vector, 0);
+			inter->callback(inter->user);
+			MP_TRACE_EVENT(MP_TRACE_ISR_EXIT, vector, 0);
+		}
+
+		__atomic_fetch_sub(&__inside, 1, __ATOMIC_SEQ_CST);
+
+	/* raised between the last check and the exit */
+	} while(__atomic_load_n(&__pending, __ATOMIC_SEQ_CST) != 0 &&
+		__atomic_load_n(&__state, __ATOMIC_SEQ_CST) == YES);
+}
+
+static void _signal_io(int sig) {
+	__atomic_fetch_or(&__pending, __io, __ATOMIC_SEQ_CST);
+	if(__atomic_load_n(&__state, __ATOMIC_SEQ_CST) == YES)
+		_dispatch();
+}
@@ -0,0 +1,136 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <mp.h>
+
+#include <signal.h>
+#include <sys/utsname.h>
+
+static void _signal_quit(int sig);
+
+static volatile sig_atomic_t __quit;
+static struct utsname __uname;
+
+mp_ret_t mp_machine_init(mp_kernel_t *kernel) {
+	struct sigaction sa;
+
+	kernel->mcuVendor = "POSIX";
+	kernel->mcuName = "host";
+	if(uname(&__uname) == 0)
+		kernel->mcuName = __uname.machine;
+
+	/* leave the kernel loop on ^C */
+	__quit = 0;
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = _signal_quit;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+
+	/* initialize GATEs */
+	mp_gate_init(kernel);
+
+	/* initialize interrupts */
+	mp_interrupt_init();
+
+	/* initialize GPIO */
+	mp_gpio_init();
+
+	/* initialize timer */
+	mp_timer_init(kernel);
+
+	/* intialize clock */
+	mp_clock_init(kernel);
+
+	/* set high energy */
+	mp_clock_high_energy(kernel);
+
+	/* intialize I2C */
+	mp_i2c_init();
+
+	/* initialize DMA */
+	mp_dma_init();
+
+	/* intialize UART */
+	mp_uart_init();
+
+	/* initialize SPI */
+	mp_spi_init();
+
+	/* enter in interruptible mode */
+	mp_interrupt_enable();
+
+	return(TRUE);
+}
+
+mp_ret_t mp_machine_fini(mp_kernel_t *kernel) {
+
+	/* terminate SPI */
+	mp_spi_fini();
+
+	/* terminate UART */
+	mp_uart_fini();
+
+	/* terminate DMA */
+	mp_dma_fini();
+
+	/* terminate I2C */
+	mp_i2c_fini();
+
+	/* terminate clock */
+	mp_clock_fini(kernel);
+
+	/* terminate timer */
+	mp_timer_fini(kernel);
+
+	/* terminate GPIO */
+	mp_gpio_fini();
+
+	/* terminate interrupts */
+	mp_interrupt_fini();
+
+	/* terminate GATEs */
+	mp_gate_fini(kernel);
+
+	return(TRUE);
+}
+
+void mp_machine_state_set(mp_kernel_t *kernel) { }
+
+void mp_machine_state_unset(mp_kernel_t *kernel) { }
+
+/**
+ * @brief Ask the kernel loop to terminate
+ *
+ * The process exits from the next mp_clock_schedule(), after
+ * mp_kernel_fini(). Safe from signal handlers.
+ */
+void mp_posix_quit(void) {
+	__quit = 1;
+}
+
+mp_bool_t mp_posix_quitting(void) {
+	return(__quit ? YES : NO);
+}
+
+static void _signal_quit(int sig) {
+	mp_posix_quit();
+}
@@ -0,0 +1,240 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <mp.h>
+
+static void mp_spi_interruptDispatch(void *user);
+
+/* internal pointers */
+static mp_list_t __spi;
+static unsigned int __spi_count;
+
+/**
+@defgroup mpArchPosixSPI SPI stand-in
+
+@ingroup mpArchPosix
+
+@brief USCI SPI master emulation talking to simulated devices
+
+@author @htmlonly &copy; @endhtmlonly 2016
+Michael Vergoz <mv@verman.fr>
+
+@date 17 Oct 2016
+
+Writing TXBUF exchanges the byte with the selected device at once and
+raises both RX and TX flags. Without device 0xff is received.
+
+@{
+*/
+
+void mp_spi_init() {
+	mp_list_init(&__spi);
+	__spi_count = 0;
+}
+
+void mp_spi_fini() {
+
+}
+
+mp_ret_t mp_spi_open(mp_kernel_t *kernel, mp_spi_t *spi, mp_options_t *options, char *who) {
+	char *value;
+
+	/* get gate Id*/
+	value = mp_options_get(options, "gate");
+	if(!value)
+		return(FALSE);
+	spi->gate = mp_gate_handle(value, "SPI");
+	if(spi->gate == NULL) {
+		mp_printk("SPI - No gate specify (USCI_B) for %s", who);
+		return(FALSE);
+	}
+
+	/* somi */
+	value = mp_options_get(options, "somi");
+	if(!value) {
+		mp_printk("SPI - No SOMI port for %s", who);
+		mp_spi_close(spi);
+		return(FALSE);
+	}
+	spi->somi = mp_gpio_text_handle(value, "SPI SOMI");
+	if(!spi->somi) {
+		mp_printk("SPI - Can not handle GPIO SOMI for %s using %s", who, value);
+		mp_spi_close(spi);
+		return(FALSE);
+	}
+
+	/* simo */
+	value = mp_options_get(options, "simo");
+	if(!value) {
+		mp_printk("SPI - No SIMO port for %s", who);
+		mp_spi_close(spi);
+		return(FALSE);
+	}
+	spi->simo = mp_gpio_text_handle(value, "SPI SIMO");
+	if(!spi->simo) {
+		mp_printk("SPI - Can not handle GPIO SIMO for %s using %s", who, value);
+		mp_spi_close(spi);
+		return(FALSE);
+	}
+
+	/* clk */
+	value = mp_options_get(options, "clk");
+	if(!value) {
+		mp_printk("SPI - No CLK port for %s", who);
+		mp_spi_close(spi);
+		return(FALSE);
+	}
+	spi->clk = mp_gpio_text_handle(value, "SPI CLK");
+	if(!spi->clk) {
+		mp_printk("SPI - Can not handle GPIO CLK for %s using %s", who, value);
+		mp_spi_close(spi);
+		return(FALSE);
+	}
+
+	return(TRUE);
+}
+
+mp_ret_t mp_spi_setup(mp_spi_t *spi, mp_options_t *options) {
+	char *value;
+
+	/* frequency */
+	value = mp_options_get(options, "frequency");
+	if(!value) {
+		mp_printk("SPI - No frequency specify");
+		mp_spi_close(spi);
+		return(FALSE);
+	}
+	spi->frequency = atol(value);
+
+	MP_INTERRUPT_SAFE_BEGIN
+
+	/* disable interrupts, TXBUF is empty */
+	spi->gate->ie = 0;
+	spi->gate->ifg = MP_SPI_IV_TX;
+	spi->ie = 0;
+
+	/* place interrupt */
+	mp_interrupt_set(spi->gate->_ISRVector, mp_spi_interruptDispatch, spi, spi->gate->portDevice);
+
+	MP_INTERRUPT_SAFE_END
+
+	/* list */
+	mp_list_add_last(&__spi, &spi->item, spi);
+	__spi_count++;
+	return(TRUE);
+}
+
+mp_ret_t mp_spi_close(mp_spi_t *spi) {
+	/* disable interrupts */
+	if(spi->gate) {
+		mp_spi_disable_rx(spi);
+		mp_spi_disable_tx(spi);
+		mp_interrupt_unset(spi->gate->_ISRVector);
+	}
+
+	if(spi->simo)
+		mp_gpio_release(spi->simo);
+
+	if(spi->somi)
+		mp_gpio_release(spi->somi);
+
+	if(spi->clk)
+		mp_gpio_release(spi->clk);
+
+	if(spi->gate)
+		mp_gate_release(spi->gate);
+
+	if(spi->item.user == spi) {
+		mp_list_remove(&__spi, &spi->item);
+		__spi_count--;
+	}
+
+	return(TRUE);
+}
+
+unsigned char mp_spi_rx(mp_spi_t *spi) {
+	spi->gate->ifg &= ~MP_SPI_IV_RX;
+	return(spi->rxbuf);
+}
+
+void mp_spi_tx(mp_spi_t *spi, unsigned char data) {
+	mp_posix_spi_device_t *device;
+	mp_list_item_t *item;
+
+	spi->rxbuf = 0xff;
+	for(item=spi->gate->devices.first; item; item=item->next) {
+		device = item->user;
+		if(device->select == NULL || mp_posix_gpio_output(device->select) == OFF) {
+			spi->rxbuf = device->onExchange(device, data);
+			break;
+		}
+	}
+
+	spi->gate->ifg |= MP_SPI_IV_TX | MP_SPI_IV_RX;
+	mp_posix_gate_update(spi->gate);
+}
+
+/**
+ * @brief Wire a simulated device on a SPI gate
+ *
+ * @param[in] gate Gate name
+ * @param[in] device Device
+ * @return TRUE or FALSE
+ */
+mp_ret_t mp_posix_spi_attach(char *gate, mp_posix_spi_device_t *device) {
+	mp_gate_t *g = mp_posix_gate_get(gate);
+
+	if(g == NULL)
+		return(FALSE);
+	mp_list_add_last(&g->devices, &device->item, device);
+	return(TRUE);
+}
+
+void mp_posix_spi_detach(char *gate, mp_posix_spi_device_t *device) {
+	mp_gate_t *g = mp_posix_gate_get(gate);
+
+	if(g != NULL)
+		mp_list_remove(&g->devices, &device->item);
+}
+
+/**@}*/
+
+static void mp_spi_interruptDispatch(void *user) {
+	mp_spi_t *spi = user;
+	unsigned char pending = spi->gate->ifg & spi->gate->ie;
+	mp_spi_iv_t iv;
+
+	/* same priority than UCxIV, reading it clears the flag */
+	if(pending & MP_SPI_IV_RX)
+		iv = MP_SPI_IV_RX;
+	else if(pending & MP_SPI_IV_TX)
+		iv = MP_SPI_IV_TX;
+	else
+		return;
+
+	spi->gate->ifg &= ~iv;
+
+	if(spi->intDispatch)
+		spi->intDispatch(spi, iv);
+
+	/* level triggered */
+	mp_posix_gate_update(spi->gate);
+}
@@ -0,0 +1,185 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <mp.h>
+
+#include <signal.h>
+
+static void _timer_interrupt(void *user);
+static void _signal_alarm(int sig, siginfo_t *info, void *context);
+
+/**
+@defgroup mpArchPosixTimer Timers
+
+@ingroup mpArchPosix
+
+@brief Timer gates backed by POSIX timers
+
+@author @htmlonly &copy; @endhtmlonly 2016
+Michael Vergoz <mv@verman.fr>
+
+@date 17 Oct 2016
+
+Each timer gate owns a CLOCK_MONOTONIC timer delivering SIGALRM. Options
+are the MSP430 ones:
+@li gate: TIMER_A0, TIMER_A1 or TIMER_B0
+@li frequency: periodic interrupt frequency in Hz
+@li mode: "cont" for no periodic interrupt, see mp_posix_timer_oneshot()
+
+PWM is not emulated.
+
+@{
+*/
+
+mp_ret_t mp_timer_init(mp_kernel_t *kernel) {
+	struct sigaction sa;
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_sigaction = _signal_alarm;
+	sigemptyset(&sa.sa_mask);
+	sigaddset(&sa.sa_mask, SIGALRM);
+	sigaddset(&sa.sa_mask, SIGIO);
+	sa.sa_flags = SA_SIGINFO | SA_RESTART;
+	sigaction(SIGALRM, &sa, NULL);
+
+	return(TRUE);
+}
+
+void mp_timer_fini(mp_kernel_t *kernel) {
+	signal(SIGALRM, SIG_DFL);
+}
+
+mp_ret_t mp_timer_create(mp_kernel_t *kernel, mp_timer_t *timer, mp_options_t *options, char *who) {
+	struct sigevent event;
+	struct itimerspec spec;
+	char *value;
+
+	memset(timer, 0, sizeof(*timer));
+	timer->kernel = kernel;
+	timer->who = who;
+
+	value = mp_options_get(options, "gate");
+	if(!value) {
+		mp_printk("TIMER - No gate specify for %s", who);
+		return(FALSE);
+	}
+	timer->gate = mp_gate_handle(value, who);
+	if(timer->gate == NULL) {
+		mp_printk("TIMER - Can not handle gate %s for %s", value, who);
+		return(FALSE);
+	}
+
+	value = mp_options_get(options, "mode");
+	if(!value || !mp_options_cmp(value, "cont")) {
+		value = mp_options_get(options, "frequency");
+		if(value)
+			timer->frequency = atol(value);
+	}
+
+	memset(&event, 0, sizeof(event));
+	event.sigev_notify = SIGEV_SIGNAL;
+	event.sigev_signo = SIGALRM;
+	event.sigev_value.sival_ptr = timer;
+	if(timer_create(CLOCK_MONOTONIC, &event, &timer->id) != 0) {
+		mp_printk("TIMER - Can not create timer for %s", who);
+		mp_gate_release(timer->gate);
+		return(FALSE);
+	}
+
+	if(mp_interrupt_set(timer->gate->_ISRVector, _timer_interrupt, timer, who) == NULL) {
+		timer_delete(timer->id);
+		mp_gate_release(timer->gate);
+		return(FALSE);
+	}
+
+	/* periodic */
+	if(timer->frequency > 0) {
+		memset(&spec, 0, sizeof(spec));
+		spec.it_interval.tv_nsec = 1000000000L/timer->frequency;
+		spec.it_value = spec.it_interval;
+		timer_settime(timer->id, 0, &spec, NULL);
+	}
+
+	return(TRUE);
+}
+
+void mp_timer_destroy(mp_timer_t *timer) {
+	timer->enabled = NO;
+	timer_delete(timer->id);
+	mp_interrupt_unset(timer->gate->_ISRVector);
+	mp_gate_release(timer->gate);
+}
+
+mp_ret_t mp_timer_set_interrupt(mp_timer_t *timer, mp_timer_interrupt_t isr) {
+	timer->isr = isr;
+	return(TRUE);
+}
+
+mp_ret_t mp_timer_unset_interrupt(mp_timer_t *timer) {
+	timer->isr = NULL;
+	return(TRUE);
+}
+
+/**
+ * @brief Program a single interrupt
+ *
+ * Stands for a compare register on a continuous timer
+ *
+ * @param[in] timer Timer in continuous mode
+ * @param[in] usec Delay in microseconds, 0 cancels
+ */
+void mp_posix_timer_oneshot(mp_timer_t *timer, unsigned long usec) {
+	struct itimerspec spec;
+
+	memset(&spec, 0, sizeof(spec));
+	spec.it_value.tv_sec = usec/1000000;
+	spec.it_value.tv_nsec = (usec%1000000)*1000;
+	timer_settime(timer->id, 0, &spec, NULL);
+}
+
+/**@}*/
+
+static void _timer_interrupt(void *user) {
+	mp_timer_t *timer = user;
+	int count = 1+timer->overrun;
+
+	timer->overrun = 0;
+	if(timer->enabled == NO || timer->isr == NULL)
+		return;
+
+	/* expirations merged by the signal are served too */
+	while(count-- > 0)
+		timer->isr(timer);
+}
+
+static void _signal_alarm(int sig, siginfo_t *info, void *context) {
+	mp_timer_t *timer = info->si_value.sival_ptr;
+	int overrun;
+
+	if(info->si_code != SI_TIMER || timer == NULL)
+		return;
+
+	overrun = timer_getoverrun(timer->id);
+	if(overrun > 0)
+		timer->overrun += overrun;
+
+	mp_posix_interrupt_signal(timer->gate->_ISRVector);
+}
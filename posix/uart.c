@@ -0,0 +1,434 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#define _GNU_SOURCE /* ptsname */
+
+#include <mp.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+
+static void _mp_uart_interrupt(void *user);
+static void _poll(mp_uart_t *uart);
+static void _flush(mp_uart_t *uart);
+static mp_ret_t _mp_uart_dma_open(mp_uart_t *uart, mp_options_t *options, char *who);
+static void _mp_uart_dma_txDone(mp_dma_t *dma);
+static void _mp_uart_dma_rxDone(mp_dma_t *dma);
+
+/**
+@defgroup mpArchPosixUART UART stand-in
+
+@ingroup mpArchPosix
+
+@brief UART gates backed by a pseudo terminal
+
+@author @htmlonly &copy; @endhtmlonly 2016
+Michael Vergoz <mv@verman.fr>
+
+@date 17 Oct 2016
+
+Options are the MSP430 ones plus:
+@li device: file to open read/write instead of a new pseudo terminal
+
+The slave side of the pseudo terminal is printed with mp_printk(), connect
+to it with any terminal program. The descriptor raises the gate vector on
+SIGIO, bytes sent while nobody reads are dropped and counted. Bytes
+sent from the gate ISR are written at once when the TX interrupt stops.
+
+DMA channels are triggered by the ISR: each received byte goes through
+RXBUF to the RX channel, the TX channel is pumped into TXBUF until its
+block is done.
+
+@{
+*/
+
+mp_ret_t mp_uart_init() {
+
+	return(TRUE);
+}
+
+mp_ret_t mp_uart_fini() {
+
+	return(TRUE);
+}
+
+mp_ret_t mp_uart_open(mp_kernel_t *kernel, mp_uart_t *uart, mp_options_t *options, char *who) {
+	char *value;
+
+	memset(uart, 0, sizeof(*uart));
+	uart->kernel = kernel;
+	uart->fd = -1;
+
+	/* get gate Id*/
+	value = mp_options_get(options, "gate");
+	if(!value)
+		return(FALSE);
+
+	uart->gate = mp_gate_handle(value, "UART");
+	if(!uart->gate) {
+		mp_printk("UART - No gate specify (USCI_A) for %s", who);
+		return(FALSE);
+	}
+
+	/* allocate GPIO port for RX data */
+	value = mp_options_get(options, "rxd");
+	if(value) {
+		uart->rxd_port = mp_gpio_text_handle(value, "UART RXD");
+		if(!uart->rxd_port) {
+			mp_printk("UART - Can not handle GPIO RXD for %s using %s", who, value);
+			mp_uart_close(uart);
+			return(FALSE);
+		}
+		mp_gpio_direction(uart->rxd_port, MP_GPIO_INPUT);
+	}
+
+	/* allocate GPIO port for TX data */
+	value = mp_options_get(options, "txd");
+	if(value) {
+		uart->txd_port = mp_gpio_text_handle(value, "UART TXD");
+		if(!uart->txd_port) {
+			mp_printk("UART - Can not handle GPIO TXD for %s using %s", who, value);
+			mp_uart_close(uart);
+			return(FALSE);
+		}
+		mp_gpio_direction(uart->txd_port, MP_GPIO_OUTPUT);
+	}
+
+	/* setup */
+	if(mp_uart_setup(uart, options) == FALSE) {
+		mp_printk("UART - Can not open a descriptor for %s", who);
+		mp_uart_close(uart);
+		return(FALSE);
+	}
+
+	/* optional DMA channels */
+	if(_mp_uart_dma_open(uart, options, who) == FALSE) {
+		mp_uart_close(uart);
+		return(FALSE);
+	}
+
+	return(TRUE);
+}
+
+mp_ret_t mp_uart_setup(mp_uart_t *uart, mp_options_t *options) {
+	struct termios tio;
+	char *value;
+
+	/* frequency */
+	value = mp_options_get(options, "baudRate");
+	if(value)
+		uart->baudRate = atoi(value);
+
+	if(uart->fd < 0) {
+		value = mp_options_get(options, "device");
+		if(value)
+			uart->fd = open(value, O_RDWR | O_NOCTTY);
+		else {
+			uart->fd = posix_openpt(O_RDWR | O_NOCTTY);
+			if(uart->fd >= 0 && (grantpt(uart->fd) != 0 || unlockpt(uart->fd) != 0)) {
+				close(uart->fd);
+				uart->fd = -1;
+			}
+			if(uart->fd >= 0) {
+				/* raw line, the serial layer does its own framing */
+				if(tcgetattr(uart->fd, &tio) == 0) {
+					cfmakeraw(&tio);
+					tcsetattr(uart->fd, TCSANOW, &tio);
+				}
+				mp_printk("UART %s on %s", uart->gate->portDevice, ptsname(uart->fd));
+			}
+		}
+		if(uart->fd < 0)
+			return(FALSE);
+
+		fcntl(uart->fd, F_SETOWN, getpid());
+		fcntl(uart->fd, F_SETFL, fcntl(uart->fd, F_GETFL) | O_NONBLOCK | O_ASYNC);
+	}
+
+	/* disable interrupts */
+	MP_INTERRUPT_SAFE_BEGIN
+
+	uart->rxHead = 0;
+	uart->rxTail = 0;
+	uart->txLength = 0;
+
+	/* TXBUF is always empty */
+	uart->gate->ifg = POSIX_UART_TX;
+
+	/* place interrupt */
+	mp_interrupt_set(uart->gate->_ISRVector, _mp_uart_interrupt, uart, uart->gate->portDevice);
+	mp_posix_interrupt_io(uart->gate->_ISRVector, YES);
+
+	MP_INTERRUPT_SAFE_END
+
+	return(TRUE);
+}
+
+mp_ret_t mp_uart_close(mp_uart_t *uart) {
+
+	/* release DMA channels */
+	mp_dma_close(&uart->dmaTx);
+	mp_dma_close(&uart->dmaRx);
+
+	if(uart->gate) {
+		/* remove interrupt */
+		mp_posix_interrupt_io(uart->gate->_ISRVector, NO);
+		mp_interrupt_unset(uart->gate->_ISRVector);
+	}
+
+	if(uart->fd >= 0) {
+		_flush(uart);
+		close(uart->fd);
+		uart->fd = -1;
+	}
+
+	/* clean gpio */
+	if(uart->rxd_port != NULL)
+		mp_gpio_release(uart->rxd_port);
+
+	if(uart->txd_port != NULL)
+		mp_gpio_release(uart->txd_port);
+
+	if(uart->gate)
+		mp_gate_release(uart->gate);
+
+	return(TRUE);
+}
+
+void mp_uart_tx(mp_uart_t *uart, unsigned char data) {
+	if(uart->txLength == POSIX_UART_TX_SIZE)
+		_flush(uart);
+	uart->tx[uart->txLength++] = data;
+
+	/* outside of the gate ISR nobody would flush */
+	if(uart->inside == NO)
+		_flush(uart);
+
+	/* sent at once */
+	uart->gate->ifg |= POSIX_UART_TX;
+	mp_posix_gate_update(uart->gate);
+}
+
+unsigned char mp_uart_rx(mp_uart_t *uart) {
+	unsigned char data;
+
+	if(uart->rxHead == uart->rxTail)
+		return(0);
+
+	data = uart->rx[uart->rxTail];
+	uart->rxTail = (uart->rxTail+1)%POSIX_UART_RX_SIZE;
+	if(uart->rxHead == uart->rxTail)
+		uart->gate->ifg &= ~POSIX_UART_RX;
+	return(data);
+}
+
+mp_ret_t mp_uart_dma_tx(mp_uart_t *uart, unsigned char *data, unsigned int size) {
+	if(uart->dmaTx.opened != YES || size == 0)
+		return(FALSE);
+
+	/* TXIFG belongs to the channel */
+	uart->gate->ie &= ~POSIX_UART_TX;
+
+	mp_dma_start(
+		&uart->dmaTx, uart->dmaTxTrigger, MP_DMA_SRC_INCR,
+		data, &uart->txbuf, size
+	);
+
+	/* the ISR pumps the channel */
+	mp_posix_interrupt_raise(uart->gate->_ISRVector);
+
+	return(TRUE);
+}
+
+mp_ret_t mp_uart_dma_rx(mp_uart_t *uart, unsigned char *buffer, unsigned int size) {
+	if(uart->dmaRx.opened != YES || size == 0)
+		return(FALSE);
+
+	/* RXIFG belongs to the channel */
+	uart->gate->ie &= ~POSIX_UART_RX;
+
+	uart->dmaRxSize = size;
+	mp_dma_start(
+		&uart->dmaRx, uart->dmaRxTrigger, MP_DMA_DST_INCR | MP_DMA_REPEAT,
+		&uart->rxbuf, buffer, size
+	);
+
+	/* bytes already waiting */
+	mp_posix_interrupt_raise(uart->gate->_ISRVector);
+
+	return(TRUE);
+}
+
+unsigned int mp_uart_dma_rx_count(mp_uart_t *uart) {
+	unsigned int remaining;
+	mp_bool_t pending;
+
+	/* a lap may end between both reads */
+	do {
+		remaining = mp_dma_remaining(&uart->dmaRx);
+		pending = mp_dma_pending(&uart->dmaRx);
+	} while(remaining != mp_dma_remaining(&uart->dmaRx));
+
+	return(uart->dmaRxSize-remaining+(pending == YES ? uart->dmaRxSize : 0));
+}
+
+void mp_uart_dma_stop(mp_uart_t *uart) {
+	if(uart->dmaTx.opened == YES)
+		mp_dma_stop(&uart->dmaTx);
+	if(uart->dmaRx.opened == YES)
+		mp_dma_stop(&uart->dmaRx);
+}
+
+/**@}*/
+
+/* read what the descriptor holds, lines are masked */
+static void _poll(mp_uart_t *uart) {
+	unsigned int space;
+	ssize_t ret;
+
+	while(1) {
+		/* contiguous free room, one slot stays empty */
+		if(uart->rxHead >= uart->rxTail)
+			space = POSIX_UART_RX_SIZE-uart->rxHead-(uart->rxTail == 0 ? 1 : 0);
+		else
+			space = uart->rxTail-uart->rxHead-1;
+		if(space == 0)
+			break;
+
+		ret = read(uart->fd, uart->rx+uart->rxHead, space);
+		if(ret <= 0)
+			break;
+		uart->rxHead = (uart->rxHead+ret)%POSIX_UART_RX_SIZE;
+	}
+
+	if(uart->rxHead != uart->rxTail)
+		uart->gate->ifg |= POSIX_UART_RX;
+}
+
+/* write what has been shifted out */
+static void _flush(mp_uart_t *uart) {
+	ssize_t ret;
+
+	if(uart->txLength == 0)
+		return;
+
+	ret = write(uart->fd, uart->tx, uart->txLength);
+	if(ret < 0)
+		ret = 0;
+	uart->txDropped += uart->txLength-ret;
+	uart->txLength = 0;
+}
+
+static mp_ret_t _mp_uart_dma_open(mp_uart_t *uart, mp_options_t *options, char *who) {
+	char *value;
+
+	/* same triggers than the F5438 */
+	if(strcmp(uart->gate->portDevice, "USCI_A0") == 0) {
+		uart->dmaTxTrigger = MP_DMA_TRIGGER_UCA0TX;
+		uart->dmaRxTrigger = MP_DMA_TRIGGER_UCA0RX;
+	}
+	else if(strcmp(uart->gate->portDevice, "USCI_A1") == 0) {
+		uart->dmaTxTrigger = MP_DMA_TRIGGER_UCA1TX;
+		uart->dmaRxTrigger = MP_DMA_TRIGGER_UCA1RX;
+	}
+
+	value = mp_options_get(options, "dmaTx");
+	if(value) {
+		if(uart->dmaTxTrigger == 0 || mp_dma_open(&uart->dmaTx, value, who) == FALSE) {
+			mp_printk("UART - Can not use DMA TX for %s", who);
+			return(FALSE);
+		}
+		uart->dmaTx.onDone = _mp_uart_dma_txDone;
+		uart->dmaTx.user = uart;
+	}
+
+	value = mp_options_get(options, "dmaRx");
+	if(value) {
+		if(uart->dmaRxTrigger == 0 || mp_dma_open(&uart->dmaRx, value, who) == FALSE) {
+			mp_printk("UART - Can not use DMA RX for %s", who);
+			return(FALSE);
+		}
+		uart->dmaRx.onDone = _mp_uart_dma_rxDone;
+		uart->dmaRx.user = uart;
+	}
+
+	return(TRUE);
+}
+
+static void _mp_uart_dma_txDone(mp_dma_t *dma) {
+	mp_uart_t *uart = dma->user;
+	if(uart->onDmaTx)
+		uart->onDmaTx(uart);
+}
+
+static void _mp_uart_dma_rxDone(mp_dma_t *dma) {
+	mp_uart_t *uart = dma->user;
+	if(uart->onDmaRx)
+		uart->onDmaRx(uart);
+}
+
+static void _mp_uart_interrupt(void *user) {
+	mp_uart_t *uart = user;
+	unsigned int tail;
+
+	uart->inside = YES;
+
+	_poll(uart);
+
+	/* RXBUF read by the RX channel */
+	while(uart->rxHead != uart->rxTail) {
+		uart->rxbuf = uart->rx[uart->rxTail];
+		if(mp_posix_dma_trigger(uart->dmaRxTrigger) == NO)
+			break;
+		mp_uart_rx(uart);
+	}
+
+	/* TXBUF written by the TX channel */
+	while(mp_posix_dma_trigger(uart->dmaTxTrigger) == YES)
+		mp_uart_tx(uart, uart->txbuf);
+
+	if(uart->gate->ifg & uart->gate->ie & POSIX_UART_RX) {
+		tail = uart->rxTail;
+		if(uart->onRead)
+			uart->onRead(uart);
+
+		/* the handler did not take the byte */
+		if(tail == uart->rxTail)
+			mp_uart_rx(uart);
+	}
+
+	/* served until the handler stops writing */
+	if(uart->gate->ifg & uart->gate->ie & POSIX_UART_TX) {
+		uart->gate->ifg &= ~POSIX_UART_TX;
+		if(uart->onWrite)
+			uart->onWrite(uart);
+	}
+
+	/* the next byte comes from another ISR call */
+	if(!(uart->gate->ifg & uart->gate->ie & POSIX_UART_TX))
+		_flush(uart);
+
+	uart->inside = NO;
+
+	/* level triggered */
+	mp_posix_gate_update(uart->gate);
+}
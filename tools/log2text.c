@@ -0,0 +1,302 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Host decoder of a MP_LOG serial capture. Format strings are read
+ * from the mp_log section of the ELF image which produced the capture.
+ *
+ * $ make log2text
+ * $ ./tools/bin/log2text firmware.out capture.bin
+ *
+ * Record layout follows include/common/log.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MP_LOG_SYNC   0xffff
+#define MP_LOG_LOST   0xfffe
+#define MP_LOG_HEADER 7
+
+#define SECTION "mp_log"
+
+static char *strings = NULL;
+static unsigned long stringsSize = 0;
+
+static unsigned long hz = 32768;
+static unsigned long long epoch = 0;
+static unsigned long lastTime = 0;
+static int intSize = 2;
+static int ptrSize = 2;
+
+static unsigned long long get(const unsigned char *p, int size) {
+	unsigned long long v = 0;
+	while(size-- > 0)
+		v = v<<8 | p[size];
+	return(v);
+}
+
+/* little endian ELF32 or ELF64, returns the section content */
+static int loadStrings(const char *path) {
+	unsigned char *image;
+	unsigned long shoff, shentsize, shnum, shstrndx;
+	unsigned long nameOff, off, size, a;
+	const unsigned char *sh;
+	long length;
+	int is64;
+	FILE *fp;
+
+	fp = fopen(path, "rb");
+	if(!fp) {
+		perror(path);
+		return(0);
+	}
+	fseek(fp, 0, SEEK_END);
+	length = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	image = malloc(length);
+	if(!image || fread(image, 1, length, fp) != (size_t)length) {
+		fprintf(stderr, "%s: read error\n", path);
+		fclose(fp);
+		return(0);
+	}
+	fclose(fp);
+
+	if(length < 52 || memcmp(image, "\x7f" "ELF", 4) || image[5] != 1) {
+		fprintf(stderr, "%s: not a little endian ELF image\n", path);
+		return(0);
+	}
+
+	is64 = image[4] == 2;
+	shoff = get(image+(is64 ? 0x28 : 0x20), is64 ? 8 : 4);
+	shentsize = get(image+(is64 ? 0x3a : 0x2e), 2);
+	shnum = get(image+(is64 ? 0x3c : 0x30), 2);
+	shstrndx = get(image+(is64 ? 0x3e : 0x32), 2);
+	if(shoff+shnum*shentsize > (unsigned long)length || shstrndx >= shnum) {
+		fprintf(stderr, "%s: bad section table\n", path);
+		return(0);
+	}
+
+	sh = image+shoff+shstrndx*shentsize;
+	nameOff = get(sh+(is64 ? 0x18 : 0x10), is64 ? 8 : 4);
+
+	for(a=0; a<shnum; a++) {
+		sh = image+shoff+a*shentsize;
+		off = get(sh+(is64 ? 0x18 : 0x10), is64 ? 8 : 4);
+		size = get(sh+(is64 ? 0x20 : 0x14), is64 ? 8 : 4);
+		if(nameOff+get(sh, 4)+sizeof(SECTION) > (unsigned long)length ||
+				strcmp((char *)image+nameOff+get(sh, 4), SECTION))
+			continue;
+		if(off+size > (unsigned long)length) {
+			fprintf(stderr, "%s: truncated %s section\n", path, SECTION);
+			return(0);
+		}
+
+		/* trailing zero for a string running to the end */
+		strings = calloc(1, size+1);
+		memcpy(strings, image+off, size);
+		stringsSize = size;
+		free(image);
+		return(1);
+	}
+
+	fprintf(stderr, "%s: no %s section, is MP_LOG defined?\n", path, SECTION);
+	return(0);
+}
+
+static double timestamp(unsigned long t) {
+	/* 32 bits counter wrapping */
+	if(t < lastTime && lastTime-t > 0x80000000UL)
+		epoch += 0x100000000ULL;
+	lastTime = t;
+	return((double)(epoch+t)/(double)hz);
+}
+
+/* replays the target walk of mp_log_encode() */
+static void format(const char *fmt, const unsigned char *args, int size) {
+	char spec[32];
+	char str[256];
+	int pos = 0;
+	int len, n;
+	unsigned long long v;
+	float real;
+	char conv;
+
+	for(; *fmt; fmt++) {
+		if(*fmt != '%') {
+			putchar(*fmt);
+			continue;
+		}
+
+		len = 0;
+		spec[len++] = *fmt++;
+		for(; *fmt && strchr("-+ #.*0123456789", *fmt); fmt++) {
+			if(*fmt != '*') {
+				if(len < 20)
+					spec[len++] = *fmt;
+				continue;
+			}
+			if(pos+intSize > size)
+				goto missing;
+			n = (int)get(args+pos, intSize);
+			if(intSize == 2)
+				n = (short)n;
+			pos += intSize;
+			len += snprintf(spec+len, sizeof(spec)-len-4, "%d", n);
+		}
+
+		n = intSize;
+		if(*fmt == 'h')
+			fmt++;
+		else if(*fmt == 'l') {
+			n = 4;
+			fmt++;
+		}
+
+		conv = *fmt;
+		switch(conv) {
+			case '%':
+				putchar('%');
+				break;
+
+			case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+				if(pos+n > size)
+					goto missing;
+				v = get(args+pos, n);
+				pos += n;
+				if(conv == 'c') {
+					spec[len++] = 'c';
+					spec[len] = 0;
+					printf(spec, (int)v);
+					break;
+				}
+				spec[len++] = 'l';
+				spec[len++] = 'l';
+				spec[len++] = conv;
+				spec[len] = 0;
+				/* sign extend from the target width */
+				if((conv == 'd' || conv == 'i') && n < 8 && (v >> (n*8-1)) & 1)
+					v |= ~0ULL << (n*8);
+				printf(spec, v);
+				break;
+
+			case 'p':
+				if(pos+ptrSize > size)
+					goto missing;
+				printf("0x%llx", get(args+pos, ptrSize));
+				pos += ptrSize;
+				break;
+
+			case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+				if(pos+4 > size)
+					goto missing;
+				memcpy(&real, args+pos, 4);
+				pos += 4;
+				spec[len++] = conv;
+				spec[len] = 0;
+				printf(spec, (double)real);
+				break;
+
+			case 's':
+				if(pos+1 > size || pos+1+args[pos] > size)
+					goto missing;
+				memcpy(str, args+pos+1, args[pos]);
+				str[args[pos]] = 0;
+				pos += 1+args[pos];
+				spec[len++] = 's';
+				spec[len] = 0;
+				printf(spec, str);
+				break;
+
+			default:
+				goto missing;
+		}
+	}
+	return;
+
+missing:
+	printf("<?>%s", *fmt ? fmt+1 : "");
+}
+
+int main(int argc, char **argv) {
+	unsigned char header[MP_LOG_HEADER];
+	unsigned char args[256];
+	unsigned long t;
+	unsigned short id;
+	int size;
+	FILE *fp = stdin;
+
+	if(argc < 2) {
+		fprintf(stderr, "usage: %s image.elf [capture.bin]\n", argv[0]);
+		return(1);
+	}
+
+	if(!loadStrings(argv[1]))
+		return(1);
+
+	if(argc > 2 && strcmp(argv[2], "-") != 0) {
+		fp = fopen(argv[2], "rb");
+		if(!fp) {
+			perror(argv[2]);
+			return(1);
+		}
+	}
+
+	while(fread(header, 1, MP_LOG_HEADER, fp) == MP_LOG_HEADER) {
+		id = get(header, 2);
+		size = header[2];
+		t = get(header+3, 4);
+		if(fread(args, 1, size, fp) != (size_t)size)
+			break;
+
+		switch(id) {
+			case MP_LOG_SYNC:
+				hz = t ? t : hz;
+				epoch = 0;
+				lastTime = 0;
+				if(size < 3 || args[0] != 1) {
+					fprintf(stderr, "warning: unknown stream version %d\n", args[0]);
+					break;
+				}
+				intSize = args[1];
+				ptrSize = args[2];
+				break;
+
+			case MP_LOG_LOST:
+				printf("[%12.6f] %llu records lost\n", timestamp(t), get(args, 2));
+				break;
+
+			default:
+				printf("[%12.6f] ", timestamp(t));
+				if(id >= stringsSize)
+					printf("unknown format %u", id);
+				else
+					format(strings+id, args, size);
+				putchar('\n');
+				break;
+		}
+	}
+
+	if(fp != stdin)
+		fclose(fp);
+	return(0);
+}
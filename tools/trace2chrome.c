@@ -0,0 +1,249 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * miniPhi - RTOS                                                          *
+ * Copyright (C) 2015  Michael VERGOZ                                      *
+ * Copyright (C) 2015  VERMAN                                              *
+ *                                                                         *
+ * This program is free software; you can redistribute it and/or modify    *
+ * it under the terms of the GNU General Public License as published by    *
+ * the Free Software Foundation; either version 3 of the License, or       *
+ * (at your option) any later version.                                     *
+ *                                                                         *
+ * This program is distributed in the hope that it will be useful,         *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ * GNU General Public License for more details.                            *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License       *
+ * along with this program; if not, write to the Free Software Foundation, *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA       *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Host converter from a MP_TRACE serial capture to the Chrome trace
+ * event format, loadable by chrome://tracing or ui.perfetto.dev
+ *
+ * $ make trace2chrome
+ * $ ./tools/bin/trace2chrome capture.bin > capture.json
+ *
+ * Record layout and types follow include/common/trace.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MP_TRACE_SYNC            0x00
+#define MP_TRACE_TASK_BEGIN      0x01
+#define MP_TRACE_TASK_END        0x02
+#define MP_TRACE_ISR_ENTER       0x03
+#define MP_TRACE_ISR_EXIT        0x04
+#define MP_TRACE_REGMASTER_START 0x05
+#define MP_TRACE_REGMASTER_DONE  0x06
+#define MP_TRACE_STATE           0x07
+#define MP_TRACE_LPM_ENTER       0x08
+#define MP_TRACE_LPM_EXIT        0x09
+#define MP_TRACE_LOST            0x0a
+#define MP_TRACE_NAME_TASK       0x10
+#define MP_TRACE_NAME_STATE      0x11
+
+#define RECORD_SIZE 8
+
+/* chrome trace threads */
+#define TID_TASKS     1
+#define TID_ISR       2
+#define TID_REGMASTER 3
+#define TID_LPM       4
+#define TID_KERNEL    5
+
+#define MAX_REGMASTER 16
+
+static char *taskNames[256];
+static char *stateNames[256];
+
+static unsigned long hz = 32768;
+static unsigned long long epoch = 0;
+static unsigned long firstTime = 0;
+static unsigned long lastTime = 0;
+static int haveTime = 0;
+static int first = 1;
+
+static struct {
+	unsigned short client;
+	int open;
+} regMasters[MAX_REGMASTER];
+
+static double timestamp(unsigned long t) {
+	/* 32 bits counter wrapping, capture starts at 0 */
+	if(!haveTime)
+		firstTime = t;
+	else if(t < lastTime && lastTime-t > 0x80000000UL)
+		epoch += 0x100000000ULL;
+	lastTime = t;
+	haveTime = 1;
+	return((double)(epoch+t-firstTime)*1000000.0/(double)hz);
+}
+
+static void event(const char *ph, const char *name, const char *cat, int tid, double ts, const char *extra) {
+	printf("%s\n  {\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"%s\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f%s}",
+		first ? "" : ",", name, cat, ph, tid, ts, extra ? extra : "");
+	first = 0;
+}
+
+static void threadName(int tid, const char *name) {
+	char extra[128];
+	snprintf(extra, sizeof(extra), ", \"args\": {\"name\": \"%s\"}", name);
+	printf("%s\n  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d%s}",
+		first ? "" : ",", tid, extra);
+	first = 0;
+}
+
+static char *readName(FILE *fp, int len) {
+	int padded = (len+RECORD_SIZE-1)/RECORD_SIZE*RECORD_SIZE;
+	char *name = calloc(1, padded+1);
+	if(!name || fread(name, 1, padded, fp) != (size_t)padded) {
+		free(name);
+		return(NULL);
+	}
+	name[len] = 0;
+
+	/* keep JSON valid */
+	for(int a=0; a<len; a++) {
+		if(name[a] == '"' || name[a] == '\\' || (unsigned char)name[a] < 0x20)
+			name[a] = '_';
+	}
+	return(name);
+}
+
+static int regMasterSlot(unsigned short client) {
+	int a;
+	for(a=0; a<MAX_REGMASTER; a++) {
+		if(regMasters[a].client == client)
+			return(a);
+	}
+	for(a=0; a<MAX_REGMASTER; a++) {
+		if(regMasters[a].client == 0) {
+			regMasters[a].client = client;
+			return(a);
+		}
+	}
+	return(-1);
+}
+
+int main(int argc, char **argv) {
+	unsigned char rec[RECORD_SIZE];
+	char name[128];
+	char extra[128];
+	unsigned long t;
+	unsigned char type, id;
+	unsigned short arg;
+	double ts;
+	int slot;
+	FILE *fp = stdin;
+
+	if(argc > 1 && strcmp(argv[1], "-") != 0) {
+		fp = fopen(argv[1], "rb");
+		if(!fp) {
+			perror(argv[1]);
+			return(1);
+		}
+	}
+
+	printf("{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+	threadName(TID_TASKS, "Tasks");
+	threadName(TID_ISR, "ISR");
+	threadName(TID_REGMASTER, "regMaster");
+	threadName(TID_LPM, "Low power");
+	threadName(TID_KERNEL, "Kernel");
+
+	while(fread(rec, 1, RECORD_SIZE, fp) == RECORD_SIZE) {
+		t = rec[0] | rec[1]<<8 | rec[2]<<16 | (unsigned long)rec[3]<<24;
+		type = rec[4];
+		id = rec[5];
+		arg = rec[6] | rec[7]<<8;
+
+		switch(type) {
+			case MP_TRACE_SYNC:
+				hz = t ? t : hz;
+				epoch = 0;
+				haveTime = 0;
+				if(id != 1)
+					fprintf(stderr, "warning: unknown stream version %d\n", id);
+				continue;
+
+			case MP_TRACE_NAME_TASK:
+			case MP_TRACE_NAME_STATE: {
+				char **table = type == MP_TRACE_NAME_TASK ? taskNames : stateNames;
+				free(table[id]);
+				table[id] = readName(fp, arg);
+				continue;
+			}
+		}
+
+		ts = timestamp(t);
+
+		switch(type) {
+			case MP_TRACE_TASK_BEGIN:
+			case MP_TRACE_TASK_END:
+				if(taskNames[id])
+					snprintf(name, sizeof(name), "%s", taskNames[id]);
+				else
+					snprintf(name, sizeof(name), "task %d", id);
+				event(type == MP_TRACE_TASK_BEGIN ? "B" : "E", name, "task", TID_TASKS, ts, NULL);
+				break;
+
+			case MP_TRACE_ISR_ENTER:
+			case MP_TRACE_ISR_EXIT:
+				snprintf(name, sizeof(name), "vector %d", id);
+				event(type == MP_TRACE_ISR_ENTER ? "B" : "E", name, "isr", TID_ISR, ts, NULL);
+				break;
+
+			case MP_TRACE_REGMASTER_START:
+			case MP_TRACE_REGMASTER_DONE:
+				slot = regMasterSlot(arg);
+				if(slot < 0)
+					break;
+
+				/* the ASR may restart a pending operation */
+				if(type == MP_TRACE_REGMASTER_START && regMasters[slot].open)
+					break;
+				if(type == MP_TRACE_REGMASTER_DONE && !regMasters[slot].open)
+					break;
+				regMasters[slot].open = type == MP_TRACE_REGMASTER_START;
+
+				snprintf(name, sizeof(name), "regMaster client %d", arg);
+				snprintf(extra, sizeof(extra), ", \"id\": %d, \"args\": {\"reg\": \"0x%02x\"}", arg, id);
+				event(type == MP_TRACE_REGMASTER_START ? "b" : "e", name, "regMaster", TID_REGMASTER, ts, extra);
+				break;
+
+			case MP_TRACE_STATE:
+				if(stateNames[id])
+					snprintf(name, sizeof(name), "state %s", stateNames[id]);
+				else
+					snprintf(name, sizeof(name), "state %d", id);
+				event("i", name, "state", TID_KERNEL, ts, ", \"s\": \"p\"");
+				break;
+
+			case MP_TRACE_LPM_ENTER:
+			case MP_TRACE_LPM_EXIT:
+				snprintf(name, sizeof(name), "LPM%d", id);
+				event(type == MP_TRACE_LPM_ENTER ? "B" : "E", name, "lpm", TID_LPM, ts, NULL);
+				break;
+
+			case MP_TRACE_LOST:
+				snprintf(name, sizeof(name), "%d records lost", arg);
+				event("i", name, "trace", TID_KERNEL, ts, ", \"s\": \"g\"");
+				break;
+
+			default:
+				fprintf(stderr, "warning: unknown record type 0x%02x\n", type);
+				break;
+		}
+	}
+
+	printf("\n]}\n");
+
+	if(fp != stdin)
+		fclose(fp);
+	return(0);
+}